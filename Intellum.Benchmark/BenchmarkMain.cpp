@@ -0,0 +1,863 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "HeadlessInput.h"
+#include "../Intellum/Engine/Objects/EntityManager.h"
+#include "../Intellum/Engine/Objects/Systems/SystemScheduler.h"
+#include "../Intellum/Engine/Objects/Systems/TransformSystem.h"
+#include "../Intellum/Engine/Objects/Systems/ButtonSystem.h"
+#include "../Intellum/Engine/Objects/Systems/InputSystem.h"
+#include "../Intellum/Engine/Objects/Systems/RenderSystem.h"
+#include "../Intellum/Engine/Objects/Systems/UISystem.h"
+#include "../Intellum/Engine/Objects/Systems/TextSystem.h"
+#include "../Intellum/Engine/Objects/Transform/TransformBatch.h"
+#include "../Intellum/Engine/Rendering/RenderQueue.h"
+#include "../Intellum/Engine/Rendering/RecordingRenderDevice.h"
+#include "../Intellum/Engine/Rendering/SoftwareRenderDevice.h"
+#include "../Intellum/Engine/Scenes/JSONSceneHandler.h"
+#include "../Intellum/Engine/Scenes/SceneBlobLoader.h"
+#include "../Intellum/Engine/Scenes/SceneBlobWriter.h"
+#include "../Intellum/Engine/Scenes/SceneInstantiator.h"
+#include "../Intellum/Engine/Scenes/StressSceneGenerator.h"
+#include "../Intellum/Engine/Threading/WorkerPool.h"
+#include "../Intellum/Loaders/JSONLoader.h"
+#include "../Intellum/Loaders/TargaLoader.h"
+#include "../Intellum/Common/Constants.h"
+#include "../Intellum/ErrorHandling/Exception.h"
+
+using namespace std;
+
+struct BenchmarkSettings
+{
+	StressSceneDescription Scene;
+	int Frames;
+	float Delta;
+	int Threads;
+	int KernelMatrices;
+	int QueueDraws;
+	float ReducedRateDistance;
+	int ReducedRateInterval;
+	bool Render;
+	bool Rasterize;
+	bool Check;
+	char* FramePath;
+	char* ReferencePath;
+	char* CompileScenePath;
+	char* ScenePath;
+	const char* SceneOutputPath;
+
+	BenchmarkSettings() : Scene(StressSceneDescription()), Frames(600), Delta(1.0f / 60.0f), Threads(WorkerPool::GetDefaultWorkerCount()), KernelMatrices(0), QueueDraws(0),
+		ReducedRateDistance(SIMULATION_REDUCED_RATE_DISTANCE), ReducedRateInterval(SIMULATION_REDUCED_RATE_INTERVAL), Render(false), Rasterize(false), Check(false), FramePath(nullptr),
+		ReferencePath(nullptr), CompileScenePath(nullptr), ScenePath(nullptr), SceneOutputPath(COMPILED_SCENE_PATH) {}
+};
+
+const char* SystemName(SystemType systemType)
+{
+	switch (systemType)
+	{
+	case TRANSFORM_SYSTEM:
+		return "Transform";
+	case RENDER_SYSTEM:
+		return "Render";
+	case UI_RENDER_SYSTEM:
+		return "UI Render";
+	case FONT_SYSTEM:
+		return "Font";
+	case BUTTON_SYSTEM:
+		return "Button";
+	case INPUT_SYSTEM:
+		return "Input";
+	default:
+		return "Unknown";
+	}
+}
+
+bool ParseArguments(int argc, char* argv[], BenchmarkSettings& settings)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (i + 1 >= argc)
+			return false;
+
+		const char* name = argv[i];
+		const char* value = argv[++i];
+
+		if (strcmp(name, "--cubes") == 0)
+			settings.Scene.CubeCount = atoi(value);
+		else if (strcmp(name, "--spheres") == 0)
+			settings.Scene.SphereCount = atoi(value);
+		else if (strcmp(name, "--turrets") == 0)
+			settings.Scene.TurretsPerCube = atoi(value);
+		else if (strcmp(name, "--statics") == 0)
+			settings.Scene.StaticCount = atoi(value);
+		else if (strcmp(name, "--texts") == 0)
+			settings.Scene.TextLabelCount = atoi(value);
+		else if (strcmp(name, "--buttons") == 0)
+			settings.Scene.ButtonCount = atoi(value);
+		else if (strcmp(name, "--seed") == 0)
+			settings.Scene.Seed = static_cast<unsigned int>(strtoul(value, nullptr, 10));
+		else if (strcmp(name, "--frames") == 0)
+			settings.Frames = atoi(value);
+		else if (strcmp(name, "--delta") == 0)
+			settings.Delta = static_cast<float>(atof(value));
+		else if (strcmp(name, "--threads") == 0)
+			settings.Threads = atoi(value);
+		else if (strcmp(name, "--kernel") == 0)
+			settings.KernelMatrices = atoi(value);
+		else if (strcmp(name, "--queue") == 0)
+			settings.QueueDraws = atoi(value);
+		else if (strcmp(name, "--lod-distance") == 0)
+			settings.ReducedRateDistance = static_cast<float>(atof(value));
+		else if (strcmp(name, "--lod-interval") == 0)
+			settings.ReducedRateInterval = atoi(value);
+		else if (strcmp(name, "--render") == 0)
+			settings.Render = atoi(value) != 0;
+		else if (strcmp(name, "--rasterize") == 0)
+			settings.Rasterize = atoi(value) != 0;
+		else if (strcmp(name, "--check") == 0)
+			settings.Check = atoi(value) != 0;
+		else if (strcmp(name, "--frame") == 0)
+			settings.FramePath = argv[i];
+		else if (strcmp(name, "--reference") == 0)
+			settings.ReferencePath = argv[i];
+		else if (strcmp(name, "--scene") == 0)
+			settings.ScenePath = argv[i];
+		else if (strcmp(name, "--compile-scene") == 0)
+			settings.CompileScenePath = argv[i];
+		else if (strcmp(name, "--scene-output") == 0)
+			settings.SceneOutputPath = argv[i];
+		else
+			return false;
+	}
+
+	if ((settings.FramePath || settings.ReferencePath) && settings.Rasterize == false)
+		return false;
+
+	if (settings.Rasterize)
+		settings.Render = true;
+
+	return settings.Frames > 0;
+}
+
+// Composes the same random transforms through the batched kernel and through the XMMatrix path TransformSystem
+// used before it, then reports the time per matrix of each and the largest difference between them. Rotation
+// terms are compared relative to the scale of their row so large scales do not hide small angle errors.
+int CompareTransformKernels(int count, unsigned int seed)
+{
+	const float tolerance = 1e-5f;
+	const int repeats = 20;
+
+	mt19937 random(seed);
+	uniform_real_distribution<float> positions(-500.0f, 500.0f);
+	uniform_real_distribution<float> rotations(-2.0f * XM_2PI, 2.0f * XM_2PI);
+	uniform_real_distribution<float> scales(0.01f, 1000.0f);
+
+	vector<vector<float>> inputs(BATCH_INPUT_COUNT, vector<float>(count));
+	vector<vector<float>> outputs(TransformBatchOutputCount, vector<float>(count));
+	vector<XMMATRIX> references(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		inputs[BATCH_POSITION_X][i] = positions(random);
+		inputs[BATCH_POSITION_Y][i] = positions(random);
+		inputs[BATCH_POSITION_Z][i] = positions(random);
+		inputs[BATCH_ROTATION_X][i] = rotations(random);
+		inputs[BATCH_ROTATION_Y][i] = rotations(random);
+		inputs[BATCH_ROTATION_Z][i] = rotations(random);
+		inputs[BATCH_SCALE_X][i] = scales(random);
+		inputs[BATCH_SCALE_Y][i] = scales(random);
+		inputs[BATCH_SCALE_Z][i] = scales(random);
+	}
+
+	const float* inputColumns[BATCH_INPUT_COUNT];
+	for (int input = 0; input < BATCH_INPUT_COUNT; input++)
+		inputColumns[input] = inputs[input].data();
+
+	float* outputColumns[TransformBatchOutputCount];
+	for (int output = 0; output < TransformBatchOutputCount; output++)
+		outputColumns[output] = outputs[output].data();
+
+	chrono::steady_clock::time_point referenceStart = chrono::steady_clock::now();
+	for (int repeat = 0; repeat < repeats; repeat++)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			XMMATRIX transformation = XMMatrixScaling(inputs[BATCH_SCALE_X][i], inputs[BATCH_SCALE_Y][i], inputs[BATCH_SCALE_Z][i]);
+			transformation *= XMMatrixRotationRollPitchYaw(inputs[BATCH_ROTATION_X][i], inputs[BATCH_ROTATION_Y][i], inputs[BATCH_ROTATION_Z][i]);
+			transformation *= XMMatrixTranslation(inputs[BATCH_POSITION_X][i], inputs[BATCH_POSITION_Y][i], inputs[BATCH_POSITION_Z][i]);
+			references[i] = transformation;
+		}
+	}
+	double referenceNanoseconds = chrono::duration<double, nano>(chrono::steady_clock::now() - referenceStart).count() / (static_cast<double>(repeats) * count);
+
+	chrono::steady_clock::time_point kernelStart = chrono::steady_clock::now();
+	for (int repeat = 0; repeat < repeats; repeat++)
+		TransformBatch::ComposeMatrices(inputColumns, outputColumns, count);
+	double kernelNanoseconds = chrono::duration<double, nano>(chrono::steady_clock::now() - kernelStart).count() / (static_cast<double>(repeats) * count);
+
+	float largestError = 0.0f;
+	for (int i = 0; i < count; i++)
+	{
+		XMFLOAT4X4 reference;
+		XMFLOAT4X4 batched;
+		XMStoreFloat4x4(&reference, references[i]);
+		XMStoreFloat4x4(&batched, TransformBatch::ToMatrix(outputColumns, i));
+
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				float magnitude = row < 3 ? inputs[BATCH_SCALE_X + row][i] : fabsf(reference.m[row][column]);
+				float error = fabsf(reference.m[row][column] - batched.m[row][column]) / (magnitude > 1.0f ? magnitude : 1.0f);
+				if (error > largestError)
+					largestError = error;
+			}
+		}
+	}
+
+	printf("Matrices: %d  Lanes: %d\n", count, TransformBatch::GetLaneCount());
+	printf("%-10s %10.2f ns/matrix\n", "XMMatrix", referenceNanoseconds);
+	printf("%-10s %10.2f ns/matrix\n", "Batched", kernelNanoseconds);
+	printf("%-10s %10.3g (tolerance %.0e)\n", "Max error", largestError, tolerance);
+
+	return largestError <= tolerance ? 0 : 1;
+}
+
+// Queues draws spread over a handful of shaders, cull modes, texture sets and meshes in a random order, submits
+// them to a recording device and reports how many state changes and draw calls the sorted submission made
+// against one per piece of state per draw when drawing in the order the draws were queued. The same draws are
+// then submitted again with the command lists recorded on a worker pool, which has to make exactly the same
+// calls, and the time each submission took is reported.
+int CompareRenderQueue(int count, unsigned int seed, int threads)
+{
+	const int meshCount = 16;
+	const int textureCount = 32;
+	const int repeats = 10;
+	const ShaderType shaders[] = { SHADER_DEFAULT, SHADER_UI, SHADER_FONT };
+	const D3D11_CULL_MODE cullModes[] = { D3D11_CULL_BACK, D3D11_CULL_NONE };
+
+	mt19937 random(seed);
+	uniform_int_distribution<int> meshes(1, meshCount);
+	uniform_int_distribution<int> textures(1, textureCount);
+	uniform_int_distribution<int> shaderTypes(0, 2);
+	uniform_int_distribution<int> cullModeTypes(0, 1);
+	uniform_real_distribution<float> depths(SCREEN_NEAR, SCREEN_DEPTH);
+	uniform_real_distribution<float> colors(0.0f, 1.0f);
+
+	vector<DrawItem> items(count);
+	for (DrawItem& item : items)
+	{
+		item.Shader = shaders[shaderTypes(random)];
+		item.Pass = item.Shader == SHADER_DEFAULT ? RENDER_PASS_OPAQUE : item.Shader == SHADER_UI ? RENDER_PASS_UI : RENDER_PASS_TEXT;
+		item.CullMode = cullModes[cullModeTypes(random)];
+		item.DepthEnabled = item.Pass != RENDER_PASS_TEXT;
+		item.Mesh.VertexBuffer = reinterpret_cast<ID3D11Buffer*>(static_cast<uintptr_t>(meshes(random) * 16));
+		item.Mesh.IndexCount = 36;
+		item.Resources.MatrixParameters.WorldMatrix = XMMatrixTranslation(depths(random), depths(random), depths(random));
+		item.Resources.ColorParameters = ColorShaderParameters(XMFLOAT4(colors(random), colors(random), colors(random), 1.0f));
+		item.Resources.TextureParameters.AddTexture(reinterpret_cast<ID3D11ShaderResourceView*>(static_cast<uintptr_t>(textures(random) * 16)));
+		item.Key = RenderQueue::BuildKey(item.Pass, item.Shader, item.CullMode, item.Resources.TextureParameters, item.Mesh, depths(random));
+	}
+
+	WorkerPool workerPool(threads);
+	RenderQueue renderQueue;
+	RenderQueue parallelQueue(&workerPool);
+	RecordingRenderDevice recordingDevice(true, Box(1280, 720));
+	RecordingRenderDevice parallelDevice(true, Box(1280, 720));
+
+	double milliseconds = 0.0;
+	double parallelMilliseconds = 0.0;
+
+	for (int repeat = 0; repeat < repeats; repeat++)
+	{
+		renderQueue.Clear();
+		parallelQueue.Clear();
+		recordingDevice.Clear();
+		parallelDevice.Clear();
+
+		chrono::steady_clock::time_point queueStart = chrono::steady_clock::now();
+		for (const DrawItem& item : items)
+			renderQueue.Add(item);
+
+		renderQueue.Submit(&recordingDevice);
+		milliseconds += chrono::duration<double, milli>(chrono::steady_clock::now() - queueStart).count();
+
+		chrono::steady_clock::time_point parallelStart = chrono::steady_clock::now();
+		for (const DrawItem& item : items)
+			parallelQueue.Add(item);
+
+		parallelQueue.Submit(&parallelDevice);
+		parallelMilliseconds += chrono::duration<double, milli>(chrono::steady_clock::now() - parallelStart).count();
+	}
+
+	workerPool.Shutdown();
+
+	const RenderQueueStatistics& statistics = renderQueue.GetStatistics();
+	printf("Draws: %d  Draw calls: %d  Instanced: %d (%d instances)  Recorded: %d\n", count, statistics.Draws, statistics.InstancedDraws, statistics.Instances, recordingDevice.GetInstanceCount());
+	printf("%-10s %10d binds %10d avoided (%d states)\n", "Pipeline", statistics.PipelineBinds, statistics.PipelineBindsAvoided, recordingDevice.GetPipelineStateCount());
+	printf("%-10s %10d binds %10d avoided\n", "Texture", statistics.TextureBinds, statistics.TextureBindsAvoided);
+	printf("%-10s %10d binds %10d avoided\n", "Mesh", statistics.MeshBinds, statistics.MeshBindsAvoided);
+	printf("%-10s %10d binds (unsorted %d)\n", "Total", statistics.GetBinds(), count * 3);
+	int untieredBytes = 0;
+	for (ConstantFrequency frequency : { CONSTANTS_PER_FRAME, CONSTANTS_PER_MATERIAL, CONSTANTS_PER_OBJECT })
+		untieredBytes += count * recordingDevice.GetConstantSize(SHADER_DEFAULT, frequency);
+
+	printf("%-10s %10d frame %10d material %10d object uploads\n", "Constants", statistics.FrameUploads, statistics.MaterialUploads, statistics.ObjectUploads);
+	printf("%-10s %10d bytes (every block per draw %d)\n", "Uploaded", statistics.ConstantBytes, untieredBytes);
+	printf("%-10s %10.4f ms\n", "Queue", milliseconds / repeats);
+
+	const vector<RenderCommand>& commands = recordingDevice.GetCommands();
+	const vector<RenderCommand>& parallelCommands = parallelDevice.GetCommands();
+	bool sameCommands = commands.size() == parallelCommands.size();
+	for (size_t i = 0; sameCommands && i < commands.size(); i++)
+		sameCommands = commands[i].Type == parallelCommands[i].Type && commands[i].Value == parallelCommands[i].Value && commands[i].Instances == parallelCommands[i].Instances;
+
+	printf("%-10s %10.4f ms (%d lists on %d workers, %s commands)\n", "Parallel", parallelMilliseconds / repeats, parallelQueue.GetStatistics().CommandLists, threads,
+		sameCommands ? "same" : "different");
+
+	for (const string& error : recordingDevice.GetValidationErrors())
+		printf("Validation error %s\n", error.c_str());
+
+	for (const string& error : parallelDevice.GetValidationErrors())
+		printf("Validation error in parallel submission %s\n", error.c_str());
+
+	int recordedUploads = recordingDevice.GetCount(RENDER_COMMAND_SET_CONSTANTS);
+	int recordedBinds = recordingDevice.GetCount(RENDER_COMMAND_SET_PIPELINE_STATE) + recordingDevice.GetCount(RENDER_COMMAND_SET_TEXTURES) + recordingDevice.GetCount(RENDER_COMMAND_SET_MESH);
+	return recordingDevice.GetInstanceCount() == count && recordingDevice.GetValidationErrors().empty() && recordedBinds == statistics.GetBinds() && recordedUploads == statistics.FrameUploads + statistics.MaterialUploads
+		&& sameCommands && parallelDevice.GetValidationErrors().empty() ? 0 : 1;
+}
+
+// Prints one measured count next to the one a check expects and passes on whether they match
+bool CheckCount(const char* name, int expected, int actual)
+{
+	printf("%-20s %10d (expected %d)%s\n", name, actual, expected, actual == expected ? "" : " FAILED");
+	return actual == expected;
+}
+
+// Mesh and texture handles that only stand in for real ones, spaced out like the recording device spaces its own
+DrawItem BuildCheckItem(RenderPass pass, ShaderType shader, int mesh, int texture, float depth)
+{
+	DrawItem item;
+	item.Pass = pass;
+	item.Shader = shader;
+	item.DepthEnabled = pass == RENDER_PASS_OPAQUE;
+	item.Mesh.VertexBuffer = reinterpret_cast<ID3D11Buffer*>(static_cast<uintptr_t>(mesh * 16));
+	item.Mesh.IndexCount = 36;
+	item.Resources.TextureParameters.AddTexture(reinterpret_cast<ID3D11ShaderResourceView*>(static_cast<uintptr_t>(texture * 16)));
+	item.Key = RenderQueue::BuildKey(item.Pass, item.Shader, item.CullMode, item.Resources.TextureParameters, item.Mesh, depth);
+
+	return item;
+}
+
+// Submits a fixed set of draws to a recording device without instancing and holds the draw and bind counts against
+// the ones worked out for it by hand, so a change to the key layout or to bind avoidance fails the check instead of
+// only moving a number in the --queue output. Eight opaque draws over two meshes and two textures, queued with
+// every neighbour differing, have to come out as two texture runs of two mesh runs each. Five interface draws share
+// a mesh and alternate between two textures; the last one queued sits in front of the others, so it has to be
+// drawn first and the rest in the order they were queued.
+bool CheckRenderQueue()
+{
+	const int opaqueDraws = 8;
+	const int interfaceTextures[] = { 3, 4, 3, 4 };
+	const int frontTexture = 5;
+
+	RenderQueue renderQueue;
+	RecordingRenderDevice recordingDevice(false, Box(1280, 720));
+
+	for (int i = 0; i < opaqueDraws; i++)
+		renderQueue.Add(BuildCheckItem(RENDER_PASS_OPAQUE, SHADER_DEFAULT, 1 + i % 2, 1 + i / 2 % 2, 10.0f + i));
+
+	for (int texture : interfaceTextures)
+		renderQueue.Add(BuildCheckItem(RENDER_PASS_UI, SHADER_UI, 3, texture, 5.0f));
+
+	renderQueue.Add(BuildCheckItem(RENDER_PASS_UI, SHADER_UI, 3, frontTexture, 1.0f));
+	renderQueue.Submit(&recordingDevice);
+
+	const RenderQueueStatistics& statistics = renderQueue.GetStatistics();
+	bool passed = CheckCount("Draws", 13, statistics.Draws);
+	passed = CheckCount("Pipeline binds", 2, statistics.PipelineBinds) && passed;
+	passed = CheckCount("Texture binds", 7, statistics.TextureBinds) && passed;
+	passed = CheckCount("Mesh binds", 5, statistics.MeshBinds) && passed;
+	passed = CheckCount("Binds avoided", 25, statistics.GetBindsAvoided()) && passed;
+	passed = CheckCount("Recorded draws", 13, recordingDevice.GetCount(RENDER_COMMAND_DRAW)) && passed;
+	passed = CheckCount("Recorded binds", statistics.GetBinds(), recordingDevice.GetCount(RENDER_COMMAND_SET_PIPELINE_STATE)
+		+ recordingDevice.GetCount(RENDER_COMMAND_SET_TEXTURES) + recordingDevice.GetCount(RENDER_COMMAND_SET_MESH)) && passed;
+	passed = CheckCount("Pipeline states", 2, recordingDevice.GetPipelineStateCount()) && passed;
+	passed = CheckCount("Invalid", 0, static_cast<int>(recordingDevice.GetValidationErrors().size())) && passed;
+
+	// Every interface draw binds its own texture, so the last texture binds give the order they were drawn in
+	vector<unsigned long long> textureBinds;
+	for (const RenderCommand& command : recordingDevice.GetCommands())
+	{
+		if (command.Type == RENDER_COMMAND_SET_TEXTURES)
+			textureBinds.push_back(command.Value / 16);
+	}
+
+	vector<unsigned long long> interfaceOrder(1, frontTexture);
+	interfaceOrder.insert(interfaceOrder.end(), begin(interfaceTextures), end(interfaceTextures));
+
+	bool ordered = textureBinds.size() >= interfaceOrder.size() && equal(interfaceOrder.begin(), interfaceOrder.end(), textureBinds.end() - interfaceOrder.size());
+	printf("%-20s %10s%s\n", "Interface order", ordered ? "kept" : "changed", ordered ? "" : " FAILED");
+
+	return passed && ordered;
+}
+
+// Queues the spheres of the main scene as twenty five draws of one mesh and texture set in reverse depth order,
+// each with its own position and color, plus a sphere with a gradient and three cubes, and submits them to a
+// recording device that can instance. The spheres have to collapse into one instanced draw with their matrices
+// and colors packed into the instance stream front to back, the gradient sphere has to be drawn on its own as
+// gradients are positioned per object, and the cubes have to make a second instanced draw.
+bool CheckInstancing()
+{
+	const int sphereCount = 25;
+	const int cubeCount = 3;
+
+	RenderQueue renderQueue;
+	RecordingRenderDevice recordingDevice(true, Box(1280, 720));
+
+	for (int i = sphereCount - 1; i >= 0; i--)
+	{
+		DrawItem sphere = BuildCheckItem(RENDER_PASS_OPAQUE, SHADER_DEFAULT, 1, 1, 10.0f + i);
+		sphere.Resources.MatrixParameters.WorldMatrix = XMMatrixTranslation(static_cast<float>(i), 0.0f, 10.0f + i);
+		sphere.Resources.ColorParameters = ColorShaderParameters(XMFLOAT4(static_cast<float>(i) / sphereCount, 0.0f, 0.0f, 1.0f));
+		renderQueue.Add(sphere);
+	}
+
+	DrawItem gradientSphere = BuildCheckItem(RENDER_PASS_OPAQUE, SHADER_DEFAULT, 1, 1, 100.0f);
+	gradientSphere.Resources.GradientParameters = GradientShaderParameters(XMFLOAT4(1.0f, 0.0f, 0.0f, 1.0f), XMFLOAT4(0.0f, 0.0f, 1.0f, 1.0f), 0.0f, 1.0f);
+	renderQueue.Add(gradientSphere);
+
+	for (int i = 0; i < cubeCount; i++)
+		renderQueue.Add(BuildCheckItem(RENDER_PASS_OPAQUE, SHADER_DEFAULT, 2, 1, 10.0f + i));
+
+	renderQueue.Submit(&recordingDevice);
+
+	const RenderQueueStatistics& statistics = renderQueue.GetStatistics();
+	bool passed = CheckCount("Draws", 3, statistics.Draws);
+	passed = CheckCount("Instanced draws", 2, statistics.InstancedDraws) && passed;
+	passed = CheckCount("Instances", sphereCount + cubeCount, statistics.Instances) && passed;
+	passed = CheckCount("Object uploads", 3, statistics.ObjectUploads) && passed;
+	passed = CheckCount("Recorded draws", 1, recordingDevice.GetCount(RENDER_COMMAND_DRAW)) && passed;
+	passed = CheckCount("Recorded instanced", 2, recordingDevice.GetCount(RENDER_COMMAND_DRAW_INSTANCED)) && passed;
+	passed = CheckCount("Recorded instances", sphereCount + cubeCount + 1, recordingDevice.GetInstanceCount()) && passed;
+	passed = CheckCount("Invalid", 0, static_cast<int>(recordingDevice.GetValidationErrors().size())) && passed;
+
+	const DrawBatch* sphereBatch = nullptr;
+	for (const DrawBatch& batch : renderQueue.GetBatches())
+	{
+		if (batch.Count == sphereCount)
+			sphereBatch = &batch;
+	}
+
+	int misplacedInstances = sphereBatch ? 0 : sphereCount;
+	for (int i = 0; sphereBatch && i < sphereCount; i++)
+	{
+		const InstanceData& instance = renderQueue.GetInstances()[sphereBatch->FirstInstance + i];
+		if (instance.World._41 != static_cast<float>(i) || instance.Color.x != static_cast<float>(i) / sphereCount || instance.ColorEnabled != 1.0f)
+			misplacedInstances++;
+	}
+
+	return CheckCount("Misplaced", 0, misplacedInstances) && passed;
+}
+
+// Submits three frames of one instanced run behind an interface draw to a recording device, the middle one with
+// more instances than the instance buffer holds. The buffer has to be replaced exactly once, in the middle frame,
+// and the two pipeline states of the first frame have to outlive it: no state may be created again after the
+// resize, and the handles looked up before it have to stay valid for the draws that follow it.
+bool CheckInstanceBufferGrowth()
+{
+	const int runSizes[] = { 4, INSTANCE_BUFFER_INITIAL_CAPACITY * 2 + 1, 4 };
+	const int expectedCapacity = INSTANCE_BUFFER_INITIAL_CAPACITY * 4;
+
+	RenderQueue renderQueue;
+	RecordingRenderDevice recordingDevice(true, Box(1280, 720));
+
+	bool passed = true;
+
+	for (int frame = 0; frame < 3; frame++)
+	{
+		renderQueue.Clear();
+		recordingDevice.Clear();
+
+		for (int i = 0; i < runSizes[frame]; i++)
+			renderQueue.Add(BuildCheckItem(RENDER_PASS_OPAQUE, SHADER_DEFAULT, 1, 1, 10.0f));
+
+		renderQueue.Add(BuildCheckItem(RENDER_PASS_UI, SHADER_UI, 2, 2, 1.0f));
+		renderQueue.Submit(&recordingDevice);
+
+		int resizes = frame == 1 ? 1 : 0;
+
+		printf("Frame %d\n", frame);
+		passed = CheckCount("Instances", runSizes[frame], renderQueue.GetStatistics().Instances) && passed;
+		passed = CheckCount("Created buffers", frame == 0 ? 1 : resizes, recordingDevice.GetCount(RENDER_COMMAND_CREATE_BUFFER)) && passed;
+		passed = CheckCount("Released buffers", resizes, recordingDevice.GetCount(RENDER_COMMAND_RELEASE_BUFFER)) && passed;
+		passed = CheckCount("Pipeline states", 2, recordingDevice.GetPipelineStateCount()) && passed;
+		passed = CheckCount("Invalid", 0, static_cast<int>(recordingDevice.GetValidationErrors().size())) && passed;
+	}
+
+	passed = CheckCount("Capacity", expectedCapacity, recordingDevice.GetInstanceCapacity()) && passed;
+
+	recordingDevice.Shutdown();
+	return passed;
+}
+
+// Compiles a JSON scene into the binary layout the game loads at startup in place of the scene it builds in code
+int CompileScene(const char* scenePath, const char* outputPath)
+{
+	try
+	{
+		SceneBlobWriter writer;
+		JSONSceneHandler sceneHandler(&writer);
+		JSONLoader().Load(scenePath, &sceneHandler);
+		writer.Save(outputPath);
+
+		printf("Compiled %d entities from %s into %s\n", writer.GetEntityCount(), scenePath, outputPath);
+		return 0;
+	}
+	catch (Exception& exception)
+	{
+		printf("%s\n", exception.PrintFullMessage().c_str());
+		exception.Shutdown();
+		return 1;
+	}
+}
+
+// Loads a JSON scene, or one compiled from it, the way the game does at startup
+void LoadScene(const string& path, SceneContext context, EntityManager* entityManager, vector<IObserver*>& observers)
+{
+	size_t extension = path.find_last_of('.');
+	if (extension != string::npos && path.compare(extension, string::npos, ".json") == 0)
+	{
+		SceneInstantiator sceneInstantiator(entityManager, context, &observers);
+		JSONSceneHandler sceneHandler(&sceneInstantiator);
+		JSONLoader().Load(path, &sceneHandler);
+		sceneInstantiator.Shutdown();
+		return;
+	}
+
+	SceneBlobLoader sceneLoader(entityManager, context);
+	vector<Entity*> entities;
+	sceneLoader.Load(path, entities, observers);
+	sceneLoader.Shutdown();
+}
+
+// Builds a stress scene, or loads the one given with --scene, without a window or device and runs the update phase
+// for a fixed number of frames at a fixed delta, so runs with the same arguments are directly comparable. With
+// --render the render phase runs as well, through the real render systems into a recording device; the scene then
+// loads its models and fonts from Content, so it has to be run from the Intellum folder. With --rasterize the frames are drawn by the software
+// device instead, and the last one can be written out with --frame or held against a saved one with --reference.
+int main(int argc, char* argv[])
+{
+	BenchmarkSettings settings;
+	if (ParseArguments(argc, argv, settings) == false)
+	{
+		printf("usage: Intellum.Benchmark [--cubes N] [--spheres N] [--turrets N] [--statics N] [--texts N] [--buttons N] [--seed N] [--frames N] [--delta SECONDS] [--threads N] [--kernel MATRICES] [--queue DRAWS] [--lod-distance UNITS] [--lod-interval STEPS] [--render 0|1] [--rasterize 0|1] [--check 0|1] [--frame PATH] [--reference PATH] [--scene PATH] [--compile-scene JSON] [--scene-output PATH]\n");
+		return 1;
+	}
+
+	if (settings.CompileScenePath)
+		return CompileScene(settings.CompileScenePath, settings.SceneOutputPath);
+
+	if (settings.KernelMatrices > 0)
+		return CompareTransformKernels(settings.KernelMatrices, settings.Scene.Seed);
+
+	if (settings.QueueDraws > 0)
+		return CompareRenderQueue(settings.QueueDraws, settings.Scene.Seed, settings.Threads);
+
+	if (settings.Check)
+	{
+		bool passed = CheckRenderQueue();
+		passed = CheckInstancing() && passed;
+		passed = CheckInstanceBufferGrowth() && passed;
+		return passed ? 0 : 1;
+	}
+
+	EntityManager* entityManager = new EntityManager();
+	HeadlessInput* input = new HeadlessInput();
+	WorkerPool* workerPool = new WorkerPool(settings.Threads);
+	SystemScheduler* systemScheduler = new SystemScheduler(workerPool);
+
+	map<SystemType, ISystem*> systemList;
+	// The focus stands in for the camera, which sits at the origin of the stress scene
+	TransformSystem* transformSystem = new TransformSystem();
+	transformSystem->SetFocus(XMFLOAT3(0.0f, 0.0f, 0.0f));
+	transformSystem->SetReducedRate(settings.ReducedRateDistance, settings.ReducedRateInterval);
+
+	systemList[TRANSFORM_SYSTEM] = transformSystem;
+	systemList[BUTTON_SYSTEM] = new ButtonSystem(input);
+	systemList[INPUT_SYSTEM] = new InputSystem(input);
+
+	Box screenSize = Box(1280, 720);
+	IRenderDevice* renderDevice = nullptr;
+	RecordingRenderDevice* recordingDevice = nullptr;
+	SoftwareRenderDevice* softwareDevice = nullptr;
+	GeometryBuilder* geometryBuilder = nullptr;
+	GeometryCache* geometryCache = nullptr;
+	TextureCache* textureCache = nullptr;
+	RenderQueue* renderQueue = nullptr;
+	FontEngine* fontEngine = nullptr;
+	Camera* camera = nullptr;
+	Light* light = nullptr;
+
+	if (settings.Render)
+	{
+		if (settings.Rasterize)
+			renderDevice = softwareDevice = new SoftwareRenderDevice(screenSize, workerPool);
+		else
+			renderDevice = recordingDevice = new RecordingRenderDevice(true, screenSize);
+
+		geometryBuilder = new GeometryBuilder(renderDevice);
+		geometryCache = new GeometryCache(geometryBuilder);
+		textureCache = new TextureCache(renderDevice);
+		renderQueue = new RenderQueue(workerPool);
+		fontEngine = new FontEngine(renderDevice);
+		camera = new Camera(new Frustrum(renderDevice), new Transform(renderDevice), input);
+
+		// Placed where Graphics places it, but held still so every run lights the scene the same way
+		if (softwareDevice)
+		{
+			Transform* lightTransform = new Transform(renderDevice);
+			lightTransform->SetPosition(XMFLOAT3(1000.0f, 600.0f, 40.0f));
+
+			light = new Light;
+			light->Transform = lightTransform;
+			light->SpecularPower = 10.0f;
+
+			softwareDevice->Initialise(camera, light);
+		}
+
+		systemList[RENDER_SYSTEM] = new RenderSystem(renderDevice, renderQueue, camera);
+		systemList[UI_RENDER_SYSTEM] = new UISystem(renderDevice, screenSize);
+		systemList[FONT_SYSTEM] = new TextSystem(renderDevice, renderQueue, fontEngine, screenSize);
+	}
+
+	int exitCode = 0;
+	vector<IObserver*> sceneObservers;
+
+	try
+	{
+		if (fontEngine && fontEngine->SearchForAvaliableFonts(screenSize) == false)
+			throw Exception("Could not find any fonts to render text with");
+
+		if (settings.ScenePath)
+		{
+			SceneContext sceneContext;
+			sceneContext.RenderDevice = renderDevice;
+			sceneContext.Models = geometryCache;
+			sceneContext.Textures = textureCache;
+			LoadScene(settings.ScenePath, sceneContext, entityManager, sceneObservers);
+		}
+		else
+		{
+			StressSceneGenerator sceneGenerator(entityManager, geometryBuilder);
+			sceneGenerator.Generate(settings.Scene);
+		}
+
+		int entityCount = static_cast<int>(entityManager->GetEntities().size());
+		printf("Entities: %d  Frames: %d  Delta: %.4fs  Workers: %d\n", entityCount, settings.Frames, settings.Delta, workerPool->GetWorkerCount());
+
+		map<SystemType, double> systemMilliseconds;
+		double totalMilliseconds = 0.0;
+		long long integratedTransforms = 0;
+		double renderMilliseconds = 0.0;
+		long long drawCalls = 0;
+		long long binds = 0;
+		long long commands = 0;
+		long long triangles = 0;
+		long long commandLists = 0;
+		int validationErrors = 0;
+
+		for (int frame = 0; frame < settings.Frames; frame++)
+		{
+			chrono::steady_clock::time_point frameStart = chrono::steady_clock::now();
+
+			systemScheduler->Update(systemList, entityManager, settings.Delta, EVERY_FRAME);
+			entityManager->PlaybackCommands();
+			systemScheduler->Update(systemList, entityManager, settings.Delta, EVERY_STEP);
+			entityManager->PlaybackCommands();
+			integratedTransforms += transformSystem->GetIntegratedCount();
+
+			totalMilliseconds += chrono::duration<double, milli>(chrono::steady_clock::now() - frameStart).count();
+
+			for (auto& updateTime : systemScheduler->GetUpdateTimes())
+				systemMilliseconds[updateTime.first] += updateTime.second;
+
+			if (renderDevice == nullptr)
+				continue;
+
+			chrono::steady_clock::time_point renderStart = chrono::steady_clock::now();
+
+			camera->Update(settings.Delta);
+			renderQueue->Clear();
+
+			renderDevice->BeginFrame(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+			for (auto& system : systemList)
+				system.second->Render(entityManager);
+
+			renderQueue->Submit(renderDevice);
+			renderDevice->EndFrame();
+
+			renderMilliseconds += chrono::duration<double, milli>(chrono::steady_clock::now() - renderStart).count();
+			drawCalls += renderQueue->GetStatistics().Draws;
+			binds += renderQueue->GetStatistics().GetBinds();
+			commandLists += renderQueue->GetStatistics().CommandLists;
+
+			if (softwareDevice)
+			{
+				triangles += softwareDevice->GetTriangleCount();
+				continue;
+			}
+
+			commands += recordingDevice->GetCommands().size();
+
+			for (const string& error : recordingDevice->GetValidationErrors())
+			{
+				if (validationErrors++ == 0)
+					printf("Validation error in frame %d %s\n", frame, error.c_str());
+			}
+
+			recordingDevice->Clear();
+		}
+
+		for (auto& systemTime : systemMilliseconds)
+			printf("%-10s %10.4f ms/frame\n", SystemName(systemTime.first), systemTime.second / settings.Frames);
+
+		printf("%-10s %10.1f transforms/frame\n", "Integrated", static_cast<double>(integratedTransforms) / settings.Frames);
+
+		double millisecondsPerFrame = totalMilliseconds / settings.Frames;
+		printf("%-10s %10.4f ms/frame\n", "Total", millisecondsPerFrame);
+		printf("%-10s %10.0f entities/sec\n", "Throughput", millisecondsPerFrame > 0.0 ? entityCount * 1000.0 / millisecondsPerFrame : 0.0);
+
+		if (renderQueue)
+			printf("%-10s %10.1f lists/frame\n", "Lists", static_cast<double>(commandLists) / settings.Frames);
+
+		if (softwareDevice)
+		{
+			const int tolerance = 1;
+
+			printf("%-10s %10.4f ms/frame\n", "Raster", renderMilliseconds / settings.Frames);
+			printf("%-10s %10.1f draws/frame %10.1f binds/frame %10.1f triangles/frame\n", "Drawn", static_cast<double>(drawCalls) / settings.Frames,
+				static_cast<double>(binds) / settings.Frames, static_cast<double>(triangles) / settings.Frames);
+
+			if (settings.FramePath)
+				softwareDevice->WriteFrame(settings.FramePath);
+
+			if (settings.ReferencePath)
+			{
+				TargaData reference = TargaLoader::LoadTarga(settings.ReferencePath);
+				int differences = softwareDevice->CompareFrame(reference, tolerance);
+				delete[] reference.ImageData;
+				reference.ImageData = nullptr;
+
+				printf("%-10s %10d pixels differ from %s\n", "Reference", differences, settings.ReferencePath);
+				if (differences > 0)
+					exitCode = 1;
+			}
+		}
+
+		if (recordingDevice)
+		{
+			printf("%-10s %10.4f ms/frame\n", "Submit", renderMilliseconds / settings.Frames);
+			printf("%-10s %10.1f draws/frame %10.1f binds/frame %10.1f commands/frame\n", "Recorded", static_cast<double>(drawCalls) / settings.Frames,
+				static_cast<double>(binds) / settings.Frames, static_cast<double>(commands) / settings.Frames);
+			printf("%-10s %10d buffers %10d textures %10d pipeline states\n", "Resident", recordingDevice->GetBufferCount(), recordingDevice->GetTextureCount(), recordingDevice->GetPipelineStateCount());
+
+			if (validationErrors > 0)
+			{
+				printf("%-10s %10d\n", "Invalid", validationErrors);
+				exitCode = 1;
+			}
+		}
+	}
+	catch (Exception& exception)
+	{
+		string exceptionMessage = exception.PrintFullMessage();
+		exceptionMessage.append("\n\nStack Trace:\n").append(exception.PrintStackTrace());
+
+		printf("%s\n", exceptionMessage.c_str());
+		exception.Shutdown();
+		exitCode = 1;
+	}
+
+	if (systemScheduler)
+	{
+		systemScheduler->Shutdown();
+		delete systemScheduler;
+		systemScheduler = nullptr;
+	}
+
+	if (workerPool)
+	{
+		workerPool->Shutdown();
+		delete workerPool;
+		workerPool = nullptr;
+	}
+
+	for (IObserver* observer : sceneObservers)
+		delete observer;
+
+	if (entityManager)
+	{
+		entityManager->Shutdown();
+		delete entityManager;
+		entityManager = nullptr;
+	}
+
+	if (geometryCache)
+	{
+		geometryCache->Shutdown();
+		delete geometryCache;
+		geometryCache = nullptr;
+	}
+
+	if (textureCache)
+	{
+		textureCache->Shutdown();
+		delete textureCache;
+		textureCache = nullptr;
+	}
+
+	for (auto& system : systemList)
+	{
+		system.second->Shutdown();
+		delete system.second;
+	}
+	systemList.clear();
+
+	if (camera)
+	{
+		camera->Shutdown();
+		delete camera;
+		camera = nullptr;
+	}
+
+	if (light)
+	{
+		light->Shutdown();
+		delete light;
+		light = nullptr;
+	}
+
+	delete fontEngine;
+	delete geometryBuilder;
+	delete renderQueue;
+
+	if (renderDevice)
+	{
+		renderDevice->Shutdown();
+		delete renderDevice;
+		renderDevice = nullptr;
+	}
+
+	delete input;
+
+	return exitCode;
+}
\ No newline at end of file
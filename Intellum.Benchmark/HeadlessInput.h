@@ -0,0 +1,12 @@
+#pragma once
+#include "../Intellum/Engine/Input/IInputState.h"
+
+// Stands in for the window's Input when there is no window: no control is ever pressed.
+class HeadlessInput : public IInputState
+{
+public:
+	HeadlessInput() {}
+	~HeadlessInput() override {}
+
+	bool IsControlPressed(Controls control) override { return false; }
+};
\ No newline at end of file
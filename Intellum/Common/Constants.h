@@ -3,4 +3,19 @@
 static const bool FULL_SCREEN = false;
 static const bool VSYNC_ENABLED = true;
 static const float SCREEN_DEPTH = 1000.0f;
-static const float SCREEN_NEAR = 0.1f;
\ No newline at end of file
+static const float SCREEN_NEAR = 0.1f;
+static const float SIMULATION_TIMESTEP = 1.0f / 60.0f;
+static const int MAXIMUM_SIMULATION_STEPS = 5;
+static const float SIMULATION_SLEEP_DELAY = 0.5f;
+static const float SIMULATION_REDUCED_RATE_DISTANCE = 200.0f;
+static const int SIMULATION_REDUCED_RATE_INTERVAL = 4;
+static const int ASSET_LOADER_WORKER_COUNT = 2;
+static const bool HOT_RELOAD_ENABLED = true;
+static const float HOT_RELOAD_SETTLE_TIME = 0.25f;
+static const int INSTANCING_MIN_BATCH_SIZE = 2;
+static const int INSTANCE_BUFFER_INITIAL_CAPACITY = 1024;
+static const int MAX_SHADER_TEXTURES = 10;
+static const int SOFTWARE_TILE_SIZE = 64;
+static const int COMMAND_LIST_MIN_BATCHES = 128;
+static const char* const SCENE_PATH = "Content/Scenes/Main.json";
+static const char* const COMPILED_SCENE_PATH = "Content/Scenes/Main.scene";
\ No newline at end of file
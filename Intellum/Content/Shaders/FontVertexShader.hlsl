@@ -1,12 +1,14 @@
+// Written for every object
 cbuffer MatrixBuffer : register(b0)
 {
 	matrix worldMatrix;
-	matrix viewMatrix;
-	matrix projectionMatrix;
 };
 
+// Written once per frame for each view the frame is drawn from
 cbuffer CameraBuffer : register(b1)
 {
+	matrix viewMatrix;
+	matrix projectionMatrix;
 	float3 cameraPosition;
 	float padding;
 };
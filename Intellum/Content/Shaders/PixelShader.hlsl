@@ -48,6 +48,8 @@ struct PixelInputType
     float3 tangent : TANGENT;
     float3 binormal : BINORMAL;
 	float3 viewDirection : TEXCOORD1;
+    float4 instanceColor : INSTANCE_COLOR;
+    float instanceColorEnabled : INSTANCE_COLOR_ENABLED;
 };
 
 float4 CalculateTextureColor(float2 inputTextureCordinates)
@@ -101,7 +103,7 @@ float4 CalculateGradientColor(float4 position)
     return lerp(centerColor, apexColor, normalizedHeight);
 }
 
-float4 CalculateFinalPixelColor(float2 textureCoordinates, float4 worldPosition)
+float4 CalculateFinalPixelColor(float2 textureCoordinates, float4 worldPosition, float4 instanceColor, float instanceColorEnabled)
 {
     bool colorInitialised = false;
     float4 color = float4(0.0f, 0.0f, 0.0f, 1.0f);
@@ -117,12 +119,13 @@ float4 CalculateFinalPixelColor(float2 textureCoordinates, float4 worldPosition)
         colorInitialised = true;
     }
     
-    if (colorOverloadEnabled)
+    if (colorOverloadEnabled || instanceColorEnabled)
     {
+        float4 overloadColor = instanceColorEnabled ? instanceColor : colorOverload;
         if (colorInitialised)
-            color *= colorOverload;
+            color *= overloadColor;
         else
-            color = colorOverload;
+            color = overloadColor;
 
         colorInitialised = true;
     }
@@ -167,7 +170,7 @@ float4 DefaultPixelShader(PixelInputType input) : SV_TARGET
         specular = CalculateSpecularLight(input.normal, input.viewDirection, lightDir, lightIntensity);
     }
 
-    color = CalculateFinalPixelColor(input.tex, input.worldPosition);
+    color = CalculateFinalPixelColor(input.tex, input.worldPosition, input.instanceColor, input.instanceColorEnabled);
 	color = saturate(color + specular);
 
 	return color;
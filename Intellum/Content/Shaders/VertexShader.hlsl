@@ -1,12 +1,14 @@
+// Written for every object
 cbuffer MatrixBuffer : register(b0)
 {
 	matrix worldMatrix;
-	matrix viewMatrix;
-	matrix projectionMatrix;
 };
 
+// Written once per frame for each view the frame is drawn from
 cbuffer CameraBuffer : register(b1)
 {
+	matrix viewMatrix;
+	matrix projectionMatrix;
 	float3 cameraPosition;
 	float padding;
 };
@@ -21,6 +23,16 @@ struct VertexInputType
     float3 binormal : BINORMAL;
 };
 
+struct InstanceInputType
+{
+    float4 world0 : INSTANCE_WORLD0;
+    float4 world1 : INSTANCE_WORLD1;
+    float4 world2 : INSTANCE_WORLD2;
+    float4 world3 : INSTANCE_WORLD3;
+    float4 color : INSTANCE_COLOR;
+    float colorEnabled : INSTANCE_COLOR_ENABLED;
+};
+
 struct VertexOutputType
 {
 	float4 position : SV_POSITION;
@@ -30,9 +42,11 @@ struct VertexOutputType
     float3 tangent : TANGENT;
     float3 binormal : BINORMAL;
     float3 viewDirection : TEXCOORD1;
+    float4 instanceColor : INSTANCE_COLOR;
+    float instanceColorEnabled : INSTANCE_COLOR_ENABLED;
 };
 
-VertexOutputType DefaultVertexShader(VertexInputType input)
+VertexOutputType TransformVertex(VertexInputType input, matrix world)
 {
 	VertexOutputType output;
 
@@ -40,25 +54,43 @@ VertexOutputType DefaultVertexShader(VertexInputType input)
 
     output.worldPosition = input.position;
 
-	output.position = mul(input.position, worldMatrix);
+	output.position = mul(input.position, world);
 	output.position = mul(output.position, viewMatrix);
 	output.position = mul(output.position, projectionMatrix);
 
 	output.tex = input.tex;
 
-	output.normal = mul(input.normal, (float3x3)worldMatrix);
+	output.normal = mul(input.normal, (float3x3)world);
 	output.normal = normalize(output.normal);
 
-	float4 worldPosition = mul(input.position, worldMatrix);
+	float4 worldPosition = mul(input.position, world);
 
 	output.viewDirection = cameraPosition.xyz - worldPosition.xyz;
 	output.viewDirection = normalize(output.viewDirection);
 
-    output.tangent = mul(input.tangent, (float3x3) worldMatrix);
+    output.tangent = mul(input.tangent, (float3x3) world);
     output.tangent = normalize(output.tangent);
 
-    output.binormal = mul(input.binormal, (float3x3) worldMatrix);
+    output.binormal = mul(input.binormal, (float3x3) world);
     output.binormal = normalize(output.binormal);
 
+	return output;
+}
+
+VertexOutputType DefaultVertexShader(VertexInputType input)
+{
+	VertexOutputType output = TransformVertex(input, worldMatrix);
+	output.instanceColor = float4(0.0f, 0.0f, 0.0f, 0.0f);
+	output.instanceColorEnabled = 0.0f;
+
+	return output;
+}
+
+VertexOutputType InstancedVertexShader(VertexInputType input, InstanceInputType instance)
+{
+	VertexOutputType output = TransformVertex(input, float4x4(instance.world0, instance.world1, instance.world2, instance.world3));
+	output.instanceColor = instance.color;
+	output.instanceColorEnabled = instance.colorEnabled;
+
 	return output;
 }
\ No newline at end of file
@@ -1,14 +1,14 @@
 #include "DXSystem.h"
 #include "ErrorHandling/Exception.h"
 
-bool DXSystem::_shutdownQueued = false;
+std::atomic<bool> DXSystem::_shutdownQueued(false);
 
-DXSystem::DXSystem(): _applicationName(nullptr), _hInstance(nullptr), _hwnd(nullptr), _framesPerSecond(nullptr), _cpu(nullptr), _timer(nullptr), _input(nullptr), _graphics(nullptr)
+DXSystem::DXSystem(): _applicationName(nullptr), _hInstance(nullptr), _hwnd(nullptr), _framesPerSecond(nullptr), _cpu(nullptr), _timer(nullptr), _timestep(nullptr), _input(nullptr), _graphics(nullptr)
 {
 	Initialise();
 }
 
-DXSystem::DXSystem(const DXSystem& other): _applicationName(other._applicationName), _hInstance(other._hInstance), _hwnd(other._hwnd), _framesPerSecond(other._framesPerSecond), _cpu(other._cpu), _timer(other._timer), _input(other._input), _graphics(other._graphics)
+DXSystem::DXSystem(const DXSystem& other): _applicationName(other._applicationName), _hInstance(other._hInstance), _hwnd(other._hwnd), _framesPerSecond(other._framesPerSecond), _cpu(other._cpu), _timer(other._timer), _timestep(other._timestep), _input(other._input), _graphics(other._graphics)
 {
 }
 
@@ -26,6 +26,7 @@ void DXSystem::Initialise()
 
 		_framesPerSecond = new FramesPerSecond();
 		_cpu = new Cpu();
+		_timestep = new FixedTimestep(SIMULATION_TIMESTEP, MAXIMUM_SIMULATION_STEPS);
 
 		_input = new Input(_hInstance, _hwnd, screenSize);
 		_graphics = new Graphics(_input, screenSize, _hwnd, _framesPerSecond, _cpu);
@@ -73,6 +74,12 @@ void DXSystem::Shutdown()
 		_cpu = nullptr;
 	}
 
+	if (_timestep)
+	{
+		delete _timestep;
+		_timestep = nullptr;
+	}
+
 	ShutdownWindows();
 }
 
@@ -125,13 +132,19 @@ bool DXSystem::Frame(float delta) const
 	try
 	{
 		_input->Update();
+		_graphics->HandleInput(delta);
 
 		_framesPerSecond->Frame(delta);
 		_cpu->Frame();
-		
-		_graphics->Update(delta);
 
-		_graphics->Render();
+		// The simulation always advances in whole fixed steps and rendering blends between the last two of them
+		int steps = _timestep->Advance(delta);
+		for (int step = 0; step < steps; step++)
+		{
+			_graphics->Update(_timestep->GetTimestep());
+		}
+
+		_graphics->Render(_timestep->GetInterpolation());
 
 		return true;
 	}
@@ -3,8 +3,10 @@
 #define WIN32_LEAN_AND_MEAN
 
 #include <windows.h>
+#include <atomic>
 #include "Engine/Graphics/Graphics.h"
 #include "Engine/GameTimer.h"
+#include "Engine/FixedTimestep.h"
 #include "Engine/SystemMetrics/FramesPerSecond.h"
 #include "Engine/SystemMetrics/Cpu.h"
 #include "engine/Input/Input.h"
@@ -19,10 +21,12 @@ private:
 	FramesPerSecond* _framesPerSecond;
 	Cpu* _cpu;
 	GameTimer* _timer;
+	FixedTimestep* _timestep;
 
 	Input* _input;
 	Graphics* _graphics;
-	static bool _shutdownQueued;
+	// Queued from systems that may run on a worker thread
+	static std::atomic<bool> _shutdownQueued;
 private:
 	void Initialise();
 	void InitialiseWindows(Box& screenSize);
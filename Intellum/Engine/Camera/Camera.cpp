@@ -1,6 +1,7 @@
 #include "Camera.h"
+#include "../FixedTimestep.h"
 
-Camera::Camera(Frustrum* frustrum, Transform* transform, Input* input): _input(input), _frustrum(frustrum), _transform(transform)
+Camera::Camera(Frustrum* frustrum, Transform* transform, IInputState* input): _input(input), _frustrum(frustrum), _transform(transform), _previousPosition(0.0f, 0.0f, 0.0f), _previousRotation(0.0f, 0.0f, 0.0f)
 {
 }
 
@@ -27,6 +28,8 @@ void Camera::Update(float delta)
 {
 	HandleRotationInput();
 
+	_previousPosition = _transform->GetPosition();
+	_previousRotation = _transform->GetRotation();
 	_transform->Update(delta);
 
 	XMFLOAT3 rotation = _transform->GetRotation();
@@ -44,7 +47,26 @@ void Camera::Update(float delta)
 	XMStoreFloat3(&up, upVector);
 	HandleMovementInput(lookAt, up);
 
-	XMVECTOR positionVector = XMLoadFloat3(&_transform->GetPosition());
+	BuildViewMatrix(_transform->GetPosition(), rotation);
+}
+
+// Places the view between the last two simulation steps so camera movement is as smooth as the frame rate
+void Camera::Interpolate(float interpolation)
+{
+	BuildViewMatrix(FixedTimestep::Interpolate(_previousPosition, _transform->GetPosition(), interpolation), FixedTimestep::InterpolateRotation(_previousRotation, _transform->GetRotation(), interpolation));
+}
+
+void Camera::BuildViewMatrix(XMFLOAT3 position, XMFLOAT3 rotation)
+{
+	XMMATRIX rotationMatrix = XMMatrixRotationRollPitchYaw(rotation.x, rotation.y, rotation.z);
+
+	XMFLOAT3 up = XMFLOAT3(0.0f, 1.0f, 0.0f);
+	XMVECTOR upVector = XMVector3TransformCoord(XMLoadFloat3(&up), rotationMatrix);
+
+	XMFLOAT3 lookAt = XMFLOAT3(0.0f, 0.0f, 1.0f);
+	XMVECTOR lookAtVector = XMVector3TransformCoord(XMLoadFloat3(&lookAt), rotationMatrix);
+
+	XMVECTOR positionVector = XMLoadFloat3(&position);
 	lookAtVector = XMVectorAdd(positionVector, lookAtVector);
 
 	_viewMatrix = XMMatrixLookAtLH(positionVector, lookAtVector, upVector);
@@ -5,14 +5,14 @@
 #include "../Objects/Transform/Transform.h"
 #include "Frustrum.h"
 #include "../../Common/Constants.h"
-#include "../Input/Input.h"
+#include "../Input/IInputState.h"
 
 using namespace DirectX;
 
 class Camera
 {
 private:
-	Input* _input;
+	IInputState* _input;
 
 	Frustrum* _frustrum;
 	Transform* _transform;
@@ -20,14 +20,19 @@ private:
 	XMMATRIX _viewMatrix2D;
 	XMMATRIX _viewMatrix;
 
+	XMFLOAT3 _previousPosition;
+	XMFLOAT3 _previousRotation;
+
 	void HandleRotationInput() const;
 	void HandleMovementInput(XMFLOAT3 lookAt, XMFLOAT3 up) const;
+	void BuildViewMatrix(XMFLOAT3 position, XMFLOAT3 rotation);
 public:
-	Camera(Frustrum* frustrum, Transform* transform, Input* input);
+	Camera(Frustrum* frustrum, Transform* transform, IInputState* input);
 	~Camera();
 
 	void Shutdown();
 	void Update(float delta);
+	void Interpolate(float interpolation);
 
 	Frustrum* GetFrustrum() const;
 	Transform* GetTransform() const;
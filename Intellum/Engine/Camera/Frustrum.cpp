@@ -1,10 +1,10 @@
 #include "Frustrum.h"
 
-Frustrum::Frustrum(DirectX3D* direct3D): _direct3D(direct3D)
+Frustrum::Frustrum(IRenderDevice* renderDevice): _renderDevice(renderDevice)
 {
 }
 
-Frustrum::Frustrum(const Frustrum& other) : _direct3D(other._direct3D)
+Frustrum::Frustrum(const Frustrum& other) : _renderDevice(other._renderDevice)
 {
 }
 
@@ -15,7 +15,7 @@ Frustrum::~Frustrum()
 void Frustrum::ConstructFrustrum(XMFLOAT4X4 viewMatrix, float screenDepth)
 {
 	XMFLOAT4X4 projectionMatrix;
-	XMStoreFloat4x4(&projectionMatrix, _direct3D->GetProjectionMatrix());
+	XMStoreFloat4x4(&projectionMatrix, _renderDevice->GetProjectionMatrix());
 
 	CalculateMinimumZDistanceFrom(projectionMatrix, screenDepth);
 
@@ -1,14 +1,14 @@
 #pragma once
 
 #include <DirectXMath.h>
-#include "../DirectX3D.h"
+#include "../Rendering/IRenderDevice.h"
 
 using namespace DirectX;
 
 class Frustrum
 {
 private:
-	DirectX3D* _direct3D;
+	IRenderDevice* _renderDevice;
 	XMFLOAT4 _planes[6];
 
 	static void CalculateMinimumZDistanceFrom(XMFLOAT4X4& projectionMatrix, float screenDepth);
@@ -19,7 +19,7 @@ private:
 	void ConstructFrustrumTopPlane(XMFLOAT4X4 matrix);
 	void ConstructFrustrumBottomPlane(XMFLOAT4X4 matrix);
 public:
-	Frustrum(DirectX3D* direct3D);
+	Frustrum(IRenderDevice* renderDevice);
 	Frustrum(const Frustrum& other);
 	~Frustrum();
 	void ConstructFrustrum(XMFLOAT4X4 viewMatrix, float screenDepth);
@@ -71,6 +71,11 @@ void Rasterizer::ToggleFillMode()
 	}
 }
 
+D3D11_FILL_MODE Rasterizer::GetFillMode() const
+{
+	return _currentFillMode;
+}
+
 void Rasterizer::CreateRasterizerState(D3D11_FILL_MODE fillMode, D3D11_CULL_MODE cullMode)
 {
 	D3D11_RASTERIZER_DESC rasterizerDescription;
@@ -27,4 +27,6 @@ public:
 	void SetRasterizerFillMode(D3D11_FILL_MODE fillMode);
 	void SetRasterizerCullMode(D3D11_CULL_MODE cullMode);
 	void ToggleFillMode();
+
+	D3D11_FILL_MODE GetFillMode() const;
 };
\ No newline at end of file
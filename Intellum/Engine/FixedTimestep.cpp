@@ -0,0 +1,70 @@
+#include "FixedTimestep.h"
+#include <cmath>
+
+namespace
+{
+	// Rotations are kept within 0 to 2 pi, so a step that wraps around has to be blended the short way round
+	float InterpolateAngle(float previous, float current, float interpolation)
+	{
+		float difference = current - previous;
+		if (difference > XM_PI)
+			difference -= XM_2PI;
+		else if (difference < -XM_PI)
+			difference += XM_2PI;
+
+		return previous + difference * interpolation;
+	}
+}
+
+FixedTimestep::FixedTimestep(float timestep, int maximumSteps) : _timestep(timestep), _maximumSteps(maximumSteps), _accumulator(0.0f)
+{
+}
+
+FixedTimestep::~FixedTimestep()
+{
+}
+
+int FixedTimestep::Advance(float delta)
+{
+	if (delta > 0.0f)
+		_accumulator += delta;
+
+	int steps = static_cast<int>(_accumulator / _timestep);
+	if (steps > _maximumSteps)
+	{
+		steps = _maximumSteps;
+		_accumulator = fmodf(_accumulator, _timestep) + static_cast<float>(steps) * _timestep;
+	}
+
+	_accumulator -= static_cast<float>(steps) * _timestep;
+	if (_accumulator < 0.0f)
+		_accumulator = 0.0f;
+
+	return steps;
+}
+
+void FixedTimestep::Reset()
+{
+	_accumulator = 0.0f;
+}
+
+float FixedTimestep::GetTimestep() const
+{
+	return _timestep;
+}
+
+float FixedTimestep::GetInterpolation() const
+{
+	float interpolation = _accumulator / _timestep;
+	return interpolation < 1.0f ? interpolation : 1.0f;
+}
+
+XMFLOAT3 FixedTimestep::Interpolate(const XMFLOAT3& previous, const XMFLOAT3& current, float interpolation)
+{
+	return XMFLOAT3(previous.x + (current.x - previous.x) * interpolation, previous.y + (current.y - previous.y) * interpolation, previous.z + (current.z - previous.z) * interpolation);
+}
+
+XMFLOAT3 FixedTimestep::InterpolateRotation(const XMFLOAT3& previous, const XMFLOAT3& current, float interpolation)
+{
+	return XMFLOAT3(InterpolateAngle(previous.x, current.x, interpolation), InterpolateAngle(previous.y, current.y, interpolation), InterpolateAngle(previous.z, current.z, interpolation));
+}
\ No newline at end of file
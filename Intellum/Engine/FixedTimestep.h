@@ -0,0 +1,28 @@
+#pragma once
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+// Turns variable frame times into a whole number of fixed simulation steps. Time that does not make up a full
+// step is carried over to the next frame and exposed as how far rendering sits between the last two steps.
+// When a frame is too long to catch up within the step limit the excess is dropped rather than owed.
+class FixedTimestep
+{
+private:
+	float _timestep;
+	int _maximumSteps;
+	float _accumulator;
+
+public:
+	FixedTimestep(float timestep, int maximumSteps);
+	~FixedTimestep();
+
+	int Advance(float delta);
+	void Reset();
+
+	float GetTimestep() const;
+	float GetInterpolation() const;
+
+	static XMFLOAT3 Interpolate(const XMFLOAT3& previous, const XMFLOAT3& current, float interpolation);
+	static XMFLOAT3 InterpolateRotation(const XMFLOAT3& previous, const XMFLOAT3& current, float interpolation);
+};
\ No newline at end of file
@@ -1,7 +1,7 @@
 ﻿#include "FontEngine.h"
 #include "FontRetriever.h"
 
-FontEngine::FontEngine(DirectX3D* direct3D, ID3D11Device* device, ID3D11DeviceContext* deviceContext, IShaderType* shader) : _direct3D(direct3D), _device(device), _deviceContext(deviceContext), _shader(shader)
+FontEngine::FontEngine(IRenderDevice* renderDevice) : _renderDevice(renderDevice)
 {
 }
 
@@ -41,7 +41,7 @@ vector<TextTexture> FontEngine::ConvertTextToTextEntity(XMFLOAT2 position, strin
 
 		vector<TextTexture> textTextures = vector<TextTexture>();
 		vector<Texture*> stringAsTexture = StringToCharacterTextureList(font, input);
-		GeometryBuilder geometryBuilder = GeometryBuilder(_direct3D->GetDevice());
+		GeometryBuilder geometryBuilder = GeometryBuilder(_renderDevice);
 
 		for (int i = 0; i < stringAsTexture.size(); i++)
 		{
@@ -177,7 +177,7 @@ Character FontEngine::CreateCharacterFromFontFolder(string filePath, string name
 {
 	try
 	{
-		Texture* texture = CreateTexture::From(_direct3D, &(filePath + "/" + unicode + ".tga")[0u]);
+		Texture* texture = CreateTexture::From(_renderDevice, &(filePath + "/" + unicode + ".tga")[0u]);
 		if (!texture) throw Exception("Failed to create the letter " + name + " for the font located at: " + filePath + ".");
 
 		Character character = Character(name, unicode, texture);
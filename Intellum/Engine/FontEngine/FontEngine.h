@@ -5,9 +5,7 @@
 #include "../../ErrorHandling/Exception.h"
 #include "Font.h"
 #include "Character.h"
-#include "../ShaderEngine/IShaderType.h"
-#include "../ShaderEngine/UIShader.h"
-#include "../DirectX3D.h"
+#include "../Rendering/IRenderDevice.h"
 #include "../Objects/Entity.h"
 #include "../Objects/Components/AppearanceComponent.h"
 #include "../Objects/Components/TransformComponent.h"
@@ -21,12 +19,7 @@ using namespace std;
 class FontEngine
 {
 private:
-	DirectX3D* _direct3D;
-
-	ID3D11Device* _device;
-	ID3D11DeviceContext* _deviceContext;
-
-	IShaderType* _shader;
+	IRenderDevice* _renderDevice;
 
 	vector<Font*> _avaliableFonts;
 private:
@@ -37,7 +30,7 @@ private:
 
 	vector<Texture*> StringToCharacterTextureList(string font, string input);
 public:
-	FontEngine(DirectX3D* direct3D, ID3D11Device* device, ID3D11DeviceContext* deviceContext, IShaderType* shader);
+	FontEngine(IRenderDevice* renderDevice);
 	~FontEngine();
 
 	vector<TextTexture> ConvertTextToTextEntity(XMFLOAT2 position, string font, string input, XMFLOAT4 textColor, int fontSize);
@@ -21,8 +21,11 @@ public:
 
 	~TextTexture() {}
 
-	void Shutdown()
+	void Shutdown(IRenderDevice* renderDevice)
 	{
-		Model.Shutdown();
+		renderDevice->ReleaseBuffer(Model.VertexBuffer);
+		renderDevice->ReleaseBuffer(Model.IndexBuffer);
+		Model.VertexBuffer = nullptr;
+		Model.IndexBuffer = nullptr;
 	}
 };
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "Graphics.h"
 
-Graphics::Graphics(Input* input, Box screenSize, HWND hwnd, FramesPerSecond* framesPerSecond, Cpu* cpu) : _direct3D(nullptr), _fontEngine(nullptr), _shaderController(nullptr), _objectHandler(nullptr), _camera(nullptr), _light(nullptr)
+Graphics::Graphics(Input* input, Box screenSize, HWND hwnd, FramesPerSecond* framesPerSecond, Cpu* cpu) : _direct3D(nullptr), _renderDevice(nullptr), _fontEngine(nullptr), _shaderController(nullptr), _objectHandler(nullptr), _camera(nullptr), _light(nullptr)
 {
 	Initialise(input, framesPerSecond, cpu, screenSize, hwnd);
 }
@@ -15,22 +15,25 @@ void Graphics::Initialise(Input* input, FramesPerSecond* framesPerSecond, Cpu* c
 	{
 		_direct3D = new DirectX3D(input, screenSize, VSYNC_ENABLED, hwnd, FULL_SCREEN, SCREEN_DEPTH, SCREEN_NEAR);
 		if (!_direct3D) throw Exception("Failed to create a DirectX3D object.");
-		
-		Transform* cameraTransform = new Transform(_direct3D);
-		cameraTransform->SetPosition(XMFLOAT3(0.0f, 5.0f, -5.0f));
-		_camera = new Camera(new Frustrum(_direct3D), cameraTransform, input);
-		if (!_camera) throw Exception("Failed to create a camera object.");
 
 		_shaderController = new ShaderController(_direct3D);
 		if (!_shaderController) throw Exception("Failed to create the shader controller.");
 
+		_renderDevice = new D3D11RenderDevice(_direct3D, _shaderController);
+		if (!_renderDevice) throw Exception("Failed to create the render device.");
+		
+		Transform* cameraTransform = new Transform(_renderDevice);
+		cameraTransform->SetPosition(XMFLOAT3(0.0f, 5.0f, -5.0f));
+		_camera = new Camera(new Frustrum(_renderDevice), cameraTransform, input);
+		if (!_camera) throw Exception("Failed to create a camera object.");
+
 		_light = new Light;
 		if (!_light) throw Exception("Failed to create the light object.");
 
 		bool result = _shaderController->Initialise(hwnd, _camera, _light);
 		if (!_shaderController) throw Exception("Failed to create the shader controller.");
 
-		Transform* lightTransformation = new Transform(_direct3D);
+		Transform* lightTransformation = new Transform(_renderDevice);
 		lightTransformation->SetPosition(XMFLOAT3(1000.0f, 600.0f, 40.0f));
 		lightTransformation->SetAngularVelocity(XMFLOAT3(0.0f, 0.0f, 10.0f));
 		_light->Transform = lightTransformation;
@@ -40,10 +43,10 @@ void Graphics::Initialise(Input* input, FramesPerSecond* framesPerSecond, Cpu* c
 		//_light->Direction = XMFLOAT3(0.8f, -1.0f, 0.2f);
 		_light->SpecularPower = 10.0f;
 
-		_fontEngine = new FontEngine(_direct3D, _direct3D->GetDevice(), _direct3D->GetDeviceContext(), _shaderController->GetShader(SHADER_FONT));
+		_fontEngine = new FontEngine(_renderDevice);
 		if (!_fontEngine) throw Exception("Failed to create the Font Engine.");
 		
-		_objectHandler = new ObjectHandler(_direct3D, _shaderController, _fontEngine, hwnd, _camera, input, framesPerSecond, cpu, screenSize);
+		_objectHandler = new ObjectHandler(_renderDevice, _shaderController, _fontEngine, _camera, input, framesPerSecond, cpu, screenSize);
 		if (!_objectHandler) throw Exception("Failed to create the object handler.");
 
 		result = _fontEngine->SearchForAvaliableFonts(screenSize);
@@ -82,6 +85,13 @@ void Graphics::Shutdown()
 		_objectHandler = nullptr;
 	}
 
+	if (_renderDevice)
+	{
+		_renderDevice->Shutdown();
+		delete _renderDevice;
+		_renderDevice = nullptr;
+	}
+
 	if (_camera)
 	{
 		_camera->Shutdown();
@@ -96,6 +106,22 @@ void Graphics::Shutdown()
 	}
 }
 
+void Graphics::HandleInput(float delta) const
+{
+	try
+	{
+		_objectHandler->HandleInput(delta);
+	}
+	catch (Exception& exception) 
+	{
+		throw Exception("Frame failed to handle input.", exception);
+	}
+	catch(...)
+	{
+		throw Exception("An unexpected error occured while handling input");
+	}
+}
+
 void Graphics::Update(float delta) const
 {
 	try
@@ -114,13 +140,15 @@ void Graphics::Update(float delta) const
 	}
 }
 
-void Graphics::Render() const
+void Graphics::Render(float interpolation) const
 {
 	try
 	{
-		_direct3D->BeginScene(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
-		_objectHandler->Render();		 
-		_direct3D->EndScene();
+		_camera->Interpolate(interpolation);
+
+		_renderDevice->BeginFrame(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+		_objectHandler->Render(interpolation);		 
+		_renderDevice->EndFrame();
 	}
 	catch(Exception& exception)
 	{
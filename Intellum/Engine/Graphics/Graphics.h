@@ -10,12 +10,14 @@
 #include "../FontEngine/FontEngine.h"
 #include "../SystemMetrics/Cpu.h"
 #include "../Handlers/ObjectHandler.h"
+#include "../Rendering/D3D11RenderDevice.h"
 #include "../../Common/Constants.h"
 
 class Graphics
 {
 private:
 	DirectX3D* _direct3D;
+	IRenderDevice* _renderDevice;
 
 	FontEngine* _fontEngine;
 
@@ -32,6 +34,7 @@ public:
 	~Graphics();
 
 	void Shutdown();
+	void HandleInput(float delta) const;
 	void Update(float delta) const;
-	void Render() const;
+	void Render(float interpolation) const;
 };
\ No newline at end of file
@@ -7,10 +7,22 @@
 #include "../Objects/Systems/InputSystem.h"
 #include "../Objects/Commands/ToggleTransformCommand.h"
 #include "../Objects/Components/CollisionComponent.h"
-
-ObjectHandler::ObjectHandler(DirectX3D* direct3D, ShaderController* shaderController, FontEngine* fontEngine, HWND hwnd, Camera* camera, Input* input, FramesPerSecond* framesPerSecond, Cpu* cpu, Box screenSize)
+#include "../Scenes/JSONSceneHandler.h"
+#include "../../Loaders/JSONLoader.h"
+#include "../../Common/Constants.h"
+#include "../Objects/Query.h"
+#include <cctype>
+#include <fstream>
+
+ObjectHandler::ObjectHandler(IRenderDevice* renderDevice, ShaderController* shaderController, FontEngine* fontEngine, Camera* camera, Input* input, FramesPerSecond* framesPerSecond, Cpu* cpu, Box screenSize) : _camera(camera), _shaderController(shaderController), _entityManager(new EntityManager()), _workerPool(nullptr), _systemScheduler(nullptr), _geometryBuilder(nullptr), _geometryCache(nullptr), _textureCache(nullptr), _assetLoader(nullptr), _fileWatcher(nullptr), _sceneLoader(nullptr), _sceneInstantiator(nullptr), _renderQueue(nullptr), _renderDevice(renderDevice)
 {
-	InitialiseObjects(direct3D, shaderController, fontEngine, hwnd, camera, input, framesPerSecond, cpu, screenSize);
+	_workerPool = new WorkerPool(WorkerPool::GetDefaultWorkerCount());
+	_systemScheduler = new SystemScheduler(_workerPool);
+
+	InitialiseObjects(fontEngine, camera, input, framesPerSecond, cpu, screenSize);
+
+	if (HOT_RELOAD_ENABLED)
+		_fileWatcher = new FileWatcher({ "Content/Images", "Content/Models", "Content/Shaders" }, HOT_RELOAD_SETTLE_TIME);
 }
 
 ObjectHandler::~ObjectHandler()
@@ -19,13 +31,85 @@ ObjectHandler::~ObjectHandler()
 
 void ObjectHandler::Shutdown()
 {
-	for (unsigned long long i = _entityList.size(); i > 0; i--)
+	if (_fileWatcher)
+	{
+		_fileWatcher->Shutdown();
+		delete _fileWatcher;
+		_fileWatcher = nullptr;
+	}
+
+	if (_systemScheduler)
 	{
-		_entityList.back()->Shutdown();
-		_entityList.pop_back();
+		_systemScheduler->Shutdown();
+		delete _systemScheduler;
+		_systemScheduler = nullptr;
 	}
 
-	_entityList.clear();
+	if (_workerPool)
+	{
+		_workerPool->Shutdown();
+		delete _workerPool;
+		_workerPool = nullptr;
+	}
+
+	for (IObserver* observer : _componentObservers)
+		delete observer;
+
+	_componentObservers.clear();
+
+	if (_entityManager)
+	{
+		_entityManager->Shutdown();
+		delete _entityManager;
+		_entityManager = nullptr;
+	}
+
+	if (_sceneLoader)
+	{
+		_sceneLoader->Shutdown();
+		delete _sceneLoader;
+		_sceneLoader = nullptr;
+	}
+
+	if (_sceneInstantiator)
+	{
+		_sceneInstantiator->Shutdown();
+		delete _sceneInstantiator;
+		_sceneInstantiator = nullptr;
+	}
+
+	if (_assetLoader)
+	{
+		_assetLoader->Shutdown();
+		delete _assetLoader;
+		_assetLoader = nullptr;
+	}
+
+	if (_geometryCache)
+	{
+		_geometryCache->Shutdown();
+		delete _geometryCache;
+		_geometryCache = nullptr;
+	}
+
+	if (_textureCache)
+	{
+		_textureCache->Shutdown();
+		delete _textureCache;
+		_textureCache = nullptr;
+	}
+
+	if (_geometryBuilder)
+	{
+		delete _geometryBuilder;
+		_geometryBuilder = nullptr;
+	}
+
+	if (_renderQueue)
+	{
+		delete _renderQueue;
+		_renderQueue = nullptr;
+	}
 
 	for (map<SystemType, ISystem*>::iterator iterator = _systemList.begin(); iterator != _systemList.end(); ++iterator)
 	{
@@ -37,335 +121,522 @@ void ObjectHandler::Shutdown()
 	_systemList.clear();
 }
 
-void ObjectHandler::InitialiseObjects(DirectX3D* direct3D, ShaderController* shaderController, FontEngine* fontEngine, HWND hwnd, Camera* camera, Input* input, FramesPerSecond* framesPerSecond, Cpu* cpu, Box screenSize)
+void ObjectHandler::InitialiseObjects(FontEngine* fontEngine, Camera* camera, Input* input, FramesPerSecond* framesPerSecond, Cpu* cpu, Box screenSize)
 {
 	srand(static_cast<unsigned int>(time(nullptr)));
 
-	GeometryBuilder geometryBuilder = GeometryBuilder(direct3D->GetDevice());
+	_geometryBuilder = new GeometryBuilder(_renderDevice);
+	_geometryCache = new GeometryCache(_geometryBuilder);
+	_textureCache = new TextureCache(_renderDevice);
+	_assetLoader = new AsyncAssetLoader(_textureCache, _geometryCache, ASSET_LOADER_WORKER_COUNT);
+	_renderQueue = new RenderQueue(_workerPool);
 
 	ButtonSystem* buttonSystem = new ButtonSystem(input);
+	RenderSystem* renderSystem = new RenderSystem(_renderDevice, _renderQueue, camera);
 
-	_systemList[TRANSFORM_SYSTEM] = new TransformSystem(direct3D);
-	_systemList[UI_RENDER_SYSTEM] = new UISystem(direct3D, shaderController, hwnd, screenSize);
-	_systemList[RENDER_SYSTEM] = new RenderSystem(direct3D, shaderController, hwnd, camera);
-	_systemList[FONT_SYSTEM] = new TextSystem(direct3D, shaderController, fontEngine, screenSize);
+	_systemList[TRANSFORM_SYSTEM] = new TransformSystem();
+	_systemList[UI_RENDER_SYSTEM] = new UISystem(_renderDevice, screenSize);
+	_systemList[RENDER_SYSTEM] = renderSystem;
+	_systemList[FONT_SYSTEM] = new TextSystem(_renderDevice, _renderQueue, fontEngine, screenSize);
 	_systemList[BUTTON_SYSTEM] = buttonSystem;
 	_systemList[INPUT_SYSTEM] = new InputSystem(input);
 
+	SceneContext sceneContext;
+	sceneContext.RenderDevice = _renderDevice;
+	sceneContext.Models = _geometryCache;
+	sceneContext.Textures = _textureCache;
+	sceneContext.Observables[SCENE_OBSERVE_INPUT] = input;
+	sceneContext.Observables[SCENE_OBSERVE_FRAMES_PER_SECOND] = framesPerSecond;
+	sceneContext.Observables[SCENE_OBSERVE_CPU] = cpu;
+	sceneContext.Observables[SCENE_OBSERVE_RENDER_COUNT] = renderSystem;
+	sceneContext.Observables[SCENE_OBSERVE_CONSTANT_BYTES] = _renderQueue;
+	_sceneLoader = new SceneBlobLoader(_entityManager, sceneContext);
+	_sceneInstantiator = new SceneInstantiator(_entityManager, sceneContext, &_componentObservers);
+
+	// A compiled scene goes straight into the archetypes and is preferred over its JSON source, without either the
+	// scene is built here
+	if (ifstream(COMPILED_SCENE_PATH).good())
+		LoadScene(COMPILED_SCENE_PATH);
+	else if (ifstream(SCENE_PATH).good())
+		LoadScene(SCENE_PATH);
+	else
+		BuildScene(input, framesPerSecond, cpu, screenSize);
+}
+
+void ObjectHandler::BuildScene(Input* input, FramesPerSecond* framesPerSecond, Cpu* cpu, Box screenSize)
+{
 	for(int i = 0; i < 10; i++)
 	{
-		Entity* entity = new Entity();
-		TransformComponent* transformComponent = new TransformComponent();
-		transformComponent->Position = XMFLOAT3((i * 4) - 5.0f, 1.0f, 10.0f);
-		transformComponent->AngularVelocity = XMFLOAT3(0.0f, 1.5f, 0.0f);
+		Entity* entity = _entityManager->CreateEntity();
+		TransformComponent transformComponent;
+		transformComponent.Position = XMFLOAT3((i * 4) - 5.0f, 1.0f, 10.0f);
+		transformComponent.AngularVelocity = XMFLOAT3(0.0f, 1.5f, 0.0f);
 		entity->AddComponent(transformComponent);
 
-		AppearanceComponent* appearanceComponent = new AppearanceComponent();
-		appearanceComponent->Model = geometryBuilder.Cube();
-		appearanceComponent->Textures = CreateTexture::ListFrom(direct3D, { "Content/Images/stone.tga", "Content/Images/dirt.tga" });
-		appearanceComponent->BumpMap = CreateTexture::From(direct3D, "Content/Images/stone_bump_map.tga");
+		AppearanceComponent appearanceComponent;
+		appearanceComponent.TextureOwner = _textureCache;
+		appearanceComponent.ModelOwner = _geometryCache;
+		appearanceComponent.Model = _geometryCache->Cube();
+		appearanceComponent.BumpMap = _textureCache->From("Content/Images/stone_bump_map.tga");
 		entity->AddComponent(appearanceComponent);
+		StreamTextures(entity->GetHandle(), { "Content/Images/stone.tga", "Content/Images/dirt.tga" });
+
+		entity->AddComponent(InputComponent());
 
-		InputComponent* input = new InputComponent();
+		FrustrumCullingComponent frustrum;
+		frustrum.CullingType = FRUSTRUM_CULL_SQUARE;
+		entity->AddComponent(frustrum);
 
 		ControlCommand control;
 		control.Control = ESCAPE;
-		control.Command = new ToggleTransformCommand(transformComponent);
+		control.Command = new ToggleTransformCommand(_entityManager, entity->GetHandle());
 		control.Cooldown = 0.2f;
-		input->ControlCommands.push_back(control);
-		entity->AddComponent(input);
-
-		FrustrumCullingComponent* frustrum = new FrustrumCullingComponent();
-		frustrum->CullingType = FRUSTRUM_CULL_SQUARE;
-		entity->AddComponent(frustrum);
-
-		_entityList.push_back(entity);
+		entity->GetComponent<InputComponent>()->ControlCommands.push_back(control);
+
+		Entity* turret = _entityManager->CreateEntity();
+		TransformComponent turretTransform;
+		turretTransform.Position = XMFLOAT3(0.0f, 0.6f, 0.5f);
+		turretTransform.Scale = XMFLOAT3(0.2f, 0.2f, 1.0f);
+		turretTransform.SetParent(entity->GetHandle());
+		turret->AddComponent(turretTransform);
+
+		AppearanceComponent turretAppearance;
+		turretAppearance.TextureOwner = _textureCache;
+		turretAppearance.ModelOwner = _geometryCache;
+		turretAppearance.Model = _geometryCache->Cube();
+		turret->AddComponent(turretAppearance);
+		StreamTextures(turret->GetHandle(), { "Content/Images/stone.tga", "Content/Images/dirt.tga" });
+
+		FrustrumCullingComponent turretFrustrum;
+		turretFrustrum.CullingType = FRUSTRUM_CULL_SQUARE;
+		turret->AddComponent(turretFrustrum);
 	}
 
 	for(int i = 0; i < 25; i++)
 	{
-		Entity* entity = new Entity();
-		TransformComponent* transformComponent = new TransformComponent();
-		transformComponent->Position = XMFLOAT3(((static_cast<float>(rand()) / RAND_MAX) * 30.0f) - 15.0f, ((static_cast<float>(rand()) / RAND_MAX) * 5.0f) + 3.0f, ((static_cast<float>(rand()) / RAND_MAX) * 30.0f) - 15.0f);
-		transformComponent->AngularVelocity = XMFLOAT3(0.0f, (static_cast<float>(rand()) / RAND_MAX * 5.0f - 2.5f) * static_cast<float>(XM_PI), 0.0f);
+		Entity* entity = _entityManager->CreateEntity();
+		TransformComponent transformComponent;
+		transformComponent.Position = XMFLOAT3(((static_cast<float>(rand()) / RAND_MAX) * 30.0f) - 15.0f, ((static_cast<float>(rand()) / RAND_MAX) * 5.0f) + 3.0f, ((static_cast<float>(rand()) / RAND_MAX) * 30.0f) - 15.0f);
+		transformComponent.AngularVelocity = XMFLOAT3(0.0f, (static_cast<float>(rand()) / RAND_MAX * 5.0f - 2.5f) * static_cast<float>(XM_PI), 0.0f);
 		entity->AddComponent(transformComponent);
 
-		AppearanceComponent* appearanceComponent = new AppearanceComponent();
-		appearanceComponent->Model = geometryBuilder.FromFile("Content/Models/sphere.obj");
-		appearanceComponent->Textures = CreateTexture::ListFrom(direct3D, { "Content/Images/stone.tga", "Content/Images/dirt.tga" });
-		appearanceComponent->BumpMap = CreateTexture::From(direct3D, "Content/Images/stone_bump_map.tga");
+		AppearanceComponent appearanceComponent;
+		appearanceComponent.TextureOwner = _textureCache;
+		appearanceComponent.ModelOwner = _geometryCache;
+		appearanceComponent.BumpMap = _textureCache->From("Content/Images/stone_bump_map.tga");
 		entity->AddComponent(appearanceComponent);
+		StreamModel(entity->GetHandle(), "Content/Models/sphere.obj");
+		StreamTextures(entity->GetHandle(), { "Content/Images/stone.tga", "Content/Images/dirt.tga" });
 
-		InputComponent* input = new InputComponent();
-		ControlCommand control;
-		control.Control = ESCAPE;
-		control.Command = new ToggleTransformCommand(transformComponent);
-		control.Cooldown = 0.2f;
-		input->ControlCommands.push_back(control);
-		entity->AddComponent(input);
+		entity->AddComponent(InputComponent());
 
-		FrustrumCullingComponent* frustrum = new FrustrumCullingComponent();
-		frustrum->CullingType = FRUSTRUM_CULL_SPHERE;
+		FrustrumCullingComponent frustrum;
+		frustrum.CullingType = FRUSTRUM_CULL_SPHERE;
 		entity->AddComponent(frustrum);
 
-		_entityList.push_back(entity);
+		ControlCommand control;
+		control.Control = ESCAPE;
+		control.Command = new ToggleTransformCommand(_entityManager, entity->GetHandle());
+		control.Cooldown = 0.2f;
+		entity->GetComponent<InputComponent>()->ControlCommands.push_back(control);
 	}
 
-	Entity* entity = new Entity();
-	entity->AddComponent(new TransformComponent());
+	Entity* entity = _entityManager->CreateEntity();
+	TransformComponent gridTransform;
+	gridTransform.Simulation = SIMULATION_STATIC;
+	entity->AddComponent(gridTransform);
 
-	AppearanceComponent* appearanceComponent = new AppearanceComponent();
-	appearanceComponent->Model = geometryBuilder.ForGrid(Box(100, 100), XMFLOAT2(10, 10));
-	appearanceComponent->Textures = CreateTexture::ListFrom(direct3D, { "Content/Images/stone.tga", "Content/Images/dirt.tga" });
+	AppearanceComponent appearanceComponent;
+	appearanceComponent.TextureOwner = _textureCache;
+	appearanceComponent.ModelOwner = _geometryCache;
+	appearanceComponent.Model = _geometryCache->ForGrid(Box(100, 100), XMFLOAT2(10, 10));
 	entity->AddComponent(appearanceComponent);
+	StreamTextures(entity->GetHandle(), { "Content/Images/stone.tga", "Content/Images/dirt.tga" });
 
-	FrustrumCullingComponent* frustrum = new FrustrumCullingComponent();
-	frustrum->CullingType = FRUSTRUM_CULL_RECTANGLE;
+	FrustrumCullingComponent frustrum;
+	frustrum.CullingType = FRUSTRUM_CULL_RECTANGLE;
 	entity->AddComponent(frustrum);
-
-	_entityList.push_back(entity);
 	
-	Entity* skyBox = new Entity();
+	Entity* skyBox = _entityManager->CreateEntity();
 
-	TransformComponent* transform = new TransformComponent();
-	transform->Scale = XMFLOAT3(1000, 1000, 1000);
+	TransformComponent transform;
+	transform.Scale = XMFLOAT3(1000, 1000, 1000);
+	transform.Simulation = SIMULATION_STATIC;
 	skyBox->AddComponent(transform);
 
-	RasterizerComponent* rasterizer = new RasterizerComponent();
-	rasterizer->CullMode = D3D11_CULL_FRONT;
+	RasterizerComponent rasterizer;
+	rasterizer.CullMode = D3D11_CULL_FRONT;
 	skyBox->AddComponent(rasterizer);
 
-	AppearanceComponent* skyBoxAppearance = new AppearanceComponent();
-	skyBoxAppearance->Model = geometryBuilder.FromFile("Content/Models/sphere.obj");
-	skyBoxAppearance->Gradient = GradientShaderParameters(XMFLOAT4(0.49f, 0.75f, 0.93f, 1.0f), XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f), 0, 0);
+	AppearanceComponent skyBoxAppearance;
+	skyBoxAppearance.TextureOwner = _textureCache;
+	skyBoxAppearance.ModelOwner = _geometryCache;
+	skyBoxAppearance.Gradient = GradientShaderParameters(XMFLOAT4(0.49f, 0.75f, 0.93f, 1.0f), XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f), 0, 0);
 	skyBox->AddComponent(skyBoxAppearance);
-
-	_entityList.push_back(skyBox);
-
-	Entity* text1 = new Entity();
-	TextComponent* textComponent1 = new TextComponent();
-	textComponent1->Text = "Test Application";
-	textComponent1->FontSize = 30;
-	textComponent1->FontPosition = XMFLOAT2(50, 600);
-	textComponent1->Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
+	StreamModel(skyBox->GetHandle(), "Content/Models/sphere.obj");
+
+	Entity* text1 = _entityManager->CreateEntity();
+	TextComponent textComponent1;
+	textComponent1.Text = "Test Application";
+	textComponent1.FontSize = 30;
+	textComponent1.FontPosition = XMFLOAT2(50, 600);
+	textComponent1.Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
 	text1->AddComponent(textComponent1);
 
-	_entityList.push_back(text1);
-
-	Entity* text2 = new Entity();
-	TextComponent* textComponent2 = new TextComponent();
-	textComponent2->Text = "Mouse X:    Mouse Y: ";
-	textComponent2->FontSize = 20;
-	textComponent2->FontPosition = XMFLOAT2(10, 40);
-	textComponent2->Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
+	Entity* text2 = _entityManager->CreateEntity();
+	TextComponent textComponent2;
+	textComponent2.Text = "Mouse X:    Mouse Y: ";
+	textComponent2.FontSize = 20;
+	textComponent2.FontPosition = XMFLOAT2(10, 40);
+	textComponent2.Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
 	text2->AddComponent(textComponent2);
-
-	_entityList.push_back(text2);
-	input->AddObserver(textComponent2);
-
-	Entity* text3 = new Entity();
-	TextComponent* textComponent3 = new TextComponent();
-	textComponent3->Text = "FPS: 0";
-	textComponent3->FontSize = 20;
-	textComponent3->FontPosition = XMFLOAT2(10, 65);
-	textComponent3->Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
+	input->AddObserver(ObserveComponent<TextComponent>(text2));
+
+	Entity* text3 = _entityManager->CreateEntity();
+	TextComponent textComponent3;
+	textComponent3.Text = "FPS: 0";
+	textComponent3.FontSize = 20;
+	textComponent3.FontPosition = XMFLOAT2(10, 65);
+	textComponent3.Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
 	text3->AddComponent(textComponent3);
-
-	_entityList.push_back(text3);
-	framesPerSecond->AddObserver(textComponent3);
-
-	Entity* text4 = new Entity();
-	TextComponent* textComponent4 = new TextComponent();
-	textComponent4->Text = "CPU: 0%";
-	textComponent4->FontSize = 20;
-	textComponent4->FontPosition = XMFLOAT2(10, 90);
-	textComponent4->Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
+	framesPerSecond->AddObserver(ObserveComponent<TextComponent>(text3));
+
+	Entity* text4 = _entityManager->CreateEntity();
+	TextComponent textComponent4;
+	textComponent4.Text = "CPU: 0%";
+	textComponent4.FontSize = 20;
+	textComponent4.FontPosition = XMFLOAT2(10, 90);
+	textComponent4.Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
 	text4->AddComponent(textComponent4);
-
-	_entityList.push_back(text4);
-	cpu->AddObserver(textComponent4);
-
-	Entity* text5 = new Entity();
-	TextComponent* textComponent5 = new TextComponent();
-	textComponent5->Text = "Rendered: 0";
-	textComponent5->FontSize = 20;
-	textComponent5->FontPosition = XMFLOAT2(10, 115);
-	textComponent5->Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
+	cpu->AddObserver(ObserveComponent<TextComponent>(text4));
+
+	Entity* text5 = _entityManager->CreateEntity();
+	TextComponent textComponent5;
+	textComponent5.Text = "Rendered: 0";
+	textComponent5.FontSize = 20;
+	textComponent5.FontPosition = XMFLOAT2(10, 115);
+	textComponent5.Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
 	text5->AddComponent(textComponent5);
-
-	_entityList.push_back(text5);
-	static_cast<RenderSystem*>(_systemList[RENDER_SYSTEM])->AddObserver(textComponent5);
-
-	Entity* ui = new Entity();
-
-	AppearanceComponent* uiAppearance = new AppearanceComponent();
-	uiAppearance->ShaderType = SHADER_UI;
-	uiAppearance->Model = geometryBuilder.ForUI();
-	uiAppearance->Textures = CreateTexture::ListFrom(direct3D, { "Content/Images/dirt.tga", "Content/Images/josh.tga", "Content/Images/stone.tga" });
-	uiAppearance->LightMap = CreateTexture::From(direct3D, "Content/Images/basic_light_map.tga");
-	uiAppearance->RenderEnabled = false;
+	static_cast<RenderSystem*>(_systemList[RENDER_SYSTEM])->AddObserver(ObserveComponent<TextComponent>(text5));
+
+	Entity* text6 = _entityManager->CreateEntity();
+	TextComponent textComponent6;
+	textComponent6.Text = "Constants: 0 bytes";
+	textComponent6.FontSize = 20;
+	textComponent6.FontPosition = XMFLOAT2(10, 140);
+	textComponent6.Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
+	text6->AddComponent(textComponent6);
+	_renderQueue->AddObserver(ObserveComponent<TextComponent>(text6));
+
+	Entity* ui = _entityManager->CreateEntity();
+
+	AppearanceComponent uiAppearance;
+	uiAppearance.TextureOwner = _textureCache;
+	uiAppearance.ModelOwner = _geometryCache;
+	uiAppearance.ShaderType = SHADER_UI;
+	uiAppearance.Model = _geometryCache->ForUI();
+	uiAppearance.Textures = _textureCache->ListFrom({ "Content/Images/dirt.tga", "Content/Images/josh.tga", "Content/Images/stone.tga" });
+	uiAppearance.LightMap = _textureCache->From("Content/Images/basic_light_map.tga");
+	uiAppearance.RenderEnabled = false;
 	ui->AddComponent(uiAppearance);
 
-	TransformComponent* uiTransform = new TransformComponent();
-	uiTransform->Position = XMFLOAT3(10, 150, 0);
+	TransformComponent uiTransform;
+	uiTransform.Position = XMFLOAT3(10, 150, 0);
 	ui->AddComponent(uiTransform);
 
-	UIComponent* uiComponent = new UIComponent();
-	uiComponent->BitmapSize = XMFLOAT2(256, 256);
+	UIComponent uiComponent;
+	uiComponent.BitmapSize = XMFLOAT2(256, 256);
 	ui->AddComponent(uiComponent);
 
-	_entityList.push_back(ui);
+	Entity* navigationBar = _entityManager->CreateEntity();
 
-	Entity* navigationBar = new Entity();
-
-	AppearanceComponent* navigationBarAppearance = new AppearanceComponent();
-	navigationBarAppearance->ShaderType = SHADER_UI;
-	navigationBarAppearance->Model = geometryBuilder.ForUI();
-	navigationBarAppearance->Color = ColorShaderParameters(XMFLOAT4(0.5, 0.5, 0.5, 1));
-	navigationBarAppearance->RenderEnabled = false;
+	AppearanceComponent navigationBarAppearance;
+	navigationBarAppearance.TextureOwner = _textureCache;
+	navigationBarAppearance.ModelOwner = _geometryCache;
+	navigationBarAppearance.ShaderType = SHADER_UI;
+	navigationBarAppearance.Model = _geometryCache->ForUI();
+	navigationBarAppearance.Color = ColorShaderParameters(XMFLOAT4(0.5, 0.5, 0.5, 1));
+	navigationBarAppearance.RenderEnabled = false;
 	navigationBar->AddComponent(navigationBarAppearance);
 
-	TransformComponent* navigationBarTransform = new TransformComponent();
-	navigationBarTransform->Position = XMFLOAT3(0, 0, 2);
+	TransformComponent navigationBarTransform;
+	navigationBarTransform.Position = XMFLOAT3(0, 0, 2);
 	navigationBar->AddComponent(navigationBarTransform);
 
-	UIComponent* navigationBarComponent = new UIComponent();
-	navigationBarComponent->BitmapSize = XMFLOAT2(screenSize.Width, 30);
+	UIComponent navigationBarComponent;
+	navigationBarComponent.BitmapSize = XMFLOAT2(screenSize.Width, 30);
 	navigationBar->AddComponent(navigationBarComponent);
 
-	InputComponent* navigationBarInput = new InputComponent();
+	InputComponent* navigationBarInput = navigationBar->AddComponent(InputComponent());
 	ControlCommand control;
 	control.Control = ESCAPE;
-	control.Command = new ToggleVisibleCommand(navigationBarAppearance);
+	control.Command = new ToggleVisibleCommand(_entityManager, navigationBar->GetHandle());
 	control.Cooldown = 0.2f;
 	navigationBarInput->ControlCommands.push_back(control);
-	navigationBar->AddComponent(navigationBarInput);
-
-	_entityList.push_back(navigationBar); 
 	
-	Entity* button1 = new Entity();
-
-	AppearanceComponent* button1Appearance = new AppearanceComponent();
-	button1Appearance->ShaderType = SHADER_UI;
-	button1Appearance->Model = geometryBuilder.ForUI();
-	button1Appearance->Color = ColorShaderParameters(XMFLOAT4(0.4, 0.4, 0.4, 1));
-	button1Appearance->RenderEnabled = false;
+	Entity* button1 = _entityManager->CreateEntity();
+
+	AppearanceComponent button1Appearance;
+	button1Appearance.TextureOwner = _textureCache;
+	button1Appearance.ModelOwner = _geometryCache;
+	button1Appearance.ShaderType = SHADER_UI;
+	button1Appearance.Model = _geometryCache->ForUI();
+	button1Appearance.Color = ColorShaderParameters(XMFLOAT4(0.4, 0.4, 0.4, 1));
+	button1Appearance.RenderEnabled = false;
 	button1->AddComponent(button1Appearance);
 
-	TransformComponent* button1Transform = new TransformComponent();
-	button1Transform->Position = XMFLOAT3(0, 0, 1);
+	TransformComponent button1Transform;
+	button1Transform.Position = XMFLOAT3(0, 0, -1);
+	button1Transform.SetParent(navigationBar->GetHandle());
 	button1->AddComponent(button1Transform);
 
-	UIComponent* button1Component = new UIComponent();
-	button1Component->BitmapSize = XMFLOAT2(170, 30);
+	UIComponent button1Component;
+	button1Component.BitmapSize = XMFLOAT2(170, 30);
 	button1->AddComponent(button1Component);
 
-	TextComponent* button1Text = new TextComponent();
-	button1Text->Text = "Graphics";
-	button1Text->FontSize = 20;
-	button1Text->FontPosition = XMFLOAT2(0, 3);
-	button1Text->Color = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+	TextComponent button1Text;
+	button1Text.Text = "Graphics";
+	button1Text.FontSize = 20;
+	button1Text.FontPosition = XMFLOAT2(0, 3);
+	button1Text.Color = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
 	button1->AddComponent(button1Text);
 
-	ButtonComponent* button1Button = new ButtonComponent();
-	button1->AddComponent(button1Button);
+	button1->AddComponent(ButtonComponent());
 
-	InputComponent* button1Input = new InputComponent();
+	InputComponent* button1Input = button1->AddComponent(InputComponent());
 	control.Control = ESCAPE;
-	control.Command = new ToggleVisibleCommand(button1Appearance);
+	control.Command = new ToggleVisibleCommand(_entityManager, button1->GetHandle());
 	control.Cooldown = 0.2f;
 	button1Input->ControlCommands.push_back(control);
-	button1->AddComponent(button1Input);
 
-	_entityList.push_back(button1);
+	Entity* button2 = _entityManager->CreateEntity();
 
-	Entity* button2 = new Entity();
-
-	AppearanceComponent* button2Appearance = new AppearanceComponent();
-	button2Appearance->ShaderType = SHADER_UI;
-	button2Appearance->Model = geometryBuilder.ForUI();
-	button2Appearance->Color = ColorShaderParameters(XMFLOAT4(0.4, 0.4, 0.4, 1));
-	button2Appearance->RenderEnabled = false;
+	AppearanceComponent button2Appearance;
+	button2Appearance.TextureOwner = _textureCache;
+	button2Appearance.ModelOwner = _geometryCache;
+	button2Appearance.ShaderType = SHADER_UI;
+	button2Appearance.Model = _geometryCache->ForUI();
+	button2Appearance.Color = ColorShaderParameters(XMFLOAT4(0.4, 0.4, 0.4, 1));
+	button2Appearance.RenderEnabled = false;
 	button2->AddComponent(button2Appearance);
 
-	TransformComponent* button2Transform = new TransformComponent();
-	button2Transform->Position = XMFLOAT3(175, 0, 1);
+	TransformComponent button2Transform;
+	button2Transform.Position = XMFLOAT3(175, 0, -1);
+	button2Transform.SetParent(navigationBar->GetHandle());
 	button2->AddComponent(button2Transform);
 
-	UIComponent* button2Component = new UIComponent();
-	button2Component->BitmapSize = XMFLOAT2(170, 30);
+	UIComponent button2Component;
+	button2Component.BitmapSize = XMFLOAT2(170, 30);
 	button2->AddComponent(button2Component);
 
-	TextComponent* button2Text = new TextComponent();
-	button2Text->Text = "Exit";
-	button2Text->FontSize = 20;
-	button2Text->FontPosition = XMFLOAT2(175, 3);
-	button2Text->Color = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+	TextComponent button2Text;
+	button2Text.Text = "Exit";
+	button2Text.FontSize = 20;
+	button2Text.FontPosition = XMFLOAT2(0, 3);
+	button2Text.Color = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
 	button2->AddComponent(button2Text);
 
-	ButtonComponent* button2Button = new ButtonComponent();
-	button2Button->OnClickCommand = new ExitApplicationCommand();
+	ButtonComponent button2Button;
+	button2Button.OnClickCommand = new ExitApplicationCommand();
 	button2->AddComponent(button2Button);
 
-	InputComponent* button2Input = new InputComponent();
+	InputComponent* button2Input = button2->AddComponent(InputComponent());
 	control.Control = ESCAPE;
-	control.Command = new ToggleVisibleCommand(button2Appearance);
+	control.Command = new ToggleVisibleCommand(_entityManager, button2->GetHandle());
 	control.Cooldown = 0.2f;
 	button2Input->ControlCommands.push_back(control);
-	button2->AddComponent(button2Input);
-
-	_entityList.push_back(button2);
 
-	Entity* cursor = new Entity();
+	Entity* cursor = _entityManager->CreateEntity();
 
-	AppearanceComponent* cursorAppearance = new AppearanceComponent();
-	cursorAppearance->ShaderType = SHADER_UI;
-	cursorAppearance->Model = geometryBuilder.ForUI();
-	cursorAppearance->Textures = CreateTexture::ListFrom(direct3D, { "Content/Images/cursor.tga" });
-	cursorAppearance->RenderEnabled = false;
+	AppearanceComponent cursorAppearance;
+	cursorAppearance.TextureOwner = _textureCache;
+	cursorAppearance.ModelOwner = _geometryCache;
+	cursorAppearance.ShaderType = SHADER_UI;
+	cursorAppearance.Model = _geometryCache->ForUI();
+	cursorAppearance.Textures = _textureCache->ListFrom({ "Content/Images/cursor.tga" });
+	cursorAppearance.RenderEnabled = false;
 	cursor->AddComponent(cursorAppearance);
 
-	TransformComponent* cursorTransform = new TransformComponent();
-	cursorTransform->Position = XMFLOAT3(400, 400, 0);
-	cursorTransform->TransformEnabled = false;
+	TransformComponent cursorTransform;
+	cursorTransform.Position = XMFLOAT3(400, 400, 0);
+	cursorTransform.TransformEnabled = false;
 	cursor->AddComponent(cursorTransform);
 
-	UIComponent* cursorComponent = new UIComponent();
-	cursorComponent->BitmapSize = XMFLOAT2(24, 24);
+	UIComponent cursorComponent;
+	cursorComponent.BitmapSize = XMFLOAT2(24, 24);
 	cursor->AddComponent(cursorComponent);
 
-	InputComponent* cursorInput = new InputComponent();
+	cursor->AddComponent(InputComponent());
+
+	CollisionComponent cursorCollision;
+	cursorCollision.CollisionType = CURSOR;
+	cursor->AddComponent(cursorCollision);
+
+	InputComponent* cursorInput = cursor->GetComponent<InputComponent>();
 	control.Control = ESCAPE;
-	control.Command = new ToggleVisibleCommand(cursorAppearance);
+	control.Command = new ToggleVisibleCommand(_entityManager, cursor->GetHandle());
 	control.Cooldown = 0.2f;
 	cursorInput->ControlCommands.push_back(control);
 
 	control.Control = ESCAPE;
-	control.Command = new ToggleTransformCommand(cursorTransform);
+	control.Command = new ToggleTransformCommand(_entityManager, cursor->GetHandle());
 	control.Cooldown = 0.2f;
 	cursorInput->ControlCommands.push_back(control);
-	cursor->AddComponent(cursorInput);
 
-	CollisionComponent* cursorCollision = new CollisionComponent();
-	cursorCollision->CollisionType = CURSOR;
-	cursor->AddComponent(cursorCollision);
+	input->AddObserver(ObserveComponent<TransformComponent>(cursor));
+}
 
-	_entityList.push_back(cursor);
-	input->AddObserver(cursorTransform);
+// Gives the entity a reference on the placeholder mesh now and swaps in the real one once the loader has it on the
+// GPU
+void ObjectHandler::StreamModel(EntityHandle entity, const string& path)
+{
+	MeshFuture model = _assetLoader->LoadModel(path);
+	_entityManager->GetComponent<AppearanceComponent>(entity)->Model = _geometryCache->Share(model->GetPlaceholder());
+
+	model->Then([this, entity](const Geometry& loaded)
+	{
+		AppearanceComponent* appearance = _entityManager->IsAlive(entity) ? _entityManager->GetComponent<AppearanceComponent>(entity) : nullptr;
+		if (appearance == nullptr)
+		{
+			_geometryCache->Release(loaded);
+			return;
+		}
+
+		_geometryCache->Release(appearance->Model);
+		appearance->Model = loaded;
+		appearance->Dirty = true;
+	});
 }
 
-void ObjectHandler::Update(float delta)
+// Each slot holds a reference on the placeholder until the real texture replaces it
+void ObjectHandler::StreamTextures(EntityHandle entity, const vector<string>& paths)
 {
-	for (map<SystemType, ISystem*>::iterator iterator = _systemList.begin(); iterator != _systemList.end(); ++iterator)
+	vector<Texture*>& textures = _entityManager->GetComponent<AppearanceComponent>(entity)->Textures;
+	textures.resize(paths.size());
+
+	for (Texture*& texture : textures)
+		texture = _textureCache->Share(_assetLoader->GetPlaceholderTexture());
+
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		_assetLoader->LoadTexture(paths[i])->Then([this, entity, i](Texture* const& loaded)
+		{
+			AppearanceComponent* appearance = _entityManager->IsAlive(entity) ? _entityManager->GetComponent<AppearanceComponent>(entity) : nullptr;
+			if (appearance == nullptr || i >= appearance->Textures.size())
+			{
+				_textureCache->Release(loaded);
+				return;
+			}
+
+			_textureCache->Release(appearance->Textures[i]);
+			appearance->Textures[i] = loaded;
+			appearance->Dirty = true;
+		});
+	}
+}
+
+// Runs before anything else in the frame, so a changed asset is always swapped in between two frames
+void ObjectHandler::ReloadChangedAssets()
+{
+	if (_fileWatcher == nullptr)
+		return;
+
+	for (const string& path : _fileWatcher->TakeChanges())
+	{
+		size_t extensionStart = path.find_last_of('.');
+		if (extensionStart == string::npos)
+			continue;
+
+		string extension = path.substr(extensionStart);
+		for (char& character : extension)
+			character = static_cast<char>(tolower(static_cast<unsigned char>(character)));
+
+		if (extension == ".tga")
+			_assetLoader->ReloadTexture(path, [this]() { InvalidateDrawPackets(); });
+		else if (extension == ".obj")
+			_assetLoader->ReloadModel(path, [this](const Geometry& previous, const Geometry& model) { ReplaceModel(previous, model); });
+		else if (extension == ".hlsl")
+			_shaderController->Reload(path);
+	}
+}
+
+void ObjectHandler::ReplaceModel(const Geometry& previous, const Geometry& model)
+{
+	Query<AppearanceComponent> query(_entityManager);
+
+	for (Archetype* archetype : query.GetArchetypes())
+	{
+		ComponentArray<AppearanceComponent>* appearances = archetype->GetColumn<AppearanceComponent>();
+
+		for (int row = 0; row < archetype->GetSize(); row++)
+		{
+			AppearanceComponent* appearance = appearances->At(row);
+			if (appearance->Model.VertexBuffer == previous.VertexBuffer)
+			{
+				appearance->Model = model;
+				appearance->Dirty = true;
+			}
+		}
+	}
+}
+
+// A reloaded texture keeps its Texture but gets a new resource view, which the cached draw packets still point at
+void ObjectHandler::InvalidateDrawPackets()
+{
+	Query<AppearanceComponent> query(_entityManager);
+
+	for (Archetype* archetype : query.GetArchetypes())
+	{
+		ComponentArray<AppearanceComponent>* appearances = archetype->GetColumn<AppearanceComponent>();
+
+		for (int row = 0; row < archetype->GetSize(); row++)
+			appearances->At(row)->Dirty = true;
+	}
+}
+
+// Adds the entities of a scene to the current one. JSON scenes are streamed straight into the entity manager,
+// anything else is treated as a compiled scene.
+void ObjectHandler::LoadScene(const string& path)
+{
+	size_t extension = path.find_last_of('.');
+	if (extension != string::npos && path.compare(extension, string::npos, ".json") == 0)
 	{
-		iterator->second->Update(_entityList, delta);
+		_sceneInstantiator->BeginScene();
+		JSONSceneHandler sceneHandler(_sceneInstantiator);
+		JSONLoader().Load(path, &sceneHandler);
+		return;
 	}
+
+	vector<Entity*> entities;
+	_sceneLoader->Load(path, entities, _componentObservers);
+}
+
+// Runs once per frame with the frame's delta, so input is acted on once however many steps follow
+void ObjectHandler::HandleInput(float delta)
+{
+	_systemScheduler->Update(_systemList, _entityManager, delta, EVERY_FRAME);
+	_entityManager->PlaybackCommands();
 }
 
-void ObjectHandler::Render()
+void ObjectHandler::Update(float delta)
+{
+	ReloadChangedAssets();
+	_assetLoader->Update();
+	static_cast<TransformSystem*>(_systemList[TRANSFORM_SYSTEM])->SetFocus(_camera->GetTransform()->GetPosition());
+	_systemScheduler->Update(_systemList, _entityManager, delta, EVERY_STEP);
+	_entityManager->PlaybackCommands();
+}
+
+void ObjectHandler::Render(float interpolation)
 {
+	static_cast<TransformSystem*>(_systemList[TRANSFORM_SYSTEM])->Interpolate(_entityManager, interpolation);
+
+	_renderQueue->Clear();
+
 	for (map<SystemType, ISystem*>::iterator iterator = _systemList.begin(); iterator != _systemList.end(); ++iterator)
 	{
-		iterator->second->Render(_entityList);
+		iterator->second->Render(_entityManager);
 	}
+
+	_renderQueue->Submit(_renderDevice);
 }
\ No newline at end of file
@@ -6,16 +6,22 @@
 #include <vector>
 #include "../ShaderEngine/ShaderController.h"
 #include "../Objects/Entity.h"
+#include "../Objects/EntityManager.h"
+#include "../Objects/ComponentObserver.h"
 #include "../Objects/Systems/TransformSystem.h"
 #include "../Objects/Systems/RenderSystem.h"
 #include "../Objects/Entity.h"
 #include "../Objects/Components/TransformComponent.h"
 #include "../Objects/Components/AppearanceComponent.h"
 #include "../Objects/Systems/RenderSystem.h"
-#include "../Objects/Geometry/GeometryBuilder.h"
+#include "../Objects/Geometry/GeometryCache.h"
 #include "../Objects/Components/RasterizerComponent.h"
-#include "../Objects/Texture/CreateTexture.h"
+#include "../Objects/Texture/TextureCache.h"
+#include "../Objects/Assets/AsyncAssetLoader.h"
+#include "../Objects/Assets/FileWatcher.h"
 #include "../Objects/Systems/SystemType.h"
+#include "../Objects/Systems/SystemScheduler.h"
+#include "../Threading/WorkerPool.h"
 #include "../Objects/Components/FurstrumCullingComponent.h"
 #include "../Objects/Systems/UISystem.h"
 #include "../Objects/Components/TextComponent.h"
@@ -23,6 +29,10 @@
 #include "../Objects/Systems/TextSystem.h"
 #include "../SystemMetrics/FramesPerSecond.h"
 #include "../SystemMetrics/Cpu.h"
+#include "../Scenes/SceneBlobLoader.h"
+#include "../Scenes/SceneInstantiator.h"
+#include "../Rendering/RenderQueue.h"
+#include "../Rendering/IRenderDevice.h"
 
 using namespace DirectX;
 using namespace std;
@@ -31,16 +41,49 @@ class ObjectHandler
 {
 private:
 	Frustrum* _frustrum;
+	Camera* _camera;
+	ShaderController* _shaderController;
 
-	vector<Entity*> _entityList;
+	EntityManager* _entityManager;
+	vector<IObserver*> _componentObservers;
 	map<SystemType, ISystem*> _systemList;
-	void InitialiseObjects(DirectX3D* direct3D, ShaderController* shaderController, FontEngine* fontEngine, HWND hwnd, Camera* camera, Input* input, FramesPerSecond* framesPerSecond, Cpu* cpu, Box screenSize);
+	WorkerPool* _workerPool;
+	SystemScheduler* _systemScheduler;
+	GeometryBuilder* _geometryBuilder;
+	GeometryCache* _geometryCache;
+	TextureCache* _textureCache;
+	AsyncAssetLoader* _assetLoader;
+	FileWatcher* _fileWatcher;
+	SceneBlobLoader* _sceneLoader;
+	SceneInstantiator* _sceneInstantiator;
+	RenderQueue* _renderQueue;
+	IRenderDevice* _renderDevice;
+
+	template<typename T>
+	IObserver* ObserveComponent(Entity* entity)
+	{
+		IObserver* observer = new ComponentObserver<T>(_entityManager, entity->GetHandle());
+		_componentObservers.push_back(observer);
+		return observer;
+	}
+
+	void StreamModel(EntityHandle entity, const string& path);
+	void StreamTextures(EntityHandle entity, const vector<string>& paths);
+	void ReloadChangedAssets();
+	void ReplaceModel(const Geometry& previous, const Geometry& model);
+	void InvalidateDrawPackets();
+
+	void InitialiseObjects(FontEngine* fontEngine, Camera* camera, Input* input, FramesPerSecond* framesPerSecond, Cpu* cpu, Box screenSize);
+	void BuildScene(Input* input, FramesPerSecond* framesPerSecond, Cpu* cpu, Box screenSize);
 public:
-	ObjectHandler(DirectX3D* direct3D, ShaderController* shaderController, FontEngine* fontEngine, HWND hwnd, Camera* camera, Input* input, FramesPerSecond* framesPerSecond, Cpu* cpu, Box screenSize);
+	ObjectHandler(IRenderDevice* renderDevice, ShaderController* shaderController, FontEngine* fontEngine, Camera* camera, Input* input, FramesPerSecond* framesPerSecond, Cpu* cpu, Box screenSize);
 	~ObjectHandler();
 
 	void Shutdown();
 
+	void LoadScene(const string& path);
+
+	void HandleInput(float delta);
 	void Update(float delta);
-	void Render();
+	void Render(float interpolation);
 };
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+#include "Controls.h"
+
+class IInputState
+{
+public:
+	virtual ~IInputState() {}
+
+	virtual bool IsControlPressed(Controls control) = 0;
+};
\ No newline at end of file
@@ -10,12 +10,13 @@
 #include "../../ErrorHandling/Exception.h"
 #include "../../common/Box.h"
 #include "ControlMappings.h"
+#include "IInputState.h"
 #include "../Observer/IObserver.h"
 #include "../Observer/Observable.h"
 
 using namespace DirectX;
 
-class Input : public Observable
+class Input : public Observable, public IInputState
 {
 private:
 	IDirectInput8* _directInput;
@@ -45,7 +46,7 @@ public:
 	void Shutdown();
 	void Update();
 
-	bool IsControlPressed(Controls control);
+	bool IsControlPressed(Controls control) override;
 	bool ProcessMouseControl(InputControl input);
 
 	void AddObserver(IObserver* observer) override;
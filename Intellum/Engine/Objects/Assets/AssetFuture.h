@@ -0,0 +1,86 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+#include "../Geometry/Geometry.h"
+#include "../Texture/Texture.h"
+
+using namespace std;
+
+enum AssetStatus
+{
+	ASSET_LOADING,
+	ASSET_READY,
+	ASSET_FAILED
+};
+
+// Handle to an asset being decoded in the background. Get returns the placeholder until the asset is ready, and
+// keeps returning it if loading fails. Futures are only completed from AsyncAssetLoader::Update, so they and any
+// continuations passed to Then are only ever touched on the main thread. Once ready the value holds one cache
+// reference for whoever asked for it; the placeholder belongs to the loader, so a caller that keeps it takes its
+// own reference through the cache's Share.
+template<typename T>
+class AssetFuture
+{
+private:
+	T _placeholder;
+	T _value;
+	AssetStatus _status;
+	vector<function<void(const T&)>> _continuations;
+
+	void Complete(const T& value)
+	{
+		_value = value;
+		_status = ASSET_READY;
+
+		for (function<void(const T&)>& continuation : _continuations)
+			continuation(_value);
+
+		_continuations.clear();
+	}
+
+	void Fail()
+	{
+		_status = ASSET_FAILED;
+		_continuations.clear();
+	}
+
+	friend class AsyncAssetLoader;
+
+public:
+	AssetFuture(const T& placeholder) : _placeholder(placeholder), _value(placeholder), _status(ASSET_LOADING)
+	{
+	}
+
+	const T& Get() const
+	{
+		return _value;
+	}
+
+	const T& GetPlaceholder() const
+	{
+		return _placeholder;
+	}
+
+	AssetStatus GetStatus() const
+	{
+		return _status;
+	}
+
+	bool IsReady() const
+	{
+		return _status == ASSET_READY;
+	}
+
+	// Runs straight away if the asset is already loaded, otherwise once it is. Never runs if loading fails.
+	void Then(function<void(const T&)> continuation)
+	{
+		if (_status == ASSET_READY)
+			continuation(_value);
+		else if (_status == ASSET_LOADING)
+			_continuations.push_back(continuation);
+	}
+};
+
+typedef shared_ptr<AssetFuture<Texture*>> TextureFuture;
+typedef shared_ptr<AssetFuture<Geometry>> MeshFuture;
\ No newline at end of file
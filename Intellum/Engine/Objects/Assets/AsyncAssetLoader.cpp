@@ -0,0 +1,281 @@
+#include "AsyncAssetLoader.h"
+#include <cstring>
+#include "../../../Loaders/TargaLoader.h"
+
+AsyncAssetLoader::AsyncAssetLoader(TextureCache* textures, GeometryCache* models, int workerCount) : _textures(textures), _models(models), _workerPool(nullptr), _placeholderTexture(nullptr)
+{
+	_workerPool = new WorkerPool(workerCount);
+
+	TargaData placeholder;
+	placeholder.ImageSize = Box(2, 2);
+	placeholder.ImageData = new unsigned char[2 * 2 * 4];
+	memset(placeholder.ImageData, 255, 2 * 2 * 4);
+
+	_placeholderTexture = _textures->FromImage("#placeholder", placeholder, TextureCache::HashImage(placeholder));
+	_placeholderModel = _models->Cube();
+}
+
+AsyncAssetLoader::~AsyncAssetLoader()
+{
+}
+
+void AsyncAssetLoader::Shutdown()
+{
+	if (_workerPool)
+	{
+		_workerPool->Shutdown();
+		delete _workerPool;
+		_workerPool = nullptr;
+	}
+
+	for (DecodedTexture& decoded : _completedTextures)
+		delete[] decoded.Image.ImageData;
+
+	_completedTextures.clear();
+	_completedModels.clear();
+	_pendingTextures.clear();
+	_pendingModels.clear();
+
+	if (_placeholderTexture)
+	{
+		_textures->Release(_placeholderTexture);
+		_placeholderTexture = nullptr;
+	}
+
+	if (_placeholderModel.VertexBuffer)
+	{
+		_models->Release(_placeholderModel);
+		_placeholderModel = Geometry();
+	}
+}
+
+TextureFuture AsyncAssetLoader::LoadTexture(const string& path)
+{
+	TextureFuture future = make_shared<AssetFuture<Texture*>>(_placeholderTexture);
+
+	Texture* texture = _textures->Find(path);
+	if (texture != nullptr)
+	{
+		future->Complete(texture);
+		return future;
+	}
+
+	vector<TextureFuture>& pending = _pendingTextures[path];
+	pending.push_back(future);
+
+	if (pending.size() == 1)
+		_workerPool->Submit([this, path]() { DecodeTexture(path, false, nullptr); });
+
+	return future;
+}
+
+MeshFuture AsyncAssetLoader::LoadModel(const string& path)
+{
+	MeshFuture future = make_shared<AssetFuture<Geometry>>(_placeholderModel);
+
+	Geometry model;
+	if (_models->TryFromFile(path, model))
+	{
+		future->Complete(model);
+		return future;
+	}
+
+	vector<MeshFuture>& pending = _pendingModels[path];
+	pending.push_back(future);
+
+	if (pending.size() == 1)
+		_workerPool->Submit([this, path]() { DecodeModel(path, nullptr); });
+
+	return future;
+}
+
+// Textures are swapped in place by the cache, onReloaded is called once the new image is on the GPU
+void AsyncAssetLoader::ReloadTexture(const string& path, TextureReloaded onReloaded)
+{
+	_workerPool->Submit([this, path, onReloaded]() { DecodeTexture(path, true, onReloaded); });
+}
+
+// Meshes are rebuilt into new buffers. onReloaded is given the old and new model so every holder can be moved
+// across before the old buffers are freed.
+void AsyncAssetLoader::ReloadModel(const string& path, ModelReloaded onReloaded)
+{
+	_workerPool->Submit([this, path, onReloaded]() { DecodeModel(path, onReloaded); });
+}
+
+void AsyncAssetLoader::DecodeTexture(const string& path, bool reload, TextureReloaded onReloaded)
+{
+	DecodedTexture decoded;
+	decoded.Path = path;
+	decoded.Image.ImageData = nullptr;
+	decoded.ContentHash = 0;
+	decoded.OnReloaded = onReloaded;
+	decoded.Reload = reload;
+	decoded.Succeeded = false;
+
+	try
+	{
+		decoded.Image = TargaLoader::LoadTarga(const_cast<char*>(path.c_str()));
+		decoded.ContentHash = TextureCache::HashImage(decoded.Image);
+		decoded.Succeeded = true;
+	}
+	catch (...)
+	{
+	}
+
+	lock_guard<mutex> lock(_completedLock);
+	_completedTextures.push_back(decoded);
+}
+
+void AsyncAssetLoader::DecodeModel(const string& path, ModelReloaded onReloaded)
+{
+	DecodedModel decoded;
+	decoded.Path = path;
+	decoded.OnReloaded = onReloaded;
+	decoded.Reload = onReloaded != nullptr;
+	decoded.Succeeded = false;
+
+	try
+	{
+		decoded.Mesh = OBJLoader::Decode(const_cast<char*>(path.c_str()));
+		decoded.Succeeded = true;
+
+		if (decoded.Reload)
+			OBJLoader::DiscardBinary(const_cast<char*>(path.c_str()));
+	}
+	catch (...)
+	{
+	}
+
+	lock_guard<mutex> lock(_completedLock);
+	_completedModels.push_back(move(decoded));
+}
+
+// Creates the GPU resources for everything decoded since the last call and completes the waiting futures
+void AsyncAssetLoader::Update()
+{
+	vector<DecodedTexture> textures;
+	vector<DecodedModel> models;
+
+	{
+		lock_guard<mutex> lock(_completedLock);
+		textures.swap(_completedTextures);
+		models.swap(_completedModels);
+	}
+
+	for (DecodedTexture& decoded : textures)
+	{
+		if (decoded.Reload)
+		{
+			if (decoded.Succeeded)
+			{
+				_textures->Reload(decoded.Path, decoded.Image, decoded.ContentHash);
+
+				if (decoded.OnReloaded != nullptr)
+					decoded.OnReloaded();
+			}
+
+			continue;
+		}
+
+		CompleteTexture(decoded);
+	}
+
+	for (DecodedModel& decoded : models)
+	{
+		if (decoded.Reload)
+			ReplaceModel(decoded);
+		else
+			CompleteModel(decoded);
+	}
+}
+
+void AsyncAssetLoader::CompleteTexture(DecodedTexture& decoded)
+{
+	vector<TextureFuture> futures = _pendingTextures[decoded.Path];
+	_pendingTextures.erase(decoded.Path);
+
+	Texture* texture = nullptr;
+	if (decoded.Succeeded)
+		texture = _textures->FromImage(decoded.Path, decoded.Image, decoded.ContentHash);
+
+	for (size_t i = 0; i < futures.size(); i++)
+	{
+		if (texture == nullptr)
+		{
+			futures[i]->Fail();
+			continue;
+		}
+
+		futures[i]->Complete(i == 0 ? texture : _textures->Find(decoded.Path));
+	}
+}
+
+void AsyncAssetLoader::CompleteModel(DecodedModel& decoded)
+{
+	vector<MeshFuture> futures = _pendingModels[decoded.Path];
+	_pendingModels.erase(decoded.Path);
+
+	Geometry model;
+	bool uploaded = false;
+	if (decoded.Succeeded)
+	{
+		try
+		{
+			model = _models->FromMeshData(decoded.Path, decoded.Mesh);
+			uploaded = true;
+		}
+		catch (Exception&)
+		{
+		}
+	}
+
+	for (size_t i = 0; i < futures.size(); i++)
+	{
+		if (!uploaded)
+		{
+			futures[i]->Fail();
+			continue;
+		}
+
+		if (i > 0)
+			_models->TryFromFile(decoded.Path, model);
+
+		futures[i]->Complete(model);
+	}
+}
+
+void AsyncAssetLoader::ReplaceModel(DecodedModel& decoded)
+{
+	if (!decoded.Succeeded)
+		return;
+
+	Geometry previous;
+	Geometry model;
+	try
+	{
+		if (!_models->Reload(decoded.Path, decoded.Mesh, previous, model))
+			return;
+	}
+	catch (Exception&)
+	{
+		return;
+	}
+
+	decoded.OnReloaded(previous, model);
+	_models->Discard(previous);
+}
+
+int AsyncAssetLoader::GetPendingCount() const
+{
+	return static_cast<int>(_pendingTextures.size() + _pendingModels.size());
+}
+
+Texture* AsyncAssetLoader::GetPlaceholderTexture() const
+{
+	return _placeholderTexture;
+}
+
+Geometry AsyncAssetLoader::GetPlaceholderModel() const
+{
+	return _placeholderModel;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "AssetFuture.h"
+#include "../Geometry/GeometryCache.h"
+#include "../Texture/TextureCache.h"
+#include "../../Threading/WorkerPool.h"
+
+using namespace std;
+
+// Streams textures and meshes in without stalling the frame. Files are read and decoded on a worker pool of the
+// loader's own, so a long decode never holds up the system scheduler, and the results are queued until Update
+// hands them to the caches on the main thread, where the device is used to create the GPU resources. Requests
+// for an asset that is already resident complete immediately, and requests for one already in flight share a
+// single decode. Reloads of an asset that changed on disk are decoded the same way and swapped into the
+// resident copy by Update, so the swap always lands between two frames.
+class AsyncAssetLoader
+{
+public:
+	typedef function<void(const Geometry& previous, const Geometry& model)> ModelReloaded;
+	typedef function<void()> TextureReloaded;
+
+private:
+	struct DecodedTexture
+	{
+		string Path;
+		TargaData Image;
+		unsigned long long ContentHash;
+		TextureReloaded OnReloaded;
+		bool Reload;
+		bool Succeeded;
+	};
+
+	struct DecodedModel
+	{
+		string Path;
+		MeshData Mesh;
+		ModelReloaded OnReloaded;
+		bool Reload;
+		bool Succeeded;
+	};
+
+	TextureCache* _textures;
+	GeometryCache* _models;
+	WorkerPool* _workerPool;
+
+	Texture* _placeholderTexture;
+	Geometry _placeholderModel;
+
+	map<string, vector<TextureFuture>> _pendingTextures;
+	map<string, vector<MeshFuture>> _pendingModels;
+
+	mutex _completedLock;
+	vector<DecodedTexture> _completedTextures;
+	vector<DecodedModel> _completedModels;
+
+	void DecodeTexture(const string& path, bool reload, TextureReloaded onReloaded);
+	void DecodeModel(const string& path, ModelReloaded onReloaded);
+
+	void CompleteTexture(DecodedTexture& decoded);
+	void CompleteModel(DecodedModel& decoded);
+	void ReplaceModel(DecodedModel& decoded);
+
+public:
+	AsyncAssetLoader(TextureCache* textures, GeometryCache* models, int workerCount);
+	~AsyncAssetLoader();
+
+	void Shutdown();
+
+	TextureFuture LoadTexture(const string& path);
+	MeshFuture LoadModel(const string& path);
+
+	void ReloadTexture(const string& path, TextureReloaded onReloaded);
+	void ReloadModel(const string& path, ModelReloaded onReloaded);
+
+	void Update();
+
+	int GetPendingCount() const;
+	Texture* GetPlaceholderTexture() const;
+	Geometry GetPlaceholderModel() const;
+};
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "FileWatcher.h"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher(const vector<string>& directories, float settleTime) : _directories(directories), _settleTime(settleTime), _stopping(false)
+{
+#ifdef _WIN32
+	_stopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+#endif
+
+	_watcher = thread(&FileWatcher::Watch, this);
+}
+
+FileWatcher::~FileWatcher()
+{
+}
+
+void FileWatcher::Shutdown()
+{
+	_stopping = true;
+
+#ifdef _WIN32
+	SetEvent(_stopEvent);
+#endif
+
+	if (_watcher.joinable())
+		_watcher.join();
+
+#ifdef _WIN32
+	if (_stopEvent)
+	{
+		CloseHandle(_stopEvent);
+		_stopEvent = nullptr;
+	}
+#endif
+}
+
+void FileWatcher::AddChange(const string& path)
+{
+	lock_guard<mutex> lock(_changesLock);
+	_changes[path] = chrono::steady_clock::now();
+}
+
+// Hands back every file that has settled since the last call, as a directory given to the watcher followed by
+// the file name
+vector<string> FileWatcher::TakeChanges()
+{
+	vector<string> settled;
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+	lock_guard<mutex> lock(_changesLock);
+	for (map<string, chrono::steady_clock::time_point>::iterator change = _changes.begin(); change != _changes.end();)
+	{
+		if (chrono::duration<float>(now - change->second).count() < _settleTime)
+		{
+			++change;
+			continue;
+		}
+
+		settled.push_back(change->first);
+		change = _changes.erase(change);
+	}
+
+	return settled;
+}
+
+#ifdef _WIN32
+void FileWatcher::Watch()
+{
+	const DWORD bufferSize = 16 * 1024;
+	const DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME;
+
+	vector<HANDLE> directories;
+	vector<string> names;
+	for (const string& directory : _directories)
+	{
+		HANDLE handle = CreateFileA(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+			continue;
+
+		directories.push_back(handle);
+		names.push_back(directory);
+	}
+
+	// Notifications are DWORD aligned, so the buffers are too
+	vector<vector<DWORD>> buffers(directories.size(), vector<DWORD>(bufferSize / sizeof(DWORD)));
+	vector<OVERLAPPED> overlapped(directories.size());
+	vector<HANDLE> waitHandles;
+
+	for (size_t i = 0; i < directories.size(); i++)
+	{
+		ZeroMemory(&overlapped[i], sizeof(OVERLAPPED));
+		overlapped[i].hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+		waitHandles.push_back(overlapped[i].hEvent);
+
+		ReadDirectoryChangesW(directories[i], &buffers[i][0], bufferSize, FALSE, filter, nullptr, &overlapped[i], nullptr);
+	}
+
+	waitHandles.push_back(_stopEvent);
+
+	while (!_stopping)
+	{
+		DWORD signalled = WaitForMultipleObjects(static_cast<DWORD>(waitHandles.size()), &waitHandles[0], FALSE, INFINITE);
+		size_t index = signalled - WAIT_OBJECT_0;
+		if (index >= directories.size())
+			break;
+
+		DWORD bytes = 0;
+		GetOverlappedResult(directories[index], &overlapped[index], &bytes, FALSE);
+		ResetEvent(overlapped[index].hEvent);
+
+		// A read of zero bytes means the buffer overflowed and the changes in it were lost
+		unsigned char* position = reinterpret_cast<unsigned char*>(&buffers[index][0]);
+		while (bytes > 0)
+		{
+			FILE_NOTIFY_INFORMATION* notification = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(position);
+
+			if (notification->Action == FILE_ACTION_ADDED || notification->Action == FILE_ACTION_MODIFIED || notification->Action == FILE_ACTION_RENAMED_NEW_NAME)
+			{
+				int nameLength = static_cast<int>(notification->FileNameLength / sizeof(WCHAR));
+				int length = WideCharToMultiByte(CP_UTF8, 0, notification->FileName, nameLength, nullptr, 0, nullptr, nullptr);
+
+				string name(length, '\0');
+				WideCharToMultiByte(CP_UTF8, 0, notification->FileName, nameLength, &name[0], length, nullptr, nullptr);
+				AddChange(names[index] + "/" + name);
+			}
+
+			if (notification->NextEntryOffset == 0)
+				break;
+
+			position += notification->NextEntryOffset;
+		}
+
+		ReadDirectoryChangesW(directories[index], &buffers[index][0], bufferSize, FALSE, filter, nullptr, &overlapped[index], nullptr);
+	}
+
+	for (size_t i = 0; i < directories.size(); i++)
+	{
+		DWORD bytes = 0;
+		CancelIoEx(directories[i], &overlapped[i]);
+		GetOverlappedResult(directories[i], &overlapped[i], &bytes, TRUE);
+
+		CloseHandle(overlapped[i].hEvent);
+		CloseHandle(directories[i]);
+	}
+}
+#else
+void FileWatcher::Watch()
+{
+	int watcher = inotify_init1(IN_NONBLOCK);
+	if (watcher < 0)
+		return;
+
+	map<int, string> directories;
+	for (const string& directory : _directories)
+	{
+		int watch = inotify_add_watch(watcher, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+		if (watch >= 0)
+			directories[watch] = directory;
+	}
+
+	alignas(inotify_event) char buffer[16 * 1024];
+
+	while (!_stopping)
+	{
+		// Waking up every so often is what lets Shutdown stop the thread
+		pollfd descriptor = { watcher, POLLIN, 0 };
+		if (poll(&descriptor, 1, 100) <= 0)
+			continue;
+
+		ssize_t length = read(watcher, buffer, sizeof(buffer));
+		for (char* position = buffer; length > 0 && position < buffer + length;)
+		{
+			inotify_event* event = reinterpret_cast<inotify_event*>(position);
+			if (event->len > 0)
+				AddChange(directories[event->wd] + "/" + event->name);
+
+			position += sizeof(inotify_event) + event->len;
+		}
+	}
+
+	close(watcher);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+using namespace std;
+
+// Reports files written inside a set of directories, watched on a thread of the watcher's own through
+// ReadDirectoryChangesW, or inotify away from Windows. Editors often save a file in several writes, so a file is
+// only reported once it has gone the settle time without changing again, and then only once.
+class FileWatcher
+{
+private:
+	vector<string> _directories;
+	float _settleTime;
+
+	thread _watcher;
+	atomic<bool> _stopping;
+#ifdef _WIN32
+	HANDLE _stopEvent;
+#endif
+
+	mutex _changesLock;
+	map<string, chrono::steady_clock::time_point> _changes;
+
+	void Watch();
+	void AddChange(const string& path);
+
+public:
+	FileWatcher(const vector<string>& directories, float settleTime);
+	~FileWatcher();
+
+	void Shutdown();
+
+	vector<string> TakeChanges();
+};
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "ToggleTransformCommand.h"
 
-ToggleTransformCommand::ToggleTransformCommand(TransformComponent* transform) : _transform(transform)
+ToggleTransformCommand::ToggleTransformCommand(EntityManager* entityManager, EntityHandle entity) : _entityManager(entityManager), _entity(entity)
 {
 }
 
@@ -10,5 +10,10 @@ void ToggleTransformCommand::Shutdown()
 
 void ToggleTransformCommand::Execute()
 {
-	_transform->TransformEnabled = !_transform->TransformEnabled;
+	TransformComponent* transform = _entityManager->GetComponent<TransformComponent>(_entity);
+	if (transform == nullptr)
+		return;
+
+	transform->TransformEnabled = !transform->TransformEnabled;
+	transform->Wake();
 }
\ No newline at end of file
@@ -1,13 +1,15 @@
 #pragma once
 #include "ICommand.h"
+#include "../EntityManager.h"
 #include "../Components/TransformComponent.h"
 
 class ToggleTransformCommand : public ICommand
 {
-	TransformComponent* _transform;
+	EntityManager* _entityManager;
+	EntityHandle _entity;
 
 public:
-	ToggleTransformCommand(TransformComponent* transform);
+	ToggleTransformCommand(EntityManager* entityManager, EntityHandle entity);
 	~ToggleTransformCommand() override = default;
 	void Shutdown() override;
 	void Execute() override;
@@ -1,6 +1,6 @@
 #include "ToggleVisibleCommand.h"
 
-ToggleVisibleCommand::ToggleVisibleCommand(AppearanceComponent* appearance) : _appearance(appearance)
+ToggleVisibleCommand::ToggleVisibleCommand(EntityManager* entityManager, EntityHandle entity) : _entityManager(entityManager), _entity(entity)
 {
 }
 
@@ -10,5 +10,9 @@ void ToggleVisibleCommand::Shutdown()
 
 void ToggleVisibleCommand::Execute()
 {
-	_appearance->RenderEnabled = !_appearance->RenderEnabled;
+	AppearanceComponent* appearance = _entityManager->GetComponent<AppearanceComponent>(_entity);
+	if (appearance == nullptr)
+		return;
+
+	appearance->RenderEnabled = !appearance->RenderEnabled;
 }
\ No newline at end of file
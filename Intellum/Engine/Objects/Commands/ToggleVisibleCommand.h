@@ -1,13 +1,16 @@
 #pragma once
 #include "ICommand.h"
+#include "../EntityManager.h"
 #include "../Components/AppearanceComponent.h"
 
 class ToggleVisibleCommand : public ICommand
 {
 private:
-	AppearanceComponent* _appearance;
+	EntityManager* _entityManager;
+	EntityHandle _entity;
+
 public:
-	ToggleVisibleCommand(AppearanceComponent* appearance);
+	ToggleVisibleCommand(EntityManager* entityManager, EntityHandle entity);
 	~ToggleVisibleCommand() override = default;
 	void Shutdown() override;
 	void Execute() override;
@@ -0,0 +1,26 @@
+#pragma once
+#include "EntityManager.h"
+#include "../Observer/IObserver.h"
+
+// Forwards events to a component looked up through its entity's handle at notification time, so the
+// observer stays valid when the component moves between archetypes and goes quiet once the entity is destroyed.
+template<typename T>
+class ComponentObserver : public IObserver
+{
+private:
+	EntityManager* _entityManager;
+	EntityHandle _entity;
+
+public:
+	ComponentObserver(EntityManager* entityManager, EntityHandle entity) : _entityManager(entityManager), _entity(entity) {}
+	~ComponentObserver() override = default;
+
+	void Notify(ObserverEvent event) override
+	{
+		T* component = _entityManager->GetComponent<T>(_entity);
+		if (component == nullptr)
+			return;
+
+		component->Notify(event);
+	}
+};
@@ -1,42 +1,69 @@
 #pragma once
-#include "../Geometry/Geometry.h"
+#include "../Geometry/GeometryCache.h"
 #include "IComponent.h"
 #include "../../ShaderEngine/ShaderController.h"
-#include "../Texture/Texture.h"
+#include "../Texture/TextureCache.h"
+#include "../../Rendering/DrawPacket.h"
 
+// Packet is the cached draw the RenderSystem queues every frame and is only rebuilt while Dirty is set. Anything
+// that changes the model, textures, maps, color or gradient after the entity was created must set Dirty.
+//
+// Given a ModelOwner or TextureOwner, the model, textures and maps each hold a reference of their own on that cache
+// and are released when the component is shut down, so an asset is freed once the last entity using it goes.
+// Anything swapped in afterwards has to hold a reference as well, and whatever it replaces has to be released.
 class AppearanceComponent : public IComponent
 {
 public:
 	ShaderType ShaderType;
 
 	Geometry Model;
+	GeometryCache* ModelOwner;
 	vector<Texture*> Textures;
 	Texture* LightMap;
 	Texture* BumpMap;
+	TextureCache* TextureOwner;
 	ColorShaderParameters Color;
 	GradientShaderParameters Gradient;
 	bool RenderEnabled;
 
+	DrawPacket Packet;
+	bool Dirty;
+
 	AppearanceComponent()
-		: IComponent(APPEARANCE), ShaderType(SHADER_DEFAULT), Model(Geometry()), Textures(vector<Texture*>()), LightMap(nullptr), BumpMap(nullptr), Color(ColorShaderParameters()), Gradient(GradientShaderParameters()), RenderEnabled(true)
+		: IComponent(APPEARANCE), ShaderType(SHADER_DEFAULT), Model(Geometry()), ModelOwner(nullptr), Textures(vector<Texture*>()), LightMap(nullptr), BumpMap(nullptr), TextureOwner(nullptr), Color(ColorShaderParameters()), Gradient(GradientShaderParameters()), RenderEnabled(true),
+		Packet(DrawPacket()), Dirty(true)
 	{
 	}
 	
+	static ComponentType Type() { return APPEARANCE; }
+
 	~AppearanceComponent() override = default;
 
 	void Shutdown() override 
 	{
+		if (ModelOwner != nullptr)
+		{
+			ModelOwner->Release(Model);
+			Model = Geometry();
+		}
+
+		if (TextureOwner == nullptr)
+			return;
+
+		for (Texture* texture : Textures)
+			TextureOwner->Release(texture);
+
+		Textures.clear();
+
 		if (LightMap)
 		{
-			LightMap->Shutdown();
-			delete LightMap;
+			TextureOwner->Release(LightMap);
 			LightMap = nullptr;
 		}
 
 		if (BumpMap)
 		{
-			BumpMap->Shutdown();
-			delete BumpMap;
+			TextureOwner->Release(BumpMap);
 			BumpMap = nullptr;
 		}
 	}
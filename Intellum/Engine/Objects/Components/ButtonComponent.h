@@ -3,8 +3,6 @@
 #include "../Commands/ICommand.h"
 #include "../Commands/NullCommand.h"
 
-using namespace DirectX;
-
 class ButtonComponent : public IComponent
 {
 public:
@@ -14,6 +12,8 @@ public:
 	{
 	}
 
+	static ComponentType Type() { return BUTTON; }
+
 	~ButtonComponent() override = default;
 
 	void Shutdown() override
@@ -3,8 +3,6 @@
 #include "../Commands/ICommand.h"
 #include "../Commands/NullCommand.h"
 
-using namespace DirectX;
-
 enum CollisionType
 {
 	CURSOR
@@ -20,6 +18,8 @@ public:
 	{
 	}
 
+	static ComponentType Type() { return COLLISION; }
+
 	~CollisionComponent() override = default;
 
 	void Shutdown() override
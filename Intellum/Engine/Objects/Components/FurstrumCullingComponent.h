@@ -10,5 +10,7 @@ public:
 	FrustrumCullingComponent() 
 		: IComponent(FRUSTRUM_CULLING), CullingType(FRUSTRUM_CULL_RECTANGLE) {}
 
+	static ComponentType Type() { return FRUSTRUM_CULLING; }
+
 	void Shutdown() override {};
 };
\ No newline at end of file
@@ -1,6 +1,4 @@
 #pragma once
-#include <string>
-#include <DirectXMath.h>
 
 enum ComponentType
 {
@@ -12,7 +10,8 @@ enum ComponentType
 	TEXT,
 	BUTTON,
 	INPUT_COMPONENT,
-	COLLISION
+	COLLISION,
+	COMPONENT_TYPE_COUNT
 };
 
 class IComponent
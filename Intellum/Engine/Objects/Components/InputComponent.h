@@ -1,4 +1,5 @@
 #pragma once
+#include <vector>
 #include "IComponent.h"
 #include "../../Input/ControlCommand.h"
 
@@ -10,6 +11,9 @@ public:
 	vector<ControlCommand> ControlCommands;
 
 	InputComponent() : IComponent(INPUT_COMPONENT) {}
+
+	static ComponentType Type() { return INPUT_COMPONENT; }
+
 	~InputComponent() override = default;
 
 	void Shutdown() override {}
@@ -1,14 +1,19 @@
 #pragma once
 #include <d3d11.h>
+#include "IComponent.h"
 
+// Changing the fill or cull mode after creation must set Dirty so the entity's draw packet is rebuilt
 class RasterizerComponent : public IComponent
 {
 public:
 	D3D11_FILL_MODE FillMode;
 	D3D11_CULL_MODE CullMode;
+	bool Dirty;
 
 	RasterizerComponent()
-		: IComponent(RASTERIZER), FillMode(D3D11_FILL_SOLID), CullMode(D3D11_CULL_BACK) {}
+		: IComponent(RASTERIZER), FillMode(D3D11_FILL_SOLID), CullMode(D3D11_CULL_BACK), Dirty(true) {}
+
+	static ComponentType Type() { return RASTERIZER; }
 
 	~RasterizerComponent() override = default;
 
@@ -11,11 +11,14 @@ public:
 	string Text;
 	int FontSize;
 	XMFLOAT2 FontPosition;
+	XMFLOAT2 PreviousFontPosition;
 	XMFLOAT4 Color;
 	vector<TextTexture> TextEntity;
 
 	TextComponent()
-		: IComponent(TEXT), Text(""), FontSize(0), FontPosition(0, 0), Color(XMFLOAT4(0, 0, 0, 0)) {}
+		: IComponent(TEXT), Text(""), FontSize(0), FontPosition(0, 0), PreviousFontPosition(0, 0), Color(XMFLOAT4(0, 0, 0, 0)) {}
+
+	static ComponentType Type() { return TEXT; }
 
 	~TextComponent() override = default;
 	void Shutdown() override {}
@@ -42,5 +45,10 @@ public:
 			int renderCount = observerEvent.GetObservableData<int>();
 			Text = "Rendered: " + to_string(renderCount);
 		}
+		else if (observerEvent.EventType == CONSTANT_BYTES)
+		{
+			int constantBytes = observerEvent.GetObservableData<int>();
+			Text = "Constants: " + to_string(constantBytes) + " bytes";
+		}
 	}
 };
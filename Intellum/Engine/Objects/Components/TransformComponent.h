@@ -2,14 +2,30 @@
 #include "IComponent.h"
 #include <DirectXMath.h>
 #include "../../Observer/IObserver.h"
+#include "../EntityHandle.h"
 
 using namespace std;
 using namespace DirectX;
 
+// Static transforms are never simulated. Active transforms fall asleep once they have been at rest for a while
+// and wake again as soon as they are given a velocity or Wake is called.
+enum SimulationState
+{
+	SIMULATION_ACTIVE,
+	SIMULATION_SLEEPING,
+	SIMULATION_STATIC
+};
+
+// Transformation and WorldPosition are in world space and are only recomposed by the TransformSystem when the
+// transform or one of its parents changes. Anything that writes Position, Rotation or Scale outside of the
+// TransformSystem must set Dirty. RenderTransformation is what gets drawn: the world matrix blended between the
+// last two simulation steps for anything that moved on the last one, and Transformation for everything else.
 class TransformComponent : public IComponent, public IObserver
 {
 public:
 	XMMATRIX Transformation;
+	XMMATRIX RenderTransformation;
+	XMFLOAT3 WorldPosition;
 
 	XMFLOAT3 Position;
 	XMFLOAT3 Rotation;
@@ -19,12 +35,55 @@ public:
 	XMFLOAT3 AngularVelocity;
 	bool TransformEnabled;
 
+	XMFLOAT3 PreviousPosition;
+	XMFLOAT3 PreviousRotation;
+	bool Moving;
+
+	SimulationState Simulation;
+	float RestingTime;
+	float PendingDelta;
+
+	EntityHandle Parent;
+	bool HasParent;
+	bool ParentChanged;
+	bool Dirty;
+	unsigned int WorldVersion;
+
 	TransformComponent() 
-		: IComponent(TRANSFORM), Position(0, 0, 0), Rotation(0, 0, 0), Scale(1, 1, 1), Velocity(0, 0, 0), AngularVelocity(0, 0, 0), TransformEnabled(true) {}
+		: IComponent(TRANSFORM), WorldPosition(0, 0, 0), Position(0, 0, 0), Rotation(0, 0, 0), Scale(1, 1, 1), Velocity(0, 0, 0), AngularVelocity(0, 0, 0), TransformEnabled(true),
+		PreviousPosition(0, 0, 0), PreviousRotation(0, 0, 0), Moving(false),
+		Simulation(SIMULATION_ACTIVE), RestingTime(0.0f), PendingDelta(0.0f), HasParent(false), ParentChanged(false), Dirty(true), WorldVersion(0) {}
+
+	static ComponentType Type() { return TRANSFORM; }
 
 	~TransformComponent() override = default;
 
 	void Shutdown() override {}
+
+	// Position, Rotation and Scale become relative to the parent's transform
+	void SetParent(EntityHandle parent)
+	{
+		Parent = parent;
+		HasParent = true;
+		ParentChanged = true;
+		Dirty = true;
+	}
+
+	void ClearParent()
+	{
+		HasParent = false;
+		ParentChanged = true;
+		Dirty = true;
+	}
+
+	void Wake()
+	{
+		if (Simulation == SIMULATION_SLEEPING)
+			Simulation = SIMULATION_ACTIVE;
+
+		RestingTime = 0.0f;
+	}
+
 	void Notify(ObserverEvent event) override 
 	{
 		if (TransformEnabled == false)
@@ -34,6 +93,7 @@ public:
 		{
 			XMFLOAT2 mousePosition = event.GetObservableData<XMFLOAT2>();
 			Position = XMFLOAT3(Position.x + mousePosition.x, Position.y + mousePosition.y, 0);
+			Dirty = true;
 		}
 	}
 };
\ No newline at end of file
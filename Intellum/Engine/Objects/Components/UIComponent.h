@@ -1,4 +1,5 @@
 #pragma once
+#include <DirectXMath.h>
 #include "IComponent.h"
 
 using namespace DirectX;
@@ -13,6 +14,8 @@ public:
 
 	UIComponent() : IComponent(USER_INTERFACE) { }
 
+	static ComponentType Type() { return USER_INTERFACE; }
+
 	~UIComponent() override = default;
 
 	void Shutdown() override { }
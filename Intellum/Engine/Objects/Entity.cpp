@@ -1,58 +1,24 @@
 #include "Entity.h"
-#include <d3d11.h>
 
-Entity::Entity()
+Entity::Entity(EntityHandle handle, EntityManager* manager) : _handle(handle), _manager(manager), _archetype(nullptr), _row(-1)
 {
-	Initialise();
 }
 
 Entity::~Entity()
 {
 }
 
-void Entity::Shutdown()
+EntityHandle Entity::GetHandle() const
 {
-	for (unsigned long long i = _components.size(); i > 0; i--)
-	{
-		_components.back()->Shutdown();
-		_components.pop_back();
-	}
-
-	_components.clear();
-}
-
-void Entity::Initialise()
-{
-	GUID id;
-	_id = CoCreateGuid(&id);
-}
-
-void Entity::AddComponent(IComponent* component)
-{
-	_components.push_back(component);
+	return _handle;
 }
 
 void Entity::RemoveComponent(ComponentType component)
 {
-	for (int i = 0; i < _components.size(); i++)
-	{
-		if (_components.at(i)->Name != component)
-			continue;
-
-		_components.erase(_components.begin() + i);
-		return;
-	}
+	_manager->RemoveComponent(this, component);
 }
 
-IComponent* Entity::GetComponent(ComponentType component)
+IComponent* Entity::GetComponent(ComponentType component) const
 {
-	for (int i = 0; i < _components.size(); i++)
-	{
-		if (_components.at(i)->Name != component)
-			continue;
-
-		return _components.at(i);
-	}
-
-	return nullptr;
+	return _manager->GetComponent(const_cast<Entity*>(this), component);
 }
\ No newline at end of file
@@ -1,25 +1,35 @@
 #pragma once
-#include <vector>
 #include "Components/IComponent.h"
-
-using namespace std;
+#include "EntityManager.h"
 
 class Entity
 {
-private:
-	int _id;
-	vector<IComponent*> _components;
+	friend class EntityManager;
 
 private:
-	void Initialise();
+	EntityHandle _handle;
+	EntityManager* _manager;
+	Archetype* _archetype;
+	int _row;
 
 public:
-	Entity();
+	Entity(EntityHandle handle, EntityManager* manager);
 	~Entity();
 
-	void Shutdown();
+	EntityHandle GetHandle() const;
+
+	template<typename T>
+	T* AddComponent(const T& component)
+	{
+		return _manager->AddComponent<T>(this, component);
+	}
+
+	template<typename T>
+	T* GetComponent() const
+	{
+		return _manager->GetComponent<T>(const_cast<Entity*>(this));
+	}
 
-	void AddComponent(IComponent* component);
 	void RemoveComponent(ComponentType component);
-	IComponent* GetComponent(ComponentType component);
+	IComponent* GetComponent(ComponentType component) const;
 };
\ No newline at end of file
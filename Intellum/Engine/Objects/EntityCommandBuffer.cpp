@@ -0,0 +1,134 @@
+#include "EntityCommandBuffer.h"
+
+EntityCommandBuffer::EntityCommandBuffer() : _deferredEntityCount(0), _batch(1)
+{
+}
+
+EntityCommandBuffer::~EntityCommandBuffer()
+{
+}
+
+void EntityCommandBuffer::Shutdown()
+{
+	Clear();
+}
+
+void EntityCommandBuffer::Clear()
+{
+	lock_guard<mutex> lock(_commandLock);
+
+	for (IEntityCommand* command : _commands)
+	{
+		command->Discard();
+		delete command;
+	}
+
+	_commands.clear();
+	NextBatch();
+}
+
+// Must be called while holding _commandLock. Batch 0 is never used, so a default constructed handle never names
+// a deferred entity.
+void EntityCommandBuffer::NextBatch()
+{
+	_deferredEntityCount = 0;
+	_batch = (_batch + 1) % DEFERRED_BATCH_COUNT;
+
+	if (_batch == 0)
+		_batch = 1;
+}
+
+void EntityCommandBuffer::Record(IEntityCommand* command, EntityHandle target)
+{
+	command->Target = target;
+
+	lock_guard<mutex> lock(_commandLock);
+	_commands.push_back(command);
+}
+
+EntityHandle EntityCommandBuffer::CreateEntity()
+{
+	IEntityCommand* command = new CreateEntityCommand();
+
+	lock_guard<mutex> lock(_commandLock);
+	unsigned int batch = _deferredEntityCount < DEFERRED_ENTITY_LIMIT ? _batch : 0;
+	command->Target = EntityHandle(batch << DEFERRED_INDEX_BITS | _deferredEntityCount++ % DEFERRED_ENTITY_LIMIT, 0);
+	_commands.push_back(command);
+
+	return command->Target;
+}
+
+void EntityCommandBuffer::DestroyEntity(EntityHandle entity)
+{
+	Record(new DestroyEntityCommand(), entity);
+}
+
+void EntityCommandBuffer::RemoveComponent(EntityHandle entity, ComponentType component)
+{
+	RemoveComponentCommand* command = new RemoveComponentCommand();
+	command->Component = component;
+	Record(command, entity);
+}
+
+bool EntityCommandBuffer::IsDeferred(EntityHandle entity)
+{
+	return entity.Generation == 0;
+}
+
+bool EntityCommandBuffer::IsEmpty()
+{
+	lock_guard<mutex> lock(_commandLock);
+	return _commands.empty();
+}
+
+// Commands are applied in the order they were recorded. Commands aimed at an entity that has already been
+// destroyed, or at a deferred handle this batch did not hand out, are dropped, and any component they carried is
+// shut down.
+void EntityCommandBuffer::Playback(EntityManager* entityManager)
+{
+	vector<IEntityCommand*> commands;
+	unsigned int deferredEntityCount;
+	unsigned int batch;
+
+	{
+		lock_guard<mutex> lock(_commandLock);
+		commands.swap(_commands);
+		deferredEntityCount = _deferredEntityCount < DEFERRED_ENTITY_LIMIT ? _deferredEntityCount : DEFERRED_ENTITY_LIMIT;
+		batch = _batch;
+		NextBatch();
+	}
+
+	vector<EntityHandle> createdEntities(deferredEntityCount);
+
+	for (IEntityCommand* command : commands)
+	{
+		EntityHandle target = command->Target;
+
+		if (IsDeferred(target))
+		{
+			// A deferred handle from another batch, or one whose create has not been played back yet, names no
+			// entity
+			unsigned int index = target.Index % DEFERRED_ENTITY_LIMIT;
+			if (target.Index >> DEFERRED_INDEX_BITS != batch || index >= deferredEntityCount)
+			{
+				command->Discard();
+				delete command;
+				continue;
+			}
+
+			if (command->CreatesEntity())
+				createdEntities[index] = entityManager->CreateEntity()->GetHandle();
+
+			target = createdEntities[index];
+		}
+
+		Entity* entity = IsDeferred(target) ? nullptr : entityManager->GetEntity(target);
+
+		if (entity == nullptr)
+			command->Discard();
+		else
+			command->Playback(entityManager, entity);
+
+		delete command;
+	}
+}
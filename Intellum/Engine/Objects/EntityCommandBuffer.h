@@ -0,0 +1,97 @@
+#pragma once
+#include <mutex>
+#include <vector>
+#include "EntityManager.h"
+#include "Entity.h"
+
+using namespace std;
+
+// Records structural changes from any thread and applies them in one batch at a sync point, so systems never
+// move or destroy entities while the archetypes they are iterating are in use. Entities created through the
+// buffer are referred to by a deferred handle (generation 0) until playback turns it into a real entity. A
+// deferred handle is stamped with the batch it was created in, the span of commands up to the next playback or
+// clear, and commands aimed at one from any other batch are dropped. A batch hands out at most
+// DEFERRED_ENTITY_LIMIT deferred handles; creates past that are dropped at playback.
+class EntityCommandBuffer
+{
+private:
+	class IEntityCommand
+	{
+	public:
+		virtual ~IEntityCommand() {}
+		virtual void Playback(EntityManager* entityManager, Entity* entity) = 0;
+		virtual void Discard() {}
+		virtual bool CreatesEntity() const { return false; }
+
+		EntityHandle Target;
+	};
+
+	class CreateEntityCommand : public IEntityCommand
+	{
+	public:
+		void Playback(EntityManager*, Entity*) override {}
+		bool CreatesEntity() const override { return true; }
+	};
+
+	class DestroyEntityCommand : public IEntityCommand
+	{
+	public:
+		void Playback(EntityManager* entityManager, Entity* entity) override { entityManager->DestroyEntity(entity); }
+	};
+
+	class RemoveComponentCommand : public IEntityCommand
+	{
+	public:
+		ComponentType Component;
+
+		void Playback(EntityManager* entityManager, Entity* entity) override { entityManager->RemoveComponent(entity, Component); }
+	};
+
+	template<typename T>
+	class AddComponentCommand : public IEntityCommand
+	{
+	public:
+		T Component;
+
+		AddComponentCommand(const T& component) : Component(component) {}
+
+		void Playback(EntityManager* entityManager, Entity* entity) override { entityManager->AddComponent<T>(entity, Component); }
+		void Discard() override { Component.Shutdown(); }
+	};
+
+	static const unsigned int DEFERRED_INDEX_BITS = 20;
+	static const unsigned int DEFERRED_BATCH_COUNT = 1u << (32 - DEFERRED_INDEX_BITS);
+
+	mutex _commandLock;
+	vector<IEntityCommand*> _commands;
+	unsigned int _deferredEntityCount;
+	unsigned int _batch;
+
+	void Record(IEntityCommand* command, EntityHandle target);
+	void NextBatch();
+
+public:
+	static const unsigned int DEFERRED_ENTITY_LIMIT = 1u << DEFERRED_INDEX_BITS;
+
+	EntityCommandBuffer();
+	~EntityCommandBuffer();
+
+	void Shutdown();
+	void Clear();
+
+	EntityHandle CreateEntity();
+	void DestroyEntity(EntityHandle entity);
+
+	template<typename T>
+	void AddComponent(EntityHandle entity, const T& component)
+	{
+		Record(new AddComponentCommand<T>(component), entity);
+	}
+
+	void RemoveComponent(EntityHandle entity, ComponentType component);
+
+	static bool IsDeferred(EntityHandle entity);
+	bool IsEmpty();
+
+	void Playback(EntityManager* entityManager);
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+// Refers to an entity by its slot index and the generation of that slot. Destroying an entity bumps the
+// generation, so stale handles to a reused slot stop resolving instead of silently pointing at a new entity.
+struct EntityHandle
+{
+	unsigned int Index;
+	unsigned int Generation;
+
+	EntityHandle() : Index(0), Generation(0) {}
+	EntityHandle(unsigned int index, unsigned int generation) : Index(index), Generation(generation) {}
+
+	bool operator==(const EntityHandle& other) const { return Index == other.Index && Generation == other.Generation; }
+	bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
@@ -0,0 +1,323 @@
+#include "EntityManager.h"
+#include "Entity.h"
+#include "EntityCommandBuffer.h"
+
+EntityManager::EntityManager() : _commandBuffer(new EntityCommandBuffer())
+{
+	for (int i = 0; i < COMPONENT_TYPE_COUNT; i++)
+		_pools[i] = nullptr;
+}
+
+EntityManager::~EntityManager()
+{
+}
+
+void EntityManager::Shutdown()
+{
+	if (_commandBuffer)
+	{
+		_commandBuffer->Shutdown();
+		delete _commandBuffer;
+		_commandBuffer = nullptr;
+	}
+
+	Clear();
+
+	for (Archetype* archetype : _archetypes)
+	{
+		archetype->Shutdown();
+		delete archetype;
+	}
+
+	_archetypes.clear();
+	_archetypeLookup.clear();
+	_matchingArchetypes.clear();
+
+	for (int i = 0; i < COMPONENT_TYPE_COUNT; i++)
+	{
+		if (_pools[i])
+		{
+			_pools[i]->Shutdown();
+			delete _pools[i];
+			_pools[i] = nullptr;
+		}
+	}
+}
+
+// Unloads the scene in bulk. Every component is shut down and its chunk handed back to its pool, while the
+// archetypes, cached queries and pooled memory are kept for the next scene to reuse.
+void EntityManager::Clear()
+{
+	if (_commandBuffer)
+		_commandBuffer->Clear();
+
+	for (Archetype* archetype : _archetypes)
+		archetype->Clear();
+
+	for (Entity* entity : _entities)
+	{
+		ReleaseSlot(entity);
+		delete entity;
+	}
+
+	_entities.clear();
+}
+
+EntityCommandBuffer* EntityManager::GetCommandBuffer() const
+{
+	return _commandBuffer;
+}
+
+void EntityManager::PlaybackCommands()
+{
+	_commandBuffer->Playback(this);
+}
+
+Entity* EntityManager::CreateEntity()
+{
+	Entity* entity = AllocateEntity();
+
+	Archetype* archetype = GetEmptyArchetype();
+	entity->_archetype = archetype;
+	entity->_row = archetype->AddEntity(entity);
+
+	return entity;
+}
+
+// Places count new entities straight into the archetype without migrating them one component at a time. Their
+// component rows are left for the caller to append, in order, to every column of the archetype before anything
+// else reads it.
+void EntityManager::CreateEntities(Archetype* archetype, int count, vector<Entity*>& createdEntities)
+{
+	_entities.reserve(_entities.size() + count);
+	createdEntities.reserve(createdEntities.size() + count);
+
+	for (int i = 0; i < count; i++)
+	{
+		Entity* entity = AllocateEntity();
+		entity->_archetype = archetype;
+		entity->_row = archetype->AddEntity(entity);
+		createdEntities.push_back(entity);
+	}
+}
+
+void EntityManager::DestroyEntity(Entity* entity)
+{
+	Archetype* archetype = entity->_archetype;
+
+	for (ComponentType component : archetype->GetComponentTypes())
+		archetype->GetColumn(component)->Get(entity->_row)->Shutdown();
+
+	Entity* movedEntity = archetype->RemoveRow(entity->_row);
+	if (movedEntity != nullptr)
+		movedEntity->_row = entity->_row;
+
+	int denseIndex = _slots[entity->_handle.Index].DenseIndex;
+	Entity* lastEntity = _entities.back();
+	_entities[denseIndex] = lastEntity;
+	_slots[lastEntity->_handle.Index].DenseIndex = denseIndex;
+	_entities.pop_back();
+
+	ReleaseSlot(entity);
+	delete entity;
+}
+
+void EntityManager::DestroyEntity(EntityHandle handle)
+{
+	Entity* entity = GetEntity(handle);
+	if (entity != nullptr)
+		DestroyEntity(entity);
+}
+
+Entity* EntityManager::GetEntity(EntityHandle handle) const
+{
+	if (IsAlive(handle) == false)
+		return nullptr;
+
+	return _entities[_slots[handle.Index].DenseIndex];
+}
+
+bool EntityManager::IsAlive(EntityHandle handle) const
+{
+	return handle.Index < _slots.size() && _slots[handle.Index].Generation == handle.Generation;
+}
+
+Entity* EntityManager::AllocateEntity()
+{
+	unsigned int index;
+
+	if (_freeSlots.empty())
+	{
+		index = static_cast<unsigned int>(_slots.size());
+		EntitySlot slot;
+		slot.Generation = 1;
+		_slots.push_back(slot);
+	}
+	else
+	{
+		index = _freeSlots.back();
+		_freeSlots.pop_back();
+	}
+
+	EntitySlot& slot = _slots[index];
+	slot.DenseIndex = static_cast<int>(_entities.size());
+
+	Entity* entity = new Entity(EntityHandle(index, slot.Generation), this);
+	_entities.push_back(entity);
+
+	return entity;
+}
+
+void EntityManager::ReleaseSlot(Entity* entity)
+{
+	EntitySlot& slot = _slots[entity->_handle.Index];
+	slot.DenseIndex = -1;
+	slot.Generation++;
+
+	if (slot.Generation == 0)
+		slot.Generation = 1;
+
+	_freeSlots.push_back(entity->_handle.Index);
+}
+
+void EntityManager::RemoveComponent(Entity* entity, ComponentType component)
+{
+	Archetype* source = entity->_archetype;
+	if (source->HasComponents(MaskOf(component)) == false)
+		return;
+
+	Archetype* destination = FindOrCreateArchetype(source, source->GetMask() & ~MaskOf(component), nullptr);
+	MoveEntity(entity, destination);
+}
+
+IComponent* EntityManager::GetComponent(Entity* entity, ComponentType component) const
+{
+	IComponentArray* column = entity->_archetype->GetColumn(component);
+	if (column == nullptr)
+		return nullptr;
+
+	return column->Get(entity->_row);
+}
+
+IComponent* EntityManager::GetComponent(EntityHandle handle, ComponentType component) const
+{
+	Entity* entity = GetEntity(handle);
+	if (entity == nullptr)
+		return nullptr;
+
+	return GetComponent(entity, component);
+}
+
+Archetype* EntityManager::GetEmptyArchetype()
+{
+	return FindOrCreateArchetype(nullptr, 0, nullptr);
+}
+
+const vector<Entity*>& EntityManager::GetEntities() const
+{
+	return _entities;
+}
+
+const vector<Archetype*>& EntityManager::GetArchetypes() const
+{
+	return _archetypes;
+}
+
+ComponentPool* EntityManager::GetPool(ComponentType component) const
+{
+	return _pools[component];
+}
+
+// Matching archetype lists are built once per mask and then kept up to date as new archetypes appear, so
+// queries never rescan the archetypes. Entities moving between archetypes need no bookkeeping at all.
+const vector<Archetype*>& EntityManager::GetMatchingArchetypes(ComponentMask mask)
+{
+	lock_guard<mutex> lock(_matchingArchetypesLock);
+
+	map<ComponentMask, vector<Archetype*>>::iterator iterator = _matchingArchetypes.find(mask);
+	if (iterator != _matchingArchetypes.end())
+		return iterator->second;
+
+	vector<Archetype*>& matchingArchetypes = _matchingArchetypes[mask];
+
+	for (Archetype* archetype : _archetypes)
+	{
+		if (archetype->HasComponents(mask))
+			matchingArchetypes.push_back(archetype);
+	}
+
+	return matchingArchetypes;
+}
+
+Archetype* EntityManager::FindOrCreateArchetype(Archetype* source, ComponentMask mask, const IComponentArray* addedColumn)
+{
+	map<ComponentMask, Archetype*>::iterator iterator = _archetypeLookup.find(mask);
+	if (iterator != _archetypeLookup.end())
+		return iterator->second;
+
+	Archetype* archetype = new Archetype(mask);
+
+	if (source != nullptr)
+	{
+		for (ComponentType component : source->GetComponentTypes())
+		{
+			if (MaskContains(mask, MaskOf(component)))
+				archetype->AddColumn(source->GetColumn(component)->CreateEmpty());
+		}
+	}
+
+	if (addedColumn != nullptr)
+		archetype->AddColumn(addedColumn->CreateEmpty());
+
+	_archetypes.push_back(archetype);
+	_archetypeLookup[mask] = archetype;
+
+	lock_guard<mutex> lock(_matchingArchetypesLock);
+
+	for (map<ComponentMask, vector<Archetype*>>::iterator iterator = _matchingArchetypes.begin(); iterator != _matchingArchetypes.end(); ++iterator)
+	{
+		if (archetype->HasComponents(iterator->first))
+			iterator->second.push_back(archetype);
+	}
+
+	return archetype;
+}
+
+// Copies every component the destination also has into the destination archetype. Components the destination
+// does not have are shut down. Any component being added is left for the caller to append at the returned row.
+int EntityManager::MoveEntity(Entity* entity, Archetype* destination)
+{
+	Archetype* source = entity->_archetype;
+	int sourceRow = entity->_row;
+	int destinationRow = destination->AddEntity(entity);
+
+	for (ComponentType component : source->GetComponentTypes())
+	{
+		IComponentArray* sourceColumn = source->GetColumn(component);
+		IComponentArray* destinationColumn = destination->GetColumn(component);
+
+		if (destinationColumn == nullptr)
+			sourceColumn->Get(sourceRow)->Shutdown();
+		else
+			sourceColumn->MoveRowTo(sourceRow, destinationColumn);
+	}
+
+	Entity* movedEntity = source->RemoveRow(sourceRow);
+	if (movedEntity != nullptr)
+		movedEntity->_row = sourceRow;
+
+	entity->_archetype = destination;
+	entity->_row = destinationRow;
+
+	return destinationRow;
+}
+
+Archetype* EntityManager::GetArchetypeOf(Entity* entity)
+{
+	return entity->_archetype;
+}
+
+int EntityManager::GetRowOf(Entity* entity)
+{
+	return entity->_row;
+}
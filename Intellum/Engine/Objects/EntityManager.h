@@ -0,0 +1,118 @@
+#pragma once
+#include <map>
+#include <mutex>
+#include <vector>
+#include "EntityHandle.h"
+#include "Storage/Archetype.h"
+
+using namespace std;
+
+class Entity;
+class EntityCommandBuffer;
+
+class EntityManager
+{
+private:
+	struct EntitySlot
+	{
+		unsigned int Generation;
+		int DenseIndex;
+	};
+
+	vector<EntitySlot> _slots;
+	vector<unsigned int> _freeSlots;
+	vector<Entity*> _entities;
+	vector<Archetype*> _archetypes;
+	map<ComponentMask, Archetype*> _archetypeLookup;
+	map<ComponentMask, vector<Archetype*>> _matchingArchetypes;
+	mutex _matchingArchetypesLock;
+	ComponentPool* _pools[COMPONENT_TYPE_COUNT];
+	EntityCommandBuffer* _commandBuffer;
+
+	Archetype* FindOrCreateArchetype(Archetype* source, ComponentMask mask, const IComponentArray* addedColumn);
+	int MoveEntity(Entity* entity, Archetype* destination);
+	Entity* AllocateEntity();
+	void ReleaseSlot(Entity* entity);
+
+	static Archetype* GetArchetypeOf(Entity* entity);
+	static int GetRowOf(Entity* entity);
+
+	template<typename T>
+	ComponentPool* GetPool()
+	{
+		if (_pools[T::Type()] == nullptr)
+			_pools[T::Type()] = new ComponentPool(T::Type(), ComponentArray<T>::GetChunkBytes());
+
+		return _pools[T::Type()];
+	}
+
+public:
+	EntityManager();
+	~EntityManager();
+
+	void Shutdown();
+	void Clear();
+
+	EntityCommandBuffer* GetCommandBuffer() const;
+	void PlaybackCommands();
+
+	Entity* CreateEntity();
+	void CreateEntities(Archetype* archetype, int count, vector<Entity*>& createdEntities);
+	void DestroyEntity(Entity* entity);
+	void DestroyEntity(EntityHandle handle);
+
+	Entity* GetEntity(EntityHandle handle) const;
+	bool IsAlive(EntityHandle handle) const;
+
+	template<typename T>
+	T* AddComponent(Entity* entity, const T& component)
+	{
+		Archetype* source = GetArchetypeOf(entity);
+
+		if (source->HasComponents(MaskOf(T::Type())))
+		{
+			T* existingComponent = source->GetColumn<T>()->At(GetRowOf(entity));
+			existingComponent->Shutdown();
+			*existingComponent = component;
+			return existingComponent;
+		}
+
+		ComponentArray<T> prototype(GetPool<T>());
+		Archetype* destination = FindOrCreateArchetype(source, source->GetMask() | MaskOf(T::Type()), &prototype);
+		int row = MoveEntity(entity, destination);
+
+		ComponentArray<T>* column = destination->GetColumn<T>();
+		column->Add(component);
+		return column->At(row);
+	}
+
+	Archetype* GetEmptyArchetype();
+
+	template<typename T>
+	Archetype* GetArchetypeWith(Archetype* source)
+	{
+		ComponentArray<T> prototype(GetPool<T>());
+		return FindOrCreateArchetype(source, source->GetMask() | MaskOf(T::Type()), &prototype);
+	}
+
+	void RemoveComponent(Entity* entity, ComponentType component);
+	IComponent* GetComponent(Entity* entity, ComponentType component) const;
+	IComponent* GetComponent(EntityHandle handle, ComponentType component) const;
+
+	template<typename T>
+	T* GetComponent(Entity* entity) const
+	{
+		return static_cast<T*>(GetComponent(entity, T::Type()));
+	}
+
+	template<typename T>
+	T* GetComponent(EntityHandle handle) const
+	{
+		return static_cast<T*>(GetComponent(handle, T::Type()));
+	}
+
+	const vector<Entity*>& GetEntities() const;
+	const vector<Archetype*>& GetArchetypes() const;
+	const vector<Archetype*>& GetMatchingArchetypes(ComponentMask mask);
+	ComponentPool* GetPool(ComponentType component) const;
+};
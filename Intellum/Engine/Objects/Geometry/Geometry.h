@@ -15,19 +15,4 @@ struct Geometry
 	UINT IndexCount;
 
 	XMFLOAT3 Size;
-
-	void Shutdown()
-	{
-		if(VertexBuffer)
-		{
-			VertexBuffer->Release();
-			VertexBuffer = nullptr;
-		}
-
-		if(IndexBuffer)
-		{
-			IndexBuffer->Release();
-			IndexBuffer = nullptr;
-		}
-	}
 };
@@ -1,6 +1,6 @@
 #include "GeometryBuilder.h"
 
-GeometryBuilder::GeometryBuilder(ID3D11Device* device) : _device(device), _gridBuilder(GridBuilder(device))
+GeometryBuilder::GeometryBuilder(IRenderDevice* renderDevice) : _renderDevice(renderDevice), _gridBuilder(GridBuilder(renderDevice))
 {
 }
 
@@ -10,7 +10,12 @@ GeometryBuilder::~GeometryBuilder()
 
 Geometry GeometryBuilder::FromFile(char* string) const
 {
-	return OBJLoader::Load(string, _device);
+	return OBJLoader::Load(string, _renderDevice);
+}
+
+Geometry GeometryBuilder::FromMeshData(const MeshData& mesh) const
+{
+	return OBJLoader::Upload(mesh, _renderDevice);
 }
 
 Geometry GeometryBuilder::ForGrid(Box gridSize, XMFLOAT2 cellCount) const
@@ -25,7 +30,6 @@ Geometry GeometryBuilder::Cube() const
 	cubeGeometry.IndexCount = 36;
 	cubeGeometry.VBStride = sizeof(Vertex);
 	cubeGeometry.VBOffset = 0;
-	HRESULT hr;
 
 	// Create vertex buffer
 	Vertex vertices[] =
@@ -61,21 +65,7 @@ Geometry GeometryBuilder::Cube() const
 		{ XMFLOAT3(-1.0f, 1.0f, 1.0f), XMFLOAT2(1.0f, 0.0f), XMFLOAT3(-1.0f, 1.0f, 1.0f) },
 	};
 
-	D3D11_BUFFER_DESC bd;
-	ZeroMemory(&bd, sizeof(bd));
-	bd.Usage = D3D11_USAGE_DEFAULT;
-	bd.ByteWidth = sizeof(Vertex) * 24;
-	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	bd.CPUAccessFlags = 0;
-
-	D3D11_SUBRESOURCE_DATA InitData;
-	ZeroMemory(&InitData, sizeof(InitData));
-	InitData.pSysMem = vertices;
-
-	hr = _device->CreateBuffer(&bd, &InitData, &cubeGeometry.VertexBuffer);
-
-	if (FAILED(hr))
-		throw Exception("Failed to create the vertex buffer.");
+	cubeGeometry.VertexBuffer = _renderDevice->CreateBuffer(BUFFER_VERTEX, vertices, sizeof(Vertex) * 24, false);
 
 	// Create index buffer
 	WORD indices[] =
@@ -99,18 +89,7 @@ Geometry GeometryBuilder::Cube() const
 		23, 20, 22
 	};
 
-	ZeroMemory(&bd, sizeof(bd));
-	bd.Usage = D3D11_USAGE_DEFAULT;
-	bd.ByteWidth = sizeof(WORD) * 36;
-	bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	bd.CPUAccessFlags = 0;
-
-	ZeroMemory(&InitData, sizeof(InitData));
-	InitData.pSysMem = indices;
-	hr = _device->CreateBuffer(&bd, &InitData, &cubeGeometry.IndexBuffer);
-
-	if (FAILED(hr))
-		throw Exception("Failed to create the index buffer.");
+	cubeGeometry.IndexBuffer = _renderDevice->CreateBuffer(BUFFER_INDEX, indices, sizeof(WORD) * 36, false);
 
 	return cubeGeometry;
 }
@@ -118,9 +97,6 @@ Geometry GeometryBuilder::Cube() const
 Geometry GeometryBuilder::ForUI()
 {
 	Vertex* vertices;
-	D3D11_SUBRESOURCE_DATA vertexData;
-	D3D11_SUBRESOURCE_DATA indexData;
-	HRESULT result;
 
 	Geometry geometry;
 	geometry.VertexCount = 6;
@@ -141,39 +117,8 @@ Geometry GeometryBuilder::ForUI()
 		indices[i] = i;
 	}
 
-	// Setup Vertex Buffer Description
-	D3D11_BUFFER_DESC vertexBufferDesc;
-	ZeroMemory(&vertexBufferDesc, sizeof(vertexBufferDesc));
-	vertexBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-	vertexBufferDesc.ByteWidth = sizeof(Vertex) * geometry.VertexCount;
-	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vertexBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	vertexBufferDesc.MiscFlags = 0;
-	vertexBufferDesc.StructureByteStride = 0;
-
-	vertexData.pSysMem = vertices;
-	vertexData.SysMemPitch = 0;
-	vertexData.SysMemSlicePitch = 0;
-
-	result = _device->CreateBuffer(&vertexBufferDesc, &vertexData, &geometry.VertexBuffer);
-	if (FAILED(result)) throw Exception("Failed to create the vertex buffer.");
-
-	// Setup Index Buffer Description
-	D3D11_BUFFER_DESC indexBufferDesc;
-	ZeroMemory(&indexBufferDesc, sizeof(indexBufferDesc));
-	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	indexBufferDesc.ByteWidth = sizeof(WORD) * geometry.IndexCount;
-	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	indexBufferDesc.CPUAccessFlags = 0;
-	indexBufferDesc.MiscFlags = 0;
-	indexBufferDesc.StructureByteStride = 0;
-
-	indexData.pSysMem = indices;
-	indexData.SysMemPitch = 0;
-	indexData.SysMemSlicePitch = 0;
-
-	result = _device->CreateBuffer(&indexBufferDesc, &indexData, &geometry.IndexBuffer);
-	if (FAILED(result)) throw Exception("Failed to create the index buffer.");
+	geometry.VertexBuffer = _renderDevice->CreateBuffer(BUFFER_VERTEX, vertices, sizeof(Vertex) * geometry.VertexCount, true);
+	geometry.IndexBuffer = _renderDevice->CreateBuffer(BUFFER_INDEX, indices, sizeof(WORD) * geometry.IndexCount, false);
 
 	delete[] vertices;
 	vertices = nullptr;
@@ -182,4 +127,19 @@ Geometry GeometryBuilder::ForUI()
 	indices = nullptr;
 
 	return geometry;
+}
+
+void GeometryBuilder::Release(Geometry& geometry) const
+{
+	if (geometry.VertexBuffer)
+	{
+		_renderDevice->ReleaseBuffer(geometry.VertexBuffer);
+		geometry.VertexBuffer = nullptr;
+	}
+
+	if (geometry.IndexBuffer)
+	{
+		_renderDevice->ReleaseBuffer(geometry.IndexBuffer);
+		geometry.IndexBuffer = nullptr;
+	}
 }
\ No newline at end of file
@@ -1,20 +1,23 @@
 #pragma once
-#include "../../DirectX3D.h"
+#include "../../Rendering/IRenderDevice.h"
 #include "../../../loaders/OBJLoader.h"
 #include "GridBuilder.h"
 
 class GeometryBuilder
 {
 private:
-	ID3D11Device* _device;
+	IRenderDevice* _renderDevice;
 	GridBuilder _gridBuilder;
 
 public:
-	GeometryBuilder(ID3D11Device* device);
+	GeometryBuilder(IRenderDevice* renderDevice);
 	~GeometryBuilder();
 
 	Geometry FromFile(char* string) const;
+	Geometry FromMeshData(const MeshData& mesh) const;
 	Geometry ForGrid(Box gridSize, XMFLOAT2 cellCount) const;
 	Geometry Cube() const;
 	Geometry ForUI();
+
+	void Release(Geometry& geometry) const;
 };
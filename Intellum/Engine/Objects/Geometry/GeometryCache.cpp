@@ -0,0 +1,170 @@
+#include "GeometryCache.h"
+#include <cctype>
+
+namespace
+{
+	// Paths that name the same file on Windows share one entry
+	string NormalisePath(const string& path)
+	{
+		string key = path;
+		for (char& character : key)
+			character = character == '\\' ? '/' : static_cast<char>(tolower(static_cast<unsigned char>(character)));
+
+		return key;
+	}
+}
+
+GeometryCache::GeometryCache(GeometryBuilder* builder) : _builder(builder), _uniqueModels(0)
+{
+}
+
+GeometryCache::~GeometryCache()
+{
+}
+
+void GeometryCache::Shutdown()
+{
+	for (map<string, CachedGeometry>::iterator iterator = _models.begin(); iterator != _models.end(); ++iterator)
+		_builder->Release(iterator->second.Model);
+
+	_models.clear();
+	_keys.clear();
+}
+
+bool GeometryCache::TryAcquire(const string& key, Geometry& model)
+{
+	map<string, CachedGeometry>::iterator cached = _models.find(key);
+	if (cached == _models.end())
+		return false;
+
+	cached->second.References++;
+	model = cached->second.Model;
+	return true;
+}
+
+Geometry GeometryCache::Add(const string& key, Geometry model)
+{
+	CachedGeometry cached;
+	cached.Model = model;
+	cached.References = 1;
+
+	_models[key] = cached;
+	_keys[model.VertexBuffer] = key;
+	return model;
+}
+
+Geometry GeometryCache::FromFile(const string& path)
+{
+	string key = NormalisePath(path);
+
+	Geometry model;
+	if (TryAcquire(key, model))
+		return model;
+
+	return Add(key, _builder->FromFile(const_cast<char*>(path.c_str())));
+}
+
+// Only hands out a model that is already resident, leaving loading to the caller
+bool GeometryCache::TryFromFile(const string& path, Geometry& model)
+{
+	return TryAcquire(NormalisePath(path), model);
+}
+
+Geometry GeometryCache::FromMeshData(const string& path, const MeshData& mesh)
+{
+	string key = NormalisePath(path);
+
+	Geometry model;
+	if (TryAcquire(key, model))
+		return model;
+
+	return Add(key, _builder->FromMeshData(mesh));
+}
+
+Geometry GeometryCache::ForGrid(Box gridSize, XMFLOAT2 cellCount)
+{
+	string key = "#grid " + to_string(gridSize.Width) + " " + to_string(gridSize.Height) + " " + to_string(cellCount.x) + " " + to_string(cellCount.y);
+
+	Geometry model;
+	if (TryAcquire(key, model))
+		return model;
+
+	return Add(key, _builder->ForGrid(gridSize, cellCount));
+}
+
+Geometry GeometryCache::Cube()
+{
+	Geometry model;
+	if (TryAcquire("#cube", model))
+		return model;
+
+	return Add("#cube", _builder->Cube());
+}
+
+Geometry GeometryCache::ForUI()
+{
+	return Add("#ui " + to_string(_uniqueModels++), _builder->ForUI());
+}
+
+// Rebuilds the buffers behind a resident path. The cache hands out the new model from then on, and its reference
+// count carries over; the caller must move every holder of the replaced model across before discarding it.
+bool GeometryCache::Reload(const string& path, const MeshData& mesh, Geometry& replaced, Geometry& model)
+{
+	map<string, CachedGeometry>::iterator cached = _models.find(NormalisePath(path));
+	if (cached == _models.end())
+		return false;
+
+	model = _builder->FromMeshData(mesh);
+
+	replaced = cached->second.Model;
+	_keys.erase(replaced.VertexBuffer);
+	_keys[model.VertexBuffer] = cached->first;
+	cached->second.Model = model;
+
+	return true;
+}
+
+// Takes another reference to a model the cache handed out, for a second holder of it. Anything else is returned
+// as it is.
+Geometry GeometryCache::Share(const Geometry& model)
+{
+	map<ID3D11Buffer*, string>::iterator key = _keys.find(model.VertexBuffer);
+	if (model.VertexBuffer != nullptr && key != _keys.end())
+		_models.find(key->second)->second.References++;
+
+	return model;
+}
+
+void GeometryCache::Release(const Geometry& model)
+{
+	map<ID3D11Buffer*, string>::iterator key = _keys.find(model.VertexBuffer);
+	if (model.VertexBuffer == nullptr || key == _keys.end())
+		return;
+
+	map<string, CachedGeometry>::iterator cached = _models.find(key->second);
+	if (--cached->second.References > 0)
+		return;
+
+	_builder->Release(cached->second.Model);
+	_models.erase(cached);
+	_keys.erase(key);
+}
+
+void GeometryCache::Discard(Geometry& model)
+{
+	_builder->Release(model);
+}
+
+int GeometryCache::GetModelCount() const
+{
+	return static_cast<int>(_models.size());
+}
+
+int GeometryCache::GetReferenceCount(const Geometry& model) const
+{
+	map<ID3D11Buffer*, string>::const_iterator key = _keys.find(model.VertexBuffer);
+	if (model.VertexBuffer == nullptr || key == _keys.end())
+		return 0;
+
+	return _models.find(key->second)->second.References;
+}
\ No newline at end of file
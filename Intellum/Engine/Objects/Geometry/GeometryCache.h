@@ -0,0 +1,51 @@
+#pragma once
+#include <map>
+#include <string>
+#include "GeometryBuilder.h"
+
+using namespace std;
+
+// Hands out a single shared copy of each mesh, keyed by its source path, so a model used by many entities is
+// only parsed and uploaded once. The buffers belong to the cache: every model it hands out, or taken again through
+// Share, is given back through Release and freed once its last holder has done so, with anything still held freed
+// at Shutdown. UI quads are rewritten per element by the UISystem so each ForUI call builds its own model, but it
+// is released the same way.
+// A model the cache no longer tracks, such as the one replaced by Reload, is freed through Discard.
+class GeometryCache
+{
+private:
+	struct CachedGeometry
+	{
+		Geometry Model;
+		int References;
+	};
+
+	GeometryBuilder* _builder;
+	map<string, CachedGeometry> _models;
+	map<ID3D11Buffer*, string> _keys;
+	unsigned int _uniqueModels;
+
+	bool TryAcquire(const string& key, Geometry& model);
+	Geometry Add(const string& key, Geometry model);
+
+public:
+	GeometryCache(GeometryBuilder* builder);
+	~GeometryCache();
+
+	void Shutdown();
+
+	Geometry FromFile(const string& path);
+	bool TryFromFile(const string& path, Geometry& model);
+	Geometry FromMeshData(const string& path, const MeshData& mesh);
+	Geometry ForGrid(Box gridSize, XMFLOAT2 cellCount);
+	Geometry Cube();
+	Geometry ForUI();
+
+	bool Reload(const string& path, const MeshData& mesh, Geometry& replaced, Geometry& model);
+	Geometry Share(const Geometry& model);
+	void Release(const Geometry& model);
+	void Discard(Geometry& model);
+
+	int GetModelCount() const;
+	int GetReferenceCount(const Geometry& model) const;
+};
\ No newline at end of file
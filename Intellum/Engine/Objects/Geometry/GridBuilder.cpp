@@ -1,6 +1,6 @@
 #include "GridBuilder.h"
 
-GridBuilder::GridBuilder(ID3D11Device* device) : _device(device)
+GridBuilder::GridBuilder(IRenderDevice* renderDevice) : _renderDevice(renderDevice)
 {
 }
 
@@ -71,36 +71,10 @@ vector<unsigned short> GridBuilder::BuildIndexList(XMFLOAT2 cellCount)
 
 ID3D11Buffer* GridBuilder::CreateVertexBuffer(unsigned long long vertexCount, Vertex* finalVerts) const
 {
-	D3D11_BUFFER_DESC bd;
-	ZeroMemory(&bd, sizeof(bd));
-	bd.Usage = D3D11_USAGE_DEFAULT;
-	bd.ByteWidth = sizeof(Vertex) * static_cast<UINT>(vertexCount);
-	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	bd.CPUAccessFlags = 0;
-
-	D3D11_SUBRESOURCE_DATA InitData;
-	ZeroMemory(&InitData, sizeof(InitData));
-	InitData.pSysMem = finalVerts;
-
-	ID3D11Buffer* vertexBuffer;
-	_device->CreateBuffer(&bd, &InitData, &vertexBuffer);
-	return vertexBuffer;
+	return _renderDevice->CreateBuffer(BUFFER_VERTEX, finalVerts, sizeof(Vertex) * static_cast<int>(vertexCount), false);
 }
 
 ID3D11Buffer* GridBuilder::CreateIndexBuffer(int indexCount, unsigned short* indices) const
 {
-	D3D11_BUFFER_DESC bd;
-	ZeroMemory(&bd, sizeof(bd));
-	bd.Usage = D3D11_USAGE_DEFAULT;
-	bd.ByteWidth = sizeof(WORD) * static_cast<UINT>(indexCount);
-	bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	bd.CPUAccessFlags = 0;
-
-	D3D11_SUBRESOURCE_DATA InitData;
-	ZeroMemory(&InitData, sizeof(InitData));
-	InitData.pSysMem = indices;
-
-	ID3D11Buffer* indexBuffer;
-	_device->CreateBuffer(&bd, &InitData, &indexBuffer);
-	return indexBuffer;
+	return _renderDevice->CreateBuffer(BUFFER_INDEX, indices, sizeof(WORD) * indexCount, false);
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "../../../common/Vertex.h"
 #include "../../../common/Box.h"
 #include "Geometry.h"
+#include "../../Rendering/IRenderDevice.h"
 
 using namespace std;
 using namespace DirectX;
@@ -12,7 +13,7 @@ using namespace DirectX;
 class GridBuilder
 {
 private:
-	ID3D11Device* _device;
+	IRenderDevice* _renderDevice;
 
 	static vector<Vertex> BuildVertexList(Box gridSize, XMFLOAT2 cellCount);
 	static vector<unsigned short> BuildIndexList(XMFLOAT2 cellCount);
@@ -20,7 +21,7 @@ private:
 	ID3D11Buffer* CreateVertexBuffer(unsigned long long vertexCount, Vertex* finalVerts) const;
 	ID3D11Buffer* CreateIndexBuffer(int indexCount, unsigned short* indices) const;
 public:
-	GridBuilder(ID3D11Device* device);
+	GridBuilder(IRenderDevice* renderDevice);
 	~GridBuilder();
 
 	Geometry Build(Box gridSize, XMFLOAT2 cellCount) const;
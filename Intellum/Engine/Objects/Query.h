@@ -0,0 +1,34 @@
+#pragma once
+#include "EntityManager.h"
+
+// A typed view over every archetype that owns all of the listed components. The matching archetypes are
+// cached by the EntityManager, so building a Query each frame costs a single lookup.
+template<typename... Components>
+class Query
+{
+private:
+	const vector<Archetype*>* _archetypes;
+
+public:
+	Query(EntityManager* entityManager) : _archetypes(&entityManager->GetMatchingArchetypes(GetMask())) {}
+	~Query() = default;
+
+	static ComponentMask GetMask()
+	{
+		return ComponentMaskOf<Components...>::Value();
+	}
+
+	const vector<Archetype*>& GetArchetypes() const
+	{
+		return *_archetypes;
+	}
+
+	int GetSize() const
+	{
+		int size = 0;
+		for (Archetype* archetype : *_archetypes)
+			size += archetype->GetSize();
+
+		return size;
+	}
+};
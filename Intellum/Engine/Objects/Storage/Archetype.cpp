@@ -0,0 +1,92 @@
+#include "Archetype.h"
+
+Archetype::Archetype(ComponentMask mask) : _mask(mask)
+{
+	for (int i = 0; i < COMPONENT_TYPE_COUNT; i++)
+		_columns[i] = nullptr;
+}
+
+Archetype::~Archetype()
+{
+}
+
+void Archetype::Shutdown()
+{
+	for (ComponentType component : _componentTypes)
+	{
+		_columns[component]->Shutdown();
+		delete _columns[component];
+		_columns[component] = nullptr;
+	}
+
+	_componentTypes.clear();
+	_entities.clear();
+}
+
+void Archetype::Clear()
+{
+	for (ComponentType component : _componentTypes)
+		_columns[component]->Shutdown();
+
+	_entities.clear();
+}
+
+ComponentMask Archetype::GetMask() const
+{
+	return _mask;
+}
+
+bool Archetype::HasComponents(ComponentMask mask) const
+{
+	return MaskContains(_mask, mask);
+}
+
+const vector<ComponentType>& Archetype::GetComponentTypes() const
+{
+	return _componentTypes;
+}
+
+int Archetype::GetSize() const
+{
+	return static_cast<int>(_entities.size());
+}
+
+Entity* Archetype::GetEntity(int row) const
+{
+	return _entities[row];
+}
+
+void Archetype::AddColumn(IComponentArray* column)
+{
+	_columns[column->GetType()] = column;
+	_componentTypes.push_back(column->GetType());
+}
+
+IComponentArray* Archetype::GetColumn(ComponentType component) const
+{
+	return _columns[component];
+}
+
+int Archetype::AddEntity(Entity* entity)
+{
+	_entities.push_back(entity);
+	return static_cast<int>(_entities.size()) - 1;
+}
+
+Entity* Archetype::RemoveRow(int row)
+{
+	for (ComponentType component : _componentTypes)
+		_columns[component]->RemoveRow(row);
+
+	int lastRow = static_cast<int>(_entities.size()) - 1;
+	Entity* movedEntity = nullptr;
+
+	if (row != lastRow)
+	{
+		_entities[row] = _entities[lastRow];
+		movedEntity = _entities[row];
+	}
+
+	_entities.pop_back();
+	return movedEntity;
+}
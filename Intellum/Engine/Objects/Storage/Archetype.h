@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+#include "ComponentArray.h"
+#include "ComponentMask.h"
+
+using namespace std;
+
+class Entity;
+
+// Groups every entity that owns exactly the same set of components. Each component type lives in its own
+// contiguous ComponentArray and row N of every array belongs to _entities[N].
+class Archetype
+{
+private:
+	ComponentMask _mask;
+	IComponentArray* _columns[COMPONENT_TYPE_COUNT];
+	vector<ComponentType> _componentTypes;
+	vector<Entity*> _entities;
+
+public:
+	Archetype(ComponentMask mask);
+	~Archetype();
+
+	void Shutdown();
+	void Clear();
+
+	ComponentMask GetMask() const;
+	bool HasComponents(ComponentMask mask) const;
+	const vector<ComponentType>& GetComponentTypes() const;
+
+	int GetSize() const;
+	Entity* GetEntity(int row) const;
+
+	void AddColumn(IComponentArray* column);
+	IComponentArray* GetColumn(ComponentType component) const;
+
+	template<typename T>
+	ComponentArray<T>* GetColumn() const
+	{
+		return static_cast<ComponentArray<T>*>(_columns[T::Type()]);
+	}
+
+	int AddEntity(Entity* entity);
+	Entity* RemoveRow(int row);
+};
@@ -0,0 +1,136 @@
+#pragma once
+#include <new>
+#include <utility>
+#include <vector>
+#include "../Components/IComponent.h"
+#include "ComponentPool.h"
+
+using namespace std;
+
+class IComponentArray
+{
+public:
+	virtual ~IComponentArray() {}
+
+	virtual ComponentType GetType() const = 0;
+	virtual IComponentArray* CreateEmpty() const = 0;
+
+	virtual int GetSize() const = 0;
+	virtual IComponent* Get(int row) = 0;
+
+	virtual void MoveRowTo(int row, IComponentArray* destination) = 0;
+	virtual void RemoveRow(int row) = 0;
+	virtual void ShutdownRow(int row) = 0;
+	virtual void Shutdown() = 0;
+};
+
+// Components of a single type stored by value in fixed size chunks taken from the type's ComponentPool. Growing
+// the array never relocates existing components, so pointers handed out by At() stay valid until the row itself
+// is removed or moved. A chunk that empties is handed straight back to the pool for the next archetype to use.
+template<typename T>
+class ComponentArray : public IComponentArray
+{
+public:
+	static const int ChunkCapacity = 256;
+
+private:
+	ComponentPool* _pool;
+	vector<T*> _chunks;
+	int _size;
+
+	T* AllocateRow()
+	{
+		if (_size == static_cast<int>(_chunks.size()) * ChunkCapacity)
+			_chunks.push_back(static_cast<T*>(_pool->Allocate()));
+
+		return At(_size++);
+	}
+
+	void ReleaseEmptyChunk()
+	{
+		if (_chunks.empty() || _size > (static_cast<int>(_chunks.size()) - 1) * ChunkCapacity)
+			return;
+
+		_pool->Release(_chunks.back());
+		_chunks.pop_back();
+	}
+
+public:
+	static size_t GetChunkBytes() { return sizeof(T) * ChunkCapacity; }
+
+	ComponentArray(ComponentPool* pool) : _pool(pool), _size(0) {}
+	~ComponentArray() override
+	{
+		for (int row = _size - 1; row >= 0; row--)
+			At(row)->~T();
+
+		for (T* chunk : _chunks)
+			_pool->Release(chunk);
+
+		_chunks.clear();
+		_size = 0;
+	}
+
+	ComponentArray(const ComponentArray&) = delete;
+	ComponentArray& operator=(const ComponentArray&) = delete;
+
+	ComponentType GetType() const override { return T::Type(); }
+	IComponentArray* CreateEmpty() const override { return new ComponentArray<T>(_pool); }
+
+	int GetSize() const override { return _size; }
+	IComponent* Get(int row) override { return At(row); }
+
+	T* At(int row)
+	{
+		return _chunks[row / ChunkCapacity] + (row % ChunkCapacity);
+	}
+
+	int GetChunkCount() const { return static_cast<int>(_chunks.size()); }
+	T* GetChunk(int chunk) { return _chunks[chunk]; }
+
+	int GetChunkSize(int chunk) const
+	{
+		int remaining = _size - chunk * ChunkCapacity;
+		return remaining < ChunkCapacity ? remaining : ChunkCapacity;
+	}
+
+	T* Add(const T& component)
+	{
+		return new (AllocateRow()) T(component);
+	}
+
+	T* Add(T&& component)
+	{
+		return new (AllocateRow()) T(move(component));
+	}
+
+	void MoveRowTo(int row, IComponentArray* destination) override
+	{
+		static_cast<ComponentArray<T>*>(destination)->Add(move(*At(row)));
+	}
+
+	// Swap-back removal: the last row takes the place of the removed one so the array stays dense.
+	void RemoveRow(int row) override
+	{
+		int lastRow = _size - 1;
+		if (row != lastRow)
+			*At(row) = move(*At(lastRow));
+
+		At(lastRow)->~T();
+		_size--;
+
+		ReleaseEmptyChunk();
+	}
+
+	void ShutdownRow(int row) override
+	{
+		At(row)->Shutdown();
+		RemoveRow(row);
+	}
+
+	void Shutdown() override
+	{
+		for (int row = _size - 1; row >= 0; row--)
+			ShutdownRow(row);
+	}
+};
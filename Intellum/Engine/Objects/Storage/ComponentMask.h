@@ -0,0 +1,30 @@
+#pragma once
+#include "../Components/IComponent.h"
+
+typedef unsigned int ComponentMask;
+
+inline ComponentMask MaskOf(ComponentType component)
+{
+	return 1u << component;
+}
+
+inline bool MaskContains(ComponentMask mask, ComponentMask required)
+{
+	return (mask & required) == required;
+}
+
+
+template<typename... Components>
+struct ComponentMaskOf;
+
+template<>
+struct ComponentMaskOf<>
+{
+	static ComponentMask Value() { return 0; }
+};
+
+template<typename First, typename... Rest>
+struct ComponentMaskOf<First, Rest...>
+{
+	static ComponentMask Value() { return MaskOf(First::Type()) | ComponentMaskOf<Rest...>::Value(); }
+};
@@ -0,0 +1,69 @@
+#include "ComponentPool.h"
+
+ComponentPool::ComponentPool(ComponentType type, size_t chunkSize) : _type(type), _chunkSize(chunkSize), _freeList(nullptr), _chunksInUse(0)
+{
+	if (_chunkSize < sizeof(FreeChunk))
+		_chunkSize = sizeof(FreeChunk);
+}
+
+ComponentPool::~ComponentPool()
+{
+}
+
+void ComponentPool::Shutdown()
+{
+	for (void* block : _blocks)
+		::operator delete(block);
+
+	_blocks.clear();
+	_freeList = nullptr;
+	_chunksInUse = 0;
+}
+
+ComponentType ComponentPool::GetType() const
+{
+	return _type;
+}
+
+size_t ComponentPool::GetChunkSize() const
+{
+	return _chunkSize;
+}
+
+void* ComponentPool::Allocate()
+{
+	void* chunk;
+
+	if (_freeList != nullptr)
+	{
+		chunk = _freeList;
+		_freeList = _freeList->Next;
+	}
+	else
+	{
+		chunk = ::operator new(_chunkSize);
+		_blocks.push_back(chunk);
+	}
+
+	_chunksInUse++;
+	return chunk;
+}
+
+void ComponentPool::Release(void* chunk)
+{
+	FreeChunk* freeChunk = static_cast<FreeChunk*>(chunk);
+	freeChunk->Next = _freeList;
+	_freeList = freeChunk;
+
+	_chunksInUse--;
+}
+
+int ComponentPool::GetChunksAllocated() const
+{
+	return static_cast<int>(_blocks.size());
+}
+
+int ComponentPool::GetChunksInUse() const
+{
+	return _chunksInUse;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include "../Components/IComponent.h"
+
+using namespace std;
+
+// Hands out fixed size chunks of raw memory for a single component type. Released chunks are pushed onto an
+// intrusive free list and reused before any new memory is requested, so allocating and releasing are O(1) and
+// spawning or destroying entities never returns memory to the heap until the pool itself is shut down.
+class ComponentPool
+{
+private:
+	struct FreeChunk
+	{
+		FreeChunk* Next;
+	};
+
+	ComponentType _type;
+	size_t _chunkSize;
+	vector<void*> _blocks;
+	FreeChunk* _freeList;
+	int _chunksInUse;
+
+public:
+	ComponentPool(ComponentType type, size_t chunkSize);
+	~ComponentPool();
+
+	void Shutdown();
+
+	ComponentType GetType() const;
+	size_t GetChunkSize() const;
+
+	void* Allocate();
+	void Release(void* chunk);
+
+	int GetChunksAllocated() const;
+	int GetChunksInUse() const;
+};
@@ -5,69 +5,82 @@
 #include "../Components/TransformComponent.h"
 #include "../Components/CollisionComponent.h"
 
-ButtonSystem::ButtonSystem(Input* input) : _input(input)
+namespace
 {
+	// Only marks the appearance dirty when the color actually changes, so an idle button keeps its draw packet
+	void SetButtonColor(AppearanceComponent* appearance, const XMFLOAT4& color)
+	{
+		XMFLOAT4& current = appearance->Color.Color;
+		if (current.x == color.x && current.y == color.y && current.z == color.z && current.w == color.w)
+			return;
+
+		current = color;
+		appearance->Dirty = true;
+	}
 }
 
-void ButtonSystem::Shutdown()
+ButtonSystem::ButtonSystem(IInputState* input)
+	: ISystem(MaskOf(BUTTON) | MaskOf(APPEARANCE) | MaskOf(USER_INTERFACE) | MaskOf(TRANSFORM) | MaskOf(COLLISION), MaskOf(APPEARANCE), ANY_THREAD, EVERY_FRAME), _input(input)
 {
 }
 
-void ButtonSystem::Update(vector<Entity*>& entities, float delta)
+void ButtonSystem::Shutdown()
 {
-	for(int i = 0; i < entities.size(); i++)
-	{
-		Entity* entity = entities.at(i);
-		IComponent* component = entity->GetComponent(BUTTON);
-		if (component == nullptr) continue;
-		ButtonComponent* button = static_cast<ButtonComponent*>(component);
-
-		component = entity->GetComponent(APPEARANCE);
-		if (component == nullptr) continue;
-		AppearanceComponent* appearance = static_cast<AppearanceComponent*>(component);
-		if (appearance->RenderEnabled == false) continue;
+}
 
-		component = entity->GetComponent(USER_INTERFACE);
-		if (component == nullptr) continue;
-		UIComponent* ui = static_cast<UIComponent*>(component);
+void ButtonSystem::Update(EntityManager* entityManager, float delta)
+{
+	Query<ButtonComponent, AppearanceComponent, UIComponent, TransformComponent> buttonQuery(entityManager);
+	Query<CollisionComponent, TransformComponent, AppearanceComponent> collisionQuery(entityManager);
 
-		component = entity->GetComponent(TRANSFORM);
-		if (component == nullptr) continue;
-		TransformComponent* transform = static_cast<TransformComponent*>(component);
+	for (Archetype* archetype : buttonQuery.GetArchetypes())
+	{
+		ComponentArray<ButtonComponent>* buttons = archetype->GetColumn<ButtonComponent>();
+		ComponentArray<AppearanceComponent>* appearances = archetype->GetColumn<AppearanceComponent>();
+		ComponentArray<UIComponent>* uis = archetype->GetColumn<UIComponent>();
+		ComponentArray<TransformComponent>* transforms = archetype->GetColumn<TransformComponent>();
 
-		for (Entity* collidingEntity : entities)
+		for (int row = 0; row < archetype->GetSize(); row++)
 		{
-			component = collidingEntity->GetComponent(COLLISION);
-			if (component == nullptr) continue;
-			CollisionComponent* collidingEntityCollision = static_cast<CollisionComponent*>(component);
+			AppearanceComponent* appearance = appearances->At(row);
+			if (appearance->RenderEnabled == false) continue;
 
-			if (collidingEntityCollision->CollisionType != CURSOR)
-				continue;
+			ButtonComponent* button = buttons->At(row);
+			UIComponent* ui = uis->At(row);
+			TransformComponent* transform = transforms->At(row);
 
-			component = collidingEntity->GetComponent(TRANSFORM);
-			if (component == nullptr) continue;
-			XMFLOAT3 cursorPosition = static_cast<TransformComponent*>(component)->Position;
+			for (Archetype* collidingArchetype : collisionQuery.GetArchetypes())
+			{
+				ComponentArray<CollisionComponent>* collisions = collidingArchetype->GetColumn<CollisionComponent>();
+				ComponentArray<TransformComponent>* collidingTransforms = collidingArchetype->GetColumn<TransformComponent>();
+				ComponentArray<AppearanceComponent>* collidingAppearances = collidingArchetype->GetColumn<AppearanceComponent>();
 
-			component = collidingEntity->GetComponent(APPEARANCE);
-			if (component == nullptr) continue;
-			XMFLOAT3 cursorSize = static_cast<AppearanceComponent*>(component)->Model.Size;
+				for (int collidingRow = 0; collidingRow < collidingArchetype->GetSize(); collidingRow++)
+				{
+					if (collisions->At(collidingRow)->CollisionType != CURSOR)
+						continue;
 
-			if (cursorPosition.x + cursorSize.x > transform->Position.x
-				&& cursorPosition.x - cursorSize.x < transform->Position.x + ui->BitmapSize.x
-				&& cursorPosition.y + cursorSize.y > transform->Position.y
-				&& cursorPosition.y - cursorSize.y < transform->Position.y + ui->BitmapSize.y)
-			{
-				appearance->Color.Color = XMFLOAT4(0.35f, 0.35f, 0.35f, 1.0f);
+					XMFLOAT3 cursorPosition = collidingTransforms->At(collidingRow)->WorldPosition;
+					XMFLOAT3 cursorSize = collidingAppearances->At(collidingRow)->Model.Size;
+
+					if (cursorPosition.x + cursorSize.x > transform->WorldPosition.x
+						&& cursorPosition.x - cursorSize.x < transform->WorldPosition.x + ui->BitmapSize.x
+						&& cursorPosition.y + cursorSize.y > transform->WorldPosition.y
+						&& cursorPosition.y - cursorSize.y < transform->WorldPosition.y + ui->BitmapSize.y)
+					{
+						SetButtonColor(appearance, XMFLOAT4(0.35f, 0.35f, 0.35f, 1.0f));
 
-				if (_input->IsControlPressed(LEFT_CLICK))
-					button->OnClickCommand->Execute();
+						if (_input->IsControlPressed(LEFT_CLICK))
+							button->OnClickCommand->Execute();
+					}
+					else
+						SetButtonColor(appearance, XMFLOAT4(0.4f, 0.4f, 0.4f, 1.0f));
+				}
 			}
-			else
-				appearance->Color.Color = XMFLOAT4(0.4f, 0.4f, 0.4f, 1.0f);
 		}
 	}
 }
 
-void ButtonSystem::Render(vector<Entity*>& entities)
+void ButtonSystem::Render(EntityManager* entityManager)
 {
 }
\ No newline at end of file
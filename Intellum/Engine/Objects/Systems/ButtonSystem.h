@@ -1,17 +1,17 @@
 #pragma once
 #include "ISystem.h"
-#include "../../Input/Input.h"
+#include "../../Input/IInputState.h"
 
 class ButtonSystem : public ISystem
 {
 private:
-	Input* _input;
+	IInputState* _input;
 
 public:
-	ButtonSystem(Input* input);
+	ButtonSystem(IInputState* input);
 	~ButtonSystem() override = default;
 	void Shutdown() override;
 
-	void Update(vector<Entity*>& entities, float delta) override;
-	void Render(vector<Entity*>& entities) override;
+	void Update(EntityManager* entityManager, float delta) override;
+	void Render(EntityManager* entityManager) override;
 };
@@ -1,13 +1,42 @@
 #pragma once
 #include "../Entity.h"
+#include "../Query.h"
 
+enum SystemThreading
+{
+	ANY_THREAD,
+	MAIN_THREAD
+};
+
+// Systems that act on edge triggered input run once per rendered frame, straight after the input is sampled, so a
+// press is seen exactly once however many fixed steps the frame takes. Everything else runs once per step.
+enum SystemRate
+{
+	EVERY_STEP,
+	EVERY_FRAME
+};
+
+// Systems declare which components they read and write so the SystemScheduler can run systems that do not
+// conflict at the same time. Systems that touch the device context must stay on the main thread.
 class ISystem
 {
+private:
+	ComponentMask _readComponents;
+	ComponentMask _writeComponents;
+	SystemThreading _threading;
+	SystemRate _rate;
+
 public:
-	ISystem() {}
+	ISystem(ComponentMask readComponents, ComponentMask writeComponents, SystemThreading threading, SystemRate rate = EVERY_STEP)
+		: _readComponents(readComponents), _writeComponents(writeComponents), _threading(threading), _rate(rate) {}
 	virtual ~ISystem() {}
 	virtual void Shutdown() = 0;
 
-	virtual void Update(vector<Entity*>& entities, float delta) = 0;
-	virtual void Render(vector<Entity*>& entities) = 0;
+	virtual void Update(EntityManager* entityManager, float delta) = 0;
+	virtual void Render(EntityManager* entityManager) = 0;
+
+	ComponentMask GetReadComponents() const { return _readComponents; }
+	ComponentMask GetWriteComponents() const { return _writeComponents; }
+	SystemThreading GetThreading() const { return _threading; }
+	SystemRate GetRate() const { return _rate; }
 };
\ No newline at end of file
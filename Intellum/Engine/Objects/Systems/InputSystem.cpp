@@ -2,7 +2,8 @@
 #include "../Components/InputComponent.h"
 #include "../../Input/ControlCommand.h"
 
-InputSystem::InputSystem(Input* input) : _input(input)
+InputSystem::InputSystem(IInputState* input)
+	: ISystem(MaskOf(INPUT_COMPONENT), MaskOf(INPUT_COMPONENT) | MaskOf(TRANSFORM) | MaskOf(APPEARANCE), ANY_THREAD, EVERY_FRAME), _input(input)
 {
 }
 
@@ -10,31 +11,36 @@ void InputSystem::Shutdown()
 {
 }
 
-void InputSystem::Update(vector<Entity*>& entities, float delta)
+void InputSystem::Update(EntityManager* entityManager, float delta)
 {
-	for (Entity* entity : entities)
+	Query<InputComponent> query(entityManager);
+
+	for (Archetype* archetype : query.GetArchetypes())
 	{
-		IComponent* component = entity->GetComponent(INPUT_COMPONENT);
-		if (component == nullptr) continue;
-		InputComponent* input = static_cast<InputComponent*>(component);
+		ComponentArray<InputComponent>* inputs = archetype->GetColumn<InputComponent>();
 
-		for (ControlCommand& controlCommand : input->ControlCommands)
+		for (int row = 0; row < archetype->GetSize(); row++)
 		{
-			if (controlCommand.CurrentCooldown < controlCommand.Cooldown)
-			{
-				controlCommand.CurrentCooldown += delta;
-				continue;
-			}
+			InputComponent* input = inputs->At(row);
 
-			if (_input->IsControlPressed(controlCommand.Control))
+			for (ControlCommand& controlCommand : input->ControlCommands)
 			{
-				controlCommand.Command->Execute();
-				controlCommand.CurrentCooldown = 0;
+				if (controlCommand.CurrentCooldown < controlCommand.Cooldown)
+				{
+					controlCommand.CurrentCooldown += delta;
+					continue;
+				}
+
+				if (_input->IsControlPressed(controlCommand.Control))
+				{
+					controlCommand.Command->Execute();
+					controlCommand.CurrentCooldown = 0;
+				}
 			}
 		}
 	}
 }
 
-void InputSystem::Render(vector<Entity*>& entities)
+void InputSystem::Render(EntityManager* entityManager)
 {
 }
\ No newline at end of file
@@ -1,8 +1,7 @@
 #include "RenderSystem.h"
-#include "../Components/RasterizerComponent.h"
-#include "../Components/FurstrumCullingComponent.h"
 
-RenderSystem::RenderSystem(DirectX3D* direct3D, ShaderController* shaderController, HWND hwnd, Camera* camera) : _direct3D(direct3D), _camera(camera), _shaderController(shaderController), _renderCount(0)
+RenderSystem::RenderSystem(IRenderDevice* renderDevice, RenderQueue* renderQueue, Camera* camera)
+	: ISystem(MaskOf(APPEARANCE) | MaskOf(TRANSFORM) | MaskOf(RASTERIZER) | MaskOf(FRUSTRUM_CULLING), 0, MAIN_THREAD), _renderDevice(renderDevice), _camera(camera), _renderQueue(renderQueue), _renderCount(0)
 {
 	XMFLOAT3 up = XMFLOAT3(0.0f, 1.0f, 0.0f);
 	XMVECTOR upVector = XMLoadFloat3(&up);
@@ -20,43 +19,50 @@ void RenderSystem::Shutdown()
 {
 }
 
-void RenderSystem::Update(vector<Entity*>& entities, float delta)
+void RenderSystem::Update(EntityManager* entityManager, float delta)
 {
-	_renderCount = 0;
 }
 
-void RenderSystem::Render(vector<Entity*>& entities)
+// Counted per rendered frame, which can follow any number of fixed steps
+void RenderSystem::Render(EntityManager* entityManager)
 {
-	for (Entity* entity : entities)
-	{
-		IComponent* component = entity->GetComponent(APPEARANCE);
+	_renderCount = 0;
 
-		if (component == nullptr)
-			continue;
+	Query<AppearanceComponent, TransformComponent> query(entityManager);
 
-		AppearanceComponent* appearance = static_cast<AppearanceComponent*>(component);
+	for (Archetype* archetype : query.GetArchetypes())
+	{
+		ComponentArray<AppearanceComponent>* appearances = archetype->GetColumn<AppearanceComponent>();
+		ComponentArray<TransformComponent>* transforms = archetype->GetColumn<TransformComponent>();
+		ComponentArray<RasterizerComponent>* rasterizers = archetype->GetColumn<RasterizerComponent>();
+		ComponentArray<FrustrumCullingComponent>* frustrumCullings = archetype->GetColumn<FrustrumCullingComponent>();
 
-		if (appearance->RenderEnabled == false)
-			continue;
+		for (int row = 0; row < archetype->GetSize(); row++)
+		{
+			AppearanceComponent* appearance = appearances->At(row);
 
-		component = entity->GetComponent(TRANSFORM);
+			if (appearance->RenderEnabled == false)
+				continue;
 
-		if (component == nullptr)
-			continue;
+			TransformComponent* transform = transforms->At(row);
 
-		TransformComponent* transform = static_cast<TransformComponent*>(component);
+			if (frustrumCullings != nullptr && CheckIfInsideFrustrum(frustrumCullings->At(row), transform, appearance) == false)
+				continue;
 
-		if (CheckIfInsideFrustrum(entity, transform, appearance) == false)
-			continue;
+			RasterizerComponent* rasterizer = rasterizers != nullptr ? rasterizers->At(row) : nullptr;
+			if (PacketChanged(rasterizer, appearance))
+			{
+				appearance->Packet = BuildDrawPacket(rasterizer, appearance);
+				appearance->Dirty = false;
 
-		BuildBufferInformation(entity, appearance);
+				if (rasterizer != nullptr)
+					rasterizer->Dirty = false;
+			}
 
-		ShaderResources shaderResources = BuildShaderResources(appearance, transform);
+			_renderQueue->Add(BuildDrawItem(appearance->Packet, transform));
 
-		IShaderType* shader = _shaderController->GetShader(appearance->ShaderType);
-		shader->Render(appearance->Model.IndexCount, shaderResources);
-		
-		_renderCount++;
+			_renderCount++;
+		}
 	}
 
 	for (int i = 0; i < Observers.size(); i++)
@@ -69,15 +75,8 @@ void RenderSystem::Render(vector<Entity*>& entities)
 	}
 }
 
-bool RenderSystem::CheckIfInsideFrustrum(Entity* entity, TransformComponent* transform, AppearanceComponent* appearance) const
+bool RenderSystem::CheckIfInsideFrustrum(FrustrumCullingComponent* frustrumCulling, TransformComponent* transform, AppearanceComponent* appearance) const
 {
-	IComponent* component = entity->GetComponent(FRUSTRUM_CULLING);
-
-	if (component == nullptr)
-		return true;
-
-	FrustrumCullingComponent* frustrumCulling = static_cast<FrustrumCullingComponent*>(component);
-
 	Frustrum* frustrum = _camera->GetFrustrum();
 
 	XMFLOAT3 scaledSize = XMFLOAT3(appearance->Model.Size.x * transform->Scale.x, appearance->Model.Size.y * transform->Scale.y, appearance->Model.Size.z * transform->Scale.z);
@@ -85,97 +84,107 @@ bool RenderSystem::CheckIfInsideFrustrum(Entity* entity, TransformComponent* tra
 	switch (frustrumCulling->CullingType)
 	{
 	case FRUSTRUM_CULL_POINT:
-		return frustrum->CheckPointInsideFrustrum(transform->Position, 0.0f);
+		return frustrum->CheckPointInsideFrustrum(transform->WorldPosition, 0.0f);
 	case FRUSTRUM_CULL_RECTANGLE:
-		return frustrum->CheckRectangleInsideFrustrum(transform->Position, scaledSize);
+		return frustrum->CheckRectangleInsideFrustrum(transform->WorldPosition, scaledSize);
 	case FRUSTRUM_CULL_SPHERE:
-		return frustrum->CheckSphereInsideFrustrum(transform->Position, 0.5f * scaledSize.x);
+		return frustrum->CheckSphereInsideFrustrum(transform->WorldPosition, 0.5f * scaledSize.x);
 	case FRUSTRUM_CULL_SQUARE:
-		return frustrum->CheckCubeInsideFrustrum(transform->Position, 0.5f * scaledSize.x);
+		return frustrum->CheckCubeInsideFrustrum(transform->WorldPosition, 0.5f * scaledSize.x);
 	default: 
 		return true;
 	}
 }
 
-ShaderResources RenderSystem::BuildShaderResources(AppearanceComponent* appearance, TransformComponent* transform) const
+// An entity that lost its rasterizer falls back to solid back face culled drawing, which the packet has to pick up as well
+bool RenderSystem::PacketChanged(RasterizerComponent* rasterizer, AppearanceComponent* appearance)
 {
-	ShaderResources shaderResources = ShaderResources();
-	IShaderType* shader = _shaderController->GetShader(appearance->ShaderType);
-	switch (appearance->ShaderType)
-	{
-	case SHADER_DEFAULT:
-		shaderResources.LightEnabled = true;
-		shaderResources.MatrixParameters.ViewMatrix = _camera->GetViewMatrix();
-		shaderResources.MatrixParameters.WorldMatrix = transform->Transformation;
-		shaderResources.MatrixParameters.ProjectionMatrix = _direct3D->GetProjectionMatrix();
-		break;
-	case SHADER_UI:
-	case SHADER_FONT:
-		shaderResources.LightEnabled = false;
-		shaderResources.MatrixParameters.ViewMatrix = _defaultViewMatrix;
-		shaderResources.MatrixParameters.WorldMatrix = XMMatrixTranslation(0, 0, 0);
-		shaderResources.MatrixParameters.ProjectionMatrix = _direct3D->GetOrthoMatrix();
-		break;
-	default:
-		shaderResources.LightEnabled = true;
-		shaderResources.MatrixParameters.ViewMatrix = _camera->GetViewMatrix();
-		shaderResources.MatrixParameters.WorldMatrix = transform->Transformation;
-		shaderResources.MatrixParameters.ProjectionMatrix = _direct3D->GetProjectionMatrix();
-	}
+	if (appearance->Dirty)
+		return true;
 
-	shaderResources.ColorParameters = appearance->Color;
-	shaderResources.GradientParameters = appearance->Gradient;
-	if (appearance->Gradient.Enabled)
-	{
-		shaderResources.GradientParameters.CenterYCordinates = transform->Position.y;
-		shaderResources.GradientParameters.Height = (appearance->Model.Size.y / 2) * transform->Scale.y;
-	}
+	if (rasterizer == nullptr)
+		return appearance->Packet.FillMode != D3D11_FILL_SOLID || appearance->Packet.CullMode != D3D11_CULL_BACK;
 
-	if (appearance->Textures.size() > 0)
-		shaderResources.TextureParameters.TextureArray = ExtractResourceViewsFrom(appearance->Textures);
+	return rasterizer->Dirty || appearance->Packet.FillMode != rasterizer->FillMode || appearance->Packet.CullMode != rasterizer->CullMode;
+}
+
+DrawPacket RenderSystem::BuildDrawPacket(RasterizerComponent* rasterizer, AppearanceComponent* appearance)
+{
+	DrawPacket packet = DrawPacket();
+	packet.Pass = appearance->ShaderType == SHADER_DEFAULT ? RENDER_PASS_OPAQUE : RENDER_PASS_UI;
+	packet.Shader = appearance->ShaderType;
+	packet.FillMode = rasterizer == nullptr ? D3D11_FILL_SOLID : rasterizer->FillMode;
+	packet.CullMode = rasterizer == nullptr ? D3D11_CULL_BACK : rasterizer->CullMode;
+	packet.DepthEnabled = true;
+	packet.LightEnabled = appearance->ShaderType != SHADER_UI && appearance->ShaderType != SHADER_FONT;
+	packet.Mesh = appearance->Model;
+	packet.Color = appearance->Color;
+	packet.Gradient = appearance->Gradient;
+
+	for (Texture* texture : appearance->Textures)
+		packet.Textures.AddTexture(texture->GetTexture());
 
 	if (appearance->BumpMap != nullptr)
 	{
-		shaderResources.TextureParameters.BumpMap = appearance->BumpMap->GetTexture();
-		shaderResources.TextureParameters.BumpMapEnabled = true;
+		packet.Textures.BumpMap = appearance->BumpMap->GetTexture();
+		packet.Textures.BumpMapEnabled = true;
 	}
 
 	if (appearance->LightMap != nullptr)
 	{
-		shaderResources.TextureParameters.LightMap = appearance->LightMap->GetTexture();
-		shaderResources.TextureParameters.LightMapEnabled = true;
+		packet.Textures.LightMap = appearance->LightMap->GetTexture();
+		packet.Textures.LightMapEnabled = true;
 	}
 
-	return shaderResources;
+	packet.StateKey = RenderQueue::BuildStateKey(packet.Pass, packet.Shader, packet.CullMode, packet.Textures, packet.Mesh);
+	return packet;
 }
 
-void RenderSystem::BuildBufferInformation(Entity* entity, AppearanceComponent* appearance) const
+// World objects are sorted front to back by their distance from the camera, interface elements by their z position
+DrawItem RenderSystem::BuildDrawItem(const DrawPacket& packet, TransformComponent* transform) const
 {
-	IComponent* component = entity->GetComponent(RASTERIZER);
-
-	if (component == nullptr)
-		_direct3D->GetRasterizer()->SetRasterizerCullMode(D3D11_CULL_BACK);
+	DrawItem item;
+	item.Pass = packet.Pass;
+	item.Shader = packet.Shader;
+	item.FillMode = packet.FillMode;
+	item.CullMode = packet.CullMode;
+	item.DepthEnabled = packet.DepthEnabled;
+	item.Mesh = packet.Mesh;
+
+	ShaderResources& shaderResources = item.Resources;
+	shaderResources.LightEnabled = packet.LightEnabled;
+	shaderResources.TextureParameters = packet.Textures;
+	shaderResources.ColorParameters = packet.Color;
+	shaderResources.GradientParameters = packet.Gradient;
+
+	if (packet.LightEnabled)
+	{
+		shaderResources.MatrixParameters.ViewMatrix = _camera->GetViewMatrix();
+		shaderResources.MatrixParameters.WorldMatrix = transform->RenderTransformation;
+		shaderResources.MatrixParameters.ProjectionMatrix = _renderDevice->GetProjectionMatrix();
+	}
 	else
-		_direct3D->GetRasterizer()->SetRasterizerCullMode(static_cast<RasterizerComponent*>(component)->CullMode);
-
-	_direct3D->TurnZBufferOn();
-
-	ID3D11DeviceContext* deviceContext = _direct3D->GetDeviceContext();
-	deviceContext->IASetVertexBuffers(0, 1, &appearance->Model.VertexBuffer, &appearance->Model.VBStride, &appearance->Model.VBOffset);
-	deviceContext->IASetIndexBuffer(appearance->Model.IndexBuffer, DXGI_FORMAT_R16_UINT, 0);
-	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-}
+	{
+		shaderResources.MatrixParameters.ViewMatrix = _defaultViewMatrix;
+		shaderResources.MatrixParameters.WorldMatrix = XMMatrixTranslation(0, 0, 0);
+		shaderResources.MatrixParameters.ProjectionMatrix = _renderDevice->GetOrthoMatrix();
+	}
 
-vector<ID3D11ShaderResourceView*> RenderSystem::ExtractResourceViewsFrom(vector<Texture*> textures)
-{
-	vector<ID3D11ShaderResourceView*> textureViews;
+	if (packet.Gradient.Enabled)
+	{
+		shaderResources.GradientParameters.CenterYCordinates = transform->WorldPosition.y;
+		shaderResources.GradientParameters.Height = (packet.Mesh.Size.y / 2) * transform->Scale.y;
+	}
 
-	for (Texture* texture : textures)
+	float depth = transform->WorldPosition.z;
+	if (item.Pass == RENDER_PASS_OPAQUE)
 	{
-		textureViews.push_back(texture->GetTexture());
+		XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(&transform->WorldPosition), XMLoadFloat3(&_camera->GetTransform()->GetPosition()));
+		depth = XMVectorGetX(XMVector3Length(offset));
 	}
 
-	return textureViews;
+	item.Key = RenderQueue::BuildKey(packet.StateKey, depth);
+	return item;
 }
 
 void RenderSystem::AddObserver(IObserver* observer)
@@ -1,40 +1,37 @@
 #pragma once
 #include <d3d11.h>
-#include "../../DirectX3D.h"
+#include "../../Camera/Camera.h"
 #include "../Components/AppearanceComponent.h"
 #include "../Components/TransformComponent.h"
+#include "../Components/RasterizerComponent.h"
+#include "../Components/FurstrumCullingComponent.h"
 
 #include "ISystem.h"
-#include "../../ShaderEngine/ConstantBuffers/MatrixBuffer.h"
-#include "../../ShaderEngine/ConstantBuffers/CameraBuffer.h"
-#include "../../ShaderEngine/ConstantBuffers/LightBuffer.h"
-#include "../../ShaderEngine/ConstantBuffers/TextureBuffer.h"
-#include <d3dcompiler.h>
-#include <fstream>
-#include "../../ShaderEngine/ShaderController.h"
+#include "../../Rendering/IRenderDevice.h"
+#include "../../Rendering/RenderQueue.h"
 
 class RenderSystem : public ISystem, public Observable
 {
 private:
-	DirectX3D* _direct3D;
+	IRenderDevice* _renderDevice;
 	Camera* _camera;
-	ShaderController* _shaderController;
+	RenderQueue* _renderQueue;
 
 	XMMATRIX _defaultViewMatrix;
 	int _renderCount;
 
-	ShaderResources BuildShaderResources(AppearanceComponent* appearance, TransformComponent* transform) const;
-	void BuildBufferInformation(Entity* entity, AppearanceComponent* appearance) const;
-	static vector<ID3D11ShaderResourceView*> ExtractResourceViewsFrom(vector<Texture*> textures);
+	static bool PacketChanged(RasterizerComponent* rasterizer, AppearanceComponent* appearance);
+	static DrawPacket BuildDrawPacket(RasterizerComponent* rasterizer, AppearanceComponent* appearance);
+	DrawItem BuildDrawItem(const DrawPacket& packet, TransformComponent* transform) const;
 
-	bool CheckIfInsideFrustrum(Entity* entity, TransformComponent* transform, AppearanceComponent* appearance) const;
+	bool CheckIfInsideFrustrum(FrustrumCullingComponent* frustrumCulling, TransformComponent* transform, AppearanceComponent* appearance) const;
 public:
-	RenderSystem(DirectX3D* direct3D, ShaderController* shaderController, HWND hwnd, Camera* camera);
+	RenderSystem(IRenderDevice* renderDevice, RenderQueue* renderQueue, Camera* camera);
 	~RenderSystem() override = default;
 	void Shutdown() override;
 
-	void Update(vector<Entity*>& entities, float delta) override;
-	void Render(vector<Entity*>& entities) override;
+	void Update(EntityManager* entityManager, float delta) override;
+	void Render(EntityManager* entityManager) override;
 
 	void AddObserver(IObserver* observer) override;
 };
@@ -0,0 +1,172 @@
+#include "SystemScheduler.h"
+
+SystemScheduler::SystemScheduler(WorkerPool* workerPool) : _workerPool(workerPool), _entityManager(nullptr), _delta(0.0f), _completedCount(0), _failed(false)
+{
+}
+
+SystemScheduler::~SystemScheduler()
+{
+}
+
+void SystemScheduler::Shutdown()
+{
+	_nodes.clear();
+	_updateTimes.clear();
+}
+
+void SystemScheduler::Update(const map<SystemType, ISystem*>& systems, EntityManager* entityManager, float delta, SystemRate rate)
+{
+	BuildGraph(systems, rate);
+
+	_entityManager = entityManager;
+	_delta = delta;
+	_completedCount = 0;
+	_failed = false;
+	_failure = exception_ptr();
+
+	unique_lock<mutex> lock(_stateLock);
+
+	for (int node = 0; node < static_cast<int>(_nodes.size()); node++)
+	{
+		if (_nodes[node].RemainingDependencies == 0)
+			Dispatch(node);
+	}
+
+	while (_completedCount < static_cast<int>(_nodes.size()))
+	{
+		if (_mainThreadQueue.empty())
+		{
+			_stateChanged.wait(lock);
+			continue;
+		}
+
+		int node = _mainThreadQueue.front();
+		_mainThreadQueue.pop();
+
+		lock.unlock();
+		Execute(node);
+		lock.lock();
+	}
+
+	for (SystemNode& node : _nodes)
+		_updateTimes[node.Type] = node.UpdateMilliseconds;
+
+	if (_failed == false)
+		return;
+
+	try
+	{
+		rethrow_exception(_failure);
+	}
+	catch (Exception& exception)
+	{
+		throw Exception("A system failed to update.", exception);
+	}
+	catch (...)
+	{
+		throw Exception("An unexpected error occured while updating a system");
+	}
+}
+
+const map<SystemType, float>& SystemScheduler::GetUpdateTimes() const
+{
+	return _updateTimes;
+}
+
+// An edge is added from every earlier system to every later one it conflicts with, so the graph is rebuilt
+// cheaply each frame and always agrees with the serial SystemType order.
+void SystemScheduler::BuildGraph(const map<SystemType, ISystem*>& systems, SystemRate rate)
+{
+	_nodes.clear();
+
+	for (map<SystemType, ISystem*>::const_iterator iterator = systems.begin(); iterator != systems.end(); ++iterator)
+	{
+		if (iterator->second->GetRate() != rate)
+			continue;
+
+		SystemNode node;
+		node.Type = iterator->first;
+		node.System = iterator->second;
+		node.UpdateMilliseconds = 0.0f;
+		node.RemainingDependencies = 0;
+		_nodes.push_back(node);
+	}
+
+	for (int later = 0; later < static_cast<int>(_nodes.size()); later++)
+	{
+		for (int earlier = 0; earlier < later; earlier++)
+		{
+			if (Conflicts(_nodes[earlier].System, _nodes[later].System) == false)
+				continue;
+
+			_nodes[earlier].Dependents.push_back(later);
+			_nodes[later].RemainingDependencies++;
+		}
+	}
+}
+
+bool SystemScheduler::Conflicts(ISystem* first, ISystem* second)
+{
+	ComponentMask firstAccess = first->GetReadComponents() | first->GetWriteComponents();
+	ComponentMask secondAccess = second->GetReadComponents() | second->GetWriteComponents();
+
+	return (first->GetWriteComponents() & secondAccess) != 0 || (second->GetWriteComponents() & firstAccess) != 0;
+}
+
+// Must be called while holding _stateLock.
+void SystemScheduler::Dispatch(int node)
+{
+	if (_nodes[node].System->GetThreading() == MAIN_THREAD || _workerPool->GetWorkerCount() == 0)
+	{
+		_mainThreadQueue.push(node);
+		_stateChanged.notify_all();
+		return;
+	}
+
+	_workerPool->Submit([this, node]() { Execute(node); });
+}
+
+void SystemScheduler::Execute(int node)
+{
+	bool skip;
+
+	{
+		lock_guard<mutex> lock(_stateLock);
+		skip = _failed;
+	}
+
+	if (skip == false)
+	{
+		try
+		{
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			_nodes[node].System->Update(_entityManager, _delta);
+			_nodes[node].UpdateMilliseconds = chrono::duration<float, milli>(chrono::steady_clock::now() - start).count();
+		}
+		catch (...)
+		{
+			// Kept as an exception_ptr so the error is handed to the updating thread without being copied
+			lock_guard<mutex> lock(_stateLock);
+			if (_failed == false)
+				_failure = current_exception();
+
+			_failed = true;
+		}
+	}
+
+	Complete(node);
+}
+
+void SystemScheduler::Complete(int node)
+{
+	lock_guard<mutex> lock(_stateLock);
+
+	for (int dependent : _nodes[node].Dependents)
+	{
+		if (--_nodes[dependent].RemainingDependencies == 0)
+			Dispatch(dependent);
+	}
+
+	_completedCount++;
+	_stateChanged.notify_all();
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <vector>
+#include "ISystem.h"
+#include "SystemType.h"
+#include "../../Threading/WorkerPool.h"
+#include "../../../ErrorHandling/Exception.h"
+
+using namespace std;
+
+// Runs the update phase of every system at the given rate as a dependency graph. Systems keep their SystemType order wherever
+// their declared component access conflicts; everything else is free to run side by side on the worker pool.
+class SystemScheduler
+{
+private:
+	struct SystemNode
+	{
+		SystemType Type;
+		ISystem* System;
+		float UpdateMilliseconds;
+		vector<int> Dependents;
+		int RemainingDependencies;
+	};
+
+	WorkerPool* _workerPool;
+	vector<SystemNode> _nodes;
+
+	EntityManager* _entityManager;
+	float _delta;
+	map<SystemType, float> _updateTimes;
+
+	mutex _stateLock;
+	condition_variable _stateChanged;
+	queue<int> _mainThreadQueue;
+	int _completedCount;
+	bool _failed;
+	exception_ptr _failure;
+
+	void BuildGraph(const map<SystemType, ISystem*>& systems, SystemRate rate);
+	static bool Conflicts(ISystem* first, ISystem* second);
+
+	void Dispatch(int node);
+	void Execute(int node);
+	void Complete(int node);
+
+public:
+	SystemScheduler(WorkerPool* workerPool);
+	~SystemScheduler();
+
+	void Shutdown();
+
+	void Update(const map<SystemType, ISystem*>& systems, EntityManager* entityManager, float delta, SystemRate rate);
+
+	const map<SystemType, float>& GetUpdateTimes() const;
+};
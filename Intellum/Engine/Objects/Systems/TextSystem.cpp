@@ -1,7 +1,9 @@
 #include "TextSystem.h"
 #include "UISystem.h"
+#include "../Components/TransformComponent.h"
 
-TextSystem::TextSystem(DirectX3D* direct3D, ShaderController* shaderController, FontEngine* fontEngine, Box screenSize) : _direct3D(direct3D), _shaderController(shaderController), _fontEngine(fontEngine), _screenSize(screenSize)
+TextSystem::TextSystem(IRenderDevice* renderDevice, RenderQueue* renderQueue, FontEngine* fontEngine, Box screenSize)
+	: ISystem(MaskOf(TEXT) | MaskOf(APPEARANCE) | MaskOf(TRANSFORM), MaskOf(TEXT), MAIN_THREAD), _renderDevice(renderDevice), _renderQueue(renderQueue), _fontEngine(fontEngine), _screenSize(screenSize)
 {
 	XMFLOAT3 up = XMFLOAT3(0.0f, 1.0f, 0.0f);
 	XMVECTOR upVector = XMLoadFloat3(&up);
@@ -23,21 +25,40 @@ void TextSystem::Shutdown()
 {
 }
 
-void TextSystem::Update(vector<Entity*>& entities, float delta)
+void TextSystem::Update(EntityManager* entityManager, float delta)
 {
-	for (Entity* entity : entities)
+	Query<TextComponent> query(entityManager);
+
+	for (Archetype* archetype : query.GetArchetypes())
 	{
-		IComponent* component = entity->GetComponent(TEXT);
-		if (component == nullptr) continue;
-		TextComponent* text = static_cast<TextComponent*>(component);
+		ComponentArray<TextComponent>* texts = archetype->GetColumn<TextComponent>();
+		ComponentArray<TransformComponent>* transforms = archetype->GetColumn<TransformComponent>();
+
+		for (int row = 0; row < archetype->GetSize(); row++)
+		{
+			TextComponent* text = texts->At(row);
+
+			// Text on an entity with a transform is positioned relative to it, so it follows the entity around
+			XMFLOAT2 position = text->FontPosition;
+			if (transforms != nullptr)
+			{
+				XMFLOAT3 worldPosition = transforms->At(row)->WorldPosition;
+				position = XMFLOAT2(position.x + worldPosition.x, position.y + worldPosition.y);
+			}
+
+			bool moved = position.x != text->PreviousFontPosition.x || position.y != text->PreviousFontPosition.y;
+			if (text->Text == text->PreviousText && moved == false)
+				continue;
+
+			if (moved)
+				MoveTextEntity(text, position);
 
-		if (text->Text == text->PreviousText)
-			continue;
+			if (text->Text != text->PreviousText)
+				UpdateTextEntity(text);
 
-		UpdateTextEntity(text);
-		
-		for (TextTexture characterTexture : text->TextEntity)
-			UpdateAppearance(characterTexture);
+			for (TextTexture& characterTexture : text->TextEntity)
+				UpdateAppearance(characterTexture);
+		}
 	}
 }
 
@@ -53,7 +74,7 @@ void TextSystem::UpdateTextEntity(TextComponent* textComponent)
 		if (textSizeDifference > 0)
 		{
 			string additionalCharacters = string(currentText.end() - textSizeDifference, currentText.end());
-			XMFLOAT2 adjustedPosition = XMFLOAT2(textComponent->FontPosition.x + (previousText.size() * textComponent->FontSize), textComponent->FontPosition.y);
+			XMFLOAT2 adjustedPosition = XMFLOAT2(textComponent->PreviousFontPosition.x + (previousText.size() * textComponent->FontSize), textComponent->PreviousFontPosition.y);
 			vector<TextTexture> additionalTextures = _fontEngine->ConvertTextToTextEntity(adjustedPosition, "Impact", additionalCharacters, textComponent->Color, textComponent->FontSize);
 			textTextures.insert(textTextures.end(), additionalTextures.begin(), additionalTextures.end());
 		}
@@ -61,7 +82,7 @@ void TextSystem::UpdateTextEntity(TextComponent* textComponent)
 		{
 			for (int i = 0; i < textSizeDifference * -1; i++)
 			{
-				textTextures.at(textTextures.size() - 1).Shutdown();
+				textTextures.at(textTextures.size() - 1).Shutdown(_renderDevice);
 				textTextures.pop_back();
 			}
 		}
@@ -82,6 +103,17 @@ void TextSystem::UpdateTextEntity(TextComponent* textComponent)
 	}
 }
 
+void TextSystem::MoveTextEntity(TextComponent* textComponent, XMFLOAT2 position)
+{
+	float offsetX = position.x - textComponent->PreviousFontPosition.x;
+	float offsetY = position.y - textComponent->PreviousFontPosition.y;
+
+	for (TextTexture& characterTexture : textComponent->TextEntity)
+		characterTexture.Position = XMFLOAT2(characterTexture.Position.x + offsetX, characterTexture.Position.y + offsetY);
+
+	textComponent->PreviousFontPosition = position;
+}
+
 void TextSystem::UpdateAppearance(TextTexture& texture)
 {
 	if ((texture.Position.x == static_cast<int>(texture.PreviousPosition.x)) && (texture.Position.y == static_cast<int>(texture.PreviousPosition.y))
@@ -120,74 +152,62 @@ void TextSystem::UpdateAppearance(TextTexture& texture)
 	vertices[5].position = XMFLOAT3(right, bottom, 0.0f);
 	vertices[5].texture = XMFLOAT2(1.0f, 1.0f);
 
-	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	HRESULT result = _direct3D->GetDeviceContext()->Map(texture.Model.VertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if (FAILED(result)) throw Exception("Failed to map vertex buffer to the Device Context");
-
-	Vertex* verticesPtr = static_cast<Vertex*>(mappedResource.pData);
-
-	memcpy(verticesPtr, static_cast<void*>(vertices), (sizeof(Vertex) * texture.Model.VertexCount));
-
-	_direct3D->GetDeviceContext()->Unmap(texture.Model.VertexBuffer, 0);
+	_renderDevice->WriteBuffer(texture.Model.VertexBuffer, vertices, sizeof(Vertex) * texture.Model.VertexCount);
 
 	delete[] vertices;
 	vertices = nullptr;
 }
 
-void TextSystem::Render(vector<Entity*>& entities)
+void TextSystem::Render(EntityManager* entityManager)
 {
-	for (Entity* entity : entities)
+	Query<TextComponent> query(entityManager);
+
+	for (Archetype* archetype : query.GetArchetypes())
 	{
-		IComponent* component = entity->GetComponent(APPEARANCE);
+		ComponentArray<TextComponent>* texts = archetype->GetColumn<TextComponent>();
+		ComponentArray<AppearanceComponent>* appearances = archetype->GetColumn<AppearanceComponent>();
 
-		if (component != nullptr)
+		for (int row = 0; row < archetype->GetSize(); row++)
 		{
-			AppearanceComponent* appearance = static_cast<AppearanceComponent*>(component);
-			if (appearance->RenderEnabled == false) continue;
-		}
-
-		component = entity->GetComponent(TEXT);
-		if (component == nullptr) continue;
-		TextComponent* text = static_cast<TextComponent*>(component);
+			if (appearances != nullptr && appearances->At(row)->RenderEnabled == false)
+				continue;
 
-		RenderCharacters(text->TextEntity);
+			RenderCharacters(texts->At(row)->TextEntity);
+		}
 	}
 }
 
 void TextSystem::RenderCharacters(vector<TextTexture>& characters)
 {
-	for (TextTexture character : characters)
-	{
-		BuildBufferInformation(character);
-		ShaderResources shaderResources = BuildShaderResources(character);
-
-		IShaderType* shader = _shaderController->GetShader(SHADER_FONT);
-		shader->Render(character.Model.IndexCount, shaderResources);
-	}
+	for (TextTexture& character : characters)
+		_renderQueue->Add(BuildDrawItem(character));
 }
 
-void TextSystem::BuildBufferInformation(TextTexture& character) const
+DrawItem TextSystem::BuildDrawItem(TextTexture& character) const
 {
-	_direct3D->GetRasterizer()->SetRasterizerCullMode(D3D11_CULL_BACK);
-	_direct3D->TurnZBufferOff();
-
-	ID3D11DeviceContext* deviceContext = _direct3D->GetDeviceContext();
-	deviceContext->IASetVertexBuffers(0, 1, &character.Model.VertexBuffer, &character.Model.VBStride, &character.Model.VBOffset);
-	deviceContext->IASetIndexBuffer(character.Model.IndexBuffer, DXGI_FORMAT_R16_UINT, 0);
-	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	DrawItem item = DrawItem();
+	item.Pass = RENDER_PASS_TEXT;
+	item.Shader = SHADER_FONT;
+	item.CullMode = D3D11_CULL_BACK;
+	item.DepthEnabled = false;
+	item.Mesh = character.Model;
+	item.Resources = BuildShaderResources(character);
+	item.Key = RenderQueue::BuildKey(item.Pass, item.Shader, item.CullMode, item.Resources.TextureParameters, item.Mesh, 0.0f);
+
+	return item;
 }
 
 ShaderResources TextSystem::BuildShaderResources(TextTexture& character) const
 {
 	ShaderResources shaderResources = ShaderResources();
 	shaderResources.MatrixParameters.ViewMatrix = _viewMatrix;
-	shaderResources.MatrixParameters.WorldMatrix = _direct3D->GetWorldMatrix();
-	shaderResources.MatrixParameters.ProjectionMatrix = _direct3D->GetOrthoMatrix();
+	shaderResources.MatrixParameters.WorldMatrix = _renderDevice->GetWorldMatrix();
+	shaderResources.MatrixParameters.ProjectionMatrix = _renderDevice->GetOrthoMatrix();
 
 	shaderResources.ColorParameters = character.Color;
 
 	if (character.CharacterTexture != nullptr)
-		shaderResources.TextureParameters.TextureArray = vector<ID3D11ShaderResourceView*> { ExtractResourceViewsFrom(character.CharacterTexture) };
+		shaderResources.TextureParameters.AddTexture(ExtractResourceViewsFrom(character.CharacterTexture));
 
 	return shaderResources;
 }
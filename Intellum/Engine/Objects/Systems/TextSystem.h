@@ -1,32 +1,33 @@
 #pragma once
 #include "ISystem.h"
-#include "../../DirectX3D.h"
-#include "../../ShaderEngine/ShaderController.h"
 #include "../Components/TextComponent.h"
 #include "../../FontEngine/FontEngine.h"
 #include "UISystem.h"
+#include "../../Rendering/IRenderDevice.h"
+#include "../../Rendering/RenderQueue.h"
 
 class TextSystem : public ISystem
 {
 private:
-	DirectX3D* _direct3D;
-	ShaderController* _shaderController;
+	IRenderDevice* _renderDevice;
+	RenderQueue* _renderQueue;
 	FontEngine* _fontEngine;
 	Box _screenSize;
 	XMMATRIX _viewMatrix;
 
 	void UpdateTextEntity(TextComponent* textComponent);
+	static void MoveTextEntity(TextComponent* textComponent, XMFLOAT2 position);
 	void UpdateAppearance(TextTexture& texture);
 	void RenderCharacters(vector<TextTexture>& entities);
-	void BuildBufferInformation(TextTexture& character) const;
+	DrawItem BuildDrawItem(TextTexture& character) const;
 	ShaderResources BuildShaderResources(TextTexture& character) const;
 	static ID3D11ShaderResourceView* TextSystem::ExtractResourceViewsFrom(Texture* texture);
 
 public:
-	TextSystem(DirectX3D* direct3D, ShaderController* shaderController, FontEngine* fontEngine, Box screenSize);
+	TextSystem(IRenderDevice* renderDevice, RenderQueue* renderQueue, FontEngine* fontEngine, Box screenSize);
 	~TextSystem();
 	void Shutdown() override;
 
-	void Update(vector<Entity*>& entities, float delta) override;
-	void Render(vector<Entity*>& entities) override;
+	void Update(EntityManager* entityManager, float delta) override;
+	void Render(EntityManager* entityManager) override;
 };
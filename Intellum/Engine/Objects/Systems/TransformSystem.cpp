@@ -1,43 +1,377 @@
 #include "TransformSystem.h"
 #include "../Components/TransformComponent.h"
+#include "../../FixedTimestep.h"
+#include "../../../Common/Constants.h"
 
-TransformSystem::TransformSystem(DirectX3D* direct3D) : _direct3D(direct3D)
+TransformSystem::TransformSystem() : ISystem(MaskOf(TRANSFORM), MaskOf(TRANSFORM), ANY_THREAD), _batch(BATCH_TARGET_WORLD), _renderBatch(BATCH_TARGET_RENDER), _hierarchyStale(false),
+	_focus(0.0f, 0.0f, 0.0f), _hasFocus(false), _reducedRateDistance(SIMULATION_REDUCED_RATE_DISTANCE), _reducedRateInterval(SIMULATION_REDUCED_RATE_INTERVAL),
+	_sleepDelay(SIMULATION_SLEEP_DELAY), _step(0), _integratedCount(0)
 {
 }
 
 void TransformSystem::Shutdown()
 {
+	_hierarchy.clear();
+	_resolvedHierarchy.clear();
+	_renderChanged.clear();
+	_hierarchyIndices.clear();
+	_childrenByParent.clear();
 }
 
-void TransformSystem::Update(vector<Entity*>& entities, float delta)
+void TransformSystem::Update(EntityManager* entityManager, float delta)
 {
-	for (Entity* entity : entities)
+	Query<TransformComponent> query(entityManager);
+	bool hierarchyChanged = _hierarchyStale;
+	_integratedCount = 0;
+	_step++;
+
+	for (Archetype* archetype : query.GetArchetypes())
 	{
-		IComponent* component = entity->GetComponent(TRANSFORM);
-		
-		if (component != nullptr)
+		ComponentArray<TransformComponent>* transforms = archetype->GetColumn<TransformComponent>();
+
+		for (int chunk = 0; chunk < transforms->GetChunkCount(); chunk++)
 		{
-			TransformComponent* transformComponent = static_cast<TransformComponent*>(component);
+			TransformComponent* transformComponents = transforms->GetChunk(chunk);
+			int chunkSize = transforms->GetChunkSize(chunk);
+
+			for (int i = 0; i < chunkSize; i++)
+			{
+				TransformComponent* transformComponent = &transformComponents[i];
+
+				if (transformComponent->ParentChanged)
+				{
+					transformComponent->ParentChanged = false;
+					hierarchyChanged = true;
+				}
+
+				if (IsResting(transformComponent) == false)
+					Simulate(transformComponent, chunk * ComponentArray<TransformComponent>::ChunkCapacity + i, delta);
+
+				if (transformComponent->Dirty == false || transformComponent->HasParent)
+					continue;
+
+				_batch.Add(transformComponent);
+				if (_batch.IsFull())
+					_batch.Compose();
+			}
+		}
+	}
+
+	_batch.Compose();
+
+	if (hierarchyChanged)
+		RebuildHierarchy(entityManager);
+
+	// A node that no longer resolves, or has lost its parent, means the hierarchy changed without going through
+	// SetParent, so the order is rebuilt and the pass repeated rather than leaving its children a frame behind
+	if (UpdateHierarchy(entityManager) == false)
+	{
+		RebuildHierarchy(entityManager);
+		UpdateHierarchy(entityManager);
+	}
+}
+
+void TransformSystem::Render(EntityManager* entityManager)
+{
+}
+
+void TransformSystem::Interpolate(EntityManager* entityManager, float interpolation)
+{
+	Query<TransformComponent> query(entityManager);
+
+	for (Archetype* archetype : query.GetArchetypes())
+	{
+		ComponentArray<TransformComponent>* transforms = archetype->GetColumn<TransformComponent>();
+
+		for (int chunk = 0; chunk < transforms->GetChunkCount(); chunk++)
+		{
+			TransformComponent* transformComponents = transforms->GetChunk(chunk);
+			int chunkSize = transforms->GetChunkSize(chunk);
+
+			for (int i = 0; i < chunkSize; i++)
+			{
+				TransformComponent* transformComponent = &transformComponents[i];
+				if (transformComponent->Moving == false || transformComponent->HasParent)
+					continue;
+
+				_renderBatch.Add(transformComponent, interpolation);
+				if (_renderBatch.IsFull())
+					_renderBatch.Compose();
+			}
+		}
+	}
+
+	_renderBatch.Compose();
+
+	// A child is blended if it moves itself or sits under anything that does. Nodes are resolved again as
+	// entities may have been destroyed since the last step; if the order no longer holds the next step rebuilds
+	// it and the children are simply drawn where that step left them.
+	for (size_t i = 0; i < _hierarchy.size(); i++)
+	{
+		const TransformNode& node = _hierarchy[i];
+		TransformComponent* transform = entityManager->GetComponent<TransformComponent>(node.Entity);
+		if (transform == nullptr || (node.Parent >= 0 && transform->HasParent == false))
+			return;
+
+		_resolvedHierarchy[i] = transform;
+		_renderChanged[i] = transform->Moving || (node.Parent >= 0 && _renderChanged[node.Parent]);
+
+		if (_renderChanged[i] == false || (node.Parent < 0 && transform->HasParent == false))
+			continue;
 
-			if (transformComponent->TransformEnabled == false)
+		XMMATRIX transformation = transform->Moving
+			? ComposeLocal(FixedTimestep::Interpolate(transform->PreviousPosition, transform->Position, interpolation), FixedTimestep::InterpolateRotation(transform->PreviousRotation, transform->Rotation, interpolation), transform->Scale)
+			: ComposeLocal(transform->Position, transform->Rotation, transform->Scale);
+
+		if (node.Parent >= 0)
+			transformation *= _resolvedHierarchy[node.Parent]->RenderTransformation;
+
+		transform->RenderTransformation = transformation;
+	}
+}
+
+void TransformSystem::SetFocus(XMFLOAT3 focus)
+{
+	_focus = focus;
+	_hasFocus = true;
+}
+
+void TransformSystem::SetReducedRate(float distance, int interval)
+{
+	_reducedRateDistance = distance;
+	_reducedRateInterval = interval;
+}
+
+void TransformSystem::SetSleepDelay(float sleepDelay)
+{
+	_sleepDelay = sleepDelay;
+}
+
+int TransformSystem::GetHierarchySize() const
+{
+	return static_cast<int>(_hierarchy.size());
+}
+
+int TransformSystem::GetIntegratedCount() const
+{
+	return _integratedCount;
+}
+
+void TransformSystem::Simulate(TransformComponent* transform, int row, float delta)
+{
+	bool moving = transform->Simulation != SIMULATION_STATIC && transform->TransformEnabled && IsMoving(transform);
+
+	if (moving)
+	{
+		transform->Wake();
+
+		if (_reducedRateInterval > 1 && IsDistant(transform))
+		{
+			// Skipped steps are owed to the transform and paid back in one go on its turn, so distant motion keeps
+			// the same speed. Until then it is drawn where it is rather than blended back towards an older step.
+			transform->PendingDelta += delta;
+			transform->PreviousPosition = transform->Position;
+			transform->PreviousRotation = transform->Rotation;
+
+			if ((row + _step) % _reducedRateInterval != 0)
+				return;
+
+			delta = transform->PendingDelta;
+			transform->PendingDelta = 0.0f;
+		}
+		else
+		{
+			delta += transform->PendingDelta;
+			transform->PendingDelta = 0.0f;
+		}
+
+		transform->PreviousPosition = transform->Position;
+		transform->PreviousRotation = transform->Rotation;
+		UpdatePosition(transform->Position, transform->Velocity, delta);
+		UpdateRotation(transform->Rotation, transform->AngularVelocity, delta);
+		transform->Dirty = true;
+		_integratedCount++;
+	}
+	else if (transform->Simulation == SIMULATION_ACTIVE)
+	{
+		transform->RestingTime += delta;
+		if (transform->RestingTime >= _sleepDelay)
+			transform->Simulation = SIMULATION_SLEEPING;
+	}
+
+	// Recomposing once after a transform stops brings its render matrix back to where it came to rest
+	if (moving != transform->Moving)
+	{
+		transform->Moving = moving;
+		transform->PendingDelta = 0.0f;
+		transform->Dirty = true;
+	}
+}
+
+bool TransformSystem::IsDistant(const TransformComponent* transform) const
+{
+	if (_hasFocus == false)
+		return false;
+
+	float x = transform->WorldPosition.x - _focus.x;
+	float y = transform->WorldPosition.y - _focus.y;
+	float z = transform->WorldPosition.z - _focus.z;
+
+	return x * x + y * y + z * z > _reducedRateDistance * _reducedRateDistance;
+}
+
+void TransformSystem::RebuildHierarchy(EntityManager* entityManager)
+{
+	_hierarchy.clear();
+	_hierarchyIndices.clear();
+	_childrenByParent.clear();
+	_hierarchyStale = false;
+
+	vector<EntityHandle> children;
+	Query<TransformComponent> query(entityManager);
+
+	for (Archetype* archetype : query.GetArchetypes())
+	{
+		ComponentArray<TransformComponent>* transforms = archetype->GetColumn<TransformComponent>();
+
+		for (int row = 0; row < archetype->GetSize(); row++)
+		{
+			TransformComponent* transform = transforms->At(row);
+			if (transform->HasParent == false)
 				continue;
 
-			XMMATRIX transformation = _direct3D->GetWorldMatrix();
+			EntityHandle child = archetype->GetEntity(row)->GetHandle();
+			children.push_back(child);
+
+			// Children of a destroyed parent are left out here and end up as roots below
+			if (entityManager->GetComponent<TransformComponent>(transform->Parent) != nullptr)
+				_childrenByParent[transform->Parent.Index].push_back(child);
+		}
+	}
+
+	for (map<unsigned int, vector<EntityHandle>>::iterator iterator = _childrenByParent.begin(); iterator != _childrenByParent.end(); ++iterator)
+	{
+		EntityHandle parent = entityManager->GetComponent<TransformComponent>(iterator->second.front())->Parent;
+		if (entityManager->GetComponent<TransformComponent>(parent)->HasParent == false)
+			AddHierarchyNode(parent, -1);
+	}
+
+	ExpandHierarchy(0);
+
+	// Anything not reached from a root is either orphaned or part of a cycle. Each is treated as a root so it
+	// still gets a world matrix, and the walk stops when it comes back round to a node it has already placed.
+	for (const EntityHandle& child : children)
+	{
+		if (_hierarchyIndices.find(child.Index) != _hierarchyIndices.end())
+			continue;
+
+		size_t firstNode = _hierarchy.size();
+		AddHierarchyNode(child, -1);
+		ExpandHierarchy(firstNode);
+	}
+
+	_resolvedHierarchy.resize(_hierarchy.size());
+	_renderChanged.resize(_hierarchy.size());
+}
+
+void TransformSystem::AddHierarchyNode(EntityHandle entity, int parent)
+{
+	if (_hierarchyIndices.find(entity.Index) != _hierarchyIndices.end())
+		return;
+
+	TransformNode node;
+	node.Entity = entity;
+	node.Parent = parent;
+	node.ParentVersion = 0;
+
+	_hierarchyIndices[entity.Index] = static_cast<int>(_hierarchy.size());
+	_hierarchy.push_back(node);
+}
+
+void TransformSystem::ExpandHierarchy(size_t firstNode)
+{
+	for (size_t node = firstNode; node < _hierarchy.size(); node++)
+	{
+		map<unsigned int, vector<EntityHandle>>::iterator children = _childrenByParent.find(_hierarchy[node].Entity.Index);
+		if (children == _childrenByParent.end())
+			continue;
+
+		for (const EntityHandle& child : children->second)
+			AddHierarchyNode(child, static_cast<int>(node));
+	}
+}
+
+bool TransformSystem::UpdateHierarchy(EntityManager* entityManager)
+{
+	for (size_t i = 0; i < _hierarchy.size(); i++)
+	{
+		TransformNode& node = _hierarchy[i];
+		TransformComponent* transform = entityManager->GetComponent<TransformComponent>(node.Entity);
+		if (transform == nullptr || (node.Parent >= 0 && transform->HasParent == false))
+		{
+			_hierarchyStale = true;
+			return false;
+		}
 
-			UpdatePosition(transformComponent->Position, transformComponent->Velocity, delta);
-			UpdateRotation(transformComponent->Rotation, transformComponent->AngularVelocity, delta);
+		_resolvedHierarchy[i] = transform;
 
-			transformation *= XMMatrixScaling(transformComponent->Scale.x, transformComponent->Scale.y, transformComponent->Scale.z);
-			transformation *= XMMatrixRotationRollPitchYaw(transformComponent->Rotation.x, transformComponent->Rotation.y, transformComponent->Rotation.z);
-			transformation *= XMMatrixTranslation(transformComponent->Position.x, transformComponent->Position.y, transformComponent->Position.z);
+		if (node.Parent < 0)
+		{
+			// Parentless roots were already composed with the rest of their archetype
+			if (transform->HasParent && transform->Dirty)
+				ComposeWorld(transform, nullptr);
 
-			transformComponent->Transformation = transformation;
+			continue;
 		}
+
+		TransformComponent* parent = _resolvedHierarchy[node.Parent];
+		if (transform->Dirty == false && parent->WorldVersion == node.ParentVersion)
+			continue;
+
+		ComposeWorld(transform, &parent->Transformation);
+		node.ParentVersion = parent->WorldVersion;
 	}
+
+	return true;
+}
+
+// Static transforms, and sleeping ones that have not been given a velocity since, have nothing to simulate once
+// they have stopped. They are only recomposed when something else marks them dirty.
+bool TransformSystem::IsResting(const TransformComponent* transform)
+{
+	if (transform->Moving)
+		return false;
+
+	return transform->Simulation == SIMULATION_STATIC || (transform->Simulation == SIMULATION_SLEEPING && IsMoving(transform) == false);
+}
+
+bool TransformSystem::IsMoving(const TransformComponent* transform)
+{
+	return transform->Velocity.x != 0.0f || transform->Velocity.y != 0.0f || transform->Velocity.z != 0.0f
+		|| transform->AngularVelocity.x != 0.0f || transform->AngularVelocity.y != 0.0f || transform->AngularVelocity.z != 0.0f;
+}
+
+XMMATRIX TransformSystem::ComposeLocal(const XMFLOAT3& position, const XMFLOAT3& rotation, const XMFLOAT3& scale)
+{
+	XMMATRIX transformation = XMMatrixScaling(scale.x, scale.y, scale.z);
+	transformation *= XMMatrixRotationRollPitchYaw(rotation.x, rotation.y, rotation.z);
+	transformation *= XMMatrixTranslation(position.x, position.y, position.z);
+
+	return transformation;
 }
 
-void TransformSystem::Render(vector<Entity*>& entities)
+void TransformSystem::ComposeWorld(TransformComponent* transform, const XMMATRIX* parentTransformation)
 {
+	XMMATRIX transformation = ComposeLocal(transform->Position, transform->Rotation, transform->Scale);
+
+	if (parentTransformation != nullptr)
+		transformation *= *parentTransformation;
+
+	transform->Transformation = transformation;
+	transform->RenderTransformation = transformation;
+	XMStoreFloat3(&transform->WorldPosition, transformation.r[3]);
+	transform->WorldVersion++;
+	transform->Dirty = false;
 }
 
 void TransformSystem::UpdatePosition(XMFLOAT3& position, XMFLOAT3 velocity, float delta)
@@ -1,22 +1,76 @@
 #pragma once
+#include <map>
 #include <vector>
-#include "../../DirectX3D.h"
+#include <DirectXMath.h>
 #include "../Entity.h"
 #include "ISystem.h"
+#include "../Transform/TransformBatch.h"
 
+using namespace DirectX;
+
+class TransformComponent;
+
+// Transforms without a parent are updated in their archetype chunks and the dirty ones composed a batch at a time
+// by TransformBatch. Parented transforms are kept in a separate array sorted so every parent comes before its
+// children, which lets a single pass push a changed world matrix down each subtree. A transform is only
+// recomposed when it moved or its parent did. Between simulation steps Interpolate blends moving transforms, and
+// anything parented to them, into RenderTransformation so rendering is not tied to the step rate. Moving
+// transforms further than the reduced rate distance from the focus only integrate every few steps, taking turns
+// by row so the work is spread evenly across steps. Static and sleeping transforms are skipped by the simulation.
 class TransformSystem : public ISystem
 {
 private:
-	DirectX3D* _direct3D;
+	struct TransformNode
+	{
+		EntityHandle Entity;
+		int Parent;
+		unsigned int ParentVersion;
+	};
+
+	TransformBatch _batch;
+	TransformBatch _renderBatch;
+	vector<TransformNode> _hierarchy;
+	vector<TransformComponent*> _resolvedHierarchy;
+	vector<char> _renderChanged;
+	map<unsigned int, int> _hierarchyIndices;
+	map<unsigned int, vector<EntityHandle>> _childrenByParent;
+	bool _hierarchyStale;
+
+	XMFLOAT3 _focus;
+	bool _hasFocus;
+	float _reducedRateDistance;
+	int _reducedRateInterval;
+	float _sleepDelay;
+	unsigned int _step;
+	int _integratedCount;
 
+	void RebuildHierarchy(EntityManager* entityManager);
+	void AddHierarchyNode(EntityHandle entity, int parent);
+	void ExpandHierarchy(size_t firstNode);
+	bool UpdateHierarchy(EntityManager* entityManager);
+	void Simulate(TransformComponent* transform, int row, float delta);
+	bool IsDistant(const TransformComponent* transform) const;
+
+	static bool IsMoving(const TransformComponent* transform);
+	static bool IsResting(const TransformComponent* transform);
+	static XMMATRIX ComposeLocal(const XMFLOAT3& position, const XMFLOAT3& rotation, const XMFLOAT3& scale);
+	static void ComposeWorld(TransformComponent* transform, const XMMATRIX* parentTransformation);
 	static void UpdatePosition(XMFLOAT3& position, XMFLOAT3 velocity, float delta);
 	static void UpdateRotation(XMFLOAT3& rotation, XMFLOAT3 velocity, float delta);
 	static float CapRotationRange(float rotation);
 public:
-	TransformSystem(DirectX3D* direct3D);
+	TransformSystem();
 	~TransformSystem() override = default;
 	void Shutdown() override;
 	
-	void Update(vector<Entity*>& entities, float delta) override;
-	void Render(vector<Entity*>& entities) override;
-};
+	void Update(EntityManager* entityManager, float delta) override;
+	void Render(EntityManager* entityManager) override;
+	void Interpolate(EntityManager* entityManager, float interpolation);
+
+	void SetFocus(XMFLOAT3 focus);
+	void SetReducedRate(float distance, int interval);
+	void SetSleepDelay(float sleepDelay);
+
+	int GetHierarchySize() const;
+	int GetIntegratedCount() const;
+};
\ No newline at end of file
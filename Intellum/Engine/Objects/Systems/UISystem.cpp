@@ -2,7 +2,8 @@
 #include "../Components/TransformComponent.h"
 #include "../Components/AppearanceComponent.h"
 
-UISystem::UISystem(DirectX3D* direct3D, ShaderController* shaderController, HWND hwnd, Box screenSize): _direct3D(direct3D), _shaderController(shaderController), _screenSize(screenSize)
+UISystem::UISystem(IRenderDevice* renderDevice, Box screenSize)
+	: ISystem(MaskOf(APPEARANCE) | MaskOf(USER_INTERFACE) | MaskOf(TRANSFORM), MaskOf(USER_INTERFACE), MAIN_THREAD), _renderDevice(renderDevice), _screenSize(screenSize)
 {
 
 }
@@ -11,88 +12,73 @@ void UISystem::Shutdown()
 {
 }
 
-void UISystem::Update(vector<Entity*>& entities, float delta)
+void UISystem::Update(EntityManager* entityManager, float delta)
 {
-	for(int i = 0; i < entities.size(); i++)
-	{
-		Entity* entity = entities.at(i);
-		IComponent* component = entity->GetComponent(APPEARANCE);
-
-		if (component == nullptr)
-			continue;
-
-		AppearanceComponent* appearance = static_cast<AppearanceComponent*>(component);
-
-		component = entity->GetComponent(USER_INTERFACE);
-
-		if (component == nullptr)
-			continue;
-
-		UIComponent* ui = static_cast<UIComponent*>(component);
+	Query<AppearanceComponent, UIComponent, TransformComponent> query(entityManager);
 
-		component = entity->GetComponent(TRANSFORM);
-
-		if (component == nullptr)
-			continue;
-
-		TransformComponent* transform = static_cast<TransformComponent*>(component);
-
-		if (transform->TransformEnabled == false)
-			continue;
+	for (Archetype* archetype : query.GetArchetypes())
+	{
+		ComponentArray<AppearanceComponent>* appearances = archetype->GetColumn<AppearanceComponent>();
+		ComponentArray<UIComponent>* uis = archetype->GetColumn<UIComponent>();
+		ComponentArray<TransformComponent>* transforms = archetype->GetColumn<TransformComponent>();
 
-		if ((transform->Position.x == static_cast<int>(ui->PreviousPosition.x)) && (transform->Position.y == static_cast<int>(ui->PreviousPosition.y))
-			&& (ui->BitmapSize.x == ui->PreviousBitmapSize.x) && (ui->BitmapSize.y == ui->PreviousBitmapSize.y))
+		for (int row = 0; row < archetype->GetSize(); row++)
 		{
-			continue;
-		}
+			AppearanceComponent* appearance = appearances->At(row);
+			UIComponent* ui = uis->At(row);
+			TransformComponent* transform = transforms->At(row);
 
-		ui->PreviousPosition = XMFLOAT2(transform->Position.x, transform->Position.y);
-		ui->PreviousBitmapSize = ui->BitmapSize;
+			if (transform->TransformEnabled == false)
+				continue;
 
-		float left = ((_screenSize.Width / 2) * -1) + (transform->Position.x);
-		float right = left + ui->BitmapSize.x;
+			XMFLOAT3 position = transform->WorldPosition;
 
-		float top = (_screenSize.Height / 2) - transform->Position.y;
-		float bottom = top - ui->BitmapSize.y;
+			if ((position.x == static_cast<int>(ui->PreviousPosition.x)) && (position.y == static_cast<int>(ui->PreviousPosition.y))
+				&& (ui->BitmapSize.x == ui->PreviousBitmapSize.x) && (ui->BitmapSize.y == ui->PreviousBitmapSize.y))
+			{
+				continue;
+			}
 
-		float zBuffer = transform->Position.z;
+			ui->PreviousPosition = XMFLOAT2(position.x, position.y);
+			ui->PreviousBitmapSize = ui->BitmapSize;
 
-		Vertex* vertices = new Vertex[appearance->Model.VertexCount];
-		if (!vertices) throw Exception("Failed to initialise vertices for bitmap");
+			float left = ((_screenSize.Width / 2) * -1) + (position.x);
+			float right = left + ui->BitmapSize.x;
 
-		vertices[0].position = XMFLOAT3(left, top, zBuffer);
-		vertices[0].texture = XMFLOAT2(0.0f, 0.0f);
+			float top = (_screenSize.Height / 2) - position.y;
+			float bottom = top - ui->BitmapSize.y;
 
-		vertices[1].position = XMFLOAT3(right, bottom, zBuffer);
-		vertices[1].texture = XMFLOAT2(1.0f, 1.0f);
+			float zBuffer = position.z;
 
-		vertices[2].position = XMFLOAT3(left, bottom, zBuffer);
-		vertices[2].texture = XMFLOAT2(0.0f, 1.0f);
+			Vertex* vertices = new Vertex[appearance->Model.VertexCount];
+			if (!vertices) throw Exception("Failed to initialise vertices for bitmap");
 
-		vertices[3].position = XMFLOAT3(left, top, zBuffer);
-		vertices[3].texture = XMFLOAT2(0.0f, 0.0f);
+			vertices[0].position = XMFLOAT3(left, top, zBuffer);
+			vertices[0].texture = XMFLOAT2(0.0f, 0.0f);
 
-		vertices[4].position = XMFLOAT3(right, top, zBuffer);
-		vertices[4].texture = XMFLOAT2(1.0f, 0.0f);
+			vertices[1].position = XMFLOAT3(right, bottom, zBuffer);
+			vertices[1].texture = XMFLOAT2(1.0f, 1.0f);
 
-		vertices[5].position = XMFLOAT3(right, bottom, zBuffer);
-		vertices[5].texture = XMFLOAT2(1.0f, 1.0f);
+			vertices[2].position = XMFLOAT3(left, bottom, zBuffer);
+			vertices[2].texture = XMFLOAT2(0.0f, 1.0f);
 
-		D3D11_MAPPED_SUBRESOURCE mappedResource;
-		HRESULT result = _direct3D->GetDeviceContext()->Map(appearance->Model.VertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-		if (FAILED(result)) throw Exception("Failed to map vertex buffer to the Device Context");
+			vertices[3].position = XMFLOAT3(left, top, zBuffer);
+			vertices[3].texture = XMFLOAT2(0.0f, 0.0f);
 
-		Vertex* verticesPtr = static_cast<Vertex*>(mappedResource.pData);
+			vertices[4].position = XMFLOAT3(right, top, zBuffer);
+			vertices[4].texture = XMFLOAT2(1.0f, 0.0f);
 
-		memcpy(verticesPtr, static_cast<void*>(vertices), (sizeof(Vertex) * appearance->Model.VertexCount));
+			vertices[5].position = XMFLOAT3(right, bottom, zBuffer);
+			vertices[5].texture = XMFLOAT2(1.0f, 1.0f);
 
-		_direct3D->GetDeviceContext()->Unmap(appearance->Model.VertexBuffer, 0);
+			_renderDevice->WriteBuffer(appearance->Model.VertexBuffer, vertices, sizeof(Vertex) * appearance->Model.VertexCount);
 
-		delete[] vertices;
-		vertices = nullptr;
+			delete[] vertices;
+			vertices = nullptr;
+		}
 	}
 }
 
-void UISystem::Render(vector<Entity*>& entities)
+void UISystem::Render(EntityManager* entityManager)
 {
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 #include "ISystem.h"
-#include "../../ShaderEngine/ShaderController.h"
+#include "../../Rendering/IRenderDevice.h"
 #include "../../../common/Vertex.h"
+#include "../../../common/Box.h"
 #include "../Components/UIComponent.h"
 
 class UISystem : public ISystem
@@ -10,13 +11,12 @@ private:
 	Box _screenSize;
 
 public:
-	DirectX3D* _direct3D;
-	ShaderController* _shaderController;
+	IRenderDevice* _renderDevice;
 
-	UISystem(DirectX3D* direct3D, ShaderController* shaderController, HWND hwnd, Box screenSize);
+	UISystem(IRenderDevice* renderDevice, Box screenSize);
 	~UISystem() override = default;
 
 	void Shutdown() override;
-	void Update(vector<Entity*>& entities, float delta) override;
-	void Render(vector<Entity*>& entities) override;
+	void Update(EntityManager* entityManager, float delta) override;
+	void Render(EntityManager* entityManager) override;
 };
\ No newline at end of file
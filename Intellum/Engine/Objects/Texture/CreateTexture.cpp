@@ -8,14 +8,14 @@ CreateTexture::~CreateTexture()
 {
 }
 
-Texture* CreateTexture::From(DirectX3D* direct3D, char* fileName)
+Texture* CreateTexture::From(IRenderDevice* renderDevice, char* fileName)
 {
 	try
 	{
 		if (string(fileName) == "")
 			return nullptr;
 
-		return new Texture(direct3D, fileName);
+		return new Texture(renderDevice, fileName);
 	}
 	catch(Exception&)
 	{
@@ -23,13 +23,13 @@ Texture* CreateTexture::From(DirectX3D* direct3D, char* fileName)
 	}
 }
 
-vector<Texture*> CreateTexture::ListFrom(DirectX3D* direct3D, vector<char*> fileNames)
+vector<Texture*> CreateTexture::ListFrom(IRenderDevice* renderDevice, vector<char*> fileNames)
 {
 	vector<Texture*> textureList;
 
 	for (int i = 0; i < fileNames.size(); i++)
 	{
-		Texture* texture = From(direct3D, fileNames.at(i));
+		Texture* texture = From(renderDevice, fileNames.at(i));
 
 		if (texture != nullptr)
 			textureList.push_back(texture);
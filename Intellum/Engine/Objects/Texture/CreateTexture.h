@@ -1,9 +1,7 @@
 #pragma once
 #include "Texture.h"
-#include "../../DirectX3D.h"
 #include <string>
 #include "../../../ErrorHandling/Exception.h"
-#include "../../DirectX3D.h"
 
 class CreateTexture
 {
@@ -11,6 +9,6 @@ public:
 	CreateTexture();
 	~CreateTexture();
 
-	static Texture* From(DirectX3D* direct3D, char* fileName);
-	static vector<Texture*> ListFrom(DirectX3D* direct3D, vector<char*> fileName);
+	static Texture* From(IRenderDevice* renderDevice, char* fileName);
+	static vector<Texture*> ListFrom(IRenderDevice* renderDevice, vector<char*> fileName);
 };
\ No newline at end of file
@@ -6,36 +6,27 @@
 #include "../../../ErrorHandling/Exception.h"
 #include "../../../Loaders/TargaLoader.h"
 #include "../../../common/Box.h"
-#include "../../DirectX3D.h"
+#include "../../Rendering/IRenderDevice.h"
 
 using namespace std;
 
 class Texture
 {
-	struct TargaHeader
-	{
-		unsigned char data1[12];
-		unsigned short width;
-		unsigned short height;
-		unsigned char bpp;
-		unsigned char data2;
-	};
-
 private:
-	ID3D11Texture2D* _texture;
+	IRenderDevice* _renderDevice;
 	ID3D11ShaderResourceView* _textureView;
 
 private:
-	void Initialise(DirectX3D* direct3d, char* filename);
-
-	D3D11_TEXTURE2D_DESC SetupAndReturnDX11TextureDescription(ID3D11Device* device, Box textureBox);
-	static D3D11_SHADER_RESOURCE_VIEW_DESC SetupDX11ShaderResourceViewDescription(D3D11_TEXTURE2D_DESC textureDescription);
+	void Initialise(char* filename);
 
 public:
-	Texture(DirectX3D* direct3d, char* filename);
+	Texture(IRenderDevice* renderDevice, char* filename);
+	Texture(IRenderDevice* renderDevice, const TargaData& targaData);
+	Texture(IRenderDevice* renderDevice, ID3D11ShaderResourceView* textureView);
 	~Texture();
 
 	void Shutdown();
+	void Swap(Texture& other);
 
 	ID3D11ShaderResourceView* GetTexture() const;
 };
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include "TextureCache.h"
+#include <cctype>
+
+namespace
+{
+	string NormalisePath(const string& path)
+	{
+		string key = path;
+		for (char& character : key)
+			character = character == '\\' ? '/' : static_cast<char>(tolower(static_cast<unsigned char>(character)));
+
+		return key;
+	}
+
+	// Textures are created with a full mip chain
+	size_t TextureBytes(const Box& imageSize)
+	{
+		size_t bytes = 0;
+		unsigned int width = static_cast<unsigned int>(imageSize.Width);
+		unsigned int height = static_cast<unsigned int>(imageSize.Height);
+
+		while (true)
+		{
+			bytes += static_cast<size_t>(width) * height * 4;
+			if (width == 1 && height == 1)
+				return bytes;
+
+			width = width > 1 ? width / 2 : 1;
+			height = height > 1 ? height / 2 : 1;
+		}
+	}
+}
+
+TextureCache::TextureCache(IRenderDevice* renderDevice) : _renderDevice(renderDevice), _hits(0), _misses(0), _residentBytes(0)
+{
+}
+
+TextureCache::~TextureCache()
+{
+}
+
+void TextureCache::Shutdown()
+{
+	for (map<Texture*, CachedTexture>::iterator iterator = _textures.begin(); iterator != _textures.end(); ++iterator)
+		delete iterator->first;
+
+	for (map<ID3D11ShaderResourceView*, CachedImage>::iterator iterator = _images.begin(); iterator != _images.end(); ++iterator)
+		_renderDevice->ReleaseTexture(iterator->first);
+
+	_paths.clear();
+	_textures.clear();
+	_contents.clear();
+	_images.clear();
+	_residentBytes = 0;
+}
+
+Texture* TextureCache::Acquire(Texture* texture)
+{
+	_textures[texture].References++;
+	_hits++;
+	return texture;
+}
+
+// FNV-1a over the dimensions and every pixel. Safe to call from any thread.
+unsigned long long TextureCache::HashImage(const TargaData& targaData)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	unsigned int dimensions[2] = { static_cast<unsigned int>(targaData.ImageSize.Width), static_cast<unsigned int>(targaData.ImageSize.Height) };
+
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(dimensions);
+	for (size_t i = 0; i < sizeof(dimensions); i++)
+		hash = (hash ^ bytes[i]) * 1099511628211ULL;
+
+	size_t imageBytes = static_cast<size_t>(dimensions[0]) * dimensions[1] * 4;
+	for (size_t i = 0; i < imageBytes; i++)
+		hash = (hash ^ targaData.ImageData[i]) * 1099511628211ULL;
+
+	return hash;
+}
+
+// Returns null for a file that cannot be loaded, the same as CreateTexture::From
+Texture* TextureCache::From(const string& path)
+{
+	if (path.empty())
+		return nullptr;
+
+	Texture* texture = Find(path);
+	if (texture != nullptr)
+		return texture;
+
+	TargaData targaData;
+	try
+	{
+		targaData = TargaLoader::LoadTarga(const_cast<char*>(path.c_str()));
+	}
+	catch (Exception&)
+	{
+		return nullptr;
+	}
+
+	return FromImage(path, targaData, HashImage(targaData));
+}
+
+// Only hands out a texture that is already resident, leaving loading to the caller
+Texture* TextureCache::Find(const string& path)
+{
+	map<string, Texture*>::iterator cachedPath = _paths.find(NormalisePath(path));
+	if (cachedPath == _paths.end())
+		return nullptr;
+
+	return Acquire(cachedPath->second);
+}
+
+// Takes an image that has already been decoded and hashed. The image data is always freed.
+Texture* TextureCache::FromImage(const string& path, TargaData& targaData, unsigned long long contentHash)
+{
+	string key = NormalisePath(path);
+
+	map<string, Texture*>::iterator cachedPath = _paths.find(key);
+	if (cachedPath != _paths.end())
+	{
+		delete[] targaData.ImageData;
+		targaData.ImageData = nullptr;
+		return Acquire(cachedPath->second);
+	}
+
+	bool resident = _contents.find(contentHash) != _contents.end();
+
+	ID3D11ShaderResourceView* textureView = UseImage(targaData, contentHash);
+	if (textureView == nullptr)
+		return nullptr;
+
+	CachedTexture cached;
+	cached.Path = key;
+	cached.References = 1;
+
+	Texture* texture = new Texture(_renderDevice, textureView);
+	_paths[key] = texture;
+	_textures[texture] = cached;
+
+	if (resident)
+		_hits++;
+	else
+		_misses++;
+
+	return texture;
+}
+
+vector<Texture*> TextureCache::ListFrom(const vector<string>& paths)
+{
+	vector<Texture*> textureList;
+
+	for (const string& path : paths)
+	{
+		Texture* texture = From(path);
+
+		if (texture != nullptr)
+			textureList.push_back(texture);
+	}
+
+	return textureList;
+}
+
+// Takes another reference to a texture the cache handed out, for a second holder of it. Anything else is returned
+// as it is.
+Texture* TextureCache::Share(Texture* texture)
+{
+	map<Texture*, CachedTexture>::iterator cached = _textures.find(texture);
+	if (cached != _textures.end())
+		cached->second.References++;
+
+	return texture;
+}
+
+// Points the texture handed out for a resident path at the new image, so every holder of that path sees the new
+// pixels without being told and other paths that shared the old image keep it. The image data is always freed.
+bool TextureCache::Reload(const string& path, TargaData& targaData, unsigned long long contentHash)
+{
+	map<string, Texture*>::iterator cachedPath = _paths.find(NormalisePath(path));
+
+	ID3D11ShaderResourceView* textureView = cachedPath != _paths.end() ? UseImage(targaData, contentHash) : nullptr;
+	if (textureView == nullptr)
+	{
+		delete[] targaData.ImageData;
+		targaData.ImageData = nullptr;
+		return false;
+	}
+
+	Texture replaced(_renderDevice, textureView);
+	cachedPath->second->Swap(replaced);
+	ReleaseImage(replaced.GetTexture());
+
+	return true;
+}
+
+// Hands out a use of the resident view holding this image, or uploads it. The image data is always freed.
+ID3D11ShaderResourceView* TextureCache::UseImage(TargaData& targaData, unsigned long long contentHash)
+{
+	map<unsigned long long, ID3D11ShaderResourceView*>::iterator cachedContent = _contents.find(contentHash);
+	if (cachedContent != _contents.end())
+	{
+		delete[] targaData.ImageData;
+		targaData.ImageData = nullptr;
+
+		_images[cachedContent->second].Users++;
+		return cachedContent->second;
+	}
+
+	ID3D11ShaderResourceView* textureView = nullptr;
+	try
+	{
+		textureView = _renderDevice->CreateTexture(targaData);
+	}
+	catch (Exception&)
+	{
+	}
+
+	CachedImage image;
+	image.ContentHash = contentHash;
+	image.Bytes = TextureBytes(targaData.ImageSize);
+	image.Users = 1;
+
+	delete[] targaData.ImageData;
+	targaData.ImageData = nullptr;
+
+	if (textureView == nullptr)
+		return nullptr;
+
+	_contents[contentHash] = textureView;
+	_images[textureView] = image;
+	_residentBytes += image.Bytes;
+
+	return textureView;
+}
+
+void TextureCache::ReleaseImage(ID3D11ShaderResourceView* textureView)
+{
+	map<ID3D11ShaderResourceView*, CachedImage>::iterator image = _images.find(textureView);
+	if (image == _images.end() || --image->second.Users > 0)
+		return;
+
+	map<unsigned long long, ID3D11ShaderResourceView*>::iterator content = _contents.find(image->second.ContentHash);
+	if (content != _contents.end() && content->second == textureView)
+		_contents.erase(content);
+
+	_residentBytes -= image->second.Bytes;
+	_images.erase(image);
+
+	_renderDevice->ReleaseTexture(textureView);
+}
+
+void TextureCache::Release(Texture* texture)
+{
+	map<Texture*, CachedTexture>::iterator cached = _textures.find(texture);
+	if (cached == _textures.end() || --cached->second.References > 0)
+		return;
+
+	map<string, Texture*>::iterator path = _paths.find(cached->second.Path);
+	if (path != _paths.end() && path->second == texture)
+		_paths.erase(path);
+
+	_textures.erase(cached);
+
+	ReleaseImage(texture->GetTexture());
+	delete texture;
+}
+
+int TextureCache::GetTextureCount() const
+{
+	return static_cast<int>(_images.size());
+}
+
+int TextureCache::GetHitCount() const
+{
+	return _hits;
+}
+
+int TextureCache::GetMissCount() const
+{
+	return _misses;
+}
+
+size_t TextureCache::GetResidentBytes() const
+{
+	return _residentBytes;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include "Texture.h"
+
+using namespace std;
+
+// Keeps a single GPU copy of every distinct image. Textures are looked up by normalised path first, and a path
+// seen for the first time is decoded and hashed so an identical image saved under another name still resolves
+// to the resource view already resident. Each path is handed out as a texture of its own over that shared view,
+// so reloading one path never changes what the others draw. Every texture handed out, or taken again through
+// Share, is given back through Release and freed once its last holder has done so, with the view freed once no
+// path uses it and anything still held freed at Shutdown.
+class TextureCache
+{
+private:
+	struct CachedTexture
+	{
+		string Path;
+		int References;
+	};
+
+	struct CachedImage
+	{
+		unsigned long long ContentHash;
+		size_t Bytes;
+		int Users;
+	};
+
+	IRenderDevice* _renderDevice;
+	map<string, Texture*> _paths;
+	map<Texture*, CachedTexture> _textures;
+	map<unsigned long long, ID3D11ShaderResourceView*> _contents;
+	map<ID3D11ShaderResourceView*, CachedImage> _images;
+
+	int _hits;
+	int _misses;
+	size_t _residentBytes;
+
+	Texture* Acquire(Texture* texture);
+	ID3D11ShaderResourceView* UseImage(TargaData& targaData, unsigned long long contentHash);
+	void ReleaseImage(ID3D11ShaderResourceView* textureView);
+
+public:
+	TextureCache(IRenderDevice* renderDevice);
+	~TextureCache();
+
+	void Shutdown();
+
+	Texture* From(const string& path);
+	Texture* Find(const string& path);
+	Texture* FromImage(const string& path, TargaData& targaData, unsigned long long contentHash);
+	vector<Texture*> ListFrom(const vector<string>& paths);
+	Texture* Share(Texture* texture);
+
+	bool Reload(const string& path, TargaData& targaData, unsigned long long contentHash);
+	void Release(Texture* texture);
+
+	static unsigned long long HashImage(const TargaData& targaData);
+
+	int GetTextureCount() const;
+	int GetHitCount() const;
+	int GetMissCount() const;
+	size_t GetResidentBytes() const;
+};
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "Transform.h"
 
-Transform::Transform(DirectX3D* direct3D) : _direct3D(direct3D), _position(XMFLOAT3(0.0f, 0.0f, 0.0f)), _rotation(XMFLOAT3(0.0f, 0.0f, 0.0f)), _scale(XMFLOAT3(1.0f, 1.0f, 1.0f))
+Transform::Transform(IRenderDevice* renderDevice) : _renderDevice(renderDevice), _position(XMFLOAT3(0.0f, 0.0f, 0.0f)), _rotation(XMFLOAT3(0.0f, 0.0f, 0.0f)), _scale(XMFLOAT3(1.0f, 1.0f, 1.0f))
 {
 }
 
@@ -10,7 +10,7 @@ Transform::~Transform()
 
 void Transform::Update(float delta)
 {
-	XMMATRIX transformation = _direct3D->GetWorldMatrix();
+	XMMATRIX transformation = _renderDevice->GetWorldMatrix();
 	
 	UpdatePosition(delta);
 	UpdateRotation(delta);
@@ -1,13 +1,13 @@
 #pragma once
 #include <DirectXMath.h>
-#include "../../DirectX3D.h"
+#include "../../Rendering/IRenderDevice.h"
 
 using namespace DirectX;
 
 class Transform
 {
 private:
-	DirectX3D* _direct3D;
+	IRenderDevice* _renderDevice;
 	XMMATRIX _transformation;
 
 	XMFLOAT3 _position;
@@ -22,7 +22,7 @@ private:
 	static float CapRotationRange(float rotation);
 
 public:
-	Transform(DirectX3D* direct3D);
+	Transform(IRenderDevice* renderDevice);
 	~Transform();
 
 	void Update(float delta);
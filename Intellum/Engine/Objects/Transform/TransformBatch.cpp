@@ -0,0 +1,264 @@
+#include "TransformBatch.h"
+#include <cmath>
+#include "../Components/TransformComponent.h"
+#include "../../FixedTimestep.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define TRANSFORM_BATCH_SIMD
+#elif defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define TRANSFORM_BATCH_SIMD
+#endif
+
+namespace
+{
+#if defined(__AVX__)
+	typedef __m256 FloatLanes;
+	const int LaneCount = 8;
+
+	inline FloatLanes LanesSet(float value) { return _mm256_set1_ps(value); }
+	inline FloatLanes LanesLoad(const float* values) { return _mm256_loadu_ps(values); }
+	inline void LanesStore(float* values, FloatLanes lanes) { _mm256_storeu_ps(values, lanes); }
+	inline FloatLanes LanesAdd(FloatLanes a, FloatLanes b) { return _mm256_add_ps(a, b); }
+	inline FloatLanes LanesSubtract(FloatLanes a, FloatLanes b) { return _mm256_sub_ps(a, b); }
+	inline FloatLanes LanesMultiply(FloatLanes a, FloatLanes b) { return _mm256_mul_ps(a, b); }
+	inline FloatLanes LanesAnd(FloatLanes a, FloatLanes b) { return _mm256_and_ps(a, b); }
+	inline FloatLanes LanesAndNot(FloatLanes mask, FloatLanes b) { return _mm256_andnot_ps(mask, b); }
+	inline FloatLanes LanesOr(FloatLanes a, FloatLanes b) { return _mm256_or_ps(a, b); }
+	inline FloatLanes LanesXor(FloatLanes a, FloatLanes b) { return _mm256_xor_ps(a, b); }
+	inline FloatLanes LanesTruncate(FloatLanes a) { return _mm256_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+	inline FloatLanes LanesGreaterOrEqual(FloatLanes a, FloatLanes b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+	inline FloatLanes LanesLess(FloatLanes a, FloatLanes b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+#elif defined(TRANSFORM_BATCH_SIMD)
+	typedef __m128 FloatLanes;
+	const int LaneCount = 4;
+
+	inline FloatLanes LanesSet(float value) { return _mm_set1_ps(value); }
+	inline FloatLanes LanesLoad(const float* values) { return _mm_loadu_ps(values); }
+	inline void LanesStore(float* values, FloatLanes lanes) { _mm_storeu_ps(values, lanes); }
+	inline FloatLanes LanesAdd(FloatLanes a, FloatLanes b) { return _mm_add_ps(a, b); }
+	inline FloatLanes LanesSubtract(FloatLanes a, FloatLanes b) { return _mm_sub_ps(a, b); }
+	inline FloatLanes LanesMultiply(FloatLanes a, FloatLanes b) { return _mm_mul_ps(a, b); }
+	inline FloatLanes LanesAnd(FloatLanes a, FloatLanes b) { return _mm_and_ps(a, b); }
+	inline FloatLanes LanesAndNot(FloatLanes mask, FloatLanes b) { return _mm_andnot_ps(mask, b); }
+	inline FloatLanes LanesOr(FloatLanes a, FloatLanes b) { return _mm_or_ps(a, b); }
+	inline FloatLanes LanesXor(FloatLanes a, FloatLanes b) { return _mm_xor_ps(a, b); }
+	inline FloatLanes LanesTruncate(FloatLanes a) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(a)); }
+	inline FloatLanes LanesGreaterOrEqual(FloatLanes a, FloatLanes b) { return _mm_cmpge_ps(a, b); }
+	inline FloatLanes LanesLess(FloatLanes a, FloatLanes b) { return _mm_cmplt_ps(a, b); }
+#else
+	const int LaneCount = 1;
+#endif
+
+#if defined(TRANSFORM_BATCH_SIMD)
+	inline FloatLanes LanesSelect(FloatLanes mask, FloatLanes whenSet, FloatLanes whenClear)
+	{
+		return LanesOr(LanesAnd(mask, whenSet), LanesAndNot(mask, whenClear));
+	}
+
+	// Cephes style sine and cosine: the angle is reduced to an octant around a multiple of pi / 4 and both
+	// minimax polynomials are evaluated for every lane, with the octant deciding which one and which sign each
+	// result takes. The octant is tracked in floats so the same code runs without 256 bit integer support.
+	void SinCos(FloatLanes angle, FloatLanes& sine, FloatLanes& cosine)
+	{
+		const FloatLanes signBit = LanesSet(-0.0f);
+
+		FloatLanes sineSign = LanesAnd(angle, signBit);
+		FloatLanes x = LanesAndNot(signBit, angle);
+
+		FloatLanes octant = LanesTruncate(LanesMultiply(x, LanesSet(1.27323954473516f)));
+		octant = LanesMultiply(LanesTruncate(LanesMultiply(LanesAdd(octant, LanesSet(1.0f)), LanesSet(0.5f))), LanesSet(2.0f));
+
+		FloatLanes octantModEight = LanesSubtract(octant, LanesMultiply(LanesTruncate(LanesMultiply(octant, LanesSet(0.125f))), LanesSet(8.0f)));
+		FloatLanes upperHalf = LanesGreaterOrEqual(octantModEight, LanesSet(4.0f));
+		FloatLanes octantModFour = LanesSubtract(octantModEight, LanesAnd(upperHalf, LanesSet(4.0f)));
+		FloatLanes useSinePolynomial = LanesLess(octantModFour, LanesSet(1.0f));
+		FloatLanes flipCosine = LanesAnd(LanesGreaterOrEqual(octantModEight, LanesSet(2.0f)), LanesLess(octantModEight, LanesSet(5.0f)));
+
+		sineSign = LanesXor(sineSign, LanesAnd(upperHalf, signBit));
+		FloatLanes cosineSign = LanesAnd(flipCosine, signBit);
+
+		x = LanesSubtract(x, LanesMultiply(octant, LanesSet(0.78515625f)));
+		x = LanesSubtract(x, LanesMultiply(octant, LanesSet(2.4187564849853515625e-4f)));
+		x = LanesSubtract(x, LanesMultiply(octant, LanesSet(3.77489497744594108e-8f)));
+
+		FloatLanes z = LanesMultiply(x, x);
+
+		FloatLanes cosinePolynomial = LanesAdd(LanesMultiply(LanesSet(2.443315711809948e-5f), z), LanesSet(-1.388731625493765e-3f));
+		cosinePolynomial = LanesAdd(LanesMultiply(cosinePolynomial, z), LanesSet(4.166664568298827e-2f));
+		cosinePolynomial = LanesMultiply(LanesMultiply(cosinePolynomial, z), z);
+		cosinePolynomial = LanesAdd(LanesSubtract(cosinePolynomial, LanesMultiply(z, LanesSet(0.5f))), LanesSet(1.0f));
+
+		FloatLanes sinePolynomial = LanesAdd(LanesMultiply(LanesSet(-1.9515295891e-4f), z), LanesSet(8.3321608736e-3f));
+		sinePolynomial = LanesAdd(LanesMultiply(sinePolynomial, z), LanesSet(-1.6666654611e-1f));
+		sinePolynomial = LanesAdd(LanesMultiply(LanesMultiply(sinePolynomial, z), x), x);
+
+		sine = LanesXor(LanesSelect(useSinePolynomial, sinePolynomial, cosinePolynomial), sineSign);
+		cosine = LanesXor(LanesSelect(useSinePolynomial, cosinePolynomial, sinePolynomial), cosineSign);
+	}
+#endif
+
+	// The same formula one transform at a time, used for the tail of a batch that does not fill every lane
+	void ComposeMatrix(const float* const* inputs, float* const* outputs, int index)
+	{
+		float sinePitch = sinf(inputs[BATCH_ROTATION_X][index]);
+		float cosinePitch = cosf(inputs[BATCH_ROTATION_X][index]);
+		float sineYaw = sinf(inputs[BATCH_ROTATION_Y][index]);
+		float cosineYaw = cosf(inputs[BATCH_ROTATION_Y][index]);
+		float sineRoll = sinf(inputs[BATCH_ROTATION_Z][index]);
+		float cosineRoll = cosf(inputs[BATCH_ROTATION_Z][index]);
+
+		float scaleX = inputs[BATCH_SCALE_X][index];
+		float scaleY = inputs[BATCH_SCALE_Y][index];
+		float scaleZ = inputs[BATCH_SCALE_Z][index];
+
+		outputs[0][index] = (cosineRoll * cosineYaw + sineRoll * sinePitch * sineYaw) * scaleX;
+		outputs[1][index] = (sineRoll * cosinePitch) * scaleX;
+		outputs[2][index] = (sineRoll * sinePitch * cosineYaw - cosineRoll * sineYaw) * scaleX;
+
+		outputs[3][index] = (cosineRoll * sinePitch * sineYaw - sineRoll * cosineYaw) * scaleY;
+		outputs[4][index] = (cosineRoll * cosinePitch) * scaleY;
+		outputs[5][index] = (sineRoll * sineYaw + cosineRoll * sinePitch * cosineYaw) * scaleY;
+
+		outputs[6][index] = (cosinePitch * sineYaw) * scaleZ;
+		outputs[7][index] = -sinePitch * scaleZ;
+		outputs[8][index] = (cosinePitch * cosineYaw) * scaleZ;
+
+		outputs[9][index] = inputs[BATCH_POSITION_X][index];
+		outputs[10][index] = inputs[BATCH_POSITION_Y][index];
+		outputs[11][index] = inputs[BATCH_POSITION_Z][index];
+	}
+}
+
+TransformBatch::TransformBatch(TransformBatchTarget target) : _target(target), _count(0)
+{
+}
+
+TransformBatch::~TransformBatch()
+{
+}
+
+int TransformBatch::GetCount() const
+{
+	return _count;
+}
+
+bool TransformBatch::IsFull() const
+{
+	return _count == Capacity;
+}
+
+int TransformBatch::GetLaneCount()
+{
+	return LaneCount;
+}
+
+void TransformBatch::Add(TransformComponent* transform)
+{
+	Add(transform, transform->Position, transform->Rotation);
+}
+
+void TransformBatch::Add(TransformComponent* transform, float interpolation)
+{
+	Add(transform, FixedTimestep::Interpolate(transform->PreviousPosition, transform->Position, interpolation), FixedTimestep::InterpolateRotation(transform->PreviousRotation, transform->Rotation, interpolation));
+}
+
+void TransformBatch::Add(TransformComponent* transform, const XMFLOAT3& position, const XMFLOAT3& rotation)
+{
+	_transforms[_count] = transform;
+
+	_inputs[BATCH_POSITION_X][_count] = position.x;
+	_inputs[BATCH_POSITION_Y][_count] = position.y;
+	_inputs[BATCH_POSITION_Z][_count] = position.z;
+	_inputs[BATCH_ROTATION_X][_count] = rotation.x;
+	_inputs[BATCH_ROTATION_Y][_count] = rotation.y;
+	_inputs[BATCH_ROTATION_Z][_count] = rotation.z;
+	_inputs[BATCH_SCALE_X][_count] = transform->Scale.x;
+	_inputs[BATCH_SCALE_Y][_count] = transform->Scale.y;
+	_inputs[BATCH_SCALE_Z][_count] = transform->Scale.z;
+
+	_count++;
+}
+
+void TransformBatch::Compose()
+{
+	if (_count == 0)
+		return;
+
+	const float* inputs[BATCH_INPUT_COUNT];
+	for (int input = 0; input < BATCH_INPUT_COUNT; input++)
+		inputs[input] = _inputs[input];
+
+	float* outputs[TransformBatchOutputCount];
+	for (int output = 0; output < TransformBatchOutputCount; output++)
+		outputs[output] = _outputs[output];
+
+	ComposeMatrices(inputs, outputs, _count);
+
+	for (int i = 0; i < _count; i++)
+	{
+		TransformComponent* transform = _transforms[i];
+		transform->RenderTransformation = ToMatrix(outputs, i);
+
+		if (_target == BATCH_TARGET_RENDER)
+			continue;
+
+		transform->Transformation = transform->RenderTransformation;
+		transform->WorldPosition = XMFLOAT3(_outputs[9][i], _outputs[10][i], _outputs[11][i]);
+		transform->WorldVersion++;
+		transform->Dirty = false;
+	}
+
+	_count = 0;
+}
+
+void TransformBatch::ComposeMatrices(const float* const* inputs, float* const* outputs, int count)
+{
+	int index = 0;
+
+#if defined(TRANSFORM_BATCH_SIMD)
+	for (; index + LaneCount <= count; index += LaneCount)
+	{
+		FloatLanes sinePitch, cosinePitch, sineYaw, cosineYaw, sineRoll, cosineRoll;
+		SinCos(LanesLoad(inputs[BATCH_ROTATION_X] + index), sinePitch, cosinePitch);
+		SinCos(LanesLoad(inputs[BATCH_ROTATION_Y] + index), sineYaw, cosineYaw);
+		SinCos(LanesLoad(inputs[BATCH_ROTATION_Z] + index), sineRoll, cosineRoll);
+
+		FloatLanes scaleX = LanesLoad(inputs[BATCH_SCALE_X] + index);
+		FloatLanes scaleY = LanesLoad(inputs[BATCH_SCALE_Y] + index);
+		FloatLanes scaleZ = LanesLoad(inputs[BATCH_SCALE_Z] + index);
+
+		FloatLanes sineRollSinePitch = LanesMultiply(sineRoll, sinePitch);
+		FloatLanes cosineRollSinePitch = LanesMultiply(cosineRoll, sinePitch);
+
+		LanesStore(outputs[0] + index, LanesMultiply(LanesAdd(LanesMultiply(cosineRoll, cosineYaw), LanesMultiply(sineRollSinePitch, sineYaw)), scaleX));
+		LanesStore(outputs[1] + index, LanesMultiply(LanesMultiply(sineRoll, cosinePitch), scaleX));
+		LanesStore(outputs[2] + index, LanesMultiply(LanesSubtract(LanesMultiply(sineRollSinePitch, cosineYaw), LanesMultiply(cosineRoll, sineYaw)), scaleX));
+
+		LanesStore(outputs[3] + index, LanesMultiply(LanesSubtract(LanesMultiply(cosineRollSinePitch, sineYaw), LanesMultiply(sineRoll, cosineYaw)), scaleY));
+		LanesStore(outputs[4] + index, LanesMultiply(LanesMultiply(cosineRoll, cosinePitch), scaleY));
+		LanesStore(outputs[5] + index, LanesMultiply(LanesAdd(LanesMultiply(sineRoll, sineYaw), LanesMultiply(cosineRollSinePitch, cosineYaw)), scaleY));
+
+		LanesStore(outputs[6] + index, LanesMultiply(LanesMultiply(cosinePitch, sineYaw), scaleZ));
+		LanesStore(outputs[7] + index, LanesMultiply(LanesXor(sinePitch, LanesSet(-0.0f)), scaleZ));
+		LanesStore(outputs[8] + index, LanesMultiply(LanesMultiply(cosinePitch, cosineYaw), scaleZ));
+
+		LanesStore(outputs[9] + index, LanesLoad(inputs[BATCH_POSITION_X] + index));
+		LanesStore(outputs[10] + index, LanesLoad(inputs[BATCH_POSITION_Y] + index));
+		LanesStore(outputs[11] + index, LanesLoad(inputs[BATCH_POSITION_Z] + index));
+	}
+#endif
+
+	for (; index < count; index++)
+		ComposeMatrix(inputs, outputs, index);
+}
+
+XMMATRIX TransformBatch::ToMatrix(const float* const* outputs, int index)
+{
+	return XMMatrixSet(
+		outputs[0][index], outputs[1][index], outputs[2][index], 0.0f,
+		outputs[3][index], outputs[4][index], outputs[5][index], 0.0f,
+		outputs[6][index], outputs[7][index], outputs[8][index], 0.0f,
+		outputs[9][index], outputs[10][index], outputs[11][index], 1.0f);
+}
\ No newline at end of file
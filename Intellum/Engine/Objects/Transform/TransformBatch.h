@@ -0,0 +1,64 @@
+#pragma once
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+class TransformComponent;
+
+enum TransformBatchInput
+{
+	BATCH_POSITION_X,
+	BATCH_POSITION_Y,
+	BATCH_POSITION_Z,
+	BATCH_ROTATION_X,
+	BATCH_ROTATION_Y,
+	BATCH_ROTATION_Z,
+	BATCH_SCALE_X,
+	BATCH_SCALE_Y,
+	BATCH_SCALE_Z,
+	BATCH_INPUT_COUNT
+};
+
+enum TransformBatchTarget
+{
+	BATCH_TARGET_WORLD,
+	BATCH_TARGET_RENDER
+};
+
+// Rows 0 to 2 of the scaled rotation followed by the translation. The fourth column is always (0, 0, 0, 1).
+const int TransformBatchOutputCount = 12;
+
+// Composes the world matrices of many parentless transforms together. Transforms are gathered into structure
+// of arrays form so the kernel can build one matrix per SIMD lane, evaluating sine and cosine for every lane at
+// once and writing Scale * RollPitchYaw * Translation straight into the matrix instead of multiplying three.
+// A world batch composes each transform's current state, while a render batch composes the state blended
+// between the last two simulation steps and only writes RenderTransformation.
+class TransformBatch
+{
+public:
+	static const int Capacity = 256;
+
+private:
+	TransformBatchTarget _target;
+	TransformComponent* _transforms[Capacity];
+	float _inputs[BATCH_INPUT_COUNT][Capacity];
+	float _outputs[TransformBatchOutputCount][Capacity];
+	int _count;
+
+	void Add(TransformComponent* transform, const XMFLOAT3& position, const XMFLOAT3& rotation);
+
+public:
+	TransformBatch(TransformBatchTarget target);
+	~TransformBatch();
+
+	int GetCount() const;
+	bool IsFull() const;
+
+	void Add(TransformComponent* transform);
+	void Add(TransformComponent* transform, float interpolation);
+	void Compose();
+
+	static int GetLaneCount();
+	static void ComposeMatrices(const float* const* inputs, float* const* outputs, int count);
+	static XMMATRIX ToMatrix(const float* const* outputs, int index);
+};
\ No newline at end of file
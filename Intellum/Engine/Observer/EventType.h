@@ -5,5 +5,6 @@ enum EventType
 	MOVED_MOUSE,
 	FRAMES_PER_SECOND,
 	CPU_USAGE,
-	RENDER_COUNT
+	RENDER_COUNT,
+	CONSTANT_BYTES
 };
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "CommandList.h"
+
+CommandList::CommandList()
+{
+}
+
+CommandList::~CommandList()
+{
+}
+
+void CommandList::Clear()
+{
+	_commands.clear();
+}
+
+CommandList::Command& CommandList::Append(CommandListOperation operation)
+{
+	Command command;
+	command.Operation = operation;
+	command.Shader = SHADER_DEFAULT;
+	command.Value = 0;
+	command.InstanceCount = 0;
+	command.Textures = nullptr;
+	command.Mesh = nullptr;
+	command.Resources = nullptr;
+	command.Instances = nullptr;
+
+	_commands.push_back(command);
+	return _commands.back();
+}
+
+void CommandList::Execute(IRenderDevice* device) const
+{
+	for (const Command& command : _commands)
+	{
+		switch (command.Operation)
+		{
+		case COMMAND_SET_PIPELINE_STATE:
+			device->SetPipelineState(command.Value);
+			break;
+		case COMMAND_SET_TEXTURES:
+			device->SetTextures(*command.Textures);
+			break;
+		case COMMAND_SET_MESH:
+			device->SetMesh(*command.Mesh);
+			break;
+		case COMMAND_SET_CONSTANTS:
+			device->SetConstants(command.Shader, static_cast<ConstantFrequency>(command.Value), *command.Resources);
+			break;
+		case COMMAND_DRAW:
+			device->Draw(command.Shader, *command.Resources, command.Value);
+			break;
+		case COMMAND_DRAW_INSTANCED:
+			device->DrawInstanced(command.Shader, *command.Resources, command.Value, command.Instances, command.InstanceCount);
+			break;
+		}
+	}
+}
+
+void CommandList::SetPipelineState(PipelineStateHandle pipelineState)
+{
+	Append(COMMAND_SET_PIPELINE_STATE).Value = pipelineState;
+}
+
+void CommandList::SetTextures(const TextureShaderParameters& textures)
+{
+	Append(COMMAND_SET_TEXTURES).Textures = &textures;
+}
+
+void CommandList::SetMesh(const Geometry& mesh)
+{
+	Append(COMMAND_SET_MESH).Mesh = &mesh;
+}
+
+void CommandList::SetConstants(ShaderType shader, ConstantFrequency frequency, const ShaderResources& resources)
+{
+	Command& command = Append(COMMAND_SET_CONSTANTS);
+	command.Shader = shader;
+	command.Value = frequency;
+	command.Resources = &resources;
+}
+
+void CommandList::Draw(ShaderType shader, const ShaderResources& resources, int indexCount)
+{
+	Command& command = Append(COMMAND_DRAW);
+	command.Shader = shader;
+	command.Value = indexCount;
+	command.Resources = &resources;
+}
+
+void CommandList::DrawInstanced(ShaderType shader, const ShaderResources& resources, int indexCount, const InstanceData* instances, int instanceCount)
+{
+	Command& command = Append(COMMAND_DRAW_INSTANCED);
+	command.Shader = shader;
+	command.Value = indexCount;
+	command.InstanceCount = instanceCount;
+	command.Resources = &resources;
+	command.Instances = instances;
+}
+
+int CommandList::GetSize() const
+{
+	return static_cast<int>(_commands.size());
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include "IRenderDevice.h"
+
+using namespace std;
+
+enum CommandListOperation
+{
+	COMMAND_SET_PIPELINE_STATE,
+	COMMAND_SET_TEXTURES,
+	COMMAND_SET_MESH,
+	COMMAND_SET_CONSTANTS,
+	COMMAND_DRAW,
+	COMMAND_DRAW_INSTANCED
+};
+
+// The state changes and draws of part of a frame, written down on any thread and made on the device later by the
+// thread that owns it. Recording never touches a device, so lists can be recorded side by side and executed one
+// after the other in the order the frame needs them.
+//
+// Commands point at the resources they were recorded with rather than copying them, so whatever a list was
+// recorded from has to stay untouched until the list has been executed.
+class CommandList
+{
+private:
+	struct Command
+	{
+		CommandListOperation Operation;
+		ShaderType Shader;
+		int Value;
+		int InstanceCount;
+		const TextureShaderParameters* Textures;
+		const Geometry* Mesh;
+		const ShaderResources* Resources;
+		const InstanceData* Instances;
+	};
+
+	vector<Command> _commands;
+
+	Command& Append(CommandListOperation operation);
+
+public:
+	CommandList();
+	~CommandList();
+
+	void Clear();
+	void Execute(IRenderDevice* device) const;
+
+	void SetPipelineState(PipelineStateHandle pipelineState);
+	void SetTextures(const TextureShaderParameters& textures);
+	void SetMesh(const Geometry& mesh);
+	void SetConstants(ShaderType shader, ConstantFrequency frequency, const ShaderResources& resources);
+
+	void Draw(ShaderType shader, const ShaderResources& resources, int indexCount);
+	void DrawInstanced(ShaderType shader, const ShaderResources& resources, int indexCount, const InstanceData* instances, int instanceCount);
+
+	int GetSize() const;
+};
\ No newline at end of file
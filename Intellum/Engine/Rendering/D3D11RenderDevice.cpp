@@ -0,0 +1,358 @@
+#include "D3D11RenderDevice.h"
+#include <cstring>
+#include "../../Common/Constants.h"
+
+D3D11RenderDevice::D3D11RenderDevice(DirectX3D* direct3D, ShaderController* shaderController) : _direct3D(direct3D), _shaderController(shaderController), _shader(SHADER_DEFAULT),
+	_shaderVersion(shaderController->GetVersion()), _instanceBuffer(nullptr), _instanceCapacity(0), _instanceOffset(0)
+{
+}
+
+D3D11RenderDevice::~D3D11RenderDevice()
+{
+}
+
+void D3D11RenderDevice::Shutdown()
+{
+	ReleaseInstanceBuffer();
+
+	for (PipelineState& pipelineState : _pipelineStates)
+	{
+		if (pipelineState.Rasterizer)
+		{
+			pipelineState.Rasterizer->Release();
+			pipelineState.Rasterizer = nullptr;
+		}
+
+		if (pipelineState.DepthStencil)
+		{
+			pipelineState.DepthStencil->Release();
+			pipelineState.DepthStencil = nullptr;
+		}
+	}
+
+	_pipelineStates.clear();
+	_pipelineLookup.clear();
+}
+
+void D3D11RenderDevice::BeginFrame(XMFLOAT4 clearColor)
+{
+	_direct3D->BeginScene(clearColor);
+}
+
+void D3D11RenderDevice::EndFrame()
+{
+	_direct3D->EndScene();
+}
+
+XMMATRIX D3D11RenderDevice::GetWorldMatrix() const
+{
+	return _direct3D->GetWorldMatrix();
+}
+
+XMMATRIX D3D11RenderDevice::GetProjectionMatrix() const
+{
+	return _direct3D->GetProjectionMatrix();
+}
+
+XMMATRIX D3D11RenderDevice::GetOrthoMatrix() const
+{
+	return _direct3D->GetOrthoMatrix();
+}
+
+ID3D11Buffer* D3D11RenderDevice::CreateBuffer(BufferType type, const void* data, int size, bool dynamic)
+{
+	D3D11_BUFFER_DESC bufferDesc;
+	ZeroMemory(&bufferDesc, sizeof(bufferDesc));
+	bufferDesc.Usage = dynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_DEFAULT;
+	bufferDesc.ByteWidth = static_cast<UINT>(size);
+	bufferDesc.BindFlags = type == BUFFER_INDEX ? D3D11_BIND_INDEX_BUFFER : D3D11_BIND_VERTEX_BUFFER;
+	bufferDesc.CPUAccessFlags = dynamic ? D3D11_CPU_ACCESS_WRITE : 0;
+
+	D3D11_SUBRESOURCE_DATA initialData;
+	ZeroMemory(&initialData, sizeof(initialData));
+	initialData.pSysMem = data;
+
+	ID3D11Buffer* buffer = nullptr;
+	HRESULT result = _direct3D->GetDevice()->CreateBuffer(&bufferDesc, data ? &initialData : nullptr, &buffer);
+	if (FAILED(result)) throw Exception(type == BUFFER_INDEX ? "Failed to create the index buffer." : "Failed to create the vertex buffer.");
+
+	return buffer;
+}
+
+void D3D11RenderDevice::WriteBuffer(ID3D11Buffer* buffer, const void* data, int size)
+{
+	ID3D11DeviceContext* deviceContext = _direct3D->GetDeviceContext();
+
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	HRESULT result = deviceContext->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	if (FAILED(result)) throw Exception("Failed to map vertex buffer to the Device Context");
+
+	memcpy(mappedResource.pData, data, size);
+
+	deviceContext->Unmap(buffer, 0);
+}
+
+void D3D11RenderDevice::ReleaseBuffer(ID3D11Buffer* buffer)
+{
+	if (buffer)
+		buffer->Release();
+}
+
+ID3D11ShaderResourceView* D3D11RenderDevice::CreateTexture(const TargaData& targaData)
+{
+	ID3D11Device* device = _direct3D->GetDevice();
+	ID3D11DeviceContext* deviceContext = _direct3D->GetDeviceContext();
+
+	D3D11_TEXTURE2D_DESC textureDescription;
+	textureDescription.Height = static_cast<UINT>(targaData.ImageSize.Height);
+	textureDescription.Width = static_cast<UINT>(targaData.ImageSize.Width);
+	textureDescription.MipLevels = 0;
+	textureDescription.ArraySize = 1;
+	textureDescription.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDescription.SampleDesc.Count = 1;
+	textureDescription.SampleDesc.Quality = 0;
+	textureDescription.Usage = D3D11_USAGE_DEFAULT;
+	textureDescription.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+	textureDescription.CPUAccessFlags = 0;
+	textureDescription.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+	ID3D11Texture2D* texture = nullptr;
+	HRESULT result = device->CreateTexture2D(&textureDescription, nullptr, &texture);
+	if (FAILED(result)) throw Exception("Failed to create texture description");
+
+	unsigned int rowPitch = static_cast<unsigned int>(targaData.ImageSize.Width * 4 * sizeof(unsigned char));
+	deviceContext->UpdateSubresource(texture, 0, nullptr, targaData.ImageData, rowPitch, 0);
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC shaderDescription;
+	shaderDescription.Format = textureDescription.Format;
+	shaderDescription.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	shaderDescription.Texture2D.MostDetailedMip = 0;
+	shaderDescription.Texture2D.MipLevels = -1;
+
+	ID3D11ShaderResourceView* textureView = nullptr;
+	result = device->CreateShaderResourceView(texture, &shaderDescription, &textureView);
+	texture->Release();
+
+	if (FAILED(result)) throw Exception("Failed to create the Shader Resource View");
+
+	deviceContext->GenerateMips(textureView);
+	return textureView;
+}
+
+void D3D11RenderDevice::ReleaseTexture(ID3D11ShaderResourceView* texture)
+{
+	if (texture)
+		texture->Release();
+}
+
+bool D3D11RenderDevice::SupportsInstancing(ShaderType shader) const
+{
+	return _shaderController->GetShader(shader)->SupportsInstancing();
+}
+
+int D3D11RenderDevice::GetConstantSize(ShaderType shader, ConstantFrequency frequency) const
+{
+	return _shaderController->GetShader(shader)->GetConstantSize(frequency);
+}
+
+PipelineStateHandle D3D11RenderDevice::GetPipelineState(const PipelineStateDesc& desc)
+{
+	PipelineStateDesc resolved = desc;
+	if (_direct3D->GetRasterizer()->GetFillMode() == D3D11_FILL_WIREFRAME)
+		resolved.FillMode = D3D11_FILL_WIREFRAME;
+
+	unordered_map<unsigned long long, PipelineStateHandle>::const_iterator existing = _pipelineLookup.find(resolved.GetKey());
+	if (existing != _pipelineLookup.end())
+		return existing->second;
+
+	PipelineStateHandle handle = static_cast<PipelineStateHandle>(_pipelineStates.size());
+	_pipelineStates.push_back(CreatePipelineState(resolved));
+	_pipelineLookup[resolved.GetKey()] = handle;
+
+	return handle;
+}
+
+int D3D11RenderDevice::GetPipelineStateCount() const
+{
+	return static_cast<int>(_pipelineStates.size());
+}
+
+D3D11RenderDevice::PipelineState D3D11RenderDevice::CreatePipelineState(const PipelineStateDesc& desc) const
+{
+	if (desc.Instanced && !SupportsInstancing(desc.Shader))
+		throw Exception("Cannot create an instanced pipeline state for a shader without an instanced variant");
+
+	PipelineState pipelineState;
+	pipelineState.Desc = desc;
+	pipelineState.Rasterizer = nullptr;
+	pipelineState.DepthStencil = nullptr;
+	FetchShaders(pipelineState);
+
+	D3D11_RASTERIZER_DESC rasterizerDescription;
+	rasterizerDescription.AntialiasedLineEnable = false;
+	rasterizerDescription.CullMode = desc.CullMode;
+	rasterizerDescription.DepthBias = 0;
+	rasterizerDescription.DepthBiasClamp = 0.0f;
+	rasterizerDescription.DepthClipEnable = true;
+	rasterizerDescription.FillMode = desc.FillMode;
+	rasterizerDescription.FrontCounterClockwise = false;
+	rasterizerDescription.MultisampleEnable = false;
+	rasterizerDescription.ScissorEnable = false;
+	rasterizerDescription.SlopeScaledDepthBias = 0.0f;
+
+	HRESULT result = _direct3D->GetDevice()->CreateRasterizerState(&rasterizerDescription, &pipelineState.Rasterizer);
+	if (FAILED(result)) throw Exception("Failed to create the rasterizer state of a pipeline state");
+
+	D3D11_DEPTH_STENCIL_DESC depthStencilDescription;
+	ZeroMemory(&depthStencilDescription, sizeof(depthStencilDescription));
+
+	depthStencilDescription.DepthEnable = desc.DepthEnabled;
+	depthStencilDescription.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+	depthStencilDescription.DepthFunc = D3D11_COMPARISON_LESS;
+	depthStencilDescription.StencilEnable = false;
+
+	result = _direct3D->GetDevice()->CreateDepthStencilState(&depthStencilDescription, &pipelineState.DepthStencil);
+	if (FAILED(result))
+	{
+		pipelineState.Rasterizer->Release();
+		throw Exception("Failed to create the depth stencil state of a pipeline state");
+	}
+
+	return pipelineState;
+}
+
+void D3D11RenderDevice::FetchShaders(PipelineState& pipelineState) const
+{
+	IShaderType* shader = _shaderController->GetShader(pipelineState.Desc.Shader);
+
+	pipelineState.VertexShader = shader->GetVertexShader(pipelineState.Desc.Instanced);
+	pipelineState.PixelShader = shader->GetPixelShader();
+	pipelineState.Layout = shader->GetInputLayout(pipelineState.Desc.Instanced);
+	pipelineState.Sampler = shader->GetSamplerState();
+}
+
+void D3D11RenderDevice::SetPipelineState(PipelineStateHandle pipelineState)
+{
+	if (pipelineState < 0 || pipelineState >= static_cast<int>(_pipelineStates.size()))
+		throw Exception("Tried to bind a pipeline state this device did not create");
+
+	if (_shaderVersion != _shaderController->GetVersion())
+	{
+		for (PipelineState& existing : _pipelineStates)
+			FetchShaders(existing);
+
+		_shaderVersion = _shaderController->GetVersion();
+	}
+
+	const PipelineState& state = _pipelineStates[pipelineState];
+	_shader = state.Desc.Shader;
+
+	ID3D11DeviceContext* deviceContext = _direct3D->GetDeviceContext();
+	deviceContext->IASetInputLayout(state.Layout);
+	deviceContext->VSSetShader(state.VertexShader, nullptr, 0);
+	deviceContext->PSSetShader(state.PixelShader, nullptr, 0);
+	deviceContext->PSSetSamplers(0, 1, &state.Sampler);
+	deviceContext->RSSetState(state.Rasterizer);
+	deviceContext->OMSetDepthStencilState(state.DepthStencil, 1);
+}
+
+void D3D11RenderDevice::SetTextures(const TextureShaderParameters& textures)
+{
+	_shaderController->GetShader(_shader)->SetShaderTextures(textures);
+}
+
+void D3D11RenderDevice::SetMesh(const Geometry& mesh)
+{
+	ID3D11DeviceContext* deviceContext = _direct3D->GetDeviceContext();
+	deviceContext->IASetVertexBuffers(0, 1, &mesh.VertexBuffer, &mesh.VBStride, &mesh.VBOffset);
+	deviceContext->IASetIndexBuffer(mesh.IndexBuffer, DXGI_FORMAT_R16_UINT, 0);
+	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+void D3D11RenderDevice::SetConstants(ShaderType shader, ConstantFrequency frequency, const ShaderResources& resources)
+{
+	IShaderType* shaderType = _shaderController->GetShader(shader);
+
+	if (frequency == CONSTANTS_PER_FRAME)
+		shaderType->SetFrameParameters(resources);
+	else if (frequency == CONSTANTS_PER_MATERIAL)
+		shaderType->SetMaterialParameters(resources);
+	else
+		shaderType->SetObjectParameters(resources);
+}
+
+void D3D11RenderDevice::Draw(ShaderType shader, const ShaderResources& resources, int indexCount)
+{
+	_shaderController->GetShader(shader)->SetObjectParameters(resources);
+	_direct3D->GetDeviceContext()->DrawIndexed(indexCount, 0, 0);
+}
+
+void D3D11RenderDevice::ReleaseInstanceBuffer()
+{
+	if (_instanceBuffer)
+	{
+		_instanceBuffer->Release();
+		_instanceBuffer = nullptr;
+	}
+
+	_instanceCapacity = 0;
+	_instanceOffset = 0;
+}
+
+void D3D11RenderDevice::ReserveInstances(int instanceCount)
+{
+	if (_instanceBuffer != nullptr && instanceCount <= _instanceCapacity)
+		return;
+
+	int capacity = _instanceCapacity > 0 ? _instanceCapacity : INSTANCE_BUFFER_INITIAL_CAPACITY;
+	while (capacity < instanceCount)
+		capacity *= 2;
+
+	// Only the instance buffer is replaced, the pipeline states stay bound to their handles
+	ReleaseInstanceBuffer();
+
+	D3D11_BUFFER_DESC instanceBufferDesc;
+	instanceBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	instanceBufferDesc.ByteWidth = sizeof(InstanceData) * capacity;
+	instanceBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	instanceBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	instanceBufferDesc.MiscFlags = 0;
+	instanceBufferDesc.StructureByteStride = 0;
+
+	HRESULT result = _direct3D->GetDevice()->CreateBuffer(&instanceBufferDesc, nullptr, &_instanceBuffer);
+	if (FAILED(result)) throw Exception("Failed to create the instance buffer");
+
+	_instanceCapacity = capacity;
+	_instanceOffset = capacity;
+}
+
+void D3D11RenderDevice::DrawInstanced(ShaderType shader, const ShaderResources& resources, int indexCount, const InstanceData* instances, int instanceCount)
+{
+	ReserveInstances(instanceCount);
+
+	// Append behind the instances already drawn from the buffer and only discard it once it is full
+	D3D11_MAP mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+	if (_instanceOffset + instanceCount > _instanceCapacity)
+	{
+		mapType = D3D11_MAP_WRITE_DISCARD;
+		_instanceOffset = 0;
+	}
+
+	ID3D11DeviceContext* deviceContext = _direct3D->GetDeviceContext();
+
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	HRESULT result = deviceContext->Map(_instanceBuffer, 0, mapType, 0, &mappedResource);
+	if (FAILED(result)) throw Exception("Failed to map the instance buffer to the Device Context");
+
+	memcpy(static_cast<InstanceData*>(mappedResource.pData) + _instanceOffset, instances, sizeof(InstanceData) * instanceCount);
+	deviceContext->Unmap(_instanceBuffer, 0);
+
+	UINT stride = sizeof(InstanceData);
+	UINT offset = sizeof(InstanceData) * _instanceOffset;
+	deviceContext->IASetVertexBuffers(1, 1, &_instanceBuffer, &stride, &offset);
+
+	_shaderController->GetShader(shader)->SetObjectParameters(resources);
+	deviceContext->DrawIndexedInstanced(indexCount, instanceCount, 0, 0, 0);
+
+	_instanceOffset += instanceCount;
+}
\ No newline at end of file
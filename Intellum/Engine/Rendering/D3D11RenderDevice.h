@@ -0,0 +1,81 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include "IRenderDevice.h"
+#include "../DirectX3D.h"
+#include "../ShaderEngine/ShaderController.h"
+
+using namespace std;
+
+// Puts queued draws on screen through the Direct3D 11 device context. Buffers and textures are created on the
+// device, the view kept for a texture holds the only reference to the texture itself. Instance data for instanced draws is
+// written into a dynamic vertex buffer used as a ring, so batches in the same frame do not stall on each other.
+//
+// Pipeline states own their rasterizer and depth stencil states and borrow the shader objects from the shader
+// controller. Recompiled shaders are picked up again before the next pipeline state is bound. The wireframe
+// toggle is applied when a description is looked up, so it switches every draw over to wireframe states.
+class D3D11RenderDevice : public IRenderDevice
+{
+private:
+	struct PipelineState
+	{
+		PipelineStateDesc Desc;
+		ID3D11VertexShader* VertexShader;
+		ID3D11PixelShader* PixelShader;
+		ID3D11InputLayout* Layout;
+		ID3D11SamplerState* Sampler;
+		ID3D11RasterizerState* Rasterizer;
+		ID3D11DepthStencilState* DepthStencil;
+	};
+
+	DirectX3D* _direct3D;
+	ShaderController* _shaderController;
+	ShaderType _shader;
+
+	vector<PipelineState> _pipelineStates;
+	unordered_map<unsigned long long, PipelineStateHandle> _pipelineLookup;
+	int _shaderVersion;
+
+	ID3D11Buffer* _instanceBuffer;
+	int _instanceCapacity;
+	int _instanceOffset;
+
+	void ReserveInstances(int instanceCount);
+	void ReleaseInstanceBuffer();
+	PipelineState CreatePipelineState(const PipelineStateDesc& desc) const;
+	void FetchShaders(PipelineState& pipelineState) const;
+
+public:
+	D3D11RenderDevice(DirectX3D* direct3D, ShaderController* shaderController);
+	~D3D11RenderDevice() override;
+
+	void Shutdown() override;
+
+	void BeginFrame(XMFLOAT4 clearColor) override;
+	void EndFrame() override;
+
+	XMMATRIX GetWorldMatrix() const override;
+	XMMATRIX GetProjectionMatrix() const override;
+	XMMATRIX GetOrthoMatrix() const override;
+
+	ID3D11Buffer* CreateBuffer(BufferType type, const void* data, int size, bool dynamic) override;
+	void WriteBuffer(ID3D11Buffer* buffer, const void* data, int size) override;
+	void ReleaseBuffer(ID3D11Buffer* buffer) override;
+
+	ID3D11ShaderResourceView* CreateTexture(const TargaData& targaData) override;
+	void ReleaseTexture(ID3D11ShaderResourceView* texture) override;
+
+	bool SupportsInstancing(ShaderType shader) const override;
+	int GetConstantSize(ShaderType shader, ConstantFrequency frequency) const override;
+
+	PipelineStateHandle GetPipelineState(const PipelineStateDesc& desc) override;
+	int GetPipelineStateCount() const override;
+
+	void SetPipelineState(PipelineStateHandle pipelineState) override;
+	void SetTextures(const TextureShaderParameters& textures) override;
+	void SetMesh(const Geometry& mesh) override;
+	void SetConstants(ShaderType shader, ConstantFrequency frequency, const ShaderResources& resources) override;
+
+	void Draw(ShaderType shader, const ShaderResources& resources, int indexCount) override;
+	void DrawInstanced(ShaderType shader, const ShaderResources& resources, int indexCount, const InstanceData* instances, int instanceCount) override;
+};
\ No newline at end of file
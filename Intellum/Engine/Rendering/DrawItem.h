@@ -0,0 +1,28 @@
+#pragma once
+#include "../Objects/Geometry/Geometry.h"
+#include "../ShaderEngine/ShaderTypes.h"
+#include "../ShaderEngine/ShaderResources.h"
+
+// Passes are submitted in the order they are declared
+enum RenderPass
+{
+	RENDER_PASS_OPAQUE,
+	RENDER_PASS_UI,
+	RENDER_PASS_TEXT
+};
+
+// Everything needed to issue one draw, captured when the draw is queued so it can be submitted in any order
+class DrawItem
+{
+public:
+	unsigned long long Key;
+	RenderPass Pass;
+	ShaderType Shader;
+	D3D11_FILL_MODE FillMode;
+	D3D11_CULL_MODE CullMode;
+	bool DepthEnabled;
+	Geometry Mesh;
+	ShaderResources Resources;
+
+	DrawItem() : Key(0), Pass(RENDER_PASS_OPAQUE), Shader(SHADER_DEFAULT), FillMode(D3D11_FILL_SOLID), CullMode(D3D11_CULL_BACK), DepthEnabled(true), Mesh(Geometry()), Resources(ShaderResources()) {}
+};
\ No newline at end of file
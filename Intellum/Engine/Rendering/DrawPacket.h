@@ -0,0 +1,24 @@
+#pragma once
+#include "DrawItem.h"
+
+// The part of an entity's draw that only changes with its appearance or rasterizer state, kept on the
+// AppearanceComponent so queuing the draw each frame only fills in the matrices and depth. Everything in it is
+// held by value, so copying it never allocates. StateKey is the sort key without its depth bits.
+class DrawPacket
+{
+public:
+	unsigned long long StateKey;
+	RenderPass Pass;
+	ShaderType Shader;
+	D3D11_FILL_MODE FillMode;
+	D3D11_CULL_MODE CullMode;
+	bool DepthEnabled;
+	bool LightEnabled;
+	Geometry Mesh;
+	TextureShaderParameters Textures;
+	ColorShaderParameters Color;
+	GradientShaderParameters Gradient;
+
+	DrawPacket() : StateKey(0), Pass(RENDER_PASS_OPAQUE), Shader(SHADER_DEFAULT), FillMode(D3D11_FILL_SOLID), CullMode(D3D11_CULL_BACK), DepthEnabled(true), LightEnabled(true), Mesh(Geometry()),
+		Textures(TextureShaderParameters()), Color(ColorShaderParameters()), Gradient(GradientShaderParameters()) {}
+};
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+#include "../Objects/Geometry/Geometry.h"
+#include "../ShaderEngine/ShaderTypes.h"
+#include "../ShaderEngine/ShaderResources.h"
+#include "../../Loaders/models/TargaData.h"
+#include "InstanceData.h"
+#include "PipelineState.h"
+
+enum BufferType
+{
+	BUFFER_VERTEX,
+	BUFFER_INDEX
+};
+
+// Everything the engine asks of the graphics API, so the systems, loaders and caches never touch a device
+// context themselves and can run against a device that draws nothing.
+//
+// Buffers and textures are created and released through the device, and dynamic buffers are rewritten whole
+// with WriteBuffer. The rest are the calls a RenderQueue makes to put a frame on screen. Each call changes one
+// piece of state, so the queue can leave out any call that would set what is already bound. Shaders, rasterizer
+// and depth state are bound together as a pipeline state, looked up once per change of description. Draws only
+// upload the per object constants, the per frame and per material ones are uploaded through SetConstants when
+// they change.
+//
+// The interface still hands out Direct3D 11 handles and takes DirectXMath types, so every device, including the
+// recording one, only builds where d3d11.h is available. Headless runs happen on Windows, through the benchmark.
+class IRenderDevice
+{
+public:
+	virtual ~IRenderDevice() {}
+
+	virtual void Shutdown() = 0;
+
+	virtual void BeginFrame(XMFLOAT4 clearColor) = 0;
+	virtual void EndFrame() = 0;
+
+	virtual XMMATRIX GetWorldMatrix() const = 0;
+	virtual XMMATRIX GetProjectionMatrix() const = 0;
+	virtual XMMATRIX GetOrthoMatrix() const = 0;
+
+	virtual ID3D11Buffer* CreateBuffer(BufferType type, const void* data, int size, bool dynamic) = 0;
+	virtual void WriteBuffer(ID3D11Buffer* buffer, const void* data, int size) = 0;
+	virtual void ReleaseBuffer(ID3D11Buffer* buffer) = 0;
+
+	virtual ID3D11ShaderResourceView* CreateTexture(const TargaData& targaData) = 0;
+	virtual void ReleaseTexture(ID3D11ShaderResourceView* texture) = 0;
+
+	virtual bool SupportsInstancing(ShaderType shader) const = 0;
+	virtual int GetConstantSize(ShaderType shader, ConstantFrequency frequency) const = 0;
+
+	virtual PipelineStateHandle GetPipelineState(const PipelineStateDesc& desc) = 0;
+	virtual int GetPipelineStateCount() const = 0;
+
+	virtual void SetPipelineState(PipelineStateHandle pipelineState) = 0;
+	virtual void SetTextures(const TextureShaderParameters& textures) = 0;
+	virtual void SetMesh(const Geometry& mesh) = 0;
+	virtual void SetConstants(ShaderType shader, ConstantFrequency frequency, const ShaderResources& resources) = 0;
+
+	virtual void Draw(ShaderType shader, const ShaderResources& resources, int indexCount) = 0;
+	virtual void DrawInstanced(ShaderType shader, const ShaderResources& resources, int indexCount, const InstanceData* instances, int instanceCount) = 0;
+};
\ No newline at end of file
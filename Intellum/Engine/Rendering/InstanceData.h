@@ -0,0 +1,14 @@
+#pragma once
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+// One entry of the per-instance vertex stream read by the instanced vertex shader. The layout matches the
+// INSTANCE_* elements of the instanced input layout, padded out to a multiple of 16 bytes.
+struct InstanceData
+{
+	XMFLOAT4X4 World;
+	XMFLOAT4 Color;
+	float ColorEnabled;
+	float Padding[3];
+};
\ No newline at end of file
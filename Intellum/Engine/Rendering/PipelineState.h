@@ -0,0 +1,42 @@
+#pragma once
+#include <d3d11.h>
+#include "../ShaderEngine/ShaderTypes.h"
+
+typedef int PipelineStateHandle;
+
+static const PipelineStateHandle NO_PIPELINE_STATE = -1;
+
+// Everything bound before a draw that is not a resource: the shader pair and input layout (picked by Shader and
+// Instanced), the sampler that goes with the shader, the rasterizer state and the depth stencil state. A device
+// creates the state objects for a description once and hands back the same handle whenever it is asked for it
+// again, so switching between two states is a single bind.
+struct PipelineStateDesc
+{
+	ShaderType Shader;
+	bool Instanced;
+	D3D11_FILL_MODE FillMode;
+	D3D11_CULL_MODE CullMode;
+	bool DepthEnabled;
+
+	// Every field packed into its own bits, so two descriptions share a key only when they are the same
+	unsigned long long GetKey() const
+	{
+		unsigned long long key = static_cast<unsigned long long>(Shader & 0xFF);
+		key |= static_cast<unsigned long long>(Instanced ? 1 : 0) << 8;
+		key |= static_cast<unsigned long long>(FillMode & 0xF) << 9;
+		key |= static_cast<unsigned long long>(CullMode & 0xF) << 13;
+		key |= static_cast<unsigned long long>(DepthEnabled ? 1 : 0) << 17;
+
+		return key;
+	}
+
+	bool operator==(const PipelineStateDesc& other) const
+	{
+		return GetKey() == other.GetKey();
+	}
+
+	bool operator!=(const PipelineStateDesc& other) const
+	{
+		return GetKey() != other.GetKey();
+	}
+};
\ No newline at end of file
@@ -0,0 +1,360 @@
+#include "RecordingRenderDevice.h"
+#include "../../Common/Constants.h"
+
+namespace
+{
+	// Sizes of the default shader's constant blocks
+	const int FrameConstantSize = 224;
+	const int MaterialConstantSize = 16;
+	const int ObjectConstantSize = 144;
+
+	const char* CommandName(RenderCommandType type)
+	{
+		switch (type)
+		{
+		case RENDER_COMMAND_SET_PIPELINE_STATE:
+			return "SetPipelineState";
+		case RENDER_COMMAND_SET_TEXTURES:
+			return "SetTextures";
+		case RENDER_COMMAND_SET_MESH:
+			return "SetMesh";
+		case RENDER_COMMAND_SET_CONSTANTS:
+			return "SetConstants";
+		case RENDER_COMMAND_DRAW:
+			return "Draw";
+		case RENDER_COMMAND_DRAW_INSTANCED:
+			return "DrawInstanced";
+		case RENDER_COMMAND_BEGIN_FRAME:
+			return "BeginFrame";
+		case RENDER_COMMAND_END_FRAME:
+			return "EndFrame";
+		case RENDER_COMMAND_CREATE_BUFFER:
+			return "CreateBuffer";
+		case RENDER_COMMAND_WRITE_BUFFER:
+			return "WriteBuffer";
+		case RENDER_COMMAND_RELEASE_BUFFER:
+			return "ReleaseBuffer";
+		case RENDER_COMMAND_CREATE_TEXTURE:
+			return "CreateTexture";
+		case RENDER_COMMAND_RELEASE_TEXTURE:
+			return "ReleaseTexture";
+		default:
+			return "Unknown";
+		}
+	}
+}
+
+RecordingRenderDevice::RecordingRenderDevice(bool instancingSupported, Box screenSize) : _instancingSupported(instancingSupported), _nextResource(1), _boundPipelineState(NO_PIPELINE_STATE), _meshBound(false),
+	_instanceBuffer(nullptr), _instanceCapacity(0)
+{
+	float fieldOfView = XM_PI / 4.0f;
+	float screenAspect = screenSize.Width / screenSize.Height;
+
+	_worldMatrix = XMMatrixIdentity();
+	_projectionMatrix = XMMatrixPerspectiveFovLH(fieldOfView, screenAspect, SCREEN_NEAR, SCREEN_DEPTH);
+	_orthoMatrix = XMMatrixOrthographicLH(screenSize.Width, screenSize.Height, SCREEN_NEAR, SCREEN_DEPTH);
+}
+
+RecordingRenderDevice::~RecordingRenderDevice()
+{
+}
+
+void RecordingRenderDevice::Shutdown()
+{
+	ReleaseBuffer(_instanceBuffer);
+	_instanceBuffer = nullptr;
+	_instanceCapacity = 0;
+
+	Clear();
+	_pipelineStates.clear();
+	_pipelineLookup.clear();
+	_buffers.clear();
+	_textures.clear();
+}
+
+void RecordingRenderDevice::BeginFrame(XMFLOAT4 clearColor)
+{
+	Record(RENDER_COMMAND_BEGIN_FRAME, 0, 0);
+}
+
+void RecordingRenderDevice::EndFrame()
+{
+	Record(RENDER_COMMAND_END_FRAME, 0, 0);
+}
+
+XMMATRIX RecordingRenderDevice::GetWorldMatrix() const
+{
+	return _worldMatrix;
+}
+
+XMMATRIX RecordingRenderDevice::GetProjectionMatrix() const
+{
+	return _projectionMatrix;
+}
+
+XMMATRIX RecordingRenderDevice::GetOrthoMatrix() const
+{
+	return _orthoMatrix;
+}
+
+// Handles are spaced out so none of them is null and each looks like an aligned pointer in the command stream
+ID3D11Buffer* RecordingRenderDevice::CreateBuffer(BufferType type, const void* data, int size, bool dynamic)
+{
+	Validate(size > 0, "Created a buffer of " + to_string(size) + " bytes");
+	Validate(data != nullptr || dynamic, "Created a buffer that is not dynamic without any data to fill it");
+
+	unsigned long long handle = _nextResource++ * 16;
+	_buffers[handle] = { size, dynamic };
+
+	Record(RENDER_COMMAND_CREATE_BUFFER, handle, 0);
+	return reinterpret_cast<ID3D11Buffer*>(handle);
+}
+
+void RecordingRenderDevice::WriteBuffer(ID3D11Buffer* buffer, const void* data, int size)
+{
+	unsigned long long handle = reinterpret_cast<unsigned long long>(buffer);
+	unordered_map<unsigned long long, RecordedBuffer>::const_iterator recorded = _buffers.find(handle);
+
+	if (recorded == _buffers.end())
+		Validate(false, "Wrote to buffer " + to_string(handle) + " which was never created or already released");
+	else
+	{
+		Validate(recorded->second.Dynamic, "Wrote to buffer " + to_string(handle) + " which is not dynamic");
+		Validate(size <= recorded->second.Size, "Wrote " + to_string(size) + " bytes to buffer " + to_string(handle) + " of " + to_string(recorded->second.Size) + " bytes");
+	}
+
+	Record(RENDER_COMMAND_WRITE_BUFFER, handle, 0);
+}
+
+void RecordingRenderDevice::ReleaseBuffer(ID3D11Buffer* buffer)
+{
+	if (buffer == nullptr)
+		return;
+
+	unsigned long long handle = reinterpret_cast<unsigned long long>(buffer);
+	Validate(_buffers.erase(handle) == 1, "Released buffer " + to_string(handle) + " which was never created or already released");
+
+	Record(RENDER_COMMAND_RELEASE_BUFFER, handle, 0);
+}
+
+ID3D11ShaderResourceView* RecordingRenderDevice::CreateTexture(const TargaData& targaData)
+{
+	Validate(targaData.ImageSize.Width > 0 && targaData.ImageSize.Height > 0, "Created an empty texture");
+
+	unsigned long long handle = _nextResource++ * 16;
+	_textures[handle] = targaData.ImageSize;
+
+	Record(RENDER_COMMAND_CREATE_TEXTURE, handle, 0);
+	return reinterpret_cast<ID3D11ShaderResourceView*>(handle);
+}
+
+void RecordingRenderDevice::ReleaseTexture(ID3D11ShaderResourceView* texture)
+{
+	if (texture == nullptr)
+		return;
+
+	unsigned long long handle = reinterpret_cast<unsigned long long>(texture);
+	Validate(_textures.erase(handle) == 1, "Released texture " + to_string(handle) + " which was never created or already released");
+
+	Record(RENDER_COMMAND_RELEASE_TEXTURE, handle, 0);
+}
+
+bool RecordingRenderDevice::SupportsInstancing(ShaderType shader) const
+{
+	return _instancingSupported;
+}
+
+void RecordingRenderDevice::Record(RenderCommandType type, unsigned long long value, int instances)
+{
+	RenderCommand command;
+	command.Type = type;
+	command.Value = value;
+	command.Instances = instances;
+
+	_commands.push_back(command);
+}
+
+void RecordingRenderDevice::Validate(bool valid, const string& error)
+{
+	if (!valid)
+		_validationErrors.push_back(to_string(_commands.size()) + ": " + error);
+}
+
+void RecordingRenderDevice::ValidateShader(ShaderType shader, const char* call)
+{
+	if (_boundPipelineState == NO_PIPELINE_STATE)
+	{
+		Validate(false, string(call) + " before a pipeline state was bound");
+		return;
+	}
+
+	Validate(_pipelineStates[_boundPipelineState].Shader == shader, string(call) + " for shader " + to_string(shader) + " while the bound pipeline state uses shader "
+		+ to_string(_pipelineStates[_boundPipelineState].Shader));
+}
+
+int RecordingRenderDevice::GetConstantSize(ShaderType shader, ConstantFrequency frequency) const
+{
+	switch (frequency)
+	{
+	case CONSTANTS_PER_FRAME:
+		return FrameConstantSize;
+	case CONSTANTS_PER_MATERIAL:
+		return MaterialConstantSize;
+	case CONSTANTS_PER_OBJECT:
+		return ObjectConstantSize;
+	default:
+		return 0;
+	}
+}
+
+PipelineStateHandle RecordingRenderDevice::GetPipelineState(const PipelineStateDesc& desc)
+{
+	Validate(!desc.Instanced || _instancingSupported, "Instanced pipeline state requested for shader " + to_string(desc.Shader) + " without instancing support");
+
+	unordered_map<unsigned long long, PipelineStateHandle>::const_iterator existing = _pipelineLookup.find(desc.GetKey());
+	if (existing != _pipelineLookup.end())
+		return existing->second;
+
+	PipelineStateHandle handle = static_cast<PipelineStateHandle>(_pipelineStates.size());
+	_pipelineStates.push_back(desc);
+	_pipelineLookup[desc.GetKey()] = handle;
+
+	return handle;
+}
+
+int RecordingRenderDevice::GetPipelineStateCount() const
+{
+	return static_cast<int>(_pipelineStates.size());
+}
+
+void RecordingRenderDevice::SetPipelineState(PipelineStateHandle pipelineState)
+{
+	bool known = pipelineState >= 0 && pipelineState < static_cast<int>(_pipelineStates.size());
+	Validate(known, "Bound pipeline state " + to_string(pipelineState) + " which was never created");
+	Validate(pipelineState != _boundPipelineState, "Bound pipeline state " + to_string(pipelineState) + " while it was already bound");
+
+	Record(RENDER_COMMAND_SET_PIPELINE_STATE, static_cast<unsigned long long>(pipelineState), 0);
+	_boundPipelineState = known ? pipelineState : NO_PIPELINE_STATE;
+}
+
+void RecordingRenderDevice::SetTextures(const TextureShaderParameters& textures)
+{
+	Validate(_boundPipelineState != NO_PIPELINE_STATE, "Textures set before a pipeline state was bound");
+	Record(RENDER_COMMAND_SET_TEXTURES, textures.TextureCount == 0 ? 0 : reinterpret_cast<unsigned long long>(textures.TextureArray[0]), 0);
+}
+
+void RecordingRenderDevice::SetMesh(const Geometry& mesh)
+{
+	_meshBound = mesh.VertexBuffer != nullptr;
+	Record(RENDER_COMMAND_SET_MESH, reinterpret_cast<unsigned long long>(mesh.VertexBuffer), 0);
+}
+
+void RecordingRenderDevice::SetConstants(ShaderType shader, ConstantFrequency frequency, const ShaderResources& resources)
+{
+	ValidateShader(shader, "Constants set");
+	Record(RENDER_COMMAND_SET_CONSTANTS, frequency, 0);
+}
+
+void RecordingRenderDevice::Draw(ShaderType shader, const ShaderResources& resources, int indexCount)
+{
+	ValidateShader(shader, "Draw");
+	Validate(_boundPipelineState == NO_PIPELINE_STATE || !_pipelineStates[_boundPipelineState].Instanced, "Draw through an instanced pipeline state");
+	Validate(_meshBound, "Draw without a mesh bound");
+	Record(RENDER_COMMAND_DRAW, indexCount, 1);
+}
+
+// Grows the same way as D3D11RenderDevice::ReserveInstances, replacing the buffer and nothing else
+void RecordingRenderDevice::ReserveInstances(int instanceCount)
+{
+	if (_instanceBuffer != nullptr && instanceCount <= _instanceCapacity)
+		return;
+
+	int capacity = _instanceCapacity > 0 ? _instanceCapacity : INSTANCE_BUFFER_INITIAL_CAPACITY;
+	while (capacity < instanceCount)
+		capacity *= 2;
+
+	ReleaseBuffer(_instanceBuffer);
+	_instanceBuffer = CreateBuffer(BUFFER_VERTEX, nullptr, sizeof(InstanceData) * capacity, true);
+	_instanceCapacity = capacity;
+}
+
+void RecordingRenderDevice::DrawInstanced(ShaderType shader, const ShaderResources& resources, int indexCount, const InstanceData* instances, int instanceCount)
+{
+	ReserveInstances(instanceCount);
+	WriteBuffer(_instanceBuffer, instances, sizeof(InstanceData) * instanceCount);
+
+	ValidateShader(shader, "Instanced draw");
+	Validate(_boundPipelineState == NO_PIPELINE_STATE || _pipelineStates[_boundPipelineState].Instanced, "Instanced draw through a pipeline state that is not instanced");
+	Validate(_meshBound, "Instanced draw without a mesh bound");
+	Record(RENDER_COMMAND_DRAW_INSTANCED, indexCount, instanceCount);
+}
+
+// Pipeline states, buffers and textures stay created, but nothing is taken to be bound any more
+void RecordingRenderDevice::Clear()
+{
+	_commands.clear();
+	_validationErrors.clear();
+	_boundPipelineState = NO_PIPELINE_STATE;
+	_meshBound = false;
+}
+
+void RecordingRenderDevice::Write(ostream& stream) const
+{
+	for (const RenderCommand& command : _commands)
+	{
+		stream << CommandName(command.Type) << " " << command.Value;
+		if (command.Instances > 1)
+			stream << " x" << command.Instances;
+
+		stream << "\n";
+	}
+
+	for (const string& error : _validationErrors)
+		stream << "Error " << error << "\n";
+}
+
+const vector<RenderCommand>& RecordingRenderDevice::GetCommands() const
+{
+	return _commands;
+}
+
+int RecordingRenderDevice::GetCount(RenderCommandType type) const
+{
+	int count = 0;
+	for (const RenderCommand& command : _commands)
+	{
+		if (command.Type == type)
+			count++;
+	}
+
+	return count;
+}
+
+int RecordingRenderDevice::GetInstanceCount() const
+{
+	int count = 0;
+	for (const RenderCommand& command : _commands)
+		count += command.Instances;
+
+	return count;
+}
+
+int RecordingRenderDevice::GetBufferCount() const
+{
+	return static_cast<int>(_buffers.size());
+}
+
+int RecordingRenderDevice::GetTextureCount() const
+{
+	return static_cast<int>(_textures.size());
+}
+
+int RecordingRenderDevice::GetInstanceCapacity() const
+{
+	return _instanceCapacity;
+}
+
+const vector<string>& RecordingRenderDevice::GetValidationErrors() const
+{
+	return _validationErrors;
+}
\ No newline at end of file
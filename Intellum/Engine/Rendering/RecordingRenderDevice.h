@@ -0,0 +1,126 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "IRenderDevice.h"
+#include "../../Common/Box.h"
+
+using namespace std;
+
+enum RenderCommandType
+{
+	RENDER_COMMAND_SET_PIPELINE_STATE,
+	RENDER_COMMAND_SET_TEXTURES,
+	RENDER_COMMAND_SET_MESH,
+	RENDER_COMMAND_SET_CONSTANTS,
+	RENDER_COMMAND_DRAW,
+	RENDER_COMMAND_DRAW_INSTANCED,
+	RENDER_COMMAND_BEGIN_FRAME,
+	RENDER_COMMAND_END_FRAME,
+	RENDER_COMMAND_CREATE_BUFFER,
+	RENDER_COMMAND_WRITE_BUFFER,
+	RENDER_COMMAND_RELEASE_BUFFER,
+	RENDER_COMMAND_CREATE_TEXTURE,
+	RENDER_COMMAND_RELEASE_TEXTURE,
+	RENDER_COMMAND_TYPE_COUNT
+};
+
+struct RenderCommand
+{
+	RenderCommandType Type;
+	unsigned long long Value;
+	int Instances;
+};
+
+// Writes down the calls made to it instead of drawing anything, so a frame can be inspected without a GPU.
+// Every call is also checked against the pipeline state bound at the time, and anything a real device would
+// draw wrongly or reject is kept as a validation error: binding a state that was never created or is already
+// bound, and setting constants or drawing before a state is bound, for another shader than the bound one, or
+// instanced through a state that is not (and the other way round).
+//
+// Buffers and textures are handed out as made up handles that must never be dereferenced. The device keeps the
+// ones still alive, so writing to a buffer that is not dynamic or too small, releasing a resource twice and
+// anything left unreleased at the end of a run can all be caught without a GPU.
+//
+// Instances are written to a dynamic buffer of the device's own, grown the way the Direct3D device grows its
+// instance buffer, so what a resize does to the rest of the device's state shows up here as well.
+class RecordingRenderDevice : public IRenderDevice
+{
+private:
+	struct RecordedBuffer
+	{
+		int Size;
+		bool Dynamic;
+	};
+
+	vector<RenderCommand> _commands;
+	vector<string> _validationErrors;
+	bool _instancingSupported;
+
+	XMMATRIX _worldMatrix;
+	XMMATRIX _projectionMatrix;
+	XMMATRIX _orthoMatrix;
+
+	unsigned long long _nextResource;
+	unordered_map<unsigned long long, RecordedBuffer> _buffers;
+	unordered_map<unsigned long long, Box> _textures;
+
+	vector<PipelineStateDesc> _pipelineStates;
+	unordered_map<unsigned long long, PipelineStateHandle> _pipelineLookup;
+	PipelineStateHandle _boundPipelineState;
+	bool _meshBound;
+
+	ID3D11Buffer* _instanceBuffer;
+	int _instanceCapacity;
+
+	void Record(RenderCommandType type, unsigned long long value, int instances);
+	void Validate(bool valid, const string& error);
+	void ValidateShader(ShaderType shader, const char* call);
+	void ReserveInstances(int instanceCount);
+
+public:
+	RecordingRenderDevice(bool instancingSupported, Box screenSize);
+	~RecordingRenderDevice() override;
+
+	void Shutdown() override;
+
+	void BeginFrame(XMFLOAT4 clearColor) override;
+	void EndFrame() override;
+
+	XMMATRIX GetWorldMatrix() const override;
+	XMMATRIX GetProjectionMatrix() const override;
+	XMMATRIX GetOrthoMatrix() const override;
+
+	ID3D11Buffer* CreateBuffer(BufferType type, const void* data, int size, bool dynamic) override;
+	void WriteBuffer(ID3D11Buffer* buffer, const void* data, int size) override;
+	void ReleaseBuffer(ID3D11Buffer* buffer) override;
+
+	ID3D11ShaderResourceView* CreateTexture(const TargaData& targaData) override;
+	void ReleaseTexture(ID3D11ShaderResourceView* texture) override;
+
+	bool SupportsInstancing(ShaderType shader) const override;
+	int GetConstantSize(ShaderType shader, ConstantFrequency frequency) const override;
+
+	PipelineStateHandle GetPipelineState(const PipelineStateDesc& desc) override;
+	int GetPipelineStateCount() const override;
+
+	void SetPipelineState(PipelineStateHandle pipelineState) override;
+	void SetTextures(const TextureShaderParameters& textures) override;
+	void SetMesh(const Geometry& mesh) override;
+	void SetConstants(ShaderType shader, ConstantFrequency frequency, const ShaderResources& resources) override;
+
+	void Draw(ShaderType shader, const ShaderResources& resources, int indexCount) override;
+	void DrawInstanced(ShaderType shader, const ShaderResources& resources, int indexCount, const InstanceData* instances, int instanceCount) override;
+
+	void Clear();
+	void Write(ostream& stream) const;
+
+	const vector<RenderCommand>& GetCommands() const;
+	int GetCount(RenderCommandType type) const;
+	int GetInstanceCount() const;
+	int GetBufferCount() const;
+	int GetTextureCount() const;
+	int GetInstanceCapacity() const;
+	const vector<string>& GetValidationErrors() const;
+};
\ No newline at end of file
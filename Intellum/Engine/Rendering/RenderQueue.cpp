@@ -0,0 +1,449 @@
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cstring>
+#include "../../Common/Constants.h"
+
+namespace
+{
+	unsigned long long HashPointer(unsigned long long hash, const void* pointer)
+	{
+		unsigned long long value = reinterpret_cast<unsigned long long>(pointer);
+		for (int i = 0; i < 8; i++)
+		{
+			hash = (hash ^ (value & 0xFF)) * 1099511628211ULL;
+			value >>= 8;
+		}
+
+		return hash;
+	}
+
+	unsigned long long FoldTo16Bits(unsigned long long hash)
+	{
+		return (hash ^ (hash >> 16) ^ (hash >> 32) ^ (hash >> 48)) & 0xFFFF;
+	}
+}
+
+RenderQueue::RenderQueue() : _constantSizes(), _workerPool(nullptr)
+{
+}
+
+RenderQueue::RenderQueue(WorkerPool* workerPool) : _constantSizes(), _workerPool(workerPool)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+void RenderQueue::Clear()
+{
+	_items.clear();
+	_order.clear();
+	_batches.clear();
+	_instances.clear();
+}
+
+void RenderQueue::Add(const DrawItem& item)
+{
+	SortEntry entry;
+	entry.Key = item.Key;
+	entry.Item = static_cast<int>(_items.size());
+
+	_items.push_back(item);
+	_order.push_back(entry);
+}
+
+unsigned long long RenderQueue::BuildKey(RenderPass pass, ShaderType shader, D3D11_CULL_MODE cullMode, const TextureShaderParameters& textures, const Geometry& mesh, float depth)
+{
+	return BuildKey(BuildStateKey(pass, shader, cullMode, textures, mesh), depth);
+}
+
+// Everything in the key but the depth, which lets a draw that keeps its state build its key once
+unsigned long long RenderQueue::BuildStateKey(RenderPass pass, ShaderType shader, D3D11_CULL_MODE cullMode, const TextureShaderParameters& textures, const Geometry& mesh)
+{
+	unsigned long long key = static_cast<unsigned long long>(pass & 0x3) << 62;
+
+	// Interface draws overlap, so they keep their depth and submission order instead of being grouped by state
+	if (pass != RENDER_PASS_OPAQUE)
+		return key;
+
+	unsigned long long textureHash = 14695981039346656037ULL;
+	for (int i = 0; i < textures.TextureCount; i++)
+		textureHash = HashPointer(textureHash, textures.TextureArray[i]);
+
+	textureHash = HashPointer(textureHash, textures.LightMap);
+	textureHash = HashPointer(textureHash, textures.BumpMap);
+
+	unsigned long long meshHash = HashPointer(14695981039346656037ULL, mesh.VertexBuffer);
+
+	key |= static_cast<unsigned long long>(shader & 0xF) << 58;
+	key |= static_cast<unsigned long long>(cullMode & 0x3) << 56;
+	key |= FoldTo16Bits(textureHash) << 40;
+	key |= FoldTo16Bits(meshHash) << 24;
+
+	return key;
+}
+
+unsigned long long RenderQueue::BuildKey(unsigned long long stateKey, float depth)
+{
+	float normalisedDepth = depth / SCREEN_DEPTH;
+	normalisedDepth = normalisedDepth < 0.0f ? 0.0f : normalisedDepth > 1.0f ? 1.0f : normalisedDepth;
+
+	unsigned long long depthBits = static_cast<unsigned long long>(normalisedDepth * 0xFFFFFF);
+	if ((stateKey >> 62) != RENDER_PASS_OPAQUE)
+		return (stateKey & (0x3ULL << 62)) | (depthBits << 38);
+
+	return (stateKey & ~0xFFFFFFULL) | depthBits;
+}
+
+bool RenderQueue::SameTextures(const TextureShaderParameters& first, const TextureShaderParameters& second)
+{
+	if (first.TextureCount != second.TextureCount)
+		return false;
+
+	for (int i = 0; i < first.TextureCount; i++)
+	{
+		if (first.TextureArray[i] != second.TextureArray[i])
+			return false;
+	}
+
+	return first.LightMap == second.LightMap && first.BumpMap == second.BumpMap
+		&& first.LightMapEnabled == second.LightMapEnabled && first.BumpMapEnabled == second.BumpMapEnabled;
+}
+
+bool RenderQueue::SameMesh(const Geometry& first, const Geometry& second)
+{
+	return first.VertexBuffer == second.VertexBuffer && first.IndexBuffer == second.IndexBuffer && first.VBStride == second.VBStride && first.VBOffset == second.VBOffset;
+}
+
+bool RenderQueue::SameMatrix(const XMMATRIX& first, const XMMATRIX& second)
+{
+	return memcmp(&first, &second, sizeof(XMMATRIX)) == 0;
+}
+
+// Instances share everything but their world matrix and color. Gradients are positioned per object, so draws
+// using one are never merged.
+bool RenderQueue::CanInstance(const DrawItem& first, const DrawItem& second)
+{
+	const ShaderResources& firstResources = first.Resources;
+	const ShaderResources& secondResources = second.Resources;
+
+	return first.Pass == second.Pass && first.Shader == second.Shader && first.FillMode == second.FillMode && first.CullMode == second.CullMode && first.DepthEnabled == second.DepthEnabled
+		&& SameMesh(first.Mesh, second.Mesh) && first.Mesh.IndexCount == second.Mesh.IndexCount
+		&& SameTextures(firstResources.TextureParameters, secondResources.TextureParameters)
+		&& firstResources.LightEnabled == secondResources.LightEnabled
+		&& !firstResources.GradientParameters.Enabled && !secondResources.GradientParameters.Enabled
+		&& SameMatrix(firstResources.MatrixParameters.ViewMatrix, secondResources.MatrixParameters.ViewMatrix)
+		&& SameMatrix(firstResources.MatrixParameters.ProjectionMatrix, secondResources.MatrixParameters.ProjectionMatrix);
+}
+
+bool RenderQueue::SameFrame(const DrawItem& first, const DrawItem& second)
+{
+	return first.Shader == second.Shader && first.Resources.LightEnabled == second.Resources.LightEnabled
+		&& SameMatrix(first.Resources.MatrixParameters.ViewMatrix, second.Resources.MatrixParameters.ViewMatrix)
+		&& SameMatrix(first.Resources.MatrixParameters.ProjectionMatrix, second.Resources.MatrixParameters.ProjectionMatrix);
+}
+
+PipelineStateDesc RenderQueue::DescribePipeline(const DrawItem& item, bool instanced)
+{
+	PipelineStateDesc desc;
+	desc.Shader = item.Shader;
+	desc.Instanced = instanced;
+	desc.FillMode = item.FillMode;
+	desc.CullMode = item.CullMode;
+	desc.DepthEnabled = item.DepthEnabled;
+
+	return desc;
+}
+
+InstanceData RenderQueue::PackInstance(const DrawItem& item)
+{
+	InstanceData instance;
+	XMStoreFloat4x4(&instance.World, item.Resources.MatrixParameters.WorldMatrix);
+	instance.Color = item.Resources.ColorParameters.Color;
+	instance.ColorEnabled = item.Resources.ColorParameters.Enabled ? 1.0f : 0.0f;
+	instance.Padding[0] = instance.Padding[1] = instance.Padding[2] = 0.0f;
+
+	return instance;
+}
+
+void RenderQueue::Sort()
+{
+	sort(_order.begin(), _order.end(), [](const SortEntry& first, const SortEntry& second)
+	{
+		return first.Key != second.Key ? first.Key < second.Key : first.Item < second.Item;
+	});
+}
+
+// Pipeline states are looked up as the batches are built, and only when the description changes from the batch
+// before, as the device may create them
+void RenderQueue::BuildBatches(IRenderDevice* device)
+{
+	_batches.clear();
+	_instances.clear();
+
+	int count = static_cast<int>(_order.size());
+	for (int first = 0; first < count;)
+	{
+		const DrawItem& item = _items[_order[first].Item];
+
+		int last = first + 1;
+		if (device->SupportsInstancing(item.Shader))
+		{
+			while (last < count && CanInstance(item, _items[_order[last].Item]))
+				last++;
+		}
+
+		DrawBatch batch;
+		batch.First = first;
+		batch.Count = last - first;
+		batch.FirstInstance = -1;
+		batch.PipelineState = NO_PIPELINE_STATE;
+
+		if (batch.Count >= INSTANCING_MIN_BATCH_SIZE)
+		{
+			batch.FirstInstance = static_cast<int>(_instances.size());
+			for (int i = first; i < last; i++)
+				_instances.push_back(PackInstance(_items[_order[i].Item]));
+
+			// Colors come from the instance stream, so the shared constants must not override them
+			_items[_order[first].Item].Resources.ColorParameters = ColorShaderParameters();
+			_batches.push_back(batch);
+		}
+		else
+		{
+			for (int i = first; i < last; i++)
+			{
+				batch.First = i;
+				batch.Count = 1;
+				_batches.push_back(batch);
+			}
+		}
+
+		first = last;
+	}
+
+	PipelineStateDesc previousPipeline = PipelineStateDesc();
+	for (int i = 0; i < static_cast<int>(_batches.size()); i++)
+	{
+		DrawBatch& batch = _batches[i];
+		PipelineStateDesc pipeline = DescribePipeline(_items[_order[batch.First].Item], batch.FirstInstance >= 0);
+
+		batch.PipelineState = i > 0 && pipeline == previousPipeline ? _batches[i - 1].PipelineState : device->GetPipelineState(pipeline);
+		previousPipeline = pipeline;
+	}
+}
+
+void RenderQueue::CacheConstantSizes(const IRenderDevice* device)
+{
+	for (int shader = 0; shader < SHADER_TYPE_COUNT; shader++)
+	{
+		for (int frequency = 0; frequency < CONSTANT_FREQUENCY_COUNT; frequency++)
+			_constantSizes[shader][frequency] = device->GetConstantSize(static_cast<ShaderType>(shader), static_cast<ConstantFrequency>(frequency));
+	}
+}
+
+// Nothing is assumed about what the device has bound before the first draw, so every piece of state is set for it.
+// The submitting thread records the first list itself and then executes the lists in order as they are finished.
+void RenderQueue::Submit(IRenderDevice* device)
+{
+	Sort();
+	BuildBatches(device);
+	CacheConstantSizes(device);
+
+	int batchCount = static_cast<int>(_batches.size());
+	int workerCount = _workerPool ? _workerPool->GetWorkerCount() : 0;
+	int listCount = max(1, min(workerCount + 1, batchCount / COMMAND_LIST_MIN_BATCHES));
+
+	if (static_cast<int>(_commandLists.size()) < listCount)
+		_commandLists.resize(listCount);
+
+	_listStatistics.assign(listCount, RenderQueueStatistics());
+	_listRecorded.assign(listCount, false);
+	_listErrors.assign(listCount, exception_ptr());
+
+	for (int list = 1; list < listCount; list++)
+	{
+		int firstBatch = batchCount * list / listCount;
+		int lastBatch = batchCount * (list + 1) / listCount;
+
+		_workerPool->Submit([this, list, firstBatch, lastBatch]()
+		{
+			// A list that fails to record is still marked as recorded, and its error is thrown by the submitting thread
+			exception_ptr error;
+			try
+			{
+				Record(list, firstBatch, lastBatch);
+			}
+			catch (...)
+			{
+				error = current_exception();
+			}
+
+			lock_guard<mutex> lock(_recordLock);
+			_listErrors[list] = error;
+			_listRecorded[list] = true;
+			_listFinished.notify_all();
+		});
+	}
+
+	try
+	{
+		Record(0, 0, batchCount / listCount);
+		_commandLists[0].Execute(device);
+
+		for (int list = 1; list < listCount; list++)
+		{
+			WaitForList(list);
+			if (_listErrors[list])
+				rethrow_exception(_listErrors[list]);
+
+			_commandLists[list].Execute(device);
+		}
+	}
+	catch (...)
+	{
+		// The workers still recording read the queue, so it cannot be cleared until they are done
+		for (int list = 1; list < listCount; list++)
+			WaitForList(list);
+
+		throw;
+	}
+
+	_statistics = RenderQueueStatistics();
+	for (const RenderQueueStatistics& statistics : _listStatistics)
+		_statistics.Add(statistics);
+
+	_statistics.Items = static_cast<int>(_items.size());
+	_statistics.CommandLists = listCount;
+
+	NotifyObservers();
+}
+
+// The batch before the run has left its state bound, unless the run starts the frame
+void RenderQueue::Record(int list, int firstBatch, int lastBatch)
+{
+	CommandList& commandList = _commandLists[list];
+	RenderQueueStatistics& statistics = _listStatistics[list];
+	commandList.Clear();
+
+	const DrawItem* previous = nullptr;
+	PipelineStateHandle previousPipeline = NO_PIPELINE_STATE;
+
+	if (firstBatch > 0)
+	{
+		previous = &_items[_order[_batches[firstBatch - 1].First].Item];
+		previousPipeline = _batches[firstBatch - 1].PipelineState;
+	}
+
+	for (int i = firstBatch; i < lastBatch; i++)
+	{
+		const DrawBatch& batch = _batches[i];
+		const DrawItem& item = _items[_order[batch.First].Item];
+
+		if (previous == nullptr || batch.PipelineState != previousPipeline)
+		{
+			commandList.SetPipelineState(batch.PipelineState);
+			statistics.PipelineBinds++;
+		}
+		else
+			statistics.PipelineBindsAvoided++;
+
+		bool texturesChanged = previous == nullptr || !SameTextures(previous->Resources.TextureParameters, item.Resources.TextureParameters);
+		if (texturesChanged)
+		{
+			commandList.SetTextures(item.Resources.TextureParameters);
+			statistics.TextureBinds++;
+		}
+		else
+			statistics.TextureBindsAvoided++;
+
+		if (previous == nullptr || !SameMesh(previous->Mesh, item.Mesh))
+		{
+			commandList.SetMesh(item.Mesh);
+			statistics.MeshBinds++;
+		}
+		else
+			statistics.MeshBindsAvoided++;
+
+		bool frameChanged = previous == nullptr || !SameFrame(*previous, item);
+		if (frameChanged)
+		{
+			RecordConstants(list, item.Shader, CONSTANTS_PER_FRAME, item.Resources);
+			statistics.FrameUploads++;
+		}
+
+		if (frameChanged || texturesChanged)
+		{
+			RecordConstants(list, item.Shader, CONSTANTS_PER_MATERIAL, item.Resources);
+			statistics.MaterialUploads++;
+		}
+
+		statistics.ObjectUploads++;
+		statistics.ConstantBytes += _constantSizes[item.Shader][CONSTANTS_PER_OBJECT];
+
+		if (batch.FirstInstance >= 0)
+		{
+			commandList.DrawInstanced(item.Shader, item.Resources, item.Mesh.IndexCount, &_instances[batch.FirstInstance], batch.Count);
+			statistics.InstancedDraws++;
+			statistics.Instances += batch.Count;
+		}
+		else
+			commandList.Draw(item.Shader, item.Resources, item.Mesh.IndexCount);
+
+		statistics.Draws++;
+
+		previous = &item;
+		previousPipeline = batch.PipelineState;
+	}
+}
+
+void RenderQueue::RecordConstants(int list, ShaderType shader, ConstantFrequency frequency, const ShaderResources& resources)
+{
+	_commandLists[list].SetConstants(shader, frequency, resources);
+	_listStatistics[list].ConstantBytes += _constantSizes[shader][frequency];
+}
+
+void RenderQueue::WaitForList(int list)
+{
+	unique_lock<mutex> lock(_recordLock);
+	while (_listRecorded[list] == false)
+		_listFinished.wait(lock);
+}
+
+void RenderQueue::NotifyObservers() const
+{
+	for (int i = 0; i < Observers.size(); i++)
+	{
+		ObserverEvent observerEvent;
+		observerEvent.EventType = CONSTANT_BYTES;
+		observerEvent.SetObservableData(_statistics.ConstantBytes);
+		Observers.at(i)->Notify(observerEvent);
+		observerEvent.Shutdown<int>();
+	}
+}
+
+int RenderQueue::GetSize() const
+{
+	return static_cast<int>(_items.size());
+}
+
+const RenderQueueStatistics& RenderQueue::GetStatistics() const
+{
+	return _statistics;
+}
+
+const vector<DrawBatch>& RenderQueue::GetBatches() const
+{
+	return _batches;
+}
+
+const vector<InstanceData>& RenderQueue::GetInstances() const
+{
+	return _instances;
+}
+
+void RenderQueue::AddObserver(IObserver* observer)
+{
+	Observers.push_back(observer);
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+#pragma once
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <vector>
+#include "CommandList.h"
+#include "DrawItem.h"
+#include "IRenderDevice.h"
+#include "../Observer/Observable.h"
+#include "../Threading/WorkerPool.h"
+
+using namespace std;
+
+struct RenderQueueStatistics
+{
+	int Items;
+	int Draws;
+	int InstancedDraws;
+	int Instances;
+	int PipelineBinds;
+	int PipelineBindsAvoided;
+	int TextureBinds;
+	int TextureBindsAvoided;
+	int MeshBinds;
+	int MeshBindsAvoided;
+	int FrameUploads;
+	int MaterialUploads;
+	int ObjectUploads;
+	int ConstantBytes;
+	int CommandLists;
+
+	RenderQueueStatistics() : Items(0), Draws(0), InstancedDraws(0), Instances(0), PipelineBinds(0), PipelineBindsAvoided(0), TextureBinds(0), TextureBindsAvoided(0), MeshBinds(0),
+		MeshBindsAvoided(0), FrameUploads(0), MaterialUploads(0), ObjectUploads(0), ConstantBytes(0), CommandLists(0) {}
+
+	// Adds up what separately recorded parts of a frame did
+	void Add(const RenderQueueStatistics& other)
+	{
+		Items += other.Items;
+		Draws += other.Draws;
+		InstancedDraws += other.InstancedDraws;
+		Instances += other.Instances;
+		PipelineBinds += other.PipelineBinds;
+		PipelineBindsAvoided += other.PipelineBindsAvoided;
+		TextureBinds += other.TextureBinds;
+		TextureBindsAvoided += other.TextureBindsAvoided;
+		MeshBinds += other.MeshBinds;
+		MeshBindsAvoided += other.MeshBindsAvoided;
+		FrameUploads += other.FrameUploads;
+		MaterialUploads += other.MaterialUploads;
+		ObjectUploads += other.ObjectUploads;
+		ConstantBytes += other.ConstantBytes;
+		CommandLists += other.CommandLists;
+	}
+
+	int GetBinds() const { return PipelineBinds + TextureBinds + MeshBinds; }
+	int GetBindsAvoided() const { return PipelineBindsAvoided + TextureBindsAvoided + MeshBindsAvoided; }
+};
+
+// A run of sorted draws submitted with one draw call through PipelineState. Runs of a single draw are drawn
+// normally, longer runs are drawn instanced from the instance stream starting at FirstInstance.
+struct DrawBatch
+{
+	int First;
+	int Count;
+	int FirstInstance;
+	PipelineStateHandle PipelineState;
+};
+
+// Collects the draws of a frame and submits them ordered by a 64 bit key, so draws sharing state end up next to
+// each other and the state is only bound once for the run. From the most significant bit down the key holds
+//     pass (2) | shader (4) | cull mode (2) | texture set (16) | mesh (16) | depth (24)
+// Texture sets and meshes are folded down to 16 bits, so two of them can share a value. That only costs a bind,
+// as submission compares the state itself rather than the key before leaving a bind out.
+//
+// Interface and text draws overlap each other, so their keys only hold the pass and the depth, right below it.
+// They are drawn by depth and then in the order they were added, and only share binds with the draw before.
+//
+// The shader, fill mode, cull mode and depth test of a run are bound as one pipeline state, which is only looked
+// up on the device when the description changes from the previous run.
+//
+// Neighbouring draws that only differ in their world matrix and color are merged into an instanced draw when the
+// device can draw their shader instanced.
+//
+// Shader constants are uploaded by how often they change. Per frame constants are uploaded when the shader or the
+// view changes, per material constants when the textures change as well, and only per object constants are
+// uploaded with every draw. Observers are told how many bytes of constants each submitted frame uploaded.
+//
+// Given a worker pool, the sorted batches are split into runs of at least COMMAND_LIST_MIN_BATCHES, at most one
+// for each worker and one for the submitting thread, and each run is recorded into a command list of its own on
+// a worker. A run starts from the state the run before it leaves bound, so the lists executed in order make
+// exactly the calls one list would. Pipeline states and constant sizes are looked up on the submitting thread
+// first, so the workers never touch the device.
+class RenderQueue : public Observable
+{
+private:
+	struct SortEntry
+	{
+		unsigned long long Key;
+		int Item;
+	};
+
+	vector<DrawItem> _items;
+	vector<SortEntry> _order;
+	vector<DrawBatch> _batches;
+	vector<InstanceData> _instances;
+	RenderQueueStatistics _statistics;
+	int _constantSizes[SHADER_TYPE_COUNT][CONSTANT_FREQUENCY_COUNT];
+
+	WorkerPool* _workerPool;
+	vector<CommandList> _commandLists;
+	vector<RenderQueueStatistics> _listStatistics;
+	vector<bool> _listRecorded;
+	vector<exception_ptr> _listErrors;
+	mutex _recordLock;
+	condition_variable _listFinished;
+
+	void Sort();
+	void BuildBatches(IRenderDevice* device);
+	void CacheConstantSizes(const IRenderDevice* device);
+	void Record(int list, int firstBatch, int lastBatch);
+	void RecordConstants(int list, ShaderType shader, ConstantFrequency frequency, const ShaderResources& resources);
+	void WaitForList(int list);
+
+	static bool SameTextures(const TextureShaderParameters& first, const TextureShaderParameters& second);
+	static bool SameMesh(const Geometry& first, const Geometry& second);
+	static bool SameMatrix(const XMMATRIX& first, const XMMATRIX& second);
+	static bool SameFrame(const DrawItem& first, const DrawItem& second);
+	static PipelineStateDesc DescribePipeline(const DrawItem& item, bool instanced);
+
+	void NotifyObservers() const;
+
+public:
+	RenderQueue();
+	RenderQueue(WorkerPool* workerPool);
+	~RenderQueue() override;
+
+	void Clear();
+	void Add(const DrawItem& item);
+	void Submit(IRenderDevice* device);
+
+	static unsigned long long BuildKey(RenderPass pass, ShaderType shader, D3D11_CULL_MODE cullMode, const TextureShaderParameters& textures, const Geometry& mesh, float depth);
+	static unsigned long long BuildStateKey(RenderPass pass, ShaderType shader, D3D11_CULL_MODE cullMode, const TextureShaderParameters& textures, const Geometry& mesh);
+	static unsigned long long BuildKey(unsigned long long stateKey, float depth);
+	static bool CanInstance(const DrawItem& first, const DrawItem& second);
+	static InstanceData PackInstance(const DrawItem& item);
+
+	int GetSize() const;
+	const RenderQueueStatistics& GetStatistics() const;
+	const vector<DrawBatch>& GetBatches() const;
+	const vector<InstanceData>& GetInstances() const;
+
+	void AddObserver(IObserver* observer) override;
+};
\ No newline at end of file
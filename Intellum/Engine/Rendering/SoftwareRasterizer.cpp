@@ -0,0 +1,698 @@
+#include "SoftwareRasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace
+{
+	const int SubpixelBits = 4;
+	const int SubpixelScale = 1 << SubpixelBits;
+	const int SubpixelHalf = SubpixelScale / 2;
+
+	// How far past the screen edges a triangle may reach before it is clipped. Keeps snapped coordinates small
+	// enough that an edge function stepped across a tile never leaves 32 bits.
+	const float GuardBandPixels = 4096.0f;
+	const long long EdgeLimit = 1LL << 30;
+
+	const int ClipPlaneCount = 6;
+	const int MaxClippedVertices = 3 + ClipPlaneCount;
+
+	// Four pixels of a quad held across the lanes of one register per component
+	struct QuadVector
+	{
+		__m128 X;
+		__m128 Y;
+		__m128 Z;
+		__m128 W;
+	};
+
+	QuadVector Splat(XMFLOAT4 value)
+	{
+		QuadVector result = { _mm_set1_ps(value.x), _mm_set1_ps(value.y), _mm_set1_ps(value.z), _mm_set1_ps(value.w) };
+		return result;
+	}
+
+	QuadVector Multiply(const QuadVector& first, const QuadVector& second)
+	{
+		QuadVector result = { _mm_mul_ps(first.X, second.X), _mm_mul_ps(first.Y, second.Y), _mm_mul_ps(first.Z, second.Z), _mm_mul_ps(first.W, second.W) };
+		return result;
+	}
+
+	__m128 Saturate(__m128 value)
+	{
+		return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	}
+
+	__m128 Dot3(const QuadVector& first, const QuadVector& second)
+	{
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(first.X, second.X), _mm_mul_ps(first.Y, second.Y)), _mm_mul_ps(first.Z, second.Z));
+	}
+
+	QuadVector Normalize3(const QuadVector& vector)
+	{
+		__m128 length = _mm_sqrt_ps(Dot3(vector, vector));
+		QuadVector result = { _mm_div_ps(vector.X, length), _mm_div_ps(vector.Y, length), _mm_div_ps(vector.Z, length), vector.W };
+		return result;
+	}
+
+	__m128 Power(__m128 value, float exponent)
+	{
+		float lanes[4];
+		_mm_storeu_ps(lanes, value);
+
+		for (int lane = 0; lane < 4; lane++)
+			lanes[lane] = powf(lanes[lane], exponent);
+
+		return _mm_loadu_ps(lanes);
+	}
+
+	__m128 CoverageMask(int coverage)
+	{
+		__m128i laneBits = _mm_setr_epi32(1, 2, 4, 8);
+		return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(coverage), laneBits), laneBits));
+	}
+
+	__m128i Pack(const QuadVector& color)
+	{
+		__m128 scale = _mm_set1_ps(255.0f);
+		__m128 half = _mm_set1_ps(0.5f);
+
+		__m128i red = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(Saturate(color.X), scale), half));
+		__m128i green = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(Saturate(color.Y), scale), half));
+		__m128i blue = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(Saturate(color.Z), scale), half));
+		__m128i alpha = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(Saturate(color.W), scale), half));
+
+		return _mm_or_si128(_mm_or_si128(red, _mm_slli_epi32(green, 8)), _mm_or_si128(_mm_slli_epi32(blue, 16), _mm_slli_epi32(alpha, 24)));
+	}
+
+	unsigned int Pack(XMFLOAT4 color)
+	{
+		int packed[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(packed), Pack(Splat(color)));
+		return static_cast<unsigned int>(packed[0]);
+	}
+
+	// One level of detail for the whole quad, from the texture coordinate differences across it as the GPU takes
+	// them. Only the lanes that will be written are sampled.
+	QuadVector SampleQuad(const SoftwareTexture* texture, __m128 u, __m128 v, int active)
+	{
+		QuadVector result = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+		if (texture == nullptr)
+			return result;
+
+		float us[4];
+		float vs[4];
+		_mm_storeu_ps(us, u);
+		_mm_storeu_ps(vs, v);
+
+		float width = static_cast<float>(texture->GetWidth());
+		float height = static_cast<float>(texture->GetHeight());
+		float uAcross = (us[1] - us[0]) * width;
+		float vAcross = (vs[1] - vs[0]) * height;
+		float uDown = (us[2] - us[0]) * width;
+		float vDown = (vs[2] - vs[0]) * height;
+		float lod = 0.5f * log2f(max(uAcross * uAcross + vAcross * vAcross, uDown * uDown + vDown * vDown));
+
+		__m128 texels[4] = { result.X, result.X, result.X, result.X };
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if (active & (1 << lane))
+				texels[lane] = texture->Sample(us[lane], vs[lane], lod);
+		}
+
+		_MM_TRANSPOSE4_PS(texels[0], texels[1], texels[2], texels[3]);
+		result.X = texels[0];
+		result.Y = texels[1];
+		result.Z = texels[2];
+		result.W = texels[3];
+
+		return result;
+	}
+
+	QuadVector TextureColor(const SoftwareDrawState& state, __m128 u, __m128 v, int active)
+	{
+		QuadVector color = SampleQuad(state.Textures[0], u, v, active);
+
+		__m128 two = _mm_set1_ps(2.0f);
+		for (int i = 1; i < state.TextureCount; i++)
+		{
+			QuadVector texture = SampleQuad(state.Textures[i], u, v, active);
+			QuadVector doubled = { _mm_mul_ps(texture.X, two), _mm_mul_ps(texture.Y, two), _mm_mul_ps(texture.Z, two), _mm_mul_ps(texture.W, two) };
+			color = Multiply(color, doubled);
+		}
+
+		if (state.LightMapEnabled)
+			color = Multiply(color, SampleQuad(state.LightMap, u, v, active));
+
+		return color;
+	}
+
+	// DefaultPixelShader. The ambient and diffuse light it works out are overwritten by the material colour
+	// before they are used, so only the specular term is computed.
+	QuadVector ShadeDefault(const SoftwareDrawState& state, const __m128* varyings, int active, __m128& keep)
+	{
+		__m128 specular = _mm_setzero_ps();
+		if (state.LightEnabled)
+		{
+			QuadVector normal = { varyings[VARYING_NORMAL_X], varyings[VARYING_NORMAL_Y], varyings[VARYING_NORMAL_Z], _mm_setzero_ps() };
+			QuadVector view = { varyings[VARYING_VIEW_X], varyings[VARYING_VIEW_Y], varyings[VARYING_VIEW_Z], _mm_setzero_ps() };
+			QuadVector lightDirection = Splat(XMFLOAT4(-state.LightDirection.x, -state.LightDirection.y, -state.LightDirection.z, 0.0f));
+
+			__m128 intensity;
+			if (state.BumpMapEnabled)
+			{
+				QuadVector bump = SampleQuad(state.BumpMap, varyings[VARYING_TEXTURE_U], varyings[VARYING_TEXTURE_V], active);
+				__m128 one = _mm_set1_ps(1.0f);
+				__m128 bumpX = _mm_sub_ps(_mm_add_ps(bump.X, bump.X), one);
+				__m128 bumpY = _mm_sub_ps(_mm_add_ps(bump.Y, bump.Y), one);
+				__m128 bumpZ = _mm_sub_ps(_mm_add_ps(bump.Z, bump.Z), one);
+
+				QuadVector bumpNormal;
+				bumpNormal.X = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bumpX, varyings[VARYING_TANGENT_X]), _mm_mul_ps(bumpY, varyings[VARYING_BINORMAL_X])), _mm_mul_ps(bumpZ, normal.X));
+				bumpNormal.Y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bumpX, varyings[VARYING_TANGENT_Y]), _mm_mul_ps(bumpY, varyings[VARYING_BINORMAL_Y])), _mm_mul_ps(bumpZ, normal.Y));
+				bumpNormal.Z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bumpX, varyings[VARYING_TANGENT_Z]), _mm_mul_ps(bumpY, varyings[VARYING_BINORMAL_Z])), _mm_mul_ps(bumpZ, normal.Z));
+				bumpNormal.W = _mm_setzero_ps();
+
+				intensity = Saturate(Dot3(Normalize3(bumpNormal), lightDirection));
+			}
+			else
+				intensity = Saturate(Dot3(normal, lightDirection));
+
+			__m128 twiceIntensity = _mm_add_ps(intensity, intensity);
+			QuadVector reflection = { _mm_sub_ps(_mm_mul_ps(twiceIntensity, normal.X), lightDirection.X), _mm_sub_ps(_mm_mul_ps(twiceIntensity, normal.Y), lightDirection.Y),
+				_mm_sub_ps(_mm_mul_ps(twiceIntensity, normal.Z), lightDirection.Z), _mm_setzero_ps() };
+
+			__m128 highlight = Power(Saturate(Dot3(Normalize3(reflection), view)), state.SpecularPower);
+			specular = _mm_and_ps(_mm_cmpgt_ps(intensity, _mm_setzero_ps()), highlight);
+		}
+
+		bool colorInitialised = false;
+		QuadVector color = Splat(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+
+		if (state.TextureCount > 0)
+		{
+			color = TextureColor(state, varyings[VARYING_TEXTURE_U], varyings[VARYING_TEXTURE_V], active);
+			keep = _mm_and_ps(keep, _mm_cmpge_ps(color.W, _mm_set1_ps(0.25f)));
+			colorInitialised = true;
+		}
+
+		if (state.ColorEnabled)
+		{
+			color = colorInitialised ? Multiply(color, Splat(state.Color)) : Splat(state.Color);
+			colorInitialised = true;
+		}
+
+		if (state.Gradient.Enabled)
+		{
+			__m128 height = _mm_add_ps(_mm_div_ps(_mm_mul_ps(varyings[VARYING_OBJECT_Y], _mm_set1_ps(1000.0f)), _mm_set1_ps(state.Gradient.Height)), _mm_set1_ps(0.5f));
+			height = _mm_max_ps(height, _mm_setzero_ps());
+
+			QuadVector center = Splat(state.Gradient.CenterColor);
+			QuadVector apex = Splat(state.Gradient.ApexColor);
+			QuadVector gradient = { _mm_add_ps(center.X, _mm_mul_ps(_mm_sub_ps(apex.X, center.X), height)), _mm_add_ps(center.Y, _mm_mul_ps(_mm_sub_ps(apex.Y, center.Y), height)),
+				_mm_add_ps(center.Z, _mm_mul_ps(_mm_sub_ps(apex.Z, center.Z), height)), _mm_add_ps(center.W, _mm_mul_ps(_mm_sub_ps(apex.W, center.W), height)) };
+
+			color = colorInitialised ? Multiply(color, gradient) : gradient;
+		}
+
+		color.X = Saturate(_mm_add_ps(color.X, specular));
+		color.Y = Saturate(_mm_add_ps(color.Y, specular));
+		color.Z = Saturate(_mm_add_ps(color.Z, specular));
+		color.W = Saturate(_mm_add_ps(color.W, specular));
+
+		return color;
+	}
+
+	// FontPixelShader. An overridden colour replaces near white texels and drops the rest.
+	QuadVector ShadeFont(const SoftwareDrawState& state, const __m128* varyings, int active, __m128& keep)
+	{
+		QuadVector color = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+		if (state.TextureCount > 0)
+			color = TextureColor(state, varyings[VARYING_TEXTURE_U], varyings[VARYING_TEXTURE_V], active);
+
+		if (state.ColorEnabled)
+		{
+			__m128 white = _mm_set1_ps(0.9f);
+			keep = _mm_and_ps(keep, _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(color.X, white), _mm_cmpge_ps(color.Y, white)), _mm_cmpge_ps(color.Z, white)));
+			color = Splat(state.Color);
+		}
+
+		return color;
+	}
+
+	// Signed distance of a clip space position inside each clip plane: near, far, then the guard band
+	float ClipDistance(const XMFLOAT4& position, int plane, float guardBandX, float guardBandY)
+	{
+		switch (plane)
+		{
+		case 0:
+			return position.z;
+		case 1:
+			return position.w - position.z;
+		case 2:
+			return guardBandX * position.w + position.x;
+		case 3:
+			return guardBandX * position.w - position.x;
+		case 4:
+			return guardBandY * position.w + position.y;
+		default:
+			return guardBandY * position.w - position.y;
+		}
+	}
+
+	int ClipOutcode(const XMFLOAT4& position, float guardBandX, float guardBandY)
+	{
+		int outcode = 0;
+		for (int plane = 0; plane < ClipPlaneCount; plane++)
+		{
+			if (ClipDistance(position, plane, guardBandX, guardBandY) < 0.0f)
+				outcode |= 1 << plane;
+		}
+
+		return outcode;
+	}
+
+	ShadedVertex Interpolate(const ShadedVertex& first, const ShadedVertex& second, float amount)
+	{
+		ShadedVertex result;
+		result.Position.x = first.Position.x + (second.Position.x - first.Position.x) * amount;
+		result.Position.y = first.Position.y + (second.Position.y - first.Position.y) * amount;
+		result.Position.z = first.Position.z + (second.Position.z - first.Position.z) * amount;
+		result.Position.w = first.Position.w + (second.Position.w - first.Position.w) * amount;
+
+		for (int i = 0; i < VARYING_COUNT; i++)
+			result.Varyings[i] = first.Varyings[i] + (second.Varyings[i] - first.Varyings[i]) * amount;
+
+		return result;
+	}
+
+	bool IsTopLeft(int a, int b)
+	{
+		return a > 0 || (a == 0 && b > 0);
+	}
+}
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height) : _width(width), _height(height), _pitch((width + 1) & ~1), _rows((height + 1) & ~1), _clearColor(0)
+{
+	_tilesX = (_pitch + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+	_tilesY = (_rows + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+	_guardBandX = 1.0f + 2.0f * GuardBandPixels / width;
+	_guardBandY = 1.0f + 2.0f * GuardBandPixels / height;
+
+	_colorBuffer.resize(_pitch * _rows);
+	_depthBuffer.resize(_pitch * _rows);
+	_bins.resize(_tilesX * _tilesY);
+}
+
+SoftwareRasterizer::~SoftwareRasterizer()
+{
+}
+
+// The buffers themselves are cleared tile by tile when the tiles are rasterized
+void SoftwareRasterizer::Clear(XMFLOAT4 clearColor)
+{
+	_clearColor = Pack(clearColor);
+	_states.clear();
+	_triangles.clear();
+
+	for (vector<int>& bin : _bins)
+		bin.clear();
+}
+
+int SoftwareRasterizer::AddState(const SoftwareDrawState& state)
+{
+	_states.push_back(state);
+	return static_cast<int>(_states.size()) - 1;
+}
+
+// Only triangles crossing a clip plane are clipped. The near and far planes clip depth as the GPU does, the guard
+// band planes only keep coordinates in range.
+void SoftwareRasterizer::AddTriangle(const ShadedVertex& first, const ShadedVertex& second, const ShadedVertex& third, int state)
+{
+	int firstOutcode = ClipOutcode(first.Position, _guardBandX, _guardBandY);
+	int secondOutcode = ClipOutcode(second.Position, _guardBandX, _guardBandY);
+	int thirdOutcode = ClipOutcode(third.Position, _guardBandX, _guardBandY);
+
+	if ((firstOutcode & secondOutcode & thirdOutcode) != 0)
+		return;
+
+	int crossed = firstOutcode | secondOutcode | thirdOutcode;
+	if (crossed == 0)
+	{
+		AddClippedTriangle(first, second, third, state);
+		return;
+	}
+
+	ShadedVertex polygon[MaxClippedVertices] = { first, second, third };
+	ShadedVertex clipped[MaxClippedVertices];
+	int count = 3;
+
+	for (int plane = 0; plane < ClipPlaneCount && count >= 3; plane++)
+	{
+		if ((crossed & (1 << plane)) == 0)
+			continue;
+
+		int clippedCount = 0;
+		for (int i = 0; i < count; i++)
+		{
+			const ShadedVertex& current = polygon[i];
+			const ShadedVertex& next = polygon[(i + 1) % count];
+			float currentDistance = ClipDistance(current.Position, plane, _guardBandX, _guardBandY);
+			float nextDistance = ClipDistance(next.Position, plane, _guardBandX, _guardBandY);
+
+			if (currentDistance >= 0.0f)
+				clipped[clippedCount++] = current;
+
+			if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+				clipped[clippedCount++] = Interpolate(current, next, currentDistance / (currentDistance - nextDistance));
+		}
+
+		count = clippedCount;
+		for (int i = 0; i < count; i++)
+			polygon[i] = clipped[i];
+	}
+
+	for (int i = 1; i + 1 < count; i++)
+		AddClippedTriangle(polygon[0], polygon[i], polygon[i + 1], state);
+}
+
+// Faces wound clockwise on screen are front faces. Back faces that survive culling are turned around, so every
+// triangle set up has a positive area and is inside where all three edge functions are.
+void SoftwareRasterizer::AddClippedTriangle(const ShadedVertex& first, const ShadedVertex& second, const ShadedVertex& third, int state)
+{
+	const SoftwareDrawState& drawState = _states[state];
+	const ShadedVertex* vertices[3] = { &first, &second, &third };
+
+	RasterTriangle triangle;
+	float inverseW[3];
+
+	for (int i = 0; i < 3; i++)
+	{
+		const XMFLOAT4& position = vertices[i]->Position;
+		inverseW[i] = 1.0f / position.w;
+
+		float screenX = (position.x * inverseW[i] + 1.0f) * 0.5f * _width;
+		float screenY = (1.0f - position.y * inverseW[i]) * 0.5f * _height;
+		triangle.X[i] = static_cast<int>(floorf(screenX * SubpixelScale + 0.5f));
+		triangle.Y[i] = static_cast<int>(floorf(screenY * SubpixelScale + 0.5f));
+	}
+
+	long long area = static_cast<long long>(triangle.X[1] - triangle.X[0]) * (triangle.Y[2] - triangle.Y[0]) - static_cast<long long>(triangle.X[2] - triangle.X[0]) * (triangle.Y[1] - triangle.Y[0]);
+	if (area == 0)
+		return;
+
+	bool frontFacing = area > 0;
+	if ((drawState.CullMode == SOFTWARE_CULL_BACK && !frontFacing) || (drawState.CullMode == SOFTWARE_CULL_FRONT && frontFacing))
+		return;
+
+	if (!frontFacing)
+	{
+		swap(vertices[1], vertices[2]);
+		swap(inverseW[1], inverseW[2]);
+		swap(triangle.X[1], triangle.X[2]);
+		swap(triangle.Y[1], triangle.Y[2]);
+		area = -area;
+	}
+
+	triangle.Area = area;
+	triangle.State = state;
+	triangle.VaryingCount = drawState.Shader == SHADER_FONT ? VARYING_TEXTURE_V + 1 : VARYING_COUNT;
+
+	// Depth and the reciprocal of w vary linearly on screen, the rest only once divided by w
+	float depth[3];
+	for (int i = 0; i < 3; i++)
+		depth[i] = vertices[i]->Position.z * inverseW[i];
+
+	triangle.Depth[0] = depth[0];
+	triangle.Depth[1] = depth[1] - depth[0];
+	triangle.Depth[2] = depth[2] - depth[0];
+	triangle.InverseW[0] = inverseW[0];
+	triangle.InverseW[1] = inverseW[1] - inverseW[0];
+	triangle.InverseW[2] = inverseW[2] - inverseW[0];
+
+	for (int varying = 0; varying < triangle.VaryingCount; varying++)
+	{
+		float origin = vertices[0]->Varyings[varying] * inverseW[0];
+		triangle.Varyings[varying][0] = origin;
+		triangle.Varyings[varying][1] = vertices[1]->Varyings[varying] * inverseW[1] - origin;
+		triangle.Varyings[varying][2] = vertices[2]->Varyings[varying] * inverseW[2] - origin;
+	}
+
+	// Every pixel the triangle or its outline can touch, so wireframes can share the bounds
+	triangle.MinX = max(0, min(triangle.X[0], min(triangle.X[1], triangle.X[2])) >> SubpixelBits);
+	triangle.MinY = max(0, min(triangle.Y[0], min(triangle.Y[1], triangle.Y[2])) >> SubpixelBits);
+	triangle.MaxX = min(_width - 1, max(triangle.X[0], max(triangle.X[1], triangle.X[2])) >> SubpixelBits);
+	triangle.MaxY = min(_height - 1, max(triangle.Y[0], max(triangle.Y[1], triangle.Y[2])) >> SubpixelBits);
+
+	if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+		return;
+
+	_triangles.push_back(triangle);
+	Bin(static_cast<int>(_triangles.size()) - 1);
+}
+
+// Solid triangles skip the tiles of their bounds that lie wholly outside one of their edges
+void SoftwareRasterizer::Bin(int index)
+{
+	const RasterTriangle& triangle = _triangles[index];
+	bool solid = _states[triangle.State].Wireframe == false;
+
+	for (int tileY = triangle.MinY / SOFTWARE_TILE_SIZE; tileY <= triangle.MaxY / SOFTWARE_TILE_SIZE; tileY++)
+	{
+		for (int tileX = triangle.MinX / SOFTWARE_TILE_SIZE; tileX <= triangle.MaxX / SOFTWARE_TILE_SIZE; tileX++)
+		{
+			bool outside = false;
+			for (int edge = 0; edge < 3 && solid && !outside; edge++)
+			{
+				int from = (edge + 1) % 3;
+				int to = (edge + 2) % 3;
+				int a = triangle.Y[from] - triangle.Y[to];
+				int b = triangle.X[to] - triangle.X[from];
+
+				int left = max(tileX * SOFTWARE_TILE_SIZE, triangle.MinX);
+				int top = max(tileY * SOFTWARE_TILE_SIZE, triangle.MinY);
+				int right = min(tileX * SOFTWARE_TILE_SIZE + SOFTWARE_TILE_SIZE - 1, triangle.MaxX);
+				int bottom = min(tileY * SOFTWARE_TILE_SIZE + SOFTWARE_TILE_SIZE - 1, triangle.MaxY);
+
+				long long x = static_cast<long long>(a > 0 ? right : left) * SubpixelScale + SubpixelHalf - triangle.X[from];
+				long long y = static_cast<long long>(b > 0 ? bottom : top) * SubpixelScale + SubpixelHalf - triangle.Y[from];
+				outside = a * x + b * y + (IsTopLeft(a, b) ? 1 : 0) <= 0;
+			}
+
+			if (!outside)
+				_bins[tileY * _tilesX + tileX].push_back(index);
+		}
+	}
+}
+
+int SoftwareRasterizer::GetTileCount() const
+{
+	return _tilesX * _tilesY;
+}
+
+// Touches nothing outside its own tile, so separate tiles can be rasterized at the same time
+void SoftwareRasterizer::RasterizeTile(int tile)
+{
+	int tileX = (tile % _tilesX) * SOFTWARE_TILE_SIZE;
+	int tileY = (tile / _tilesX) * SOFTWARE_TILE_SIZE;
+	int tileRight = min(tileX + SOFTWARE_TILE_SIZE, _pitch);
+	int tileBottom = min(tileY + SOFTWARE_TILE_SIZE, _rows);
+
+	for (int y = tileY; y < tileBottom; y++)
+	{
+		fill(_colorBuffer.begin() + y * _pitch + tileX, _colorBuffer.begin() + y * _pitch + tileRight, _clearColor);
+		fill(_depthBuffer.begin() + y * _pitch + tileX, _depthBuffer.begin() + y * _pitch + tileRight, 1.0f);
+	}
+
+	for (int index : _bins[tile])
+	{
+		const RasterTriangle& triangle = _triangles[index];
+		if (_states[triangle.State].Wireframe)
+			RasterizeWireframe(triangle, tileX, tileY, tileRight, tileBottom);
+		else
+			RasterizeSolid(triangle, tileX, tileY, tileRight, tileBottom);
+	}
+}
+
+// Walks the quads of the triangle's bounds within the tile. Each edge function is worked out exactly once at the
+// first quad and then only stepped, adding the top left bias up front so a pixel is covered when all three are
+// above zero.
+void SoftwareRasterizer::RasterizeSolid(const RasterTriangle& triangle, int tileX, int tileY, int tileRight, int tileBottom)
+{
+	int startX = max(triangle.MinX, tileX) & ~1;
+	int startY = max(triangle.MinY, tileY) & ~1;
+	int endX = min(triangle.MaxX, tileRight - 1);
+	int endY = min(triangle.MaxY, tileBottom - 1);
+
+	__m128i rowEdges[3];
+	__m128i quadStepX[3];
+	__m128i quadStepY[3];
+
+	for (int edge = 0; edge < 3; edge++)
+	{
+		int from = (edge + 1) % 3;
+		int to = (edge + 2) % 3;
+		int a = triangle.Y[from] - triangle.Y[to];
+		int b = triangle.X[to] - triangle.X[from];
+
+		long long x = static_cast<long long>(startX) * SubpixelScale + SubpixelHalf - triangle.X[from];
+		long long y = static_cast<long long>(startY) * SubpixelScale + SubpixelHalf - triangle.Y[from];
+		long long origin = max(-EdgeLimit, min(EdgeLimit, a * x + b * y + (IsTopLeft(a, b) ? 1 : 0)));
+
+		int stepX = a * SubpixelScale;
+		int stepY = b * SubpixelScale;
+		rowEdges[edge] = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(origin)), _mm_setr_epi32(0, stepX, stepY, stepX + stepY));
+		quadStepX[edge] = _mm_set1_epi32(stepX * 2);
+		quadStepY[edge] = _mm_set1_epi32(stepY * 2);
+	}
+
+	__m128i zero = _mm_setzero_si128();
+	for (int y = startY; y <= endY; y += 2)
+	{
+		__m128i edges[3] = { rowEdges[0], rowEdges[1], rowEdges[2] };
+
+		for (int x = startX; x <= endX; x += 2)
+		{
+			__m128i inside = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(edges[0], zero), _mm_cmpgt_epi32(edges[1], zero)), _mm_cmpgt_epi32(edges[2], zero));
+			int coverage = _mm_movemask_ps(_mm_castsi128_ps(inside));
+			if (coverage != 0)
+				ShadeQuad(triangle, x, y, coverage);
+
+			for (int edge = 0; edge < 3; edge++)
+				edges[edge] = _mm_add_epi32(edges[edge], quadStepX[edge]);
+		}
+
+		for (int edge = 0; edge < 3; edge++)
+			rowEdges[edge] = _mm_add_epi32(rowEdges[edge], quadStepY[edge]);
+	}
+}
+
+// Steps each edge one pixel at a time along its longer axis, taking the pixel whose centre column or row it
+// crosses. Each edge leaves out its last pixel, which the next edge starts from.
+void SoftwareRasterizer::RasterizeWireframe(const RasterTriangle& triangle, int tileX, int tileY, int tileRight, int tileBottom)
+{
+	int right = min(tileRight, _width);
+	int bottom = min(tileBottom, _height);
+
+	for (int edge = 0; edge < 3; edge++)
+	{
+		int next = (edge + 1) % 3;
+		float startX = static_cast<float>(triangle.X[edge]) / SubpixelScale;
+		float startY = static_cast<float>(triangle.Y[edge]) / SubpixelScale;
+		float endX = static_cast<float>(triangle.X[next]) / SubpixelScale;
+		float endY = static_cast<float>(triangle.Y[next]) / SubpixelScale;
+
+		bool alongX = fabsf(endX - startX) >= fabsf(endY - startY);
+		if (!alongX)
+		{
+			swap(startX, startY);
+			swap(endX, endY);
+		}
+
+		if (startX == endX)
+			continue;
+
+		float slope = (endY - startY) / (endX - startX);
+		int first = static_cast<int>(ceilf(min(startX, endX) - 0.5f));
+		int last = static_cast<int>(ceilf(max(startX, endX) - 0.5f)) - 1;
+
+		first = max(first, alongX ? tileX : tileY);
+		last = min(last, (alongX ? right : bottom) - 1);
+
+		for (int major = first; major <= last; major++)
+		{
+			int minor = static_cast<int>(floorf(startY + (major + 0.5f - startX) * slope));
+			int x = alongX ? major : minor;
+			int y = alongX ? minor : major;
+
+			if (x < tileX || x >= right || y < tileY || y >= bottom)
+				continue;
+
+			ShadeQuad(triangle, x & ~1, y & ~1, 1 << ((x & 1) + 2 * (y & 1)));
+		}
+	}
+}
+
+// Interpolates at all four pixels of the quad even when only some are covered, so the texture derivatives are
+// there for every lane. Only covered lanes that pass the depth test and are not discarded are written.
+void SoftwareRasterizer::ShadeQuad(const RasterTriangle& triangle, int x, int y, int coverage)
+{
+	const SoftwareDrawState& state = _states[triangle.State];
+	double inverseArea = 1.0 / static_cast<double>(triangle.Area);
+
+	__m128 barycentrics[3];
+	for (int edge = 1; edge < 3; edge++)
+	{
+		int from = (edge + 1) % 3;
+		int to = (edge + 2) % 3;
+		double a = static_cast<double>(triangle.Y[from] - triangle.Y[to]) * inverseArea;
+		double b = static_cast<double>(triangle.X[to] - triangle.X[from]) * inverseArea;
+
+		double origin = a * (static_cast<double>(x) * SubpixelScale + SubpixelHalf - triangle.X[from]) + b * (static_cast<double>(y) * SubpixelScale + SubpixelHalf - triangle.Y[from]);
+		float stepX = static_cast<float>(a * SubpixelScale);
+		float stepY = static_cast<float>(b * SubpixelScale);
+		barycentrics[edge] = _mm_add_ps(_mm_set1_ps(static_cast<float>(origin)), _mm_setr_ps(0.0f, stepX, stepY, stepX + stepY));
+	}
+
+	float* depthRow = &_depthBuffer[y * _pitch + x];
+	__m128 storedDepth = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(depthRow)), reinterpret_cast<const __m64*>(depthRow + _pitch));
+	__m128 depth = _mm_add_ps(_mm_set1_ps(triangle.Depth[0]), _mm_add_ps(_mm_mul_ps(barycentrics[1], _mm_set1_ps(triangle.Depth[1])), _mm_mul_ps(barycentrics[2], _mm_set1_ps(triangle.Depth[2]))));
+
+	__m128 keep = CoverageMask(coverage);
+	if (state.DepthEnabled)
+		keep = _mm_and_ps(keep, _mm_cmplt_ps(depth, storedDepth));
+
+	int active = _mm_movemask_ps(keep);
+	if (active == 0)
+		return;
+
+	__m128 inverseW = _mm_add_ps(_mm_set1_ps(triangle.InverseW[0]), _mm_add_ps(_mm_mul_ps(barycentrics[1], _mm_set1_ps(triangle.InverseW[1])), _mm_mul_ps(barycentrics[2], _mm_set1_ps(triangle.InverseW[2]))));
+	__m128 w = _mm_div_ps(_mm_set1_ps(1.0f), inverseW);
+
+	__m128 varyings[VARYING_COUNT];
+	for (int varying = 0; varying < triangle.VaryingCount; varying++)
+	{
+		const float* plane = triangle.Varyings[varying];
+		__m128 value = _mm_add_ps(_mm_set1_ps(plane[0]), _mm_add_ps(_mm_mul_ps(barycentrics[1], _mm_set1_ps(plane[1])), _mm_mul_ps(barycentrics[2], _mm_set1_ps(plane[2]))));
+		varyings[varying] = _mm_mul_ps(value, w);
+	}
+
+	QuadVector color = state.Shader == SHADER_FONT ? ShadeFont(state, varyings, active, keep) : ShadeDefault(state, varyings, active, keep);
+	if (_mm_movemask_ps(keep) == 0)
+		return;
+
+	__m128i write = _mm_castps_si128(keep);
+	unsigned int* colorRow = &_colorBuffer[y * _pitch + x];
+	__m128i storedColor = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(colorRow)), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(colorRow + _pitch)));
+	__m128i blended = _mm_or_si128(_mm_and_si128(write, Pack(color)), _mm_andnot_si128(write, storedColor));
+
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(colorRow), blended);
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(colorRow + _pitch), _mm_unpackhi_epi64(blended, blended));
+
+	if (state.DepthEnabled)
+	{
+		__m128 blendedDepth = _mm_or_ps(_mm_and_ps(keep, depth), _mm_andnot_ps(keep, storedDepth));
+		_mm_storel_pi(reinterpret_cast<__m64*>(depthRow), blendedDepth);
+		_mm_storeh_pi(reinterpret_cast<__m64*>(depthRow + _pitch), blendedDepth);
+	}
+}
+
+int SoftwareRasterizer::GetWidth() const
+{
+	return _width;
+}
+
+int SoftwareRasterizer::GetHeight() const
+{
+	return _height;
+}
+
+int SoftwareRasterizer::GetTriangleCount() const
+{
+	return static_cast<int>(_triangles.size());
+}
+
+unsigned int SoftwareRasterizer::GetPixel(int x, int y) const
+{
+	return _colorBuffer[y * _pitch + x];
+}
\ No newline at end of file
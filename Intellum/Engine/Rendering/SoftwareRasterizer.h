@@ -0,0 +1,146 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+#include "SoftwareTexture.h"
+#include "../ShaderEngine/ShaderTypes.h"
+#include "../ShaderEngine/ShaderParameters/GradientShaderParameters.h"
+#include "../../Common/Constants.h"
+
+using namespace DirectX;
+using namespace std;
+
+// What the vertex shaders hand on to the pixel shaders, in the order the rasterizer interpolates it. The font
+// shader only reads the texture coordinates, so only those are interpolated for its triangles.
+enum SoftwareVarying
+{
+	VARYING_TEXTURE_U,
+	VARYING_TEXTURE_V,
+	VARYING_NORMAL_X,
+	VARYING_NORMAL_Y,
+	VARYING_NORMAL_Z,
+	VARYING_VIEW_X,
+	VARYING_VIEW_Y,
+	VARYING_VIEW_Z,
+	VARYING_TANGENT_X,
+	VARYING_TANGENT_Y,
+	VARYING_TANGENT_Z,
+	VARYING_BINORMAL_X,
+	VARYING_BINORMAL_Y,
+	VARYING_BINORMAL_Z,
+	VARYING_OBJECT_Y,
+	VARYING_COUNT
+};
+
+// The rasterizer state a draw was made with. Kept apart from the Direct3D enums so the rasterizer itself only needs
+// DirectXMath, the device translates when it captures a draw.
+enum SoftwareCullMode
+{
+	SOFTWARE_CULL_NONE,
+	SOFTWARE_CULL_FRONT,
+	SOFTWARE_CULL_BACK
+};
+
+struct ShadedVertex
+{
+	XMFLOAT4 Position;
+	float Varyings[VARYING_COUNT];
+};
+
+// Everything the pixel shaders read for one draw, or one instance of an instanced draw, captured when it is
+// submitted so the tiles can be shaded after later draws have changed the bound state
+struct SoftwareDrawState
+{
+	ShaderType Shader;
+	bool Wireframe;
+	SoftwareCullMode CullMode;
+	bool DepthEnabled;
+
+	const SoftwareTexture* Textures[MAX_SHADER_TEXTURES];
+	int TextureCount;
+	const SoftwareTexture* LightMap;
+	const SoftwareTexture* BumpMap;
+	bool LightMapEnabled;
+	bool BumpMapEnabled;
+
+	bool LightEnabled;
+	XMFLOAT3 LightDirection;
+	float SpecularPower;
+
+	bool ColorEnabled;
+	XMFLOAT4 Color;
+	GradientShaderParameters Gradient;
+};
+
+// Draws triangles into a colour and depth buffer on the CPU. Triangles are clipped, set up and sorted into
+// SOFTWARE_TILE_SIZE square tiles as they are added, and each tile is then rasterized on its own, so separate
+// tiles can be drawn at the same time from different threads. Within a tile triangles are drawn in the order they
+// were added.
+//
+// Vertices are snapped to a sixteenth of a pixel and coverage is decided on integer edge functions with the top
+// left rule, so triangles sharing an edge never both draw or both miss a pixel along it. Pixels are rasterized and
+// shaded four at a time as two by two quads in SSE registers, which also gives the texture derivatives that mip
+// selection needs. Depth is tested less than and written on pass. Nothing is blended.
+//
+// The pixel shaders follow DefaultPixelShader and FontPixelShader line for line, quirks included: only the
+// specular term of the light reaches the final colour, and the font shader drops everything but near white texels
+// when its colour is overridden.
+class SoftwareRasterizer
+{
+private:
+	struct RasterTriangle
+	{
+		int X[3];
+		int Y[3];
+		long long Area;
+		float Depth[3];
+		float InverseW[3];
+		float Varyings[VARYING_COUNT][3];
+		int VaryingCount;
+		int MinX;
+		int MinY;
+		int MaxX;
+		int MaxY;
+		int State;
+	};
+
+	int _width;
+	int _height;
+	int _pitch;
+	int _rows;
+	int _tilesX;
+	int _tilesY;
+	float _guardBandX;
+	float _guardBandY;
+
+	vector<unsigned int> _colorBuffer;
+	vector<float> _depthBuffer;
+	unsigned int _clearColor;
+
+	vector<SoftwareDrawState> _states;
+	vector<RasterTriangle> _triangles;
+	vector<vector<int>> _bins;
+
+	void AddClippedTriangle(const ShadedVertex& first, const ShadedVertex& second, const ShadedVertex& third, int state);
+	void Bin(int triangle);
+
+	void RasterizeSolid(const RasterTriangle& triangle, int tileX, int tileY, int tileRight, int tileBottom);
+	void RasterizeWireframe(const RasterTriangle& triangle, int tileX, int tileY, int tileRight, int tileBottom);
+	void ShadeQuad(const RasterTriangle& triangle, int x, int y, int coverage);
+
+public:
+	SoftwareRasterizer(int width, int height);
+	~SoftwareRasterizer();
+
+	void Clear(XMFLOAT4 clearColor);
+
+	int AddState(const SoftwareDrawState& state);
+	void AddTriangle(const ShadedVertex& first, const ShadedVertex& second, const ShadedVertex& third, int state);
+
+	int GetTileCount() const;
+	void RasterizeTile(int tile);
+
+	int GetWidth() const;
+	int GetHeight() const;
+	int GetTriangleCount() const;
+	unsigned int GetPixel(int x, int y) const;
+};
\ No newline at end of file
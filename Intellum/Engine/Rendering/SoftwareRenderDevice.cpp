@@ -0,0 +1,493 @@
+#include "SoftwareRenderDevice.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "../../Loaders/TargaLoader.h"
+
+namespace
+{
+	// Sizes of the constant blocks of the default shader, which the ui shader shares, and of the font shader
+	const int DefaultFrameConstantSize = 224;
+	const int FontFrameConstantSize = 144;
+	const int MaterialConstantSize = 16;
+	const int DefaultObjectConstantSize = 144;
+	const int FontObjectConstantSize = 96;
+
+	// Byte offsets into a vertex as the input layouts read them
+	const int PositionOffset = 0;
+	const int TextureOffset = 12;
+	const int NormalOffset = 20;
+	const int TangentOffset = 32;
+	const int BinormalOffset = 44;
+}
+
+SoftwareRenderDevice::SoftwareRenderDevice(Box screenSize, WorkerPool* workerPool) : _workerPool(workerPool), _camera(nullptr), _light(nullptr),
+	_boundPipelineState(NO_PIPELINE_STATE), _textures(), _lightMap(nullptr), _bumpMap(nullptr), _vertexBuffer(nullptr), _indexBuffer(nullptr), _vertexStride(0), _vertexOffset(0),
+	_nextTile(0), _pendingHelpers(0)
+{
+	_rasterizer = new SoftwareRasterizer(static_cast<int>(screenSize.Width), static_cast<int>(screenSize.Height));
+
+	float fieldOfView = XM_PI / 4.0f;
+	float screenAspect = screenSize.Width / screenSize.Height;
+
+	_worldMatrix = XMMatrixIdentity();
+	_projectionMatrix = XMMatrixPerspectiveFovLH(fieldOfView, screenAspect, SCREEN_NEAR, SCREEN_DEPTH);
+	_orthoMatrix = XMMatrixOrthographicLH(screenSize.Width, screenSize.Height, SCREEN_NEAR, SCREEN_DEPTH);
+}
+
+SoftwareRenderDevice::~SoftwareRenderDevice()
+{
+}
+
+void SoftwareRenderDevice::Initialise(Camera* camera, Light* light)
+{
+	_camera = camera;
+	_light = light;
+}
+
+void SoftwareRenderDevice::Shutdown()
+{
+	if (_rasterizer)
+	{
+		delete _rasterizer;
+		_rasterizer = nullptr;
+	}
+
+	_pipelineStates.clear();
+	_pipelineLookup.clear();
+	_boundPipelineState = NO_PIPELINE_STATE;
+}
+
+void SoftwareRenderDevice::BeginFrame(XMFLOAT4 clearColor)
+{
+	_rasterizer->Clear(clearColor);
+}
+
+// The calling thread rasterizes tiles alongside the workers rather than waiting idle, so a frame still ends when
+// every worker is busy with something else
+void SoftwareRenderDevice::EndFrame()
+{
+	int tileCount = _rasterizer->GetTileCount();
+	int helpers = _workerPool ? min(_workerPool->GetWorkerCount(), tileCount - 1) : 0;
+
+	_nextTile = 0;
+	_pendingHelpers = helpers;
+
+	for (int i = 0; i < helpers; i++)
+	{
+		_workerPool->Submit([this]()
+		{
+			RasterizeTiles();
+
+			lock_guard<mutex> lock(_tileLock);
+			_pendingHelpers--;
+			_tilesFinished.notify_all();
+		});
+	}
+
+	RasterizeTiles();
+
+	unique_lock<mutex> lock(_tileLock);
+	while (_pendingHelpers > 0)
+		_tilesFinished.wait(lock);
+}
+
+void SoftwareRenderDevice::RasterizeTiles()
+{
+	int tileCount = _rasterizer->GetTileCount();
+	for (int tile = _nextTile++; tile < tileCount; tile = _nextTile++)
+		_rasterizer->RasterizeTile(tile);
+}
+
+XMMATRIX SoftwareRenderDevice::GetWorldMatrix() const
+{
+	return _worldMatrix;
+}
+
+XMMATRIX SoftwareRenderDevice::GetProjectionMatrix() const
+{
+	return _projectionMatrix;
+}
+
+XMMATRIX SoftwareRenderDevice::GetOrthoMatrix() const
+{
+	return _orthoMatrix;
+}
+
+ID3D11Buffer* SoftwareRenderDevice::CreateBuffer(BufferType type, const void* data, int size, bool dynamic)
+{
+	if (size <= 0) throw Exception(type == BUFFER_INDEX ? "Failed to create the index buffer." : "Failed to create the vertex buffer.");
+
+	SoftwareBuffer* buffer = new SoftwareBuffer();
+	buffer->Data.resize(size);
+	buffer->Dynamic = dynamic;
+
+	if (data)
+		memcpy(buffer->Data.data(), data, size);
+
+	return reinterpret_cast<ID3D11Buffer*>(buffer);
+}
+
+void SoftwareRenderDevice::WriteBuffer(ID3D11Buffer* buffer, const void* data, int size)
+{
+	SoftwareBuffer* softwareBuffer = reinterpret_cast<SoftwareBuffer*>(buffer);
+	if (!softwareBuffer->Dynamic || size > static_cast<int>(softwareBuffer->Data.size())) throw Exception("Failed to map vertex buffer to the Device Context");
+
+	memcpy(softwareBuffer->Data.data(), data, size);
+}
+
+void SoftwareRenderDevice::ReleaseBuffer(ID3D11Buffer* buffer)
+{
+	SoftwareBuffer* softwareBuffer = reinterpret_cast<SoftwareBuffer*>(buffer);
+	if (softwareBuffer == nullptr)
+		return;
+
+	if (_vertexBuffer == softwareBuffer)
+		_vertexBuffer = nullptr;
+
+	if (_indexBuffer == softwareBuffer)
+		_indexBuffer = nullptr;
+
+	delete softwareBuffer;
+}
+
+ID3D11ShaderResourceView* SoftwareRenderDevice::CreateTexture(const TargaData& targaData)
+{
+	if (targaData.ImageSize.Width <= 0 || targaData.ImageSize.Height <= 0) throw Exception("Failed to create texture description");
+
+	return reinterpret_cast<ID3D11ShaderResourceView*>(new SoftwareTexture(targaData));
+}
+
+void SoftwareRenderDevice::ReleaseTexture(ID3D11ShaderResourceView* texture)
+{
+	SoftwareTexture* softwareTexture = reinterpret_cast<SoftwareTexture*>(texture);
+	if (softwareTexture == nullptr)
+		return;
+
+	for (int i = 0; i < MAX_SHADER_TEXTURES; i++)
+	{
+		if (_textures[i] == softwareTexture)
+			_textures[i] = nullptr;
+	}
+
+	if (_lightMap == softwareTexture)
+		_lightMap = nullptr;
+
+	if (_bumpMap == softwareTexture)
+		_bumpMap = nullptr;
+
+	delete softwareTexture;
+}
+
+// The font shader is the only one without an instanced vertex shader
+bool SoftwareRenderDevice::SupportsInstancing(ShaderType shader) const
+{
+	return shader != SHADER_FONT;
+}
+
+int SoftwareRenderDevice::GetConstantSize(ShaderType shader, ConstantFrequency frequency) const
+{
+	switch (frequency)
+	{
+	case CONSTANTS_PER_FRAME:
+		return shader == SHADER_FONT ? FontFrameConstantSize : DefaultFrameConstantSize;
+	case CONSTANTS_PER_MATERIAL:
+		return MaterialConstantSize;
+	case CONSTANTS_PER_OBJECT:
+		return shader == SHADER_FONT ? FontObjectConstantSize : DefaultObjectConstantSize;
+	default:
+		return 0;
+	}
+}
+
+PipelineStateHandle SoftwareRenderDevice::GetPipelineState(const PipelineStateDesc& desc)
+{
+	if (desc.Instanced && !SupportsInstancing(desc.Shader))
+		throw Exception("Cannot create an instanced pipeline state for a shader without an instanced variant");
+
+	unordered_map<unsigned long long, PipelineStateHandle>::const_iterator existing = _pipelineLookup.find(desc.GetKey());
+	if (existing != _pipelineLookup.end())
+		return existing->second;
+
+	PipelineStateHandle handle = static_cast<PipelineStateHandle>(_pipelineStates.size());
+	_pipelineStates.push_back(desc);
+	_pipelineLookup[desc.GetKey()] = handle;
+
+	return handle;
+}
+
+int SoftwareRenderDevice::GetPipelineStateCount() const
+{
+	return static_cast<int>(_pipelineStates.size());
+}
+
+void SoftwareRenderDevice::SetPipelineState(PipelineStateHandle pipelineState)
+{
+	if (pipelineState < 0 || pipelineState >= static_cast<int>(_pipelineStates.size()))
+		throw Exception("Tried to bind a pipeline state this device did not create");
+
+	_boundPipelineState = pipelineState;
+}
+
+// Binds the slots the bound shader would, leaving the others as they were
+void SoftwareRenderDevice::SetTextures(const TextureShaderParameters& textures)
+{
+	if (_boundPipelineState == NO_PIPELINE_STATE)
+		throw Exception("Tried to bind textures before a pipeline state");
+
+	for (int i = 0; i < textures.TextureCount; i++)
+		_textures[i] = reinterpret_cast<const SoftwareTexture*>(textures.TextureArray[i]);
+
+	if (_pipelineStates[_boundPipelineState].Shader == SHADER_FONT)
+	{
+		if (textures.LightMap != nullptr)
+			_lightMap = reinterpret_cast<const SoftwareTexture*>(textures.LightMap);
+
+		return;
+	}
+
+	if (textures.LightMapEnabled)
+		_lightMap = reinterpret_cast<const SoftwareTexture*>(textures.LightMap);
+
+	if (textures.BumpMapEnabled)
+		_bumpMap = reinterpret_cast<const SoftwareTexture*>(textures.BumpMap);
+}
+
+void SoftwareRenderDevice::SetMesh(const Geometry& mesh)
+{
+	_vertexBuffer = reinterpret_cast<const SoftwareBuffer*>(mesh.VertexBuffer);
+	_indexBuffer = reinterpret_cast<const SoftwareBuffer*>(mesh.IndexBuffer);
+	_vertexStride = static_cast<int>(mesh.VBStride);
+	_vertexOffset = static_cast<int>(mesh.VBOffset);
+}
+
+// Object constants come with every draw, so only the frame and material ones are kept. As in the light buffer,
+// the light is only written while it is enabled.
+void SoftwareRenderDevice::SetConstants(ShaderType shader, ConstantFrequency frequency, const ShaderResources& resources)
+{
+	if (frequency == CONSTANTS_PER_FRAME)
+	{
+		FrameConstants& frame = _frameConstants[shader];
+		frame.View = resources.MatrixParameters.ViewMatrix;
+		frame.Projection = resources.MatrixParameters.ProjectionMatrix;
+		frame.CameraPosition = _camera->GetTransform()->GetPosition();
+		frame.LightEnabled = shader != SHADER_FONT && resources.LightEnabled;
+
+		if (frame.LightEnabled)
+		{
+			frame.LightDirection = _light->GetDirection(XMMatrixIdentity());
+			frame.SpecularPower = _light->SpecularPower;
+		}
+	}
+	else if (frequency == CONSTANTS_PER_MATERIAL)
+	{
+		MaterialConstants& material = _materialConstants[shader];
+		material.TextureCount = resources.TextureParameters.TextureCount;
+		material.LightMapEnabled = resources.TextureParameters.LightMapEnabled;
+		material.BumpMapEnabled = shader != SHADER_FONT && resources.TextureParameters.BumpMapEnabled;
+	}
+}
+
+int SoftwareRenderDevice::BuildState(ShaderType shader, const ColorShaderParameters& color, const GradientShaderParameters& gradient)
+{
+	if (_boundPipelineState == NO_PIPELINE_STATE)
+		throw Exception("Tried to draw before a pipeline state was bound");
+
+	const PipelineStateDesc& pipeline = _pipelineStates[_boundPipelineState];
+	const FrameConstants& frame = _frameConstants[shader];
+	const MaterialConstants& material = _materialConstants[shader];
+
+	SoftwareDrawState state;
+	state.Shader = shader;
+	state.Wireframe = pipeline.FillMode == D3D11_FILL_WIREFRAME;
+	state.CullMode = pipeline.CullMode == D3D11_CULL_BACK ? SOFTWARE_CULL_BACK : pipeline.CullMode == D3D11_CULL_FRONT ? SOFTWARE_CULL_FRONT : SOFTWARE_CULL_NONE;
+	state.DepthEnabled = pipeline.DepthEnabled;
+
+	for (int i = 0; i < MAX_SHADER_TEXTURES; i++)
+		state.Textures[i] = _textures[i];
+
+	state.TextureCount = material.TextureCount;
+	state.LightMap = _lightMap;
+	state.BumpMap = _bumpMap;
+	state.LightMapEnabled = material.LightMapEnabled;
+	state.BumpMapEnabled = material.BumpMapEnabled;
+
+	state.LightEnabled = frame.LightEnabled;
+	state.LightDirection = frame.LightDirection;
+	state.SpecularPower = frame.SpecularPower;
+
+	state.ColorEnabled = color.Enabled;
+	state.Color = color.Color;
+	state.Gradient = shader == SHADER_FONT ? GradientShaderParameters() : gradient;
+
+	return _rasterizer->AddState(state);
+}
+
+void SoftwareRenderDevice::Draw(ShaderType shader, const ShaderResources& resources, int indexCount)
+{
+	int state = BuildState(shader, resources.ColorParameters, resources.GradientParameters);
+	DrawMesh(shader, resources.MatrixParameters.WorldMatrix, indexCount, state);
+}
+
+// Each instance gets a state of its own for its color, taken over the shared one as the instanced vertex shader does
+void SoftwareRenderDevice::DrawInstanced(ShaderType shader, const ShaderResources& resources, int indexCount, const InstanceData* instances, int instanceCount)
+{
+	for (int i = 0; i < instanceCount; i++)
+	{
+		ColorShaderParameters color = resources.ColorParameters;
+		if (instances[i].ColorEnabled != 0.0f)
+			color = ColorShaderParameters(instances[i].Color);
+
+		int state = BuildState(shader, color, resources.GradientParameters);
+		DrawMesh(shader, XMLoadFloat4x4(&instances[i].World), indexCount, state);
+	}
+}
+
+// Shades every vertex in the buffer once, then hands the indexed triangles on to the rasterizer. Triangles using a
+// vertex beyond the end of the buffer are left out.
+void SoftwareRenderDevice::DrawMesh(ShaderType shader, const XMMATRIX& world, int indexCount, int state)
+{
+	if (_vertexBuffer == nullptr || _indexBuffer == nullptr || _vertexStride <= 0)
+		return;
+
+	const FrameConstants& frame = _frameConstants[shader];
+	XMMATRIX worldViewProjection = XMMatrixMultiply(XMMatrixMultiply(world, frame.View), frame.Projection);
+
+	int vertexCount = (static_cast<int>(_vertexBuffer->Data.size()) - _vertexOffset) / _vertexStride;
+	if (vertexCount <= 0)
+		return;
+
+	_shadedVertices.resize(vertexCount);
+	for (int vertex = 0; vertex < vertexCount; vertex++)
+		ShadeVertex(shader, world, worldViewProjection, frame.CameraPosition, vertex, _shadedVertices[vertex]);
+
+	const unsigned short* indices = reinterpret_cast<const unsigned short*>(_indexBuffer->Data.data());
+	int count = min(indexCount, static_cast<int>(_indexBuffer->Data.size() / sizeof(unsigned short)));
+
+	for (int i = 0; i + 2 < count; i += 3)
+	{
+		if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount)
+			continue;
+
+		_rasterizer->AddTriangle(_shadedVertices[indices[i]], _shadedVertices[indices[i + 1]], _shadedVertices[indices[i + 2]], state);
+	}
+}
+
+// DefaultVertexShader, or FontVertexShader for the font shader, which only passes on the texture coordinates
+void SoftwareRenderDevice::ShadeVertex(ShaderType shader, const XMMATRIX& world, const XMMATRIX& worldViewProjection, const XMFLOAT3& cameraPosition, int vertex, ShadedVertex& shaded) const
+{
+	int offset = _vertexOffset + vertex * _vertexStride;
+
+	float position[3];
+	ReadFloats(offset + PositionOffset, 3, position);
+	ReadFloats(offset + TextureOffset, 2, &shaded.Varyings[VARYING_TEXTURE_U]);
+
+	XMVECTOR local = XMVectorSet(position[0], position[1], position[2], 1.0f);
+	XMStoreFloat4(&shaded.Position, XMVector4Transform(local, worldViewProjection));
+
+	if (shader == SHADER_FONT)
+		return;
+
+	float normal[3];
+	float tangent[3];
+	float binormal[3];
+	ReadFloats(offset + NormalOffset, 3, normal);
+	ReadFloats(offset + TangentOffset, 3, tangent);
+	ReadFloats(offset + BinormalOffset, 3, binormal);
+
+	XMFLOAT3 worldNormal;
+	XMFLOAT3 worldTangent;
+	XMFLOAT3 worldBinormal;
+	XMFLOAT3 viewDirection;
+	XMStoreFloat3(&worldNormal, XMVector3Normalize(XMVector3TransformNormal(XMVectorSet(normal[0], normal[1], normal[2], 0.0f), world)));
+	XMStoreFloat3(&worldTangent, XMVector3Normalize(XMVector3TransformNormal(XMVectorSet(tangent[0], tangent[1], tangent[2], 0.0f), world)));
+	XMStoreFloat3(&worldBinormal, XMVector3Normalize(XMVector3TransformNormal(XMVectorSet(binormal[0], binormal[1], binormal[2], 0.0f), world)));
+	XMStoreFloat3(&viewDirection, XMVector3Normalize(XMVectorSubtract(XMLoadFloat3(&cameraPosition), XMVector4Transform(local, world))));
+
+	shaded.Varyings[VARYING_NORMAL_X] = worldNormal.x;
+	shaded.Varyings[VARYING_NORMAL_Y] = worldNormal.y;
+	shaded.Varyings[VARYING_NORMAL_Z] = worldNormal.z;
+	shaded.Varyings[VARYING_VIEW_X] = viewDirection.x;
+	shaded.Varyings[VARYING_VIEW_Y] = viewDirection.y;
+	shaded.Varyings[VARYING_VIEW_Z] = viewDirection.z;
+	shaded.Varyings[VARYING_TANGENT_X] = worldTangent.x;
+	shaded.Varyings[VARYING_TANGENT_Y] = worldTangent.y;
+	shaded.Varyings[VARYING_TANGENT_Z] = worldTangent.z;
+	shaded.Varyings[VARYING_BINORMAL_X] = worldBinormal.x;
+	shaded.Varyings[VARYING_BINORMAL_Y] = worldBinormal.y;
+	shaded.Varyings[VARYING_BINORMAL_Z] = worldBinormal.z;
+	shaded.Varyings[VARYING_OBJECT_Y] = position[1];
+}
+
+void SoftwareRenderDevice::ReadFloats(int offset, int count, float* values) const
+{
+	if (offset + count * static_cast<int>(sizeof(float)) > static_cast<int>(_vertexBuffer->Data.size()))
+	{
+		for (int i = 0; i < count; i++)
+			values[i] = 0.0f;
+
+		return;
+	}
+
+	memcpy(values, &_vertexBuffer->Data[offset], count * sizeof(float));
+}
+
+int SoftwareRenderDevice::GetTriangleCount() const
+{
+	return _rasterizer->GetTriangleCount();
+}
+
+void SoftwareRenderDevice::WriteFrame(char* filename) const
+{
+	int width = _rasterizer->GetWidth();
+	int height = _rasterizer->GetHeight();
+
+	TargaData frame;
+	frame.ImageSize = Box(static_cast<float>(width), static_cast<float>(height));
+	frame.ImageData = new unsigned char[width * height * 4];
+
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			unsigned int pixel = _rasterizer->GetPixel(x, y);
+			memcpy(&frame.ImageData[(y * width + x) * 4], &pixel, sizeof(pixel));
+		}
+	}
+
+	TargaLoader::SaveTarga(filename, frame);
+
+	delete[] frame.ImageData;
+	frame.ImageData = nullptr;
+}
+
+// Counts the pixels of the last frame with a channel further than the tolerance from the reference
+int SoftwareRenderDevice::CompareFrame(const TargaData& reference, int tolerance) const
+{
+	int width = _rasterizer->GetWidth();
+	int height = _rasterizer->GetHeight();
+
+	if (static_cast<int>(reference.ImageSize.Width) != width || static_cast<int>(reference.ImageSize.Height) != height)
+		throw Exception("The reference frame is not the size of the screen");
+
+	int differences = 0;
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			unsigned int pixel = _rasterizer->GetPixel(x, y);
+			const unsigned char* expected = &reference.ImageData[(y * width + x) * 4];
+
+			for (int channel = 0; channel < 4; channel++)
+			{
+				if (abs(static_cast<int>((pixel >> (channel * 8)) & 0xFF) - expected[channel]) > tolerance)
+				{
+					differences++;
+					break;
+				}
+			}
+		}
+	}
+
+	return differences;
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "IRenderDevice.h"
+#include "SoftwareRasterizer.h"
+#include "../Camera/Camera.h"
+#include "../Graphics/Light.h"
+#include "../Threading/WorkerPool.h"
+#include "../../Common/Box.h"
+
+using namespace std;
+
+// Draws frames on the CPU, for machines without a GPU and as a reference to hold frames from the GPU against.
+// It follows the Direct3D 11 device call for call: the vertex shaders run on each draw, constants are kept per
+// shader, textures are bound to slots every shader shares, and the pixel shaders are those of the HLSL files.
+// Triangles are only rasterized when the frame ends, with the tiles shared out between the worker pool and the
+// thread ending the frame. The camera and light are built on the device, so they are handed over in Initialise,
+// before the first frame.
+//
+// Buffers and textures are plain memory behind their handles. The default shader's input layout reads the tangent
+// and binormal past the end of a Vertex, out of the one after it, and so does this device, reading zeros past the
+// end of the buffer as the GPU does.
+//
+// The rasterizer and its textures only need DirectXMath, but this device implements IRenderDevice, whose handles
+// are still the Direct3D 11 types, so it only builds where d3d11.h does and is only reached through the benchmark.
+class SoftwareRenderDevice : public IRenderDevice
+{
+private:
+	struct SoftwareBuffer
+	{
+		vector<unsigned char> Data;
+		bool Dynamic;
+	};
+
+	struct FrameConstants
+	{
+		XMMATRIX View;
+		XMMATRIX Projection;
+		XMFLOAT3 CameraPosition;
+		bool LightEnabled;
+		XMFLOAT3 LightDirection;
+		float SpecularPower;
+	};
+
+	struct MaterialConstants
+	{
+		int TextureCount;
+		bool LightMapEnabled;
+		bool BumpMapEnabled;
+	};
+
+	SoftwareRasterizer* _rasterizer;
+	WorkerPool* _workerPool;
+	Camera* _camera;
+	Light* _light;
+
+	XMMATRIX _worldMatrix;
+	XMMATRIX _projectionMatrix;
+	XMMATRIX _orthoMatrix;
+
+	vector<PipelineStateDesc> _pipelineStates;
+	unordered_map<unsigned long long, PipelineStateHandle> _pipelineLookup;
+	PipelineStateHandle _boundPipelineState;
+
+	map<ShaderType, FrameConstants> _frameConstants;
+	map<ShaderType, MaterialConstants> _materialConstants;
+	const SoftwareTexture* _textures[MAX_SHADER_TEXTURES];
+	const SoftwareTexture* _lightMap;
+	const SoftwareTexture* _bumpMap;
+
+	const SoftwareBuffer* _vertexBuffer;
+	const SoftwareBuffer* _indexBuffer;
+	int _vertexStride;
+	int _vertexOffset;
+	vector<ShadedVertex> _shadedVertices;
+
+	atomic<int> _nextTile;
+	mutex _tileLock;
+	condition_variable _tilesFinished;
+	int _pendingHelpers;
+
+	int BuildState(ShaderType shader, const ColorShaderParameters& color, const GradientShaderParameters& gradient);
+	void DrawMesh(ShaderType shader, const XMMATRIX& world, int indexCount, int state);
+	void ShadeVertex(ShaderType shader, const XMMATRIX& world, const XMMATRIX& worldViewProjection, const XMFLOAT3& cameraPosition, int vertex, ShadedVertex& shaded) const;
+	void ReadFloats(int offset, int count, float* values) const;
+	void RasterizeTiles();
+
+public:
+	SoftwareRenderDevice(Box screenSize, WorkerPool* workerPool);
+	~SoftwareRenderDevice() override;
+
+	void Initialise(Camera* camera, Light* light);
+
+	void Shutdown() override;
+
+	void BeginFrame(XMFLOAT4 clearColor) override;
+	void EndFrame() override;
+
+	XMMATRIX GetWorldMatrix() const override;
+	XMMATRIX GetProjectionMatrix() const override;
+	XMMATRIX GetOrthoMatrix() const override;
+
+	ID3D11Buffer* CreateBuffer(BufferType type, const void* data, int size, bool dynamic) override;
+	void WriteBuffer(ID3D11Buffer* buffer, const void* data, int size) override;
+	void ReleaseBuffer(ID3D11Buffer* buffer) override;
+
+	ID3D11ShaderResourceView* CreateTexture(const TargaData& targaData) override;
+	void ReleaseTexture(ID3D11ShaderResourceView* texture) override;
+
+	bool SupportsInstancing(ShaderType shader) const override;
+	int GetConstantSize(ShaderType shader, ConstantFrequency frequency) const override;
+
+	PipelineStateHandle GetPipelineState(const PipelineStateDesc& desc) override;
+	int GetPipelineStateCount() const override;
+
+	void SetPipelineState(PipelineStateHandle pipelineState) override;
+	void SetTextures(const TextureShaderParameters& textures) override;
+	void SetMesh(const Geometry& mesh) override;
+	void SetConstants(ShaderType shader, ConstantFrequency frequency, const ShaderResources& resources) override;
+
+	void Draw(ShaderType shader, const ShaderResources& resources, int indexCount) override;
+	void DrawInstanced(ShaderType shader, const ShaderResources& resources, int indexCount, const InstanceData* instances, int instanceCount) override;
+
+	int GetTriangleCount() const;
+	void WriteFrame(char* filename) const;
+	int CompareFrame(const TargaData& reference, int tolerance) const;
+};
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "SoftwareTexture.h"
+#include <cmath>
+#include <cstring>
+#include <emmintrin.h>
+
+namespace
+{
+	__m128 UnpackTexel(unsigned int texel)
+	{
+		__m128i zero = _mm_setzero_si128();
+		__m128i bytes = _mm_cvtsi32_si128(static_cast<int>(texel));
+		__m128i channels = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+
+		return _mm_mul_ps(_mm_cvtepi32_ps(channels), _mm_set1_ps(1.0f / 255.0f));
+	}
+
+	int Wrap(int coordinate, int size)
+	{
+		int wrapped = coordinate % size;
+		return wrapped < 0 ? wrapped + size : wrapped;
+	}
+}
+
+SoftwareTexture::SoftwareTexture(const TargaData& targaData)
+{
+	MipLevel level;
+	level.Width = static_cast<int>(targaData.ImageSize.Width);
+	level.Height = static_cast<int>(targaData.ImageSize.Height);
+	level.Texels.resize(level.Width * level.Height);
+	memcpy(level.Texels.data(), targaData.ImageData, level.Texels.size() * sizeof(unsigned int));
+
+	_levels.push_back(level);
+	GenerateMips();
+}
+
+SoftwareTexture::~SoftwareTexture()
+{
+}
+
+// Each texel of a level is the rounded average of a two by two block of the level above. Once a level is a
+// single texel wide or tall, pairs along the other side are averaged instead.
+void SoftwareTexture::GenerateMips()
+{
+	while (_levels.back().Width > 1 || _levels.back().Height > 1)
+	{
+		const MipLevel& source = _levels.back();
+
+		MipLevel level;
+		level.Width = source.Width > 1 ? source.Width / 2 : 1;
+		level.Height = source.Height > 1 ? source.Height / 2 : 1;
+		level.Texels.resize(level.Width * level.Height);
+
+		int stepX = source.Width > 1 ? 1 : 0;
+		int stepY = source.Height > 1 ? source.Width : 0;
+
+		for (int y = 0; y < level.Height; y++)
+		{
+			for (int x = 0; x < level.Width; x++)
+			{
+				const unsigned int* block = &source.Texels[y * 2 * source.Width + x * 2];
+				unsigned int texel = 0;
+
+				for (int channel = 0; channel < 32; channel += 8)
+				{
+					unsigned int sum = ((block[0] >> channel) & 0xFF) + ((block[stepX] >> channel) & 0xFF) + ((block[stepY] >> channel) & 0xFF) + ((block[stepX + stepY] >> channel) & 0xFF);
+					texel |= ((sum + 2) / 4) << channel;
+				}
+
+				level.Texels[y * level.Width + x] = texel;
+			}
+		}
+
+		_levels.push_back(level);
+	}
+}
+
+int SoftwareTexture::GetWidth() const
+{
+	return _levels[0].Width;
+}
+
+int SoftwareTexture::GetHeight() const
+{
+	return _levels[0].Height;
+}
+
+int SoftwareTexture::GetLevelCount() const
+{
+	return static_cast<int>(_levels.size());
+}
+
+// Texel centres sit half a texel in, so a coordinate on a centre reads that texel alone
+__m128 SoftwareTexture::SampleLevel(const MipLevel& level, float u, float v) const
+{
+	float x = u * level.Width - 0.5f;
+	float y = v * level.Height - 0.5f;
+	float left = floorf(x);
+	float top = floorf(y);
+
+	__m128 weightX = _mm_set1_ps(x - left);
+	__m128 weightY = _mm_set1_ps(y - top);
+
+	int x0 = Wrap(static_cast<int>(left), level.Width);
+	int x1 = Wrap(x0 + 1, level.Width);
+	const unsigned int* row0 = &level.Texels[Wrap(static_cast<int>(top), level.Height) * level.Width];
+	const unsigned int* row1 = &level.Texels[Wrap(static_cast<int>(top) + 1, level.Height) * level.Width];
+
+	__m128 topTexel = UnpackTexel(row0[x0]);
+	__m128 bottomTexel = UnpackTexel(row1[x0]);
+	topTexel = _mm_add_ps(topTexel, _mm_mul_ps(_mm_sub_ps(UnpackTexel(row0[x1]), topTexel), weightX));
+	bottomTexel = _mm_add_ps(bottomTexel, _mm_mul_ps(_mm_sub_ps(UnpackTexel(row1[x1]), bottomTexel), weightX));
+
+	return _mm_add_ps(topTexel, _mm_mul_ps(_mm_sub_ps(bottomTexel, topTexel), weightY));
+}
+
+__m128 SoftwareTexture::Sample(float u, float v, float lod) const
+{
+	float lastLevel = static_cast<float>(_levels.size() - 1);
+	if (!(lod > 0.0f))
+		return SampleLevel(_levels[0], u, v);
+
+	if (lod >= lastLevel)
+		return SampleLevel(_levels.back(), u, v);
+
+	int level = static_cast<int>(lod);
+	__m128 detailed = SampleLevel(_levels[level], u, v);
+	__m128 coarse = SampleLevel(_levels[level + 1], u, v);
+
+	return _mm_add_ps(detailed, _mm_mul_ps(_mm_sub_ps(coarse, detailed), _mm_set1_ps(lod - level)));
+}
\ No newline at end of file
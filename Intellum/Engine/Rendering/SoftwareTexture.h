@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+#include <xmmintrin.h>
+#include "../../Loaders/models/TargaData.h"
+
+using namespace std;
+
+// A texture sampled on the CPU the way the engine's samplers sample on the GPU: trilinear filtering with wrapped
+// coordinates. The full mip chain is built on creation with a box filter, as GenerateMips does for the GPU copy.
+class SoftwareTexture
+{
+private:
+	struct MipLevel
+	{
+		int Width;
+		int Height;
+		vector<unsigned int> Texels;
+	};
+
+	vector<MipLevel> _levels;
+
+	void GenerateMips();
+	__m128 SampleLevel(const MipLevel& level, float u, float v) const;
+
+public:
+	SoftwareTexture(const TargaData& targaData);
+	~SoftwareTexture();
+
+	int GetWidth() const;
+	int GetHeight() const;
+	int GetLevelCount() const;
+
+	__m128 Sample(float u, float v, float lod) const;
+};
\ No newline at end of file
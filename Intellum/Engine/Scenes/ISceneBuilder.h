@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include "SceneEntity.h"
+
+using namespace std;
+
+// Receives a scene one asset and one entity at a time, whether it is being compiled to a blob or created
+// straight into an EntityManager. Asset ids are only meaningful to the builder that returned them.
+class ISceneBuilder
+{
+public:
+	virtual ~ISceneBuilder() {}
+
+	virtual unsigned int AddModel(const string& path) = 0;
+	virtual unsigned int AddCube() = 0;
+	virtual unsigned int AddUIQuad() = 0;
+	virtual unsigned int AddGrid(float width, float height, float columns, float rows) = 0;
+	virtual unsigned int AddTexture(const string& path) = 0;
+
+	virtual void AddEntity(const SceneEntity& entity) = 0;
+};
\ No newline at end of file
@@ -0,0 +1,493 @@
+#include "JSONSceneHandler.h"
+#include <cstring>
+#include "../Input/Controls.h"
+#include "../../ErrorHandling/Exception.h"
+
+namespace
+{
+	// Each table is in the order of the enum it names
+	const char* const ShaderNames[] = { "default", "font", "ui" };
+	const char* const CullingNames[] = { "point", "rectangle", "sphere", "square" };
+	const char* const CommandNames[] = { "none", "exitApplication", "toggleVisible", "toggleTransform" };
+	const char* const ObservableNames[] = { "input", "framesPerSecond", "cpu", "renderCount", "constantBytes" };
+	const char* const CollisionNames[] = { "cursor" };
+	const char* const SimulationNames[] = { "active", "sleeping", "static" };
+	const char* const ControlNames[] = { "escape", "cameraMoveLeft", "cameraMoveRight", "cameraMoveForward", "cameraMoveBackward", "cameraLookLeft", "cameraLookRight", "cameraLookUp", "cameraLookDown", "leftClick", "toggleRasterizerState" };
+
+	// D3D11_FILL_MODE and D3D11_CULL_MODE values, which start at 2 and 1
+	const char* const FillNames[] = { "wireframe", "solid" };
+	const int FirstFillMode = 2;
+	const char* const CullNames[] = { "none", "front", "back" };
+	const int FirstCullMode = 1;
+}
+
+JSONSceneHandler::JSONSceneHandler(ISceneBuilder* builder) : _builder(builder), _entityCount(0)
+{
+	_frames.reserve(8);
+}
+
+JSONSceneHandler::~JSONSceneHandler()
+{
+}
+
+int JSONSceneHandler::GetEntityCount() const
+{
+	return _entityCount;
+}
+
+void JSONSceneHandler::Push(SceneParseState state)
+{
+	ParseFrame frame;
+	frame.State = state;
+	frame.Numbers = nullptr;
+	frame.NumberCount = 0;
+	frame.NumberIndex = 0;
+	_frames.push_back(frame);
+}
+
+void JSONSceneHandler::PushNumbers(float* numbers, int count)
+{
+	Push(PARSE_NUMBERS);
+	_frames.back().Numbers = numbers;
+	_frames.back().NumberCount = count;
+}
+
+bool JSONSceneHandler::IsKey(const char* name) const
+{
+	return _key == name;
+}
+
+void JSONSceneHandler::Unexpected(const char* value) const
+{
+	if (_frames.empty())
+		throw Exception("A scene must be a JSON object.");
+
+	throw Exception(string("Unexpected ") + value + " for property '" + _key + "'.");
+}
+
+int JSONSceneHandler::FindName(const char* text, size_t length, const char* const* names, int nameCount, const char* description)
+{
+	for (int i = 0; i < nameCount; i++)
+	{
+		if (strlen(names[i]) == length && memcmp(names[i], text, length) == 0)
+			return i;
+	}
+
+	throw Exception("Unknown " + string(description) + " '" + string(text, length) + "'.");
+}
+
+unsigned int JSONSceneHandler::ParseCommand(const char* text, size_t length)
+{
+	return FindName(text, length, CommandNames, 4, "command");
+}
+
+unsigned int JSONSceneHandler::FindAsset(const char* text, size_t length)
+{
+	_lookup.assign(text, length);
+
+	map<string, unsigned int>::iterator iterator = _assetIds.find(_lookup);
+	if (iterator == _assetIds.end())
+		throw Exception("Unknown asset '" + _lookup + "'. Assets must be declared before the entities that use them.");
+
+	return iterator->second;
+}
+
+void JSONSceneHandler::AddAsset()
+{
+	if (_assetIds.find(_assetName) != _assetIds.end())
+		throw Exception("Asset '" + _assetName + "' is declared more than once.");
+
+	bool needsPath = _assetType == "model" || _assetType == "texture";
+	if (needsPath && _assetPath.empty())
+		throw Exception("Asset '" + _assetName + "' needs a path.");
+
+	unsigned int id;
+	if (_assetType == "model")
+		id = _builder->AddModel(_assetPath);
+	else if (_assetType == "texture")
+		id = _builder->AddTexture(_assetPath);
+	else if (_assetType == "cube")
+		id = _builder->AddCube();
+	else if (_assetType == "ui")
+		id = _builder->AddUIQuad();
+	else if (_assetType == "grid")
+		id = _builder->AddGrid(_assetParameters[0], _assetParameters[1], _assetParameters[2], _assetParameters[3]);
+	else
+		throw Exception("Asset '" + _assetName + "' has unknown type '" + _assetType + "'.");
+
+	_assetIds[_assetName] = id;
+}
+
+void JSONSceneHandler::StartObject()
+{
+	if (_frames.empty())
+	{
+		Push(PARSE_ROOT);
+		return;
+	}
+
+	switch (_frames.back().State)
+	{
+	case PARSE_ROOT:
+		if (IsKey("assets") == false)
+			Unexpected("object");
+
+		Push(PARSE_ASSETS);
+		return;
+	case PARSE_ASSETS:
+		_assetName = _key;
+		_assetType.clear();
+		_assetPath.clear();
+		memset(_assetParameters, 0, sizeof(_assetParameters));
+		Push(PARSE_ASSET);
+		return;
+	case PARSE_ENTITIES:
+		_entity.Clear();
+		Push(PARSE_ENTITY);
+		return;
+	case PARSE_ENTITY:
+		if (IsKey("appearance"))
+		{
+			_entity.Mask |= MaskOf(APPEARANCE);
+			Push(PARSE_APPEARANCE);
+		}
+		else if (IsKey("transform"))
+		{
+			_entity.Mask |= MaskOf(TRANSFORM);
+			Push(PARSE_TRANSFORM);
+		}
+		else if (IsKey("rasterizer"))
+		{
+			_entity.Mask |= MaskOf(RASTERIZER);
+			Push(PARSE_RASTERIZER);
+		}
+		else if (IsKey("ui"))
+		{
+			_entity.Mask |= MaskOf(USER_INTERFACE);
+			Push(PARSE_USER_INTERFACE);
+		}
+		else if (IsKey("text"))
+		{
+			_entity.Mask |= MaskOf(TEXT);
+			Push(PARSE_TEXT);
+		}
+		else if (IsKey("button"))
+		{
+			_entity.Mask |= MaskOf(BUTTON);
+			Push(PARSE_BUTTON);
+		}
+		else if (IsKey("collision"))
+		{
+			_entity.Mask |= MaskOf(COLLISION);
+			Push(PARSE_COLLISION);
+		}
+		else
+			Unexpected("object");
+		return;
+	case PARSE_APPEARANCE:
+		if (IsKey("gradient") == false)
+			Unexpected("object");
+
+		_entity.Appearance.GradientEnabled = 1;
+		Push(PARSE_GRADIENT);
+		return;
+	case PARSE_BINDINGS:
+		_binding.Control = ESCAPE;
+		_binding.Command = SCENE_COMMAND_NONE;
+		_binding.Cooldown = 0.0f;
+		Push(PARSE_BINDING);
+		return;
+	case PARSE_OBSERVERS:
+		_observer.Observable = SCENE_OBSERVE_INPUT;
+		_observer.Component = TEXT;
+		Push(PARSE_OBSERVER);
+		return;
+	default:
+		Unexpected("object");
+	}
+}
+
+void JSONSceneHandler::EndObject()
+{
+	switch (_frames.back().State)
+	{
+	case PARSE_ASSET:
+		AddAsset();
+		break;
+	case PARSE_ENTITY:
+		_builder->AddEntity(_entity);
+		_entityCount++;
+		break;
+	case PARSE_BINDING:
+		_entity.Bindings.push_back(_binding);
+		break;
+	case PARSE_OBSERVER:
+		_entity.Observers.push_back(_observer);
+		break;
+	default:
+		break;
+	}
+
+	_frames.pop_back();
+}
+
+void JSONSceneHandler::StartArray()
+{
+	if (_frames.empty())
+		Unexpected("array");
+
+	switch (_frames.back().State)
+	{
+	case PARSE_ROOT:
+		if (IsKey("entities") == false)
+			Unexpected("array");
+
+		Push(PARSE_ENTITIES);
+		return;
+	case PARSE_ENTITY:
+		if (IsKey("input"))
+		{
+			_entity.Mask |= MaskOf(INPUT_COMPONENT);
+			Push(PARSE_BINDINGS);
+		}
+		else if (IsKey("observe"))
+			Push(PARSE_OBSERVERS);
+		else
+			Unexpected("array");
+		return;
+	case PARSE_APPEARANCE:
+		if (IsKey("textures"))
+		{
+			Push(PARSE_TEXTURES);
+		}
+		else if (IsKey("color"))
+		{
+			_entity.Appearance.ColorEnabled = 1;
+			PushNumbers(_entity.Appearance.Color, 4);
+		}
+		else
+			Unexpected("array");
+		return;
+	case PARSE_GRADIENT:
+		if (IsKey("apex"))
+			PushNumbers(_entity.Appearance.ApexColor, 4);
+		else if (IsKey("center"))
+			PushNumbers(_entity.Appearance.CenterColor, 4);
+		else
+			Unexpected("array");
+		return;
+	case PARSE_TRANSFORM:
+		if (IsKey("position"))
+			PushNumbers(_entity.Transform.Position, 3);
+		else if (IsKey("rotation"))
+			PushNumbers(_entity.Transform.Rotation, 3);
+		else if (IsKey("scale"))
+			PushNumbers(_entity.Transform.Scale, 3);
+		else if (IsKey("velocity"))
+			PushNumbers(_entity.Transform.Velocity, 3);
+		else if (IsKey("angularVelocity"))
+			PushNumbers(_entity.Transform.AngularVelocity, 3);
+		else
+			Unexpected("array");
+		return;
+	case PARSE_USER_INTERFACE:
+		if (IsKey("size") == false)
+			Unexpected("array");
+
+		PushNumbers(_entity.UserInterface.BitmapSize, 2);
+		return;
+	case PARSE_TEXT:
+		if (IsKey("position"))
+			PushNumbers(_entity.Text.FontPosition, 2);
+		else if (IsKey("color"))
+			PushNumbers(_entity.Text.Color, 4);
+		else
+			Unexpected("array");
+		return;
+	default:
+		Unexpected("array");
+	}
+}
+
+void JSONSceneHandler::EndArray()
+{
+	ParseFrame& frame = _frames.back();
+
+	if (frame.State == PARSE_NUMBERS && frame.NumberIndex != frame.NumberCount)
+		throw Exception("Property '" + _key + "' needs " + to_string(frame.NumberCount) + " numbers.");
+
+	_frames.pop_back();
+}
+
+void JSONSceneHandler::Key(const char* text, size_t length)
+{
+	_key.assign(text, length);
+}
+
+void JSONSceneHandler::String(const char* text, size_t length)
+{
+	if (_frames.empty())
+		Unexpected("string");
+
+	switch (_frames.back().State)
+	{
+	case PARSE_ASSET:
+		if (IsKey("type"))
+			_assetType.assign(text, length);
+		else if (IsKey("path"))
+			_assetPath.assign(text, length);
+		else
+			Unexpected("string");
+		return;
+	case PARSE_ENTITY:
+		if (IsKey("frustrumCulling") == false)
+			Unexpected("string");
+
+		_entity.Mask |= MaskOf(FRUSTRUM_CULLING);
+		_entity.FrustrumCulling.CullingType = FindName(text, length, CullingNames, 4, "culling type");
+		return;
+	case PARSE_APPEARANCE:
+		if (IsKey("shader"))
+			_entity.Appearance.ShaderType = FindName(text, length, ShaderNames, 3, "shader");
+		else if (IsKey("model"))
+			_entity.Appearance.Model = FindAsset(text, length);
+		else if (IsKey("lightMap"))
+			_entity.Appearance.LightMap = FindAsset(text, length);
+		else if (IsKey("bumpMap"))
+			_entity.Appearance.BumpMap = FindAsset(text, length);
+		else
+			Unexpected("string");
+		return;
+	case PARSE_TEXTURES:
+		_entity.Textures.push_back(FindAsset(text, length));
+		return;
+	case PARSE_TRANSFORM:
+		if (IsKey("simulation") == false)
+			Unexpected("string");
+
+		_entity.Transform.Simulation = FindName(text, length, SimulationNames, 3, "simulation state");
+		return;
+	case PARSE_RASTERIZER:
+		if (IsKey("fill"))
+			_entity.Rasterizer.FillMode = FirstFillMode + FindName(text, length, FillNames, 2, "fill mode");
+		else if (IsKey("cull"))
+			_entity.Rasterizer.CullMode = FirstCullMode + FindName(text, length, CullNames, 3, "cull mode");
+		else
+			Unexpected("string");
+		return;
+	case PARSE_TEXT:
+		if (IsKey("text") == false)
+			Unexpected("string");
+
+		_entity.TextString.assign(text, length);
+		return;
+	case PARSE_BUTTON:
+		if (IsKey("onClick") == false)
+			Unexpected("string");
+
+		_entity.Button.OnClickCommand = ParseCommand(text, length);
+		return;
+	case PARSE_COLLISION:
+		if (IsKey("type"))
+			_entity.Collision.CollisionType = FindName(text, length, CollisionNames, 1, "collision type");
+		else if (IsKey("onCollision"))
+			_entity.Collision.OnCollisionCommand = ParseCommand(text, length);
+		else
+			Unexpected("string");
+		return;
+	case PARSE_BINDING:
+		if (IsKey("control"))
+			_binding.Control = FindName(text, length, ControlNames, TOGGLE_RASTERIZER_STATE + 1, "control");
+		else if (IsKey("command"))
+			_binding.Command = ParseCommand(text, length);
+		else
+			Unexpected("string");
+		return;
+	case PARSE_OBSERVER:
+		if (IsKey("source"))
+		{
+			_observer.Observable = static_cast<SceneObservable>(FindName(text, length, ObservableNames, SCENE_OBSERVABLE_COUNT, "observable"));
+		}
+		else if (IsKey("component"))
+		{
+			static const char* const observerComponents[] = { "text", "transform" };
+			_observer.Component = FindName(text, length, observerComponents, 2, "observing component") == 0 ? TEXT : TRANSFORM;
+		}
+		else
+			Unexpected("string");
+		return;
+	default:
+		Unexpected("string");
+	}
+}
+
+void JSONSceneHandler::Number(double value)
+{
+	if (_frames.empty())
+		Unexpected("number");
+
+	ParseFrame& frame = _frames.back();
+	float number = static_cast<float>(value);
+
+	switch (frame.State)
+	{
+	case PARSE_NUMBERS:
+		if (frame.NumberIndex == frame.NumberCount)
+			throw Exception("Property '" + _key + "' needs " + to_string(frame.NumberCount) + " numbers.");
+
+		frame.Numbers[frame.NumberIndex++] = number;
+		return;
+	case PARSE_ASSET:
+		if (IsKey("width"))
+			_assetParameters[0] = number;
+		else if (IsKey("height"))
+			_assetParameters[1] = number;
+		else if (IsKey("columns"))
+			_assetParameters[2] = number;
+		else if (IsKey("rows"))
+			_assetParameters[3] = number;
+		else
+			Unexpected("number");
+		return;
+	case PARSE_GRADIENT:
+		if (IsKey("centerY"))
+			_entity.Appearance.CenterYCordinates = number;
+		else if (IsKey("height"))
+			_entity.Appearance.Height = number;
+		else
+			Unexpected("number");
+		return;
+	case PARSE_TEXT:
+		if (IsKey("size") == false)
+			Unexpected("number");
+
+		_entity.Text.FontSize = static_cast<int>(value);
+		return;
+	case PARSE_BINDING:
+		if (IsKey("cooldown") == false)
+			Unexpected("number");
+
+		_binding.Cooldown = number;
+		return;
+	default:
+		Unexpected("number");
+	}
+}
+
+void JSONSceneHandler::Boolean(bool value)
+{
+	if (_frames.empty())
+		Unexpected("boolean");
+
+	if (_frames.back().State == PARSE_APPEARANCE && IsKey("visible"))
+		_entity.Appearance.RenderEnabled = value ? 1 : 0;
+	else if (_frames.back().State == PARSE_TRANSFORM && IsKey("enabled"))
+		_entity.Transform.TransformEnabled = value ? 1 : 0;
+	else
+		Unexpected("boolean");
+}
+
+void JSONSceneHandler::Null()
+{
+	Unexpected("null");
+}
\ No newline at end of file
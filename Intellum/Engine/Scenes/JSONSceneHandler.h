@@ -0,0 +1,92 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include "ISceneBuilder.h"
+#include "SceneEntity.h"
+#include "../../Loaders/IJSONHandler.h"
+
+using namespace std;
+
+// Reads a JSON scene as it streams past and hands each asset and entity to an ISceneBuilder the moment it is
+// complete. A scene is an object with an "assets" object, naming every model and texture, followed by an
+// "entities" array whose entries hold one property per component. Anything the schema does not know about is
+// reported as an error rather than skipped.
+class JSONSceneHandler : public IJSONHandler
+{
+private:
+	enum SceneParseState
+	{
+		PARSE_ROOT,
+		PARSE_ASSETS,
+		PARSE_ASSET,
+		PARSE_ENTITIES,
+		PARSE_ENTITY,
+		PARSE_APPEARANCE,
+		PARSE_GRADIENT,
+		PARSE_TRANSFORM,
+		PARSE_RASTERIZER,
+		PARSE_USER_INTERFACE,
+		PARSE_TEXT,
+		PARSE_BUTTON,
+		PARSE_COLLISION,
+		PARSE_TEXTURES,
+		PARSE_BINDINGS,
+		PARSE_BINDING,
+		PARSE_OBSERVERS,
+		PARSE_OBSERVER,
+		PARSE_NUMBERS
+	};
+
+	struct ParseFrame
+	{
+		SceneParseState State;
+		float* Numbers;
+		int NumberCount;
+		int NumberIndex;
+	};
+
+	ISceneBuilder* _builder;
+	vector<ParseFrame> _frames;
+	string _key;
+	string _lookup;
+
+	map<string, unsigned int> _assetIds;
+	string _assetName;
+	string _assetType;
+	string _assetPath;
+	float _assetParameters[4];
+
+	SceneEntity _entity;
+	SceneInputBindingRecord _binding;
+	SceneEntityObserver _observer;
+	int _entityCount;
+
+	void Push(SceneParseState state);
+	void PushNumbers(float* numbers, int count);
+	void AddAsset();
+
+	bool IsKey(const char* name) const;
+	unsigned int FindAsset(const char* text, size_t length);
+	static int FindName(const char* text, size_t length, const char* const* names, int nameCount, const char* description);
+	static unsigned int ParseCommand(const char* text, size_t length);
+
+	void Unexpected(const char* value) const;
+
+public:
+	JSONSceneHandler(ISceneBuilder* builder);
+	~JSONSceneHandler() override;
+
+	int GetEntityCount() const;
+
+	void StartObject() override;
+	void EndObject() override;
+	void StartArray() override;
+	void EndArray() override;
+
+	void Key(const char* text, size_t length) override;
+	void String(const char* text, size_t length) override;
+	void Number(double value) override;
+	void Boolean(bool value) override;
+	void Null() override;
+};
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "MappedFile.h"
+#include "../../ErrorHandling/Exception.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const string& path) : _file(INVALID_HANDLE_VALUE), _mapping(nullptr), _data(nullptr), _size(0)
+{
+	_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (_file == INVALID_HANDLE_VALUE)
+		throw Exception("Failed to open '" + path + "'.");
+
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(_file, &fileSize) == FALSE)
+	{
+		Shutdown();
+		throw Exception("Failed to read the size of '" + path + "'.");
+	}
+
+	_size = static_cast<size_t>(fileSize.QuadPart);
+	if (_size == 0)
+		return;
+
+	_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (_mapping == nullptr)
+	{
+		Shutdown();
+		throw Exception("Failed to map '" + path + "' into memory.");
+	}
+
+	_data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (_data == nullptr)
+	{
+		Shutdown();
+		throw Exception("Failed to map a view of '" + path + "'.");
+	}
+}
+
+void MappedFile::Shutdown()
+{
+	if (_data)
+	{
+		UnmapViewOfFile(_data);
+		_data = nullptr;
+	}
+
+	if (_mapping)
+	{
+		CloseHandle(_mapping);
+		_mapping = nullptr;
+	}
+
+	if (_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(_file);
+		_file = INVALID_HANDLE_VALUE;
+	}
+
+	_size = 0;
+}
+#else
+MappedFile::MappedFile(const string& path) : _file(-1), _data(nullptr), _size(0)
+{
+	_file = open(path.c_str(), O_RDONLY);
+	if (_file < 0)
+		throw Exception("Failed to open '" + path + "'.");
+
+	struct stat fileStatus;
+	if (fstat(_file, &fileStatus) != 0)
+	{
+		Shutdown();
+		throw Exception("Failed to read the size of '" + path + "'.");
+	}
+
+	_size = static_cast<size_t>(fileStatus.st_size);
+	if (_size == 0)
+		return;
+
+	void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _file, 0);
+	if (data == MAP_FAILED)
+	{
+		Shutdown();
+		throw Exception("Failed to map '" + path + "' into memory.");
+	}
+
+	_data = static_cast<const char*>(data);
+}
+
+void MappedFile::Shutdown()
+{
+	if (_data)
+	{
+		munmap(const_cast<char*>(_data), _size);
+		_data = nullptr;
+	}
+
+	if (_file >= 0)
+	{
+		close(_file);
+		_file = -1;
+	}
+
+	_size = 0;
+}
+#endif
+
+MappedFile::~MappedFile()
+{
+	Shutdown();
+}
+
+const char* MappedFile::GetData() const
+{
+	return _data;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return _size;
+}
\ No newline at end of file
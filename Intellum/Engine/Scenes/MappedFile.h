@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace std;
+
+// Read only view of a whole file mapped into memory. Pages are faulted in by the OS on first touch, so opening a
+// large file costs nothing until it is read.
+class MappedFile
+{
+private:
+#ifdef _WIN32
+	HANDLE _file;
+	HANDLE _mapping;
+#else
+	int _file;
+#endif
+	const char* _data;
+	size_t _size;
+
+public:
+	MappedFile(const string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	void Shutdown();
+
+	const char* GetData() const;
+	size_t GetSize() const;
+};
\ No newline at end of file
@@ -0,0 +1,406 @@
+#include "SceneBlobLoader.h"
+#include "../Input/Controls.h"
+#include "../../ErrorHandling/Exception.h"
+
+SceneBlobLoader::SceneBlobLoader(EntityManager* entityManager, SceneContext context) : _entityManager(entityManager), _factory(entityManager, context)
+{
+}
+
+SceneBlobLoader::~SceneBlobLoader()
+{
+}
+
+void SceneBlobLoader::Shutdown()
+{
+	for (Geometry& model : _models)
+		_factory.ReleaseModel(model);
+
+	_models.clear();
+
+	for (Texture* texture : _textures)
+		_factory.ReleaseTexture(texture);
+
+	_textures.clear();
+}
+
+void SceneBlobLoader::Load(const string& path, vector<Entity*>& entities, vector<IObserver*>& observers)
+{
+	try
+	{
+		MappedFile file(path);
+		SceneBlob blob = Validate(file);
+
+		const SceneSectionRecord* sections = reinterpret_cast<const SceneSectionRecord*>(blob.Data + blob.Header->SectionOffset);
+		for (unsigned int i = 0; i < blob.Header->SectionCount; i++)
+			ValidateSection(file, blob, sections[i]);
+
+		vector<Geometry> sharedModels;
+		vector<Texture*> sharedTextures;
+		ResolveAssets(blob, sharedModels, sharedTextures);
+
+		for (unsigned int i = 0; i < blob.Header->SectionCount; i++)
+			InstantiateSection(blob, sections[i], sharedModels, sharedTextures, entities, observers);
+
+		file.Shutdown();
+	}
+	catch (Exception& exception)
+	{
+		throw Exception("Failed to load the compiled scene '" + path + "'.", exception);
+	}
+}
+
+SceneBlobLoader::SceneBlob SceneBlobLoader::Validate(const MappedFile& file)
+{
+	if (file.GetSize() < sizeof(SceneBlobHeader))
+		throw Exception("The file is too small to be a compiled scene.");
+
+	SceneBlob blob;
+	blob.Data = file.GetData();
+	blob.Header = reinterpret_cast<const SceneBlobHeader*>(blob.Data);
+
+	if (blob.Header->Magic != SceneBlobMagic)
+		throw Exception("The file is not a compiled scene.");
+
+	if (blob.Header->Version != SceneBlobVersion)
+		throw Exception("The compiled scene is version " + to_string(blob.Header->Version) + " but version " + to_string(SceneBlobVersion) + " is required. Recompile the scene.");
+
+	if (blob.Header->FileSize != file.GetSize())
+		throw Exception("The compiled scene is truncated.");
+
+	ValidateRange(file, blob.Header->AssetOffset, blob.Header->AssetCount, sizeof(SceneAssetRecord), "asset");
+	ValidateRange(file, blob.Header->TextureListOffset, blob.Header->TextureListCount, sizeof(unsigned int), "texture list");
+	ValidateRange(file, blob.Header->BindingOffset, blob.Header->BindingCount, sizeof(SceneInputBindingRecord), "input binding");
+	ValidateRange(file, blob.Header->StringOffset, blob.Header->StringBytes, sizeof(char), "string");
+	ValidateRange(file, blob.Header->SectionOffset, blob.Header->SectionCount, sizeof(SceneSectionRecord), "section");
+
+	blob.Assets = reinterpret_cast<const SceneAssetRecord*>(blob.Data + blob.Header->AssetOffset);
+	blob.TextureLists = reinterpret_cast<const unsigned int*>(blob.Data + blob.Header->TextureListOffset);
+	blob.Bindings = reinterpret_cast<const SceneInputBindingRecord*>(blob.Data + blob.Header->BindingOffset);
+	blob.Strings = blob.Data + blob.Header->StringOffset;
+
+	if (blob.Header->StringBytes > 0 && blob.Strings[blob.Header->StringBytes - 1] != '\0')
+		throw Exception("The string table of the compiled scene is not terminated.");
+
+	for (unsigned int i = 0; i < blob.Header->AssetCount; i++)
+	{
+		if (blob.Assets[i].Type > SCENE_ASSET_TEXTURE || blob.Assets[i].PathOffset >= blob.Header->StringBytes)
+			throw Exception("Asset " + to_string(i) + " of the compiled scene is invalid.");
+	}
+
+	for (unsigned int i = 0; i < blob.Header->TextureListCount; i++)
+		ValidateAsset(blob, blob.TextureLists[i], true);
+
+	for (unsigned int i = 0; i < blob.Header->BindingCount; i++)
+	{
+		if (blob.Bindings[i].Control > TOGGLE_RASTERIZER_STATE || blob.Bindings[i].Command > SCENE_COMMAND_TOGGLE_TRANSFORM)
+			throw Exception("Input binding " + to_string(i) + " of the compiled scene is invalid.");
+	}
+
+	return blob;
+}
+
+void SceneBlobLoader::ValidateRange(const MappedFile& file, unsigned int offset, unsigned int count, size_t recordSize, const string& table)
+{
+	unsigned long long end = static_cast<unsigned long long>(offset) + static_cast<unsigned long long>(count) * recordSize;
+
+	if (offset % 4 != 0 || end > file.GetSize())
+		throw Exception("The " + table + " table of the compiled scene lies outside the file.");
+}
+
+void SceneBlobLoader::ValidateAsset(const SceneBlob& blob, unsigned int asset, bool texture)
+{
+	if (asset >= blob.Header->AssetCount || (blob.Assets[asset].Type == SCENE_ASSET_TEXTURE) != texture)
+		throw Exception("The compiled scene refers to asset " + to_string(asset) + " which does not exist or has the wrong type.");
+}
+
+// Checks every reference a section makes before anything is created, so a bad file never leaves a half loaded
+// section behind.
+void SceneBlobLoader::ValidateSection(const MappedFile& file, const SceneBlob& blob, const SceneSectionRecord& section)
+{
+	if ((section.Mask >> COMPONENT_TYPE_COUNT) != 0)
+		throw Exception("A section of the compiled scene uses unknown components.");
+
+	ValidateRange(file, section.ObserverOffset, section.ObserverCount, sizeof(SceneObserverRecord), "observer");
+
+	for (int component = 0; component < COMPONENT_TYPE_COUNT; component++)
+	{
+		if (MaskContains(section.Mask, MaskOf(static_cast<ComponentType>(component))))
+			ValidateRange(file, section.ColumnOffsets[component], section.EntityCount, SceneRecordSize(static_cast<ComponentType>(component)), "component");
+	}
+
+	if (MaskContains(section.Mask, MaskOf(APPEARANCE)))
+	{
+		const SceneAppearanceRecord* records = GetRecords<SceneAppearanceRecord>(blob, section, APPEARANCE);
+
+		for (unsigned int row = 0; row < section.EntityCount; row++)
+		{
+			if (records[row].Model != SceneNoAsset)
+				ValidateAsset(blob, records[row].Model, false);
+
+			if (records[row].LightMap != SceneNoAsset)
+				ValidateAsset(blob, records[row].LightMap, true);
+
+			if (records[row].BumpMap != SceneNoAsset)
+				ValidateAsset(blob, records[row].BumpMap, true);
+
+			if (static_cast<unsigned long long>(records[row].FirstTexture) + records[row].TextureCount > blob.Header->TextureListCount)
+				throw Exception("An appearance in the compiled scene refers to textures outside the texture list table.");
+		}
+	}
+
+	if (MaskContains(section.Mask, MaskOf(TRANSFORM)))
+	{
+		const SceneTransformRecord* records = GetRecords<SceneTransformRecord>(blob, section, TRANSFORM);
+
+		for (unsigned int row = 0; row < section.EntityCount; row++)
+		{
+			if (records[row].Simulation > SIMULATION_STATIC)
+				throw Exception("A transform in the compiled scene uses an unknown simulation state.");
+		}
+	}
+
+	if (MaskContains(section.Mask, MaskOf(TEXT)))
+	{
+		const SceneTextRecord* records = GetRecords<SceneTextRecord>(blob, section, TEXT);
+
+		for (unsigned int row = 0; row < section.EntityCount; row++)
+		{
+			if (static_cast<unsigned long long>(records[row].TextOffset) + records[row].TextLength > blob.Header->StringBytes)
+				throw Exception("A text in the compiled scene lies outside the string table.");
+		}
+	}
+
+	if (MaskContains(section.Mask, MaskOf(INPUT_COMPONENT)))
+	{
+		const SceneInputRecord* records = GetRecords<SceneInputRecord>(blob, section, INPUT_COMPONENT);
+
+		for (unsigned int row = 0; row < section.EntityCount; row++)
+		{
+			if (static_cast<unsigned long long>(records[row].FirstBinding) + records[row].BindingCount > blob.Header->BindingCount)
+				throw Exception("An input in the compiled scene refers to bindings outside the binding table.");
+		}
+	}
+
+	if (MaskContains(section.Mask, MaskOf(BUTTON)))
+	{
+		const SceneButtonRecord* records = GetRecords<SceneButtonRecord>(blob, section, BUTTON);
+
+		for (unsigned int row = 0; row < section.EntityCount; row++)
+		{
+			if (records[row].OnClickCommand > SCENE_COMMAND_TOGGLE_TRANSFORM)
+				throw Exception("A button in the compiled scene uses an unknown command.");
+		}
+	}
+
+	if (MaskContains(section.Mask, MaskOf(COLLISION)))
+	{
+		const SceneCollisionRecord* records = GetRecords<SceneCollisionRecord>(blob, section, COLLISION);
+
+		for (unsigned int row = 0; row < section.EntityCount; row++)
+		{
+			if (records[row].CollisionType != CURSOR || records[row].OnCollisionCommand > SCENE_COMMAND_TOGGLE_TRANSFORM)
+				throw Exception("A collision in the compiled scene is invalid.");
+		}
+	}
+
+	const SceneObserverRecord* observers = reinterpret_cast<const SceneObserverRecord*>(blob.Data + section.ObserverOffset);
+
+	for (unsigned int i = 0; i < section.ObserverCount; i++)
+	{
+		bool observerComponent = observers[i].Component == TEXT || observers[i].Component == TRANSFORM;
+
+		if (observers[i].Row >= section.EntityCount || observers[i].Observable >= SCENE_OBSERVABLE_COUNT || observerComponent == false || MaskContains(section.Mask, MaskOf(static_cast<ComponentType>(observers[i].Component))) == false)
+			throw Exception("An observer in the compiled scene is invalid.");
+	}
+}
+
+void SceneBlobLoader::ResolveAssets(const SceneBlob& blob, vector<Geometry>& sharedModels, vector<Texture*>& sharedTextures)
+{
+	sharedModels.resize(blob.Header->AssetCount, Geometry());
+	sharedTextures.resize(blob.Header->AssetCount, nullptr);
+
+	for (unsigned int i = 0; i < blob.Header->AssetCount; i++)
+	{
+		const SceneAssetRecord& asset = blob.Assets[i];
+
+		if (asset.Type == SCENE_ASSET_TEXTURE)
+		{
+			sharedTextures[i] = LoadTexture(blob, i);
+			if (sharedTextures[i] != nullptr)
+				_textures.push_back(sharedTextures[i]);
+		}
+		else if (asset.Type != SCENE_ASSET_UI_QUAD)
+		{
+			sharedModels[i] = BuildModel(blob, asset);
+			_models.push_back(sharedModels[i]);
+		}
+	}
+}
+
+Geometry SceneBlobLoader::BuildModel(const SceneBlob& blob, const SceneAssetRecord& asset) const
+{
+	return _factory.BuildModel(asset.Type, blob.Strings + asset.PathOffset, asset.Parameters);
+}
+
+Texture* SceneBlobLoader::LoadTexture(const SceneBlob& blob, unsigned int asset) const
+{
+	return _factory.LoadTexture(blob.Strings + blob.Assets[asset].PathOffset);
+}
+
+Archetype* SceneBlobLoader::AddColumnTo(EntityManager* entityManager, Archetype* archetype, ComponentType component)
+{
+	switch (component)
+	{
+	case APPEARANCE:
+		return entityManager->GetArchetypeWith<AppearanceComponent>(archetype);
+	case TRANSFORM:
+		return entityManager->GetArchetypeWith<TransformComponent>(archetype);
+	case RASTERIZER:
+		return entityManager->GetArchetypeWith<RasterizerComponent>(archetype);
+	case FRUSTRUM_CULLING:
+		return entityManager->GetArchetypeWith<FrustrumCullingComponent>(archetype);
+	case USER_INTERFACE:
+		return entityManager->GetArchetypeWith<UIComponent>(archetype);
+	case TEXT:
+		return entityManager->GetArchetypeWith<TextComponent>(archetype);
+	case BUTTON:
+		return entityManager->GetArchetypeWith<ButtonComponent>(archetype);
+	case INPUT_COMPONENT:
+		return entityManager->GetArchetypeWith<InputComponent>(archetype);
+	case COLLISION:
+		return entityManager->GetArchetypeWith<CollisionComponent>(archetype);
+	default:
+		return archetype;
+	}
+}
+
+void SceneBlobLoader::InstantiateSection(const SceneBlob& blob, const SceneSectionRecord& section, const vector<Geometry>& sharedModels, const vector<Texture*>& sharedTextures, vector<Entity*>& entities, vector<IObserver*>& observers)
+{
+	int count = static_cast<int>(section.EntityCount);
+	if (count == 0)
+		return;
+
+	Archetype* archetype = _entityManager->GetEmptyArchetype();
+	for (int component = 0; component < COMPONENT_TYPE_COUNT; component++)
+	{
+		if (MaskContains(section.Mask, MaskOf(static_cast<ComponentType>(component))))
+			archetype = AddColumnTo(_entityManager, archetype, static_cast<ComponentType>(component));
+	}
+
+	// Models are built ahead of the entities so a failing device call cannot leave the archetype with rows that
+	// have no components.
+	vector<Geometry> models;
+	if (MaskContains(section.Mask, MaskOf(APPEARANCE)))
+	{
+		const SceneAppearanceRecord* records = GetRecords<SceneAppearanceRecord>(blob, section, APPEARANCE);
+		models.reserve(count);
+
+		for (int row = 0; row < count; row++)
+		{
+			unsigned int model = records[row].Model;
+
+			if (model != SceneNoAsset && blob.Assets[model].Type == SCENE_ASSET_UI_QUAD)
+			{
+				models.push_back(BuildModel(blob, blob.Assets[model]));
+				_models.push_back(models.back());
+			}
+			else
+				models.push_back(model == SceneNoAsset ? Geometry() : sharedModels[model]);
+		}
+	}
+
+	int firstEntity = static_cast<int>(entities.size());
+	_entityManager->CreateEntities(archetype, count, entities);
+
+	for (ComponentType component : archetype->GetComponentTypes())
+	{
+		switch (component)
+		{
+		case APPEARANCE:
+			AddAppearances(archetype->GetColumn<AppearanceComponent>(), blob, GetRecords<SceneAppearanceRecord>(blob, section, component), count, models, sharedTextures);
+			break;
+		case TRANSFORM:
+			AddRecords(archetype->GetColumn<TransformComponent>(), GetRecords<SceneTransformRecord>(blob, section, component), count, &SceneComponentFactory::CreateTransform);
+			break;
+		case RASTERIZER:
+			AddRecords(archetype->GetColumn<RasterizerComponent>(), GetRecords<SceneRasterizerRecord>(blob, section, component), count, &SceneComponentFactory::CreateRasterizer);
+			break;
+		case FRUSTRUM_CULLING:
+			AddRecords(archetype->GetColumn<FrustrumCullingComponent>(), GetRecords<SceneFrustrumCullingRecord>(blob, section, component), count, &SceneComponentFactory::CreateFrustrumCulling);
+			break;
+		case USER_INTERFACE:
+			AddRecords(archetype->GetColumn<UIComponent>(), GetRecords<SceneUIRecord>(blob, section, component), count, &SceneComponentFactory::CreateUserInterface);
+			break;
+		case TEXT:
+			AddTexts(archetype->GetColumn<TextComponent>(), blob, GetRecords<SceneTextRecord>(blob, section, component), count);
+			break;
+		case BUTTON:
+			AddButtons(archetype->GetColumn<ButtonComponent>(), GetRecords<SceneButtonRecord>(blob, section, component), entities, firstEntity, count);
+			break;
+		case INPUT_COMPONENT:
+			AddInputs(archetype->GetColumn<InputComponent>(), blob, GetRecords<SceneInputRecord>(blob, section, component), entities, firstEntity, count);
+			break;
+		case COLLISION:
+			AddCollisions(archetype->GetColumn<CollisionComponent>(), GetRecords<SceneCollisionRecord>(blob, section, component), entities, firstEntity, count);
+			break;
+		default:
+			break;
+		}
+	}
+
+	const SceneObserverRecord* observerRecords = reinterpret_cast<const SceneObserverRecord*>(blob.Data + section.ObserverOffset);
+
+	for (unsigned int i = 0; i < section.ObserverCount; i++)
+	{
+		IObserver* observer = _factory.CreateObserver(observerRecords[i].Observable, observerRecords[i].Component, entities[firstEntity + observerRecords[i].Row]->GetHandle());
+		if (observer != nullptr)
+			observers.push_back(observer);
+	}
+}
+
+void SceneBlobLoader::AddAppearances(ComponentArray<AppearanceComponent>* column, const SceneBlob& blob, const SceneAppearanceRecord* records, int count, const vector<Geometry>& models, const vector<Texture*>& sharedTextures) const
+{
+	vector<Texture*> textures;
+
+	for (int row = 0; row < count; row++)
+	{
+		const SceneAppearanceRecord& record = records[row];
+
+		textures.clear();
+		for (unsigned int i = 0; i < record.TextureCount; i++)
+		{
+			Texture* texture = sharedTextures[blob.TextureLists[record.FirstTexture + i]];
+			if (texture != nullptr)
+				textures.push_back(texture);
+		}
+
+		Texture* lightMap = record.LightMap == SceneNoAsset ? nullptr : sharedTextures[record.LightMap];
+		Texture* bumpMap = record.BumpMap == SceneNoAsset ? nullptr : sharedTextures[record.BumpMap];
+
+		column->Add(_factory.CreateAppearance(record, models[row], textures, lightMap, bumpMap));
+	}
+}
+
+void SceneBlobLoader::AddTexts(ComponentArray<TextComponent>* column, const SceneBlob& blob, const SceneTextRecord* records, int count) const
+{
+	for (int row = 0; row < count; row++)
+		column->Add(SceneComponentFactory::CreateText(records[row], blob.Strings + records[row].TextOffset));
+}
+
+void SceneBlobLoader::AddButtons(ComponentArray<ButtonComponent>* column, const SceneButtonRecord* records, const vector<Entity*>& entities, int firstEntity, int count) const
+{
+	for (int row = 0; row < count; row++)
+		column->Add(_factory.CreateButton(records[row], entities[firstEntity + row]->GetHandle()));
+}
+
+void SceneBlobLoader::AddInputs(ComponentArray<InputComponent>* column, const SceneBlob& blob, const SceneInputRecord* records, const vector<Entity*>& entities, int firstEntity, int count) const
+{
+	for (int row = 0; row < count; row++)
+		column->Add(_factory.CreateInput(blob.Bindings + records[row].FirstBinding, records[row].BindingCount, entities[firstEntity + row]->GetHandle()));
+}
+
+void SceneBlobLoader::AddCollisions(ComponentArray<CollisionComponent>* column, const SceneCollisionRecord* records, const vector<Entity*>& entities, int firstEntity, int count) const
+{
+	for (int row = 0; row < count; row++)
+		column->Add(_factory.CreateCollision(records[row], entities[firstEntity + row]->GetHandle()));
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SceneComponentFactory.h"
+#include "SceneContext.h"
+#include "SceneFormat.h"
+#include "MappedFile.h"
+#include "../Objects/Entity.h"
+#include "../Objects/EntityManager.h"
+
+using namespace std;
+
+// Instantiates compiled scenes straight from a memory mapped file. Each section becomes one archetype: its
+// entities are created in a single pass and every component column is filled from its contiguous record array,
+// so no entity migrates between archetypes while loading. Models and textures are created once per asset id and
+// owned by the loader until it is shut down.
+class SceneBlobLoader
+{
+private:
+	struct SceneBlob
+	{
+		const char* Data;
+		const SceneBlobHeader* Header;
+		const SceneAssetRecord* Assets;
+		const unsigned int* TextureLists;
+		const SceneInputBindingRecord* Bindings;
+		const char* Strings;
+	};
+
+	EntityManager* _entityManager;
+	SceneComponentFactory _factory;
+
+	vector<Geometry> _models;
+	vector<Texture*> _textures;
+
+	static SceneBlob Validate(const MappedFile& file);
+	static void ValidateSection(const MappedFile& file, const SceneBlob& blob, const SceneSectionRecord& section);
+	static void ValidateRange(const MappedFile& file, unsigned int offset, unsigned int count, size_t recordSize, const string& table);
+	static void ValidateAsset(const SceneBlob& blob, unsigned int asset, bool texture);
+
+	void ResolveAssets(const SceneBlob& blob, vector<Geometry>& sharedModels, vector<Texture*>& sharedTextures);
+	Geometry BuildModel(const SceneBlob& blob, const SceneAssetRecord& asset) const;
+	Texture* LoadTexture(const SceneBlob& blob, unsigned int asset) const;
+
+	void InstantiateSection(const SceneBlob& blob, const SceneSectionRecord& section, const vector<Geometry>& sharedModels, const vector<Texture*>& sharedTextures, vector<Entity*>& entities, vector<IObserver*>& observers);
+
+	template<typename T>
+	static const T* GetRecords(const SceneBlob& blob, const SceneSectionRecord& section, ComponentType component)
+	{
+		return reinterpret_cast<const T*>(blob.Data + section.ColumnOffsets[component]);
+	}
+
+	static Archetype* AddColumnTo(EntityManager* entityManager, Archetype* archetype, ComponentType component);
+
+	void AddAppearances(ComponentArray<AppearanceComponent>* column, const SceneBlob& blob, const SceneAppearanceRecord* records, int count, const vector<Geometry>& models, const vector<Texture*>& sharedTextures) const;
+	void AddTexts(ComponentArray<TextComponent>* column, const SceneBlob& blob, const SceneTextRecord* records, int count) const;
+	void AddButtons(ComponentArray<ButtonComponent>* column, const SceneButtonRecord* records, const vector<Entity*>& entities, int firstEntity, int count) const;
+	void AddInputs(ComponentArray<InputComponent>* column, const SceneBlob& blob, const SceneInputRecord* records, const vector<Entity*>& entities, int firstEntity, int count) const;
+	void AddCollisions(ComponentArray<CollisionComponent>* column, const SceneCollisionRecord* records, const vector<Entity*>& entities, int firstEntity, int count) const;
+
+	template<typename T, typename R>
+	static void AddRecords(ComponentArray<T>* column, const R* records, int count, T (*create)(const R&))
+	{
+		for (int row = 0; row < count; row++)
+			column->Add(create(records[row]));
+	}
+
+public:
+	SceneBlobLoader(EntityManager* entityManager, SceneContext context);
+	~SceneBlobLoader();
+
+	void Shutdown();
+
+	void Load(const string& path, vector<Entity*>& entities, vector<IObserver*>& observers);
+};
\ No newline at end of file
@@ -0,0 +1,229 @@
+#include "SceneBlobWriter.h"
+#include <cstring>
+#include <fstream>
+#include "../../ErrorHandling/Exception.h"
+
+SceneBlobWriter::SceneBlobWriter()
+{
+}
+
+SceneBlobWriter::~SceneBlobWriter()
+{
+}
+
+unsigned int SceneBlobWriter::AddString(const string& text)
+{
+	unsigned int offset = static_cast<unsigned int>(_strings.size());
+	_strings.append(text);
+	_strings.push_back('\0');
+	return offset;
+}
+
+unsigned int SceneBlobWriter::AddAsset(SceneAssetType type, const string& path, float first, float second, float third, float fourth)
+{
+	string key = to_string(type) + "|" + path + "|" + to_string(first) + "|" + to_string(second) + "|" + to_string(third) + "|" + to_string(fourth);
+
+	map<string, unsigned int>::iterator iterator = _assetLookup.find(key);
+	if (iterator != _assetLookup.end())
+		return iterator->second;
+
+	SceneAssetRecord asset;
+	asset.Type = type;
+	asset.PathOffset = AddString(path);
+	asset.Parameters[0] = first;
+	asset.Parameters[1] = second;
+	asset.Parameters[2] = third;
+	asset.Parameters[3] = fourth;
+
+	unsigned int id = static_cast<unsigned int>(_assets.size());
+	_assets.push_back(asset);
+	_assetLookup[key] = id;
+	return id;
+}
+
+unsigned int SceneBlobWriter::AddModel(const string& path)
+{
+	return AddAsset(SCENE_ASSET_MODEL, path, 0, 0, 0, 0);
+}
+
+unsigned int SceneBlobWriter::AddCube()
+{
+	return AddAsset(SCENE_ASSET_CUBE, "", 0, 0, 0, 0);
+}
+
+// UI quads have their vertices rewritten per element, so the loader builds a fresh one for every entity that
+// refers to this id rather than sharing it.
+unsigned int SceneBlobWriter::AddUIQuad()
+{
+	return AddAsset(SCENE_ASSET_UI_QUAD, "", 0, 0, 0, 0);
+}
+
+unsigned int SceneBlobWriter::AddGrid(float width, float height, float columns, float rows)
+{
+	return AddAsset(SCENE_ASSET_GRID, "", width, height, columns, rows);
+}
+
+unsigned int SceneBlobWriter::AddTexture(const string& path)
+{
+	return AddAsset(SCENE_ASSET_TEXTURE, path, 0, 0, 0, 0);
+}
+
+void SceneBlobWriter::AddEntity(const SceneEntity& entity)
+{
+	SceneEntity compiled = entity;
+
+	compiled.Appearance.FirstTexture = static_cast<unsigned int>(_textureLists.size());
+	compiled.Appearance.TextureCount = static_cast<unsigned int>(entity.Textures.size());
+	_textureLists.insert(_textureLists.end(), entity.Textures.begin(), entity.Textures.end());
+
+	compiled.Input.FirstBinding = static_cast<unsigned int>(_bindings.size());
+	compiled.Input.BindingCount = static_cast<unsigned int>(entity.Bindings.size());
+	_bindings.insert(_bindings.end(), entity.Bindings.begin(), entity.Bindings.end());
+
+	if (MaskContains(entity.Mask, MaskOf(TEXT)))
+	{
+		compiled.Text.TextOffset = AddString(entity.TextString);
+		compiled.Text.TextLength = static_cast<unsigned int>(entity.TextString.size());
+	}
+
+	_sections[entity.Mask].push_back(compiled);
+}
+
+int SceneBlobWriter::GetEntityCount() const
+{
+	int count = 0;
+
+	for (map<ComponentMask, vector<SceneEntity>>::const_iterator iterator = _sections.begin(); iterator != _sections.end(); ++iterator)
+		count += static_cast<int>(iterator->second.size());
+
+	return count;
+}
+
+void SceneBlobWriter::Append(vector<char>& blob, const void* data, size_t bytes)
+{
+	const char* source = static_cast<const char*>(data);
+	blob.insert(blob.end(), source, source + bytes);
+}
+
+void SceneBlobWriter::Align(vector<char>& blob)
+{
+	while (blob.size() % 4 != 0)
+		blob.push_back('\0');
+}
+
+vector<char> SceneBlobWriter::Build() const
+{
+	SceneBlobHeader header;
+	memset(&header, 0, sizeof(header));
+	header.Magic = SceneBlobMagic;
+	header.Version = SceneBlobVersion;
+
+	vector<char> blob(sizeof(SceneBlobHeader));
+
+	header.AssetCount = static_cast<unsigned int>(_assets.size());
+	header.AssetOffset = static_cast<unsigned int>(blob.size());
+	Append(blob, _assets.data(), _assets.size() * sizeof(SceneAssetRecord));
+
+	header.TextureListCount = static_cast<unsigned int>(_textureLists.size());
+	header.TextureListOffset = static_cast<unsigned int>(blob.size());
+	Append(blob, _textureLists.data(), _textureLists.size() * sizeof(unsigned int));
+
+	header.BindingCount = static_cast<unsigned int>(_bindings.size());
+	header.BindingOffset = static_cast<unsigned int>(blob.size());
+	Append(blob, _bindings.data(), _bindings.size() * sizeof(SceneInputBindingRecord));
+
+	header.StringBytes = static_cast<unsigned int>(_strings.size());
+	header.StringOffset = static_cast<unsigned int>(blob.size());
+	Append(blob, _strings.data(), _strings.size());
+	Align(blob);
+
+	header.SectionCount = static_cast<unsigned int>(_sections.size());
+	header.SectionOffset = static_cast<unsigned int>(blob.size());
+	blob.resize(blob.size() + _sections.size() * sizeof(SceneSectionRecord));
+
+	int sectionIndex = 0;
+	for (map<ComponentMask, vector<SceneEntity>>::const_iterator iterator = _sections.begin(); iterator != _sections.end(); ++iterator, sectionIndex++)
+	{
+		const vector<SceneEntity>& entities = iterator->second;
+
+		SceneSectionRecord section;
+		memset(&section, 0, sizeof(section));
+		section.Mask = iterator->first;
+		section.EntityCount = static_cast<unsigned int>(entities.size());
+		section.ObserverOffset = static_cast<unsigned int>(blob.size());
+
+		for (unsigned int row = 0; row < entities.size(); row++)
+		{
+			for (const SceneEntityObserver& entityObserver : entities[row].Observers)
+			{
+				SceneObserverRecord observer;
+				observer.Row = row;
+				observer.Observable = entityObserver.Observable;
+				observer.Component = entityObserver.Component;
+				Append(blob, &observer, sizeof(observer));
+				section.ObserverCount++;
+			}
+		}
+
+		for (int component = 0; component < COMPONENT_TYPE_COUNT; component++)
+		{
+			if (MaskContains(section.Mask, MaskOf(static_cast<ComponentType>(component))) == false)
+				continue;
+
+			section.ColumnOffsets[component] = static_cast<unsigned int>(blob.size());
+
+			for (const SceneEntity& entity : entities)
+			{
+				switch (component)
+				{
+				case APPEARANCE:
+					Append(blob, &entity.Appearance, sizeof(entity.Appearance));
+					break;
+				case TRANSFORM:
+					Append(blob, &entity.Transform, sizeof(entity.Transform));
+					break;
+				case RASTERIZER:
+					Append(blob, &entity.Rasterizer, sizeof(entity.Rasterizer));
+					break;
+				case FRUSTRUM_CULLING:
+					Append(blob, &entity.FrustrumCulling, sizeof(entity.FrustrumCulling));
+					break;
+				case USER_INTERFACE:
+					Append(blob, &entity.UserInterface, sizeof(entity.UserInterface));
+					break;
+				case TEXT:
+					Append(blob, &entity.Text, sizeof(entity.Text));
+					break;
+				case BUTTON:
+					Append(blob, &entity.Button, sizeof(entity.Button));
+					break;
+				case INPUT_COMPONENT:
+					Append(blob, &entity.Input, sizeof(entity.Input));
+					break;
+				case COLLISION:
+					Append(blob, &entity.Collision, sizeof(entity.Collision));
+					break;
+				}
+			}
+		}
+
+		memcpy(&blob[header.SectionOffset + sectionIndex * sizeof(SceneSectionRecord)], &section, sizeof(section));
+	}
+
+	header.FileSize = static_cast<unsigned int>(blob.size());
+	memcpy(blob.data(), &header, sizeof(header));
+	return blob;
+}
+
+void SceneBlobWriter::Save(const string& path) const
+{
+	vector<char> blob = Build();
+
+	ofstream outFile(path, ios::binary | ios::trunc);
+	if (outFile.is_open() == false)
+		throw Exception("Failed to open '" + path + "' to write the compiled scene.");
+
+	outFile.write(blob.data(), blob.size());
+	if (outFile.fail())
+		throw Exception("Failed to write the compiled scene to '" + path + "'.");
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include "ISceneBuilder.h"
+#include "SceneFormat.h"
+
+using namespace std;
+
+// Compiles scene entities into the binary layout described in SceneFormat.h. Entities with the same component
+// mask end up in one section so the loader can create them in a single pass.
+class SceneBlobWriter : public ISceneBuilder
+{
+private:
+	vector<SceneAssetRecord> _assets;
+	map<string, unsigned int> _assetLookup;
+	vector<unsigned int> _textureLists;
+	vector<SceneInputBindingRecord> _bindings;
+	string _strings;
+	map<ComponentMask, vector<SceneEntity>> _sections;
+
+	unsigned int AddString(const string& text);
+	unsigned int AddAsset(SceneAssetType type, const string& path, float first, float second, float third, float fourth);
+
+	static void Append(vector<char>& blob, const void* data, size_t bytes);
+	static void Align(vector<char>& blob);
+
+public:
+	SceneBlobWriter();
+	~SceneBlobWriter() override;
+
+	unsigned int AddModel(const string& path) override;
+	unsigned int AddCube() override;
+	unsigned int AddUIQuad() override;
+	unsigned int AddGrid(float width, float height, float columns, float rows) override;
+	unsigned int AddTexture(const string& path) override;
+
+	void AddEntity(const SceneEntity& entity) override;
+
+	int GetEntityCount() const;
+	vector<char> Build() const;
+	void Save(const string& path) const;
+};
\ No newline at end of file
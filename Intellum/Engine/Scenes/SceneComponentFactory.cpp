@@ -0,0 +1,208 @@
+#include "SceneComponentFactory.h"
+#include "../Objects/ComponentObserver.h"
+#include "../Objects/Commands/ExitApplicationCommand.h"
+#include "../Objects/Commands/NullCommand.h"
+#include "../Objects/Commands/ToggleTransformCommand.h"
+#include "../Objects/Commands/ToggleVisibleCommand.h"
+
+SceneComponentFactory::SceneComponentFactory(EntityManager* entityManager, SceneContext context) : _entityManager(entityManager), _context(context)
+{
+}
+
+SceneComponentFactory::~SceneComponentFactory()
+{
+}
+
+Geometry SceneComponentFactory::BuildModel(unsigned int assetType, const char* path, const float* parameters) const
+{
+	if (_context.Models == nullptr)
+		return Geometry();
+
+	switch (assetType)
+	{
+	case SCENE_ASSET_MODEL:
+		return _context.Models->FromFile(path);
+	case SCENE_ASSET_CUBE:
+		return _context.Models->Cube();
+	case SCENE_ASSET_UI_QUAD:
+		return _context.Models->ForUI();
+	case SCENE_ASSET_GRID:
+		return _context.Models->ForGrid(Box(parameters[0], parameters[1]), XMFLOAT2(parameters[2], parameters[3]));
+	default:
+		return Geometry();
+	}
+}
+
+void SceneComponentFactory::ReleaseModel(const Geometry& model) const
+{
+	if (_context.Models != nullptr)
+		_context.Models->Release(model);
+}
+
+Texture* SceneComponentFactory::LoadTexture(const char* path) const
+{
+	if (_context.Textures == nullptr)
+		return nullptr;
+
+	return _context.Textures->From(path);
+}
+
+void SceneComponentFactory::ReleaseTexture(Texture* texture) const
+{
+	if (_context.Textures != nullptr)
+		_context.Textures->Release(texture);
+}
+
+// The scene's models and textures are shared, so the appearance takes a reference of its own on each of them and
+// gives it back when the entity goes
+AppearanceComponent SceneComponentFactory::CreateAppearance(const SceneAppearanceRecord& record, const Geometry& model, const vector<Texture*>& textures, Texture* lightMap, Texture* bumpMap) const
+{
+	AppearanceComponent appearance;
+	appearance.ShaderType = static_cast<ShaderType>(record.ShaderType);
+	appearance.RenderEnabled = record.RenderEnabled != 0;
+
+	if (_context.Models != nullptr)
+	{
+		appearance.ModelOwner = _context.Models;
+		appearance.Model = _context.Models->Share(model);
+	}
+	else
+		appearance.Model = model;
+
+	if (_context.Textures != nullptr)
+	{
+		appearance.TextureOwner = _context.Textures;
+
+		for (Texture* texture : textures)
+			appearance.Textures.push_back(_context.Textures->Share(texture));
+
+		appearance.LightMap = lightMap == nullptr ? nullptr : _context.Textures->Share(lightMap);
+		appearance.BumpMap = bumpMap == nullptr ? nullptr : _context.Textures->Share(bumpMap);
+	}
+	else
+	{
+		appearance.Textures = textures;
+		appearance.LightMap = lightMap;
+		appearance.BumpMap = bumpMap;
+	}
+
+	if (record.ColorEnabled)
+		appearance.Color = ColorShaderParameters(XMFLOAT4(record.Color));
+
+	if (record.GradientEnabled)
+		appearance.Gradient = GradientShaderParameters(XMFLOAT4(record.ApexColor), XMFLOAT4(record.CenterColor), record.CenterYCordinates, record.Height);
+
+	return appearance;
+}
+
+TransformComponent SceneComponentFactory::CreateTransform(const SceneTransformRecord& record)
+{
+	TransformComponent transform;
+	transform.Position = XMFLOAT3(record.Position);
+	transform.Rotation = XMFLOAT3(record.Rotation);
+	transform.Scale = XMFLOAT3(record.Scale);
+	transform.Velocity = XMFLOAT3(record.Velocity);
+	transform.AngularVelocity = XMFLOAT3(record.AngularVelocity);
+	transform.TransformEnabled = record.TransformEnabled != 0;
+	transform.Simulation = static_cast<SimulationState>(record.Simulation);
+	return transform;
+}
+
+RasterizerComponent SceneComponentFactory::CreateRasterizer(const SceneRasterizerRecord& record)
+{
+	RasterizerComponent rasterizer;
+	rasterizer.FillMode = static_cast<D3D11_FILL_MODE>(record.FillMode);
+	rasterizer.CullMode = static_cast<D3D11_CULL_MODE>(record.CullMode);
+	return rasterizer;
+}
+
+FrustrumCullingComponent SceneComponentFactory::CreateFrustrumCulling(const SceneFrustrumCullingRecord& record)
+{
+	FrustrumCullingComponent frustrum;
+	frustrum.CullingType = static_cast<FrustrumCullingType>(record.CullingType);
+	return frustrum;
+}
+
+UIComponent SceneComponentFactory::CreateUserInterface(const SceneUIRecord& record)
+{
+	UIComponent userInterface;
+	userInterface.BitmapSize = XMFLOAT2(record.BitmapSize);
+	return userInterface;
+}
+
+TextComponent SceneComponentFactory::CreateText(const SceneTextRecord& record, const char* text)
+{
+	TextComponent textComponent;
+	textComponent.Text.assign(text, record.TextLength);
+	textComponent.FontSize = record.FontSize;
+	textComponent.FontPosition = XMFLOAT2(record.FontPosition);
+	textComponent.Color = XMFLOAT4(record.Color);
+	return textComponent;
+}
+
+ButtonComponent SceneComponentFactory::CreateButton(const SceneButtonRecord& record, EntityHandle entity) const
+{
+	ButtonComponent button;
+	delete button.OnClickCommand;
+	button.OnClickCommand = CreateCommand(record.OnClickCommand, entity);
+	return button;
+}
+
+InputComponent SceneComponentFactory::CreateInput(const SceneInputBindingRecord* bindings, unsigned int bindingCount, EntityHandle entity) const
+{
+	InputComponent input;
+	input.ControlCommands.reserve(bindingCount);
+
+	for (unsigned int i = 0; i < bindingCount; i++)
+	{
+		ControlCommand control;
+		control.Control = static_cast<Controls>(bindings[i].Control);
+		control.Command = CreateCommand(bindings[i].Command, entity);
+		control.Cooldown = bindings[i].Cooldown;
+		control.CurrentCooldown = 0.0f;
+		input.ControlCommands.push_back(control);
+	}
+
+	return input;
+}
+
+CollisionComponent SceneComponentFactory::CreateCollision(const SceneCollisionRecord& record, EntityHandle entity) const
+{
+	CollisionComponent collision;
+	collision.CollisionType = static_cast<CollisionType>(record.CollisionType);
+	delete collision.OnCollisionCommand;
+	collision.OnCollisionCommand = CreateCommand(record.OnCollisionCommand, entity);
+	return collision;
+}
+
+ICommand* SceneComponentFactory::CreateCommand(unsigned int command, EntityHandle entity) const
+{
+	switch (command)
+	{
+	case SCENE_COMMAND_EXIT_APPLICATION:
+		return new ExitApplicationCommand();
+	case SCENE_COMMAND_TOGGLE_VISIBLE:
+		return new ToggleVisibleCommand(_entityManager, entity);
+	case SCENE_COMMAND_TOGGLE_TRANSFORM:
+		return new ToggleTransformCommand(_entityManager, entity);
+	default:
+		return new NullCommand();
+	}
+}
+
+// Registers the new observer with its observable. Returns null when the context has no such observable, in
+// which case nothing is created.
+IObserver* SceneComponentFactory::CreateObserver(unsigned int observable, unsigned int component, EntityHandle entity) const
+{
+	if (observable >= SCENE_OBSERVABLE_COUNT || _context.Observables[observable] == nullptr)
+		return nullptr;
+
+	IObserver* observer;
+	if (component == TEXT)
+		observer = new ComponentObserver<TextComponent>(_entityManager, entity);
+	else
+		observer = new ComponentObserver<TransformComponent>(_entityManager, entity);
+
+	_context.Observables[observable]->AddObserver(observer);
+	return observer;
+}
\ No newline at end of file
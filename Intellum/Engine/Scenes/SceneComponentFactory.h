@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include "SceneContext.h"
+#include "SceneFormat.h"
+#include "../Objects/EntityManager.h"
+#include "../Objects/Components/AppearanceComponent.h"
+#include "../Objects/Components/TransformComponent.h"
+#include "../Objects/Components/RasterizerComponent.h"
+#include "../Objects/Components/FurstrumCullingComponent.h"
+#include "../Objects/Components/UIComponent.h"
+#include "../Objects/Components/TextComponent.h"
+#include "../Objects/Components/ButtonComponent.h"
+#include "../Objects/Components/InputComponent.h"
+#include "../Objects/Components/CollisionComponent.h"
+#include "../Objects/Commands/ICommand.h"
+#include "../Objects/Texture/Texture.h"
+#include "../Observer/IObserver.h"
+
+using namespace std;
+
+// Turns scene records into live components, assets, commands and observers. Shared by every path that brings
+// a scene into an EntityManager so a record means the same thing whichever format it came from.
+class SceneComponentFactory
+{
+private:
+	EntityManager* _entityManager;
+	SceneContext _context;
+
+public:
+	SceneComponentFactory(EntityManager* entityManager, SceneContext context);
+	~SceneComponentFactory();
+
+	Geometry BuildModel(unsigned int assetType, const char* path, const float* parameters) const;
+	void ReleaseModel(const Geometry& model) const;
+	Texture* LoadTexture(const char* path) const;
+	void ReleaseTexture(Texture* texture) const;
+
+	AppearanceComponent CreateAppearance(const SceneAppearanceRecord& record, const Geometry& model, const vector<Texture*>& textures, Texture* lightMap, Texture* bumpMap) const;
+	static TransformComponent CreateTransform(const SceneTransformRecord& record);
+	static RasterizerComponent CreateRasterizer(const SceneRasterizerRecord& record);
+	static FrustrumCullingComponent CreateFrustrumCulling(const SceneFrustrumCullingRecord& record);
+	static UIComponent CreateUserInterface(const SceneUIRecord& record);
+	static TextComponent CreateText(const SceneTextRecord& record, const char* text);
+	ButtonComponent CreateButton(const SceneButtonRecord& record, EntityHandle entity) const;
+	InputComponent CreateInput(const SceneInputBindingRecord* bindings, unsigned int bindingCount, EntityHandle entity) const;
+	CollisionComponent CreateCollision(const SceneCollisionRecord& record, EntityHandle entity) const;
+
+	ICommand* CreateCommand(unsigned int command, EntityHandle entity) const;
+	IObserver* CreateObserver(unsigned int observable, unsigned int component, EntityHandle entity) const;
+};
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+#include "SceneFormat.h"
+#include "../Rendering/IRenderDevice.h"
+#include "../Objects/Geometry/GeometryCache.h"
+#include "../Objects/Texture/TextureCache.h"
+#include "../Observer/Observable.h"
+
+// What a scene needs from the running engine to bring its entities to life. Any member may be null: without a
+// device or caches assets are left empty, and observers with no matching observable are skipped.
+struct SceneContext
+{
+	IRenderDevice* RenderDevice;
+	GeometryCache* Models;
+	TextureCache* Textures;
+	Observable* Observables[SCENE_OBSERVABLE_COUNT];
+
+	SceneContext() : RenderDevice(nullptr), Models(nullptr), Textures(nullptr)
+	{
+		for (int i = 0; i < SCENE_OBSERVABLE_COUNT; i++)
+			Observables[i] = nullptr;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "SceneEntity.h"
+#include <cstring>
+
+SceneEntity::SceneEntity() : Mask(0)
+{
+	Clear();
+}
+
+SceneEntity::~SceneEntity()
+{
+}
+
+// Puts every record back to the defaults of its component. The vectors keep their capacity so an entity can be
+// reused without allocating.
+void SceneEntity::Clear()
+{
+	Mask = 0;
+
+	memset(&Appearance, 0, sizeof(Appearance));
+	memset(&Transform, 0, sizeof(Transform));
+	memset(&Rasterizer, 0, sizeof(Rasterizer));
+	memset(&FrustrumCulling, 0, sizeof(FrustrumCulling));
+	memset(&UserInterface, 0, sizeof(UserInterface));
+	memset(&Text, 0, sizeof(Text));
+	memset(&Button, 0, sizeof(Button));
+	memset(&Input, 0, sizeof(Input));
+	memset(&Collision, 0, sizeof(Collision));
+
+	Appearance.Model = SceneNoAsset;
+	Appearance.LightMap = SceneNoAsset;
+	Appearance.BumpMap = SceneNoAsset;
+	Appearance.RenderEnabled = 1;
+
+	Transform.Scale[0] = 1.0f;
+	Transform.Scale[1] = 1.0f;
+	Transform.Scale[2] = 1.0f;
+	Transform.TransformEnabled = 1;
+
+	// D3D11_FILL_SOLID and D3D11_CULL_BACK, kept as raw values so scenes can be authored without Direct3D
+	Rasterizer.FillMode = 3;
+	Rasterizer.CullMode = 3;
+
+	// FRUSTRUM_CULL_RECTANGLE
+	FrustrumCulling.CullingType = 1;
+
+	Textures.clear();
+	Bindings.clear();
+	TextString.clear();
+	Observers.clear();
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SceneFormat.h"
+
+using namespace std;
+
+struct SceneEntityObserver
+{
+	SceneObservable Observable;
+	ComponentType Component;
+};
+
+// Authoring side description of a single entity. Only the records whose component is set in Mask are used.
+// Asset fields hold ids returned by the ISceneBuilder the entity is added to. Texture lists, bindings and text
+// live in the vectors and string here; the record fields that index them are filled in by the builder.
+class SceneEntity
+{
+public:
+	ComponentMask Mask;
+
+	SceneAppearanceRecord Appearance;
+	SceneTransformRecord Transform;
+	SceneRasterizerRecord Rasterizer;
+	SceneFrustrumCullingRecord FrustrumCulling;
+	SceneUIRecord UserInterface;
+	SceneTextRecord Text;
+	SceneButtonRecord Button;
+	SceneInputRecord Input;
+	SceneCollisionRecord Collision;
+
+	vector<unsigned int> Textures;
+	vector<SceneInputBindingRecord> Bindings;
+	string TextString;
+	vector<SceneEntityObserver> Observers;
+
+	SceneEntity();
+	~SceneEntity();
+
+	void Clear();
+};
\ No newline at end of file
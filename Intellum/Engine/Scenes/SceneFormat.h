@@ -0,0 +1,185 @@
+#pragma once
+#include "../Objects/Components/IComponent.h"
+#include "../Objects/Storage/ComponentMask.h"
+
+// On-disk layout of a compiled scene. Every structure is plain data with 4 byte fields so a mapped file can be
+// read in place. Entities are grouped into sections by component mask, and each section stores one contiguous
+// array of records per component. Assets, texture lists, input bindings and text are shared tables that
+// records refer to by index or offset. Any change to these structures or to ComponentType must bump the version.
+const unsigned int SceneBlobMagic = 0x4E435349;
+const unsigned int SceneBlobVersion = 2;
+
+const unsigned int SceneNoAsset = 0xFFFFFFFF;
+
+enum SceneAssetType
+{
+	SCENE_ASSET_MODEL,
+	SCENE_ASSET_CUBE,
+	SCENE_ASSET_UI_QUAD,
+	SCENE_ASSET_GRID,
+	SCENE_ASSET_TEXTURE
+};
+
+enum SceneCommandType
+{
+	SCENE_COMMAND_NONE,
+	SCENE_COMMAND_EXIT_APPLICATION,
+	SCENE_COMMAND_TOGGLE_VISIBLE,
+	SCENE_COMMAND_TOGGLE_TRANSFORM
+};
+
+enum SceneObservable
+{
+	SCENE_OBSERVE_INPUT,
+	SCENE_OBSERVE_FRAMES_PER_SECOND,
+	SCENE_OBSERVE_CPU,
+	SCENE_OBSERVE_RENDER_COUNT,
+	SCENE_OBSERVE_CONSTANT_BYTES,
+	SCENE_OBSERVABLE_COUNT
+};
+
+struct SceneBlobHeader
+{
+	unsigned int Magic;
+	unsigned int Version;
+	unsigned int FileSize;
+
+	unsigned int AssetCount;
+	unsigned int AssetOffset;
+	unsigned int TextureListCount;
+	unsigned int TextureListOffset;
+	unsigned int BindingCount;
+	unsigned int BindingOffset;
+	unsigned int StringBytes;
+	unsigned int StringOffset;
+	unsigned int SectionCount;
+	unsigned int SectionOffset;
+};
+
+struct SceneAssetRecord
+{
+	unsigned int Type;
+	unsigned int PathOffset;
+	float Parameters[4];
+};
+
+struct SceneSectionRecord
+{
+	ComponentMask Mask;
+	unsigned int EntityCount;
+	unsigned int ObserverCount;
+	unsigned int ObserverOffset;
+	unsigned int ColumnOffsets[COMPONENT_TYPE_COUNT];
+};
+
+struct SceneObserverRecord
+{
+	unsigned int Row;
+	unsigned int Observable;
+	unsigned int Component;
+};
+
+struct SceneInputBindingRecord
+{
+	unsigned int Control;
+	unsigned int Command;
+	float Cooldown;
+};
+
+struct SceneAppearanceRecord
+{
+	unsigned int ShaderType;
+	unsigned int Model;
+	unsigned int FirstTexture;
+	unsigned int TextureCount;
+	unsigned int LightMap;
+	unsigned int BumpMap;
+	unsigned int ColorEnabled;
+	float Color[4];
+	unsigned int GradientEnabled;
+	float ApexColor[4];
+	float CenterColor[4];
+	float CenterYCordinates;
+	float Height;
+	unsigned int RenderEnabled;
+};
+
+struct SceneTransformRecord
+{
+	float Position[3];
+	float Rotation[3];
+	float Scale[3];
+	float Velocity[3];
+	float AngularVelocity[3];
+	unsigned int TransformEnabled;
+	unsigned int Simulation;
+};
+
+struct SceneRasterizerRecord
+{
+	unsigned int FillMode;
+	unsigned int CullMode;
+};
+
+struct SceneFrustrumCullingRecord
+{
+	unsigned int CullingType;
+};
+
+struct SceneUIRecord
+{
+	float BitmapSize[2];
+};
+
+struct SceneTextRecord
+{
+	unsigned int TextOffset;
+	unsigned int TextLength;
+	int FontSize;
+	float FontPosition[2];
+	float Color[4];
+};
+
+struct SceneButtonRecord
+{
+	unsigned int OnClickCommand;
+};
+
+struct SceneInputRecord
+{
+	unsigned int FirstBinding;
+	unsigned int BindingCount;
+};
+
+struct SceneCollisionRecord
+{
+	unsigned int CollisionType;
+	unsigned int OnCollisionCommand;
+};
+
+inline unsigned int SceneRecordSize(ComponentType component)
+{
+	switch (component)
+	{
+	case APPEARANCE:
+		return sizeof(SceneAppearanceRecord);
+	case TRANSFORM:
+		return sizeof(SceneTransformRecord);
+	case RASTERIZER:
+		return sizeof(SceneRasterizerRecord);
+	case FRUSTRUM_CULLING:
+		return sizeof(SceneFrustrumCullingRecord);
+	case USER_INTERFACE:
+		return sizeof(SceneUIRecord);
+	case TEXT:
+		return sizeof(SceneTextRecord);
+	case BUTTON:
+		return sizeof(SceneButtonRecord);
+	case INPUT_COMPONENT:
+		return sizeof(SceneInputRecord);
+	case COLLISION:
+		return sizeof(SceneCollisionRecord);
+	default:
+		return 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "SceneInstantiator.h"
+#include "../../ErrorHandling/Exception.h"
+
+SceneInstantiator::SceneInstantiator(EntityManager* entityManager, SceneContext context, vector<IObserver*>* observers) : _entityManager(entityManager), _factory(entityManager, context), _observers(observers)
+{
+}
+
+SceneInstantiator::~SceneInstantiator()
+{
+}
+
+void SceneInstantiator::Shutdown()
+{
+	_assets.clear();
+
+	for (Geometry& model : _models)
+		_factory.ReleaseModel(model);
+
+	_models.clear();
+
+	for (Texture* texture : _textures)
+		_factory.ReleaseTexture(texture);
+
+	_textures.clear();
+}
+
+void SceneInstantiator::BeginScene()
+{
+	_assets.clear();
+}
+
+unsigned int SceneInstantiator::AddAsset(SceneAssetType type, const string& path, float first, float second, float third, float fourth)
+{
+	SceneAsset asset;
+	asset.Type = type;
+	asset.Path = path;
+	asset.Parameters[0] = first;
+	asset.Parameters[1] = second;
+	asset.Parameters[2] = third;
+	asset.Parameters[3] = fourth;
+	asset.SharedModel = Geometry();
+	asset.SharedTexture = nullptr;
+
+	if (type == SCENE_ASSET_TEXTURE)
+	{
+		asset.SharedTexture = _factory.LoadTexture(path.c_str());
+		if (asset.SharedTexture != nullptr)
+			_textures.push_back(asset.SharedTexture);
+	}
+	else if (type != SCENE_ASSET_UI_QUAD)
+	{
+		asset.SharedModel = _factory.BuildModel(type, path.c_str(), asset.Parameters);
+		_models.push_back(asset.SharedModel);
+	}
+
+	_assets.push_back(asset);
+	return static_cast<unsigned int>(_assets.size()) - 1;
+}
+
+const SceneInstantiator::SceneAsset& SceneInstantiator::GetAsset(unsigned int asset) const
+{
+	if (asset >= _assets.size())
+		throw Exception("Asset " + to_string(asset) + " has not been added to the scene.");
+
+	return _assets[asset];
+}
+
+unsigned int SceneInstantiator::AddModel(const string& path)
+{
+	return AddAsset(SCENE_ASSET_MODEL, path, 0, 0, 0, 0);
+}
+
+unsigned int SceneInstantiator::AddCube()
+{
+	return AddAsset(SCENE_ASSET_CUBE, "", 0, 0, 0, 0);
+}
+
+unsigned int SceneInstantiator::AddUIQuad()
+{
+	return AddAsset(SCENE_ASSET_UI_QUAD, "", 0, 0, 0, 0);
+}
+
+unsigned int SceneInstantiator::AddGrid(float width, float height, float columns, float rows)
+{
+	return AddAsset(SCENE_ASSET_GRID, "", width, height, columns, rows);
+}
+
+unsigned int SceneInstantiator::AddTexture(const string& path)
+{
+	return AddAsset(SCENE_ASSET_TEXTURE, path, 0, 0, 0, 0);
+}
+
+void SceneInstantiator::AddEntity(const SceneEntity& sceneEntity)
+{
+	Geometry model = Geometry();
+	vector<Texture*> textures;
+	Texture* lightMap = nullptr;
+	Texture* bumpMap = nullptr;
+
+	// Everything that can fail is resolved before the entity exists, so a bad reference never leaves a half
+	// built entity behind
+	if (MaskContains(sceneEntity.Mask, MaskOf(APPEARANCE)))
+	{
+		if (sceneEntity.Appearance.Model != SceneNoAsset)
+		{
+			const SceneAsset& asset = GetAsset(sceneEntity.Appearance.Model);
+			if (asset.Type == SCENE_ASSET_TEXTURE)
+				throw Exception("Asset " + to_string(sceneEntity.Appearance.Model) + " is a texture, not a model.");
+
+			if (asset.Type == SCENE_ASSET_UI_QUAD)
+			{
+				model = _factory.BuildModel(asset.Type, asset.Path.c_str(), asset.Parameters);
+				_models.push_back(model);
+			}
+			else
+				model = asset.SharedModel;
+		}
+
+		for (unsigned int texture : sceneEntity.Textures)
+		{
+			const SceneAsset& asset = GetAsset(texture);
+			if (asset.Type != SCENE_ASSET_TEXTURE)
+				throw Exception("Asset " + to_string(texture) + " is not a texture.");
+
+			if (asset.SharedTexture != nullptr)
+				textures.push_back(asset.SharedTexture);
+		}
+
+		if (sceneEntity.Appearance.LightMap != SceneNoAsset)
+			lightMap = GetAsset(sceneEntity.Appearance.LightMap).SharedTexture;
+
+		if (sceneEntity.Appearance.BumpMap != SceneNoAsset)
+			bumpMap = GetAsset(sceneEntity.Appearance.BumpMap).SharedTexture;
+	}
+
+	Entity* entity = _entityManager->CreateEntity();
+	EntityHandle handle = entity->GetHandle();
+
+	if (MaskContains(sceneEntity.Mask, MaskOf(APPEARANCE)))
+		entity->AddComponent(_factory.CreateAppearance(sceneEntity.Appearance, model, textures, lightMap, bumpMap));
+
+	if (MaskContains(sceneEntity.Mask, MaskOf(TRANSFORM)))
+		entity->AddComponent(SceneComponentFactory::CreateTransform(sceneEntity.Transform));
+
+	if (MaskContains(sceneEntity.Mask, MaskOf(RASTERIZER)))
+		entity->AddComponent(SceneComponentFactory::CreateRasterizer(sceneEntity.Rasterizer));
+
+	if (MaskContains(sceneEntity.Mask, MaskOf(FRUSTRUM_CULLING)))
+		entity->AddComponent(SceneComponentFactory::CreateFrustrumCulling(sceneEntity.FrustrumCulling));
+
+	if (MaskContains(sceneEntity.Mask, MaskOf(USER_INTERFACE)))
+		entity->AddComponent(SceneComponentFactory::CreateUserInterface(sceneEntity.UserInterface));
+
+	if (MaskContains(sceneEntity.Mask, MaskOf(TEXT)))
+	{
+		SceneTextRecord text = sceneEntity.Text;
+		text.TextLength = static_cast<unsigned int>(sceneEntity.TextString.size());
+		entity->AddComponent(SceneComponentFactory::CreateText(text, sceneEntity.TextString.data()));
+	}
+
+	if (MaskContains(sceneEntity.Mask, MaskOf(BUTTON)))
+		entity->AddComponent(_factory.CreateButton(sceneEntity.Button, handle));
+
+	if (MaskContains(sceneEntity.Mask, MaskOf(INPUT_COMPONENT)))
+		entity->AddComponent(_factory.CreateInput(sceneEntity.Bindings.data(), static_cast<unsigned int>(sceneEntity.Bindings.size()), handle));
+
+	if (MaskContains(sceneEntity.Mask, MaskOf(COLLISION)))
+		entity->AddComponent(_factory.CreateCollision(sceneEntity.Collision, handle));
+
+	for (const SceneEntityObserver& sceneObserver : sceneEntity.Observers)
+	{
+		IObserver* observer = _factory.CreateObserver(sceneObserver.Observable, sceneObserver.Component, handle);
+		if (observer != nullptr)
+			_observers->push_back(observer);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include "ISceneBuilder.h"
+#include "SceneComponentFactory.h"
+#include "../Objects/Entity.h"
+#include "../Objects/EntityManager.h"
+
+using namespace std;
+
+// Creates each entity it is given straight away through the same CreateEntity and AddComponent calls the rest
+// of the engine uses. Assets are created as they are added and held by the instantiator until shutdown, while
+// the ids it hands out only last until the next BeginScene.
+class SceneInstantiator : public ISceneBuilder
+{
+private:
+	struct SceneAsset
+	{
+		unsigned int Type;
+		string Path;
+		float Parameters[4];
+		Geometry SharedModel;
+		Texture* SharedTexture;
+	};
+
+	EntityManager* _entityManager;
+	SceneComponentFactory _factory;
+	vector<IObserver*>* _observers;
+
+	vector<SceneAsset> _assets;
+	vector<Geometry> _models;
+	vector<Texture*> _textures;
+
+	unsigned int AddAsset(SceneAssetType type, const string& path, float first, float second, float third, float fourth);
+	const SceneAsset& GetAsset(unsigned int asset) const;
+
+public:
+	SceneInstantiator(EntityManager* entityManager, SceneContext context, vector<IObserver*>* observers);
+	~SceneInstantiator() override;
+
+	void Shutdown();
+
+	void BeginScene();
+
+	unsigned int AddModel(const string& path) override;
+	unsigned int AddCube() override;
+	unsigned int AddUIQuad() override;
+	unsigned int AddGrid(float width, float height, float columns, float rows) override;
+	unsigned int AddTexture(const string& path) override;
+
+	void AddEntity(const SceneEntity& entity) override;
+};
\ No newline at end of file
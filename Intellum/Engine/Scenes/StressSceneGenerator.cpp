@@ -0,0 +1,220 @@
+#include "StressSceneGenerator.h"
+#include "../Objects/Components/TransformComponent.h"
+#include "../Objects/Components/AppearanceComponent.h"
+#include "../Objects/Components/FurstrumCullingComponent.h"
+#include "../Objects/Components/InputComponent.h"
+#include "../Objects/Components/TextComponent.h"
+#include "../Objects/Components/UIComponent.h"
+#include "../Objects/Components/ButtonComponent.h"
+#include "../Objects/Components/CollisionComponent.h"
+#include "../Objects/Commands/ToggleTransformCommand.h"
+#include "../Objects/Commands/ToggleVisibleCommand.h"
+
+StressSceneGenerator::StressSceneGenerator(EntityManager* entityManager, GeometryBuilder* geometryBuilder) : _entityManager(entityManager), _geometryBuilder(geometryBuilder)
+{
+}
+
+StressSceneGenerator::~StressSceneGenerator()
+{
+}
+
+void StressSceneGenerator::Generate(const StressSceneDescription& description)
+{
+	_random.seed(description.Seed);
+
+	Geometry cube = HeadlessModel(XMFLOAT3(1.0f, 1.0f, 1.0f));
+	Geometry sphere = cube;
+
+	if (_geometryBuilder != nullptr)
+	{
+		cube = _geometryBuilder->Cube();
+		sphere = _geometryBuilder->FromFile("Content/Models/sphere.obj");
+	}
+
+	for (int i = 0; i < description.CubeCount; i++)
+	{
+		Entity* parent = CreateMovingEntity(cube, FRUSTRUM_CULL_SQUARE);
+
+		for (int turret = 0; turret < description.TurretsPerCube; turret++)
+			CreateTurret(cube, parent, turret);
+	}
+
+	for (int i = 0; i < description.SphereCount; i++)
+		CreateMovingEntity(sphere, FRUSTRUM_CULL_SPHERE);
+
+	for (int i = 0; i < description.StaticCount; i++)
+		CreateStaticEntity(cube);
+
+	for (int i = 0; i < description.TextLabelCount; i++)
+		CreateTextLabel(i);
+
+	for (int i = 0; i < description.ButtonCount; i++)
+		CreateButton(i);
+
+	if (description.ButtonCount > 0)
+		CreateCursor();
+}
+
+float StressSceneGenerator::RandomRange(float minimum, float maximum)
+{
+	uniform_real_distribution<float> distribution(minimum, maximum);
+	return distribution(_random);
+}
+
+// UI models own a dynamic vertex buffer that UISystem rewrites per element, so unlike the 3D models they are
+// never shared between entities.
+Geometry StressSceneGenerator::BuildUIModel() const
+{
+	if (_geometryBuilder == nullptr)
+		return HeadlessModel(XMFLOAT3(1.0f, 1.0f, 0.0f));
+
+	return _geometryBuilder->ForUI();
+}
+
+Geometry StressSceneGenerator::HeadlessModel(XMFLOAT3 size)
+{
+	Geometry model = Geometry();
+	model.Size = size;
+	return model;
+}
+
+Entity* StressSceneGenerator::CreateMovingEntity(Geometry model, FrustrumCullingType cullingType)
+{
+	Entity* entity = _entityManager->CreateEntity();
+
+	TransformComponent transform;
+	transform.Position = XMFLOAT3(RandomRange(-500.0f, 500.0f), RandomRange(0.0f, 50.0f), RandomRange(-500.0f, 500.0f));
+	transform.Velocity = XMFLOAT3(RandomRange(-2.0f, 2.0f), RandomRange(-0.5f, 0.5f), RandomRange(-2.0f, 2.0f));
+	transform.AngularVelocity = XMFLOAT3(0.0f, RandomRange(-2.5f, 2.5f) * XM_PI, 0.0f);
+	entity->AddComponent(transform);
+
+	AppearanceComponent appearance;
+	appearance.Model = model;
+	entity->AddComponent(appearance);
+
+	InputComponent input;
+	ControlCommand control;
+	control.Control = ESCAPE;
+	control.Command = new ToggleTransformCommand(_entityManager, entity->GetHandle());
+	control.Cooldown = 0.2f;
+	control.CurrentCooldown = 0.0f;
+	input.ControlCommands.push_back(control);
+	entity->AddComponent(input);
+
+	FrustrumCullingComponent frustrum;
+	frustrum.CullingType = cullingType;
+	entity->AddComponent(frustrum);
+
+	return entity;
+}
+
+// Turrets never move by themselves, they only follow the cube they are mounted on
+void StressSceneGenerator::CreateTurret(Geometry model, Entity* parent, int index)
+{
+	Entity* entity = _entityManager->CreateEntity();
+
+	TransformComponent transform;
+	transform.Position = XMFLOAT3(0.0f, 0.6f + index * 0.3f, 0.5f);
+	transform.Scale = XMFLOAT3(0.2f, 0.2f, 1.0f);
+	transform.SetParent(parent->GetHandle());
+	entity->AddComponent(transform);
+
+	AppearanceComponent appearance;
+	appearance.Model = model;
+	entity->AddComponent(appearance);
+
+	FrustrumCullingComponent frustrum;
+	frustrum.CullingType = FRUSTRUM_CULL_SQUARE;
+	entity->AddComponent(frustrum);
+}
+
+void StressSceneGenerator::CreateStaticEntity(Geometry model)
+{
+	Entity* entity = _entityManager->CreateEntity();
+
+	TransformComponent transform;
+	transform.Position = XMFLOAT3(RandomRange(-500.0f, 500.0f), 0.0f, RandomRange(-500.0f, 500.0f));
+	transform.Rotation = XMFLOAT3(0.0f, RandomRange(0.0f, XM_2PI), 0.0f);
+	transform.Simulation = SIMULATION_STATIC;
+	entity->AddComponent(transform);
+
+	AppearanceComponent appearance;
+	appearance.Model = model;
+	entity->AddComponent(appearance);
+
+	FrustrumCullingComponent frustrum;
+	frustrum.CullingType = FRUSTRUM_CULL_SQUARE;
+	entity->AddComponent(frustrum);
+}
+
+void StressSceneGenerator::CreateTextLabel(int index)
+{
+	Entity* entity = _entityManager->CreateEntity();
+
+	TextComponent text;
+	text.Text = "Label " + to_string(index);
+	text.FontSize = 20;
+	text.FontPosition = XMFLOAT2(RandomRange(0.0f, 1000.0f), RandomRange(0.0f, 700.0f));
+	text.Color = XMFLOAT4(0.6f, 0.0f, 0.6f, 1.0f);
+	entity->AddComponent(text);
+}
+
+void StressSceneGenerator::CreateButton(int index)
+{
+	Entity* entity = _entityManager->CreateEntity();
+
+	AppearanceComponent appearance;
+	appearance.ShaderType = SHADER_UI;
+	appearance.Model = BuildUIModel();
+	appearance.Color = ColorShaderParameters(XMFLOAT4(0.4f, 0.4f, 0.4f, 1.0f));
+	entity->AddComponent(appearance);
+
+	TransformComponent transform;
+	transform.Position = XMFLOAT3(static_cast<float>((index % 10) * 175), static_cast<float>((index / 10) * 35), 1.0f);
+	entity->AddComponent(transform);
+
+	UIComponent ui;
+	ui.BitmapSize = XMFLOAT2(170, 30);
+	entity->AddComponent(ui);
+
+	TextComponent text;
+	text.Text = "Button " + to_string(index);
+	text.FontSize = 20;
+	text.FontPosition = XMFLOAT2(0, 3);
+	text.Color = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+	entity->AddComponent(text);
+
+	entity->AddComponent(ButtonComponent());
+
+	InputComponent input;
+	ControlCommand control;
+	control.Control = ESCAPE;
+	control.Command = new ToggleVisibleCommand(_entityManager, entity->GetHandle());
+	control.Cooldown = 0.2f;
+	control.CurrentCooldown = 0.0f;
+	input.ControlCommands.push_back(control);
+	entity->AddComponent(input);
+}
+
+void StressSceneGenerator::CreateCursor()
+{
+	Entity* cursor = _entityManager->CreateEntity();
+
+	AppearanceComponent appearance;
+	appearance.ShaderType = SHADER_UI;
+	appearance.Model = BuildUIModel();
+	cursor->AddComponent(appearance);
+
+	TransformComponent transform;
+	transform.Position = XMFLOAT3(400, 400, 0);
+	transform.TransformEnabled = false;
+	cursor->AddComponent(transform);
+
+	UIComponent ui;
+	ui.BitmapSize = XMFLOAT2(24, 24);
+	cursor->AddComponent(ui);
+
+	CollisionComponent collision;
+	collision.CollisionType = CURSOR;
+	cursor->AddComponent(collision);
+}
\ No newline at end of file
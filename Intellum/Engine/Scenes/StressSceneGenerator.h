@@ -0,0 +1,48 @@
+#pragma once
+#include <random>
+#include "../Objects/EntityManager.h"
+#include "../Objects/Entity.h"
+#include "../Objects/Geometry/GeometryBuilder.h"
+#include "../Camera/FrustrumCullingType.h"
+
+using namespace std;
+
+struct StressSceneDescription
+{
+	int CubeCount;
+	int SphereCount;
+	int TurretsPerCube;
+	int StaticCount;
+	int TextLabelCount;
+	int ButtonCount;
+	unsigned int Seed;
+
+	StressSceneDescription() : CubeCount(1000), SphereCount(1000), TurretsPerCube(1), StaticCount(1000), TextLabelCount(100), ButtonCount(100), Seed(1) {}
+};
+
+// Fills an EntityManager with a parameterised scene for measuring how the engine scales. Passing a null
+// GeometryBuilder leaves every model empty, so the scene can be built and updated without a device.
+class StressSceneGenerator
+{
+private:
+	EntityManager* _entityManager;
+	GeometryBuilder* _geometryBuilder;
+	mt19937 _random;
+
+	float RandomRange(float minimum, float maximum);
+	Geometry BuildUIModel() const;
+	static Geometry HeadlessModel(XMFLOAT3 size);
+
+	Entity* CreateMovingEntity(Geometry model, FrustrumCullingType cullingType);
+	void CreateTurret(Geometry model, Entity* parent, int index);
+	void CreateStaticEntity(Geometry model);
+	void CreateTextLabel(int index);
+	void CreateButton(int index);
+	void CreateCursor();
+
+public:
+	StressSceneGenerator(EntityManager* entityManager, GeometryBuilder* geometryBuilder);
+	~StressSceneGenerator();
+
+	void Generate(const StressSceneDescription& description);
+};
\ No newline at end of file
@@ -28,16 +28,23 @@ void CameraBuffer::Initialise()
 	if (FAILED(result)) throw Exception("Failed to create the buffer for the camera description");
 }
 
-void CameraBuffer::SetShaderParameters(int bufferIndex, ShaderResources shaderResources)
+void CameraBuffer::SetShaderParameters(int bufferIndex, const ShaderResources& shaderResources)
 {
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
 	HRESULT result = _direct3D->GetDeviceContext()->Map(_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
 	if (FAILED(result)) throw Exception("Failed to map camera buffer to the Device Context.");
 
 	Buffer* cameraDataPtr = static_cast<Buffer*>(mappedResource.pData);
+	cameraDataPtr->view = XMMatrixTranspose(shaderResources.MatrixParameters.ViewMatrix);
+	cameraDataPtr->projection = XMMatrixTranspose(shaderResources.MatrixParameters.ProjectionMatrix);
 	cameraDataPtr->cameraPosition = _camera->GetTransform()->GetPosition();
 	cameraDataPtr->padding = 0.0f;
 
 	_direct3D->GetDeviceContext()->Unmap(_buffer, 0);
 	_direct3D->GetDeviceContext()->VSSetConstantBuffers(bufferIndex, 1, &_buffer);
+}
+
+int CameraBuffer::GetSize() const
+{
+	return sizeof(Buffer);
 }
\ No newline at end of file
@@ -10,6 +10,8 @@ class CameraBuffer : public IShaderBuffer
 private:
 	struct Buffer
 	{
+		XMMATRIX view;
+		XMMATRIX projection;
 		XMFLOAT3 cameraPosition;
 		float padding;
 	};
@@ -25,5 +27,6 @@ public:
 	
 	void Shutdown() override;
 
-	void SetShaderParameters(int bufferIndex, ShaderResources shaderResources) override;
+	void SetShaderParameters(int bufferIndex, const ShaderResources& shaderResources) override;
+	int GetSize() const override;
 };
\ No newline at end of file
@@ -28,7 +28,7 @@ void ColorOverrideBuffer::Initialise()
 	if (FAILED(result)) throw Exception("Failed to create the buffer for the color description");
 }
 
-void ColorOverrideBuffer::SetShaderParameters(int bufferIndex, ShaderResources shaderResources)
+void ColorOverrideBuffer::SetShaderParameters(int bufferIndex, const ShaderResources& shaderResources)
 {
 	ColorShaderParameters colorOverload = shaderResources.ColorParameters;
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
@@ -47,4 +47,9 @@ void ColorOverrideBuffer::SetShaderParameters(int bufferIndex, ShaderResources s
 
 	_direct3D->GetDeviceContext()->Unmap(_buffer, 0);
 	_direct3D->GetDeviceContext()->PSSetConstantBuffers(bufferIndex, 1, &_buffer);
+}
+
+int ColorOverrideBuffer::GetSize() const
+{
+	return sizeof(Buffer);
 }
\ No newline at end of file
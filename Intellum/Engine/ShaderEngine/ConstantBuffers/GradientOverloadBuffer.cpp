@@ -28,7 +28,7 @@ void GradientOverloadBuffer::Initialise()
 	if (FAILED(result)) throw Exception("Failed to create the buffer for the gradient description");
 }
 
-void GradientOverloadBuffer::SetShaderParameters(int bufferIndex, ShaderResources shaderResources)
+void GradientOverloadBuffer::SetShaderParameters(int bufferIndex, const ShaderResources& shaderResources)
 {
 	GradientShaderParameters gradientOverload = shaderResources.GradientParameters;
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
@@ -49,4 +49,9 @@ void GradientOverloadBuffer::SetShaderParameters(int bufferIndex, ShaderResource
 
 	_direct3D->GetDeviceContext()->Unmap(_buffer, 0);
 	_direct3D->GetDeviceContext()->PSSetConstantBuffers(bufferIndex, 1, &_buffer);
+}
+
+int GradientOverloadBuffer::GetSize() const
+{
+	return sizeof(Buffer);
 }
\ No newline at end of file
@@ -23,5 +23,6 @@ public:
 	~GradientOverloadBuffer() override = default;
 	void Shutdown() override;
 
-	void SetShaderParameters(int bufferIndex, ShaderResources shaderResources) override;
+	void SetShaderParameters(int bufferIndex, const ShaderResources& shaderResources) override;
+	int GetSize() const override;
 };
@@ -15,5 +15,6 @@ public:
 	virtual void Initialise() = 0;
 	virtual void Shutdown() = 0;
 
-	virtual void SetShaderParameters(int bufferIndex, ShaderResources shaderResources) = 0;
+	virtual void SetShaderParameters(int bufferIndex, const ShaderResources& shaderResources) = 0;
+	virtual int GetSize() const = 0;
 };
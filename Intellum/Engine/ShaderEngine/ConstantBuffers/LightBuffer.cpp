@@ -28,7 +28,9 @@ void LightBuffer::Initialise()
 	if (FAILED(result)) throw Exception("Failed to create the buffer for the light description");
 }
 
-void LightBuffer::SetShaderParameters(int bufferIndex, ShaderResources shaderResources)
+// Written once per frame. Light::GetDirection only reads the projective column of the object matrix, which is zero for
+// every affine world matrix, so the identity gives the same direction for all objects.
+void LightBuffer::SetShaderParameters(int bufferIndex, const ShaderResources& shaderResources)
 {
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
 	HRESULT result = _direct3D->GetDeviceContext()->Map(_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
@@ -40,11 +42,16 @@ void LightBuffer::SetShaderParameters(int bufferIndex, ShaderResources shaderRes
 	{
 		lightDataPtr->ambientColor = _light->AmbientColor;
 		lightDataPtr->diffuseColor = _light->DiffuseColor;
-		lightDataPtr->lightDirection = _light->GetDirection(shaderResources.MatrixParameters.WorldMatrix);
+		lightDataPtr->lightDirection = _light->GetDirection(XMMatrixIdentity());
 		lightDataPtr->specularColor = _light->SpecularColor;
 		lightDataPtr->specularPower = _light->SpecularPower;
 	}
 
 	_direct3D->GetDeviceContext()->Unmap(_buffer, 0);
 	_direct3D->GetDeviceContext()->PSSetConstantBuffers(bufferIndex, 1, &_buffer);
+}
+
+int LightBuffer::GetSize() const
+{
+	return sizeof(Buffer);
 }
\ No newline at end of file
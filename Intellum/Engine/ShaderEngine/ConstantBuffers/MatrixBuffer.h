@@ -10,8 +10,6 @@ private:
 	struct ConstantBuffer
 	{
 		XMMATRIX world;
-		XMMATRIX view;
-		XMMATRIX projection;
 	};
 
 	ID3D11Buffer* _buffer;
@@ -25,6 +23,7 @@ public:
 	
 	void Shutdown() override;
 
-	void SetShaderParameters(int bufferIndex, ShaderResources shaderResources) override;
+	void SetShaderParameters(int bufferIndex, const ShaderResources& shaderResources) override;
+	int GetSize() const override;
 };
 
@@ -28,16 +28,16 @@ void TextureBuffer::Initialise()
 	if (FAILED(result)) throw Exception("Failed to create the buffer for the texture description");
 }
 
-void TextureBuffer::SetShaderParameters(int bufferIndex, ShaderResources shaderResources)
+void TextureBuffer::SetShaderParameters(int bufferIndex, const ShaderResources& shaderResources)
 {
-	TextureShaderParameters textureParameters = shaderResources.TextureParameters;
+	const TextureShaderParameters& textureParameters = shaderResources.TextureParameters;
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
 	HRESULT result = _direct3D->GetDeviceContext()->Map(_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
 	if (FAILED(result)) throw Exception("Failed to map texture buffer to the Device Context.");
 
 	Buffer* textureData = static_cast<Buffer*>(mappedResource.pData);
 
-	textureData->texturesIncluded = static_cast<float>(textureParameters.TextureArray.size());
+	textureData->texturesIncluded = static_cast<float>(textureParameters.TextureCount);
 
 	if (textureParameters.LightMapEnabled)
 		textureData->lightMapEnabled = 1.0f;
@@ -51,4 +51,9 @@ void TextureBuffer::SetShaderParameters(int bufferIndex, ShaderResources shaderR
 
 	_direct3D->GetDeviceContext()->Unmap(_buffer, 0);
 	_direct3D->GetDeviceContext()->PSSetConstantBuffers(bufferIndex, 1, &_buffer);
+}
+
+int TextureBuffer::GetSize() const
+{
+	return sizeof(Buffer);
 }
\ No newline at end of file
@@ -25,5 +25,6 @@ public:
 
 	void Shutdown() override;
 
-	void SetShaderParameters(int bufferIndex, ShaderResources shaderResources) override;
+	void SetShaderParameters(int bufferIndex, const ShaderResources& shaderResources) override;
+	int GetSize() const override;
 };
\ No newline at end of file
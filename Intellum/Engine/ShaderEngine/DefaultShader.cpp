@@ -14,114 +14,160 @@ void DefaultShader::Initialise(HWND hwnd)
 	InitialiseShader(hwnd, L"Content/Shaders/VertexShader.hlsl", L"Content/Shaders/PixelShader.hlsl");
 }
 
-void DefaultShader::InitialiseShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
+void DefaultShader::CompileShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
 {
-	try
-	{
-		ID3D10Blob* errorMessage = nullptr;
+	ID3D10Blob* errorMessage = nullptr;
 
-		ID3D10Blob* vertexShaderBuffer = nullptr;
-		HRESULT result = D3DCompileFromFile(vsFilename, nullptr, nullptr, "DefaultVertexShader", "vs_5_0", D3D10_SHADER_DEBUG /*D3D10_SHADER_ENABLE_STRICTNESS*/, 0, &vertexShaderBuffer, &errorMessage);
-		if (FAILED(result))
+	ID3D10Blob* vertexShaderBuffer = nullptr;
+	HRESULT result = D3DCompileFromFile(vsFilename, nullptr, nullptr, "DefaultVertexShader", "vs_5_0", D3D10_SHADER_DEBUG /*D3D10_SHADER_ENABLE_STRICTNESS*/, 0, &vertexShaderBuffer, &errorMessage);
+	if (FAILED(result))
+	{
+		if (errorMessage)
 		{
-			if (errorMessage)
-			{
-				OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
-			}
-			else
-			{
-				MessageBox(hwnd, vsFilename, L"Missing Vertex Shader File", MB_OK);
-			}
-
-			throw Exception("Vertex Shader file missing");
+			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
 		}
+		else
+		{
+			MessageBox(hwnd, vsFilename, L"Missing Vertex Shader File", MB_OK);
+		}
+
+		throw Exception("Vertex Shader file missing");
+	}
 
-		ID3D10Blob* pixelShaderBuffer = nullptr;
-		result = D3DCompileFromFile(psFilename, nullptr, nullptr, "DefaultPixelShader", "ps_5_0", D3D10_SHADER_DEBUG/*D3D10_SHADER_ENABLE_STRICTNESS*/, 0, &pixelShaderBuffer, &errorMessage);
+	ID3D10Blob* pixelShaderBuffer = nullptr;
+	result = D3DCompileFromFile(psFilename, nullptr, nullptr, "DefaultPixelShader", "ps_5_0", D3D10_SHADER_DEBUG/*D3D10_SHADER_ENABLE_STRICTNESS*/, 0, &pixelShaderBuffer, &errorMessage);
 
-		if (FAILED(result))
+	if (FAILED(result))
+	{
+		if (errorMessage)
 		{
-			if (errorMessage)
-			{
-				OutputShaderErrorMessage(errorMessage, hwnd, psFilename);
-			}
-			else
-			{
-				MessageBox(hwnd, psFilename, L"Missing Pixel Shader File", MB_OK);
-			}
-
-			throw Exception("Pixel Shader file missing");
+			OutputShaderErrorMessage(errorMessage, hwnd, psFilename);
 		}
+		else
+		{
+			MessageBox(hwnd, psFilename, L"Missing Pixel Shader File", MB_OK);
+		}
+
+		throw Exception("Pixel Shader file missing");
+	}
+
+	// Create Vertex Shader from the buffer
+	result = _direct3D->GetDevice()->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), nullptr, &_vertexShader);
+	if (FAILED(result)) throw Exception("Failed to create the vertex shader");
+
+	// Create Pixel Shader from the buffer
+	result = _direct3D->GetDevice()->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), nullptr, &_pixelShader);
+	if (FAILED(result)) throw Exception("Failed to create the pixel shader");
+
+	// Vertex Shader layout description
+	// The setup below NEEDS to match the VertexType structure defined in the shader file, otherwise the bytes of data become missalligned / errors occur
+	D3D11_INPUT_ELEMENT_DESC polygonLayout[6];
+	polygonLayout[0].SemanticName = "POSITION";
+	polygonLayout[0].SemanticIndex = 0;
+	polygonLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	polygonLayout[0].InputSlot = 0;
+	polygonLayout[0].AlignedByteOffset = 0;
+	polygonLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[0].InstanceDataStepRate = 0;
+
+	polygonLayout[1].SemanticName = "WORLDPOSITION";
+	polygonLayout[1].SemanticIndex = 0;
+	polygonLayout[1].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	polygonLayout[1].InputSlot = 0;
+	polygonLayout[1].AlignedByteOffset = 0;
+	polygonLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[1].InstanceDataStepRate = 0;
+
+	polygonLayout[2].SemanticName = "TEXCOORD";
+	polygonLayout[2].SemanticIndex = 0;
+	polygonLayout[2].Format = DXGI_FORMAT_R32G32_FLOAT;
+	polygonLayout[2].InputSlot = 0;
+	polygonLayout[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	polygonLayout[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[2].InstanceDataStepRate = 0;
+
+	polygonLayout[3].SemanticName = "NORMAL";
+	polygonLayout[3].SemanticIndex = 0;
+	polygonLayout[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	polygonLayout[3].InputSlot = 0;
+	polygonLayout[3].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	polygonLayout[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[3].InstanceDataStepRate = 0;
+
+	polygonLayout[4].SemanticName = "TANGENT";
+	polygonLayout[4].SemanticIndex = 0;
+	polygonLayout[4].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	polygonLayout[4].InputSlot = 0;
+	polygonLayout[4].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	polygonLayout[4].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[4].InstanceDataStepRate = 0;
+
+	polygonLayout[5].SemanticName = "BINORMAL";
+	polygonLayout[5].SemanticIndex = 0;
+	polygonLayout[5].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	polygonLayout[5].InputSlot = 0;
+	polygonLayout[5].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	polygonLayout[5].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[5].InstanceDataStepRate = 0;
+
+	unsigned int numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
+
+	result = _direct3D->GetDevice()->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &_layout);
+	if (FAILED(result)) throw Exception("Failed to create the input layout");
+
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = nullptr;
+
+	// The instanced vertex shader reads the world matrix and color of each instance from a second vertex stream
+	ID3D10Blob* instancedShaderBuffer = nullptr;
+	result = D3DCompileFromFile(vsFilename, nullptr, nullptr, "InstancedVertexShader", "vs_5_0", D3D10_SHADER_DEBUG, 0, &instancedShaderBuffer, &errorMessage);
+	if (FAILED(result))
+	{
+		if (errorMessage)
+			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
+
+		throw Exception("Failed to compile the instanced vertex shader");
+	}
 
-		// Create Vertex Shader from the buffer
-		result = _direct3D->GetDevice()->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), nullptr, &_vertexShader);
-		if (FAILED(result)) throw Exception("Failed to create the vertex shader");
-
-		// Create Pixel Shader from the buffer
-		result = _direct3D->GetDevice()->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), nullptr, &_pixelShader);
-		if (FAILED(result)) throw Exception("Failed to create the pixel shader");
-
-		// Vertex Shader layout description
-		// The setup below NEEDS to match the VertexType structure defined in the shader file, otherwise the bytes of data become missalligned / errors occur
-		D3D11_INPUT_ELEMENT_DESC polygonLayout[6];
-		polygonLayout[0].SemanticName = "POSITION";
-		polygonLayout[0].SemanticIndex = 0;
-		polygonLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		polygonLayout[0].InputSlot = 0;
-		polygonLayout[0].AlignedByteOffset = 0;
-		polygonLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-		polygonLayout[0].InstanceDataStepRate = 0;
-
-		polygonLayout[1].SemanticName = "WORLDPOSITION";
-		polygonLayout[1].SemanticIndex = 0;
-		polygonLayout[1].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		polygonLayout[1].InputSlot = 0;
-		polygonLayout[1].AlignedByteOffset = 0;
-		polygonLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-		polygonLayout[1].InstanceDataStepRate = 0;
-
-		polygonLayout[2].SemanticName = "TEXCOORD";
-		polygonLayout[2].SemanticIndex = 0;
-		polygonLayout[2].Format = DXGI_FORMAT_R32G32_FLOAT;
-		polygonLayout[2].InputSlot = 0;
-		polygonLayout[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-		polygonLayout[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-		polygonLayout[2].InstanceDataStepRate = 0;
-
-		polygonLayout[3].SemanticName = "NORMAL";
-		polygonLayout[3].SemanticIndex = 0;
-		polygonLayout[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		polygonLayout[3].InputSlot = 0;
-		polygonLayout[3].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-		polygonLayout[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-		polygonLayout[3].InstanceDataStepRate = 0;
-
-		polygonLayout[4].SemanticName = "TANGENT";
-		polygonLayout[4].SemanticIndex = 0;
-		polygonLayout[4].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		polygonLayout[4].InputSlot = 0;
-		polygonLayout[4].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-		polygonLayout[4].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-		polygonLayout[4].InstanceDataStepRate = 0;
-
-		polygonLayout[5].SemanticName = "BINORMAL";
-		polygonLayout[5].SemanticIndex = 0;
-		polygonLayout[5].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		polygonLayout[5].InputSlot = 0;
-		polygonLayout[5].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-		polygonLayout[5].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-		polygonLayout[5].InstanceDataStepRate = 0;
-
-		unsigned int numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
-
-		result = _direct3D->GetDevice()->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &_layout);
-		if (FAILED(result)) throw Exception("Failed to create the input layout");
-
-		vertexShaderBuffer->Release();
-		vertexShaderBuffer = nullptr;
-
-		pixelShaderBuffer->Release();
-		pixelShaderBuffer = nullptr;
+	result = _direct3D->GetDevice()->CreateVertexShader(instancedShaderBuffer->GetBufferPointer(), instancedShaderBuffer->GetBufferSize(), nullptr, &_instancedVertexShader);
+	if (FAILED(result)) throw Exception("Failed to create the instanced vertex shader");
+
+	const char* instanceSemantics[] = { "INSTANCE_WORLD", "INSTANCE_WORLD", "INSTANCE_WORLD", "INSTANCE_WORLD", "INSTANCE_COLOR", "INSTANCE_COLOR_ENABLED" };
+	const DXGI_FORMAT instanceFormats[] = { DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_R32_FLOAT };
+	const unsigned int instanceSemanticIndices[] = { 0, 1, 2, 3, 0, 0 };
+
+	D3D11_INPUT_ELEMENT_DESC instancedLayout[12];
+	for (unsigned int i = 0; i < numElements; i++)
+		instancedLayout[i] = polygonLayout[i];
+
+	for (unsigned int i = 0; i < 6; i++)
+	{
+		instancedLayout[numElements + i].SemanticName = instanceSemantics[i];
+		instancedLayout[numElements + i].SemanticIndex = instanceSemanticIndices[i];
+		instancedLayout[numElements + i].Format = instanceFormats[i];
+		instancedLayout[numElements + i].InputSlot = 1;
+		instancedLayout[numElements + i].AlignedByteOffset = i == 0 ? 0 : D3D11_APPEND_ALIGNED_ELEMENT;
+		instancedLayout[numElements + i].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+		instancedLayout[numElements + i].InstanceDataStepRate = 1;
+	}
+
+	result = _direct3D->GetDevice()->CreateInputLayout(instancedLayout, numElements + 6, instancedShaderBuffer->GetBufferPointer(), instancedShaderBuffer->GetBufferSize(), &_instancedLayout);
+	if (FAILED(result)) throw Exception("Failed to create the instanced input layout");
+
+	instancedShaderBuffer->Release();
+	instancedShaderBuffer = nullptr;
+
+	pixelShaderBuffer->Release();
+	pixelShaderBuffer = nullptr;
+}
+
+void DefaultShader::InitialiseShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
+{
+	try
+	{
+		_vertexShaderFile = vsFilename;
+		_pixelShaderFile = psFilename;
+		CompileShader(hwnd, vsFilename, psFilename);
 
 		_matrixBuffer = new MatrixBuffer(_direct3D);
 		_cameraBuffer = new CameraBuffer(_direct3D, _camera);
@@ -146,7 +192,7 @@ void DefaultShader::InitialiseShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFile
 		samplerDesc.MinLOD = 0;
 		samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
 
-		result = _direct3D->GetDevice()->CreateSamplerState(&samplerDesc, &_sampleState);
+		HRESULT result = _direct3D->GetDevice()->CreateSamplerState(&samplerDesc, &_sampleState);
 		if (FAILED(result)) throw Exception("Failed to create the sampler state");
 	}
 	catch(Exception& exception)
@@ -188,6 +234,18 @@ void DefaultShader::Shutdown()
 		_layout = nullptr;
 	}
 
+	if (_instancedLayout)
+	{
+		_instancedLayout->Release();
+		_instancedLayout = nullptr;
+	}
+
+	if (_instancedVertexShader)
+	{
+		_instancedVertexShader->Release();
+		_instancedVertexShader = nullptr;
+	}
+
 	if (_pixelShader)
 	{
 		_pixelShader->Release();
@@ -210,6 +268,7 @@ void DefaultShader::Shutdown()
 void DefaultShader::Render(int indexCount, ShaderResources shaderResources)
 {
 	SetShaderParameters(shaderResources);
+	SetShaderTextures(shaderResources.TextureParameters);
 	RenderShader(indexCount);
 }
 
@@ -217,23 +276,9 @@ void DefaultShader::SetShaderParameters(ShaderResources shaderResources)
 {
 	try
 	{
-		_matrixBuffer->SetShaderParameters(0, shaderResources);
-		_cameraBuffer->SetShaderParameters(1, shaderResources);
-		_colorBuffer->SetShaderParameters(4, shaderResources);
-		_lightBuffer->SetShaderParameters(3, shaderResources);
-		_gradientBuffer->SetShaderParameters(5, shaderResources);
-
-		int textureCount = static_cast<int>(shaderResources.TextureParameters.TextureArray.size());
-		_textureBuffer->SetShaderParameters(2, shaderResources);
-
-		if (textureCount > 0)
-			_direct3D->GetDeviceContext()->PSSetShaderResources(0, textureCount, &shaderResources.TextureParameters.TextureArray.at(0));
-
-		if (shaderResources.TextureParameters.LightMapEnabled)
-			_direct3D->GetDeviceContext()->PSSetShaderResources(10, 1, &shaderResources.TextureParameters.LightMap);
-		
-		if (shaderResources.TextureParameters.BumpMapEnabled)
-			_direct3D->GetDeviceContext()->PSSetShaderResources(11, 1, &shaderResources.TextureParameters.BumpMap);
+		SetFrameParameters(shaderResources);
+		SetMaterialParameters(shaderResources);
+		SetObjectParameters(shaderResources);
 	}
 	catch(Exception& exception)
 	{
@@ -245,7 +290,52 @@ void DefaultShader::SetShaderParameters(ShaderResources shaderResources)
 	}
 }
 
-void DefaultShader::RenderShader(int indexCount)
+void DefaultShader::SetFrameParameters(const ShaderResources& shaderResources)
+{
+	_cameraBuffer->SetShaderParameters(1, shaderResources);
+	_lightBuffer->SetShaderParameters(3, shaderResources);
+}
+
+void DefaultShader::SetMaterialParameters(const ShaderResources& shaderResources)
+{
+	_textureBuffer->SetShaderParameters(2, shaderResources);
+}
+
+void DefaultShader::SetObjectParameters(const ShaderResources& shaderResources)
+{
+	_matrixBuffer->SetShaderParameters(0, shaderResources);
+	_colorBuffer->SetShaderParameters(4, shaderResources);
+	_gradientBuffer->SetShaderParameters(5, shaderResources);
+}
+
+int DefaultShader::GetConstantSize(ConstantFrequency frequency) const
+{
+	switch (frequency)
+	{
+	case CONSTANTS_PER_FRAME:
+		return _cameraBuffer->GetSize() + _lightBuffer->GetSize();
+	case CONSTANTS_PER_MATERIAL:
+		return _textureBuffer->GetSize();
+	case CONSTANTS_PER_OBJECT:
+		return _matrixBuffer->GetSize() + _colorBuffer->GetSize() + _gradientBuffer->GetSize();
+	default:
+		return 0;
+	}
+}
+
+void DefaultShader::SetShaderTextures(const TextureShaderParameters& textureParameters)
+{
+	if (textureParameters.TextureCount > 0)
+		_direct3D->GetDeviceContext()->PSSetShaderResources(0, textureParameters.TextureCount, textureParameters.TextureArray);
+
+	if (textureParameters.LightMapEnabled)
+		_direct3D->GetDeviceContext()->PSSetShaderResources(10, 1, &textureParameters.LightMap);
+
+	if (textureParameters.BumpMapEnabled)
+		_direct3D->GetDeviceContext()->PSSetShaderResources(11, 1, &textureParameters.BumpMap);
+}
+
+void DefaultShader::BindShader()
 {
 	_direct3D->GetDeviceContext()->IASetInputLayout(_layout);
 
@@ -253,6 +343,21 @@ void DefaultShader::RenderShader(int indexCount)
 	_direct3D->GetDeviceContext()->PSSetShader(_pixelShader, nullptr, 0);
 
 	_direct3D->GetDeviceContext()->PSSetSamplers(0, 1, &_sampleState);
+}
+
+void DefaultShader::BindInstancedShader()
+{
+	_direct3D->GetDeviceContext()->IASetInputLayout(_instancedLayout);
+
+	_direct3D->GetDeviceContext()->VSSetShader(_instancedVertexShader, nullptr, 0);
+	_direct3D->GetDeviceContext()->PSSetShader(_pixelShader, nullptr, 0);
+
+	_direct3D->GetDeviceContext()->PSSetSamplers(0, 1, &_sampleState);
+}
+
+void DefaultShader::RenderShader(int indexCount)
+{
+	BindShader();
 	_direct3D->GetDeviceContext()->DrawIndexed(indexCount, 0, 0);
 }
 
@@ -13,11 +13,19 @@ public:
 
 	void Initialise(HWND hwnd) override;
 	void InitialiseShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename) override;
+	void CompileShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename) override;
 	void Shutdown() override;
 
 	void SetShaderParameters(ShaderResources shaderResources) override;
+	void SetFrameParameters(const ShaderResources& shaderResources) override;
+	void SetMaterialParameters(const ShaderResources& shaderResources) override;
+	void SetObjectParameters(const ShaderResources& shaderResources) override;
+	int GetConstantSize(ConstantFrequency frequency) const override;
+	void SetShaderTextures(const TextureShaderParameters& textureParameters) override;
 
 	void Render(int indexCount, ShaderResources shaderResources) override;
+	void BindShader() override;
+	void BindInstancedShader() override;
 	void RenderShader(int indexCount) override;
 
 	void OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFileName) override;
@@ -0,0 +1,103 @@
+#include "IShaderType.h"
+#include <cctype>
+#include <cwctype>
+
+// Recompiles the shader from the files it was initialised with. If the new source does not compile the shader
+// carries on with the version it already had.
+bool IShaderType::Reload(HWND hwnd)
+{
+	ID3D11VertexShader* vertexShader = _vertexShader;
+	ID3D11PixelShader* pixelShader = _pixelShader;
+	ID3D11InputLayout* layout = _layout;
+	ID3D11VertexShader* instancedVertexShader = _instancedVertexShader;
+	ID3D11InputLayout* instancedLayout = _instancedLayout;
+
+	_vertexShader = nullptr;
+	_pixelShader = nullptr;
+	_layout = nullptr;
+	_instancedVertexShader = nullptr;
+	_instancedLayout = nullptr;
+
+	bool compiled = true;
+	try
+	{
+		CompileShader(hwnd, _vertexShaderFile, _pixelShaderFile);
+	}
+	catch (Exception&)
+	{
+		compiled = false;
+	}
+
+	if (!compiled)
+	{
+		swap(vertexShader, _vertexShader);
+		swap(pixelShader, _pixelShader);
+		swap(layout, _layout);
+		swap(instancedVertexShader, _instancedVertexShader);
+		swap(instancedLayout, _instancedLayout);
+	}
+
+	if (instancedLayout)
+		instancedLayout->Release();
+
+	if (instancedVertexShader)
+		instancedVertexShader->Release();
+
+	if (layout)
+		layout->Release();
+
+	if (pixelShader)
+		pixelShader->Release();
+
+	if (vertexShader)
+		vertexShader->Release();
+
+	return compiled;
+}
+
+bool IShaderType::SupportsInstancing() const
+{
+	return _instancedVertexShader != nullptr && _instancedLayout != nullptr;
+}
+
+ID3D11VertexShader* IShaderType::GetVertexShader(bool instanced) const
+{
+	return instanced ? _instancedVertexShader : _vertexShader;
+}
+
+ID3D11PixelShader* IShaderType::GetPixelShader() const
+{
+	return _pixelShader;
+}
+
+ID3D11InputLayout* IShaderType::GetInputLayout(bool instanced) const
+{
+	return instanced ? _instancedLayout : _layout;
+}
+
+ID3D11SamplerState* IShaderType::GetSamplerState() const
+{
+	return _sampleState;
+}
+
+bool IShaderType::UsesSourceFile(const string& path) const
+{
+	for (const WCHAR* file : { _vertexShaderFile, _pixelShaderFile })
+	{
+		if (file == nullptr || wcslen(file) != path.size())
+			continue;
+
+		bool matches = true;
+		for (size_t i = 0; i < path.size() && matches; i++)
+		{
+			WCHAR expected = file[i] == L'\\' ? L'/' : static_cast<WCHAR>(towlower(file[i]));
+			char actual = path[i] == '\\' ? '/' : static_cast<char>(tolower(static_cast<unsigned char>(path[i])));
+			matches = expected == static_cast<WCHAR>(actual);
+		}
+
+		if (matches)
+			return true;
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include "ConstantBuffers/ColorOverrideBuffer.h"
 #include "ConstantBuffers/TextureBuffer.h"
 #include "ShaderResources.h"
+#include "ShaderTypes.h"
 
 using namespace DirectX;
 
@@ -29,6 +30,12 @@ protected:
 	ID3D11InputLayout* _layout;
 	ID3D11SamplerState* _sampleState;
 
+	ID3D11VertexShader* _instancedVertexShader;
+	ID3D11InputLayout* _instancedLayout;
+
+	WCHAR* _vertexShaderFile;
+	WCHAR* _pixelShaderFile;
+
 	IShaderBuffer* _matrixBuffer;
 	IShaderBuffer* _cameraBuffer;
 	IShaderBuffer* _lightBuffer;
@@ -37,17 +44,33 @@ protected:
 	IShaderBuffer* _gradientBuffer;
 
 public:
-	IShaderType(DirectX3D* direct3D, Camera* camera, Light* light) : _direct3D(direct3D), _camera(camera), _light(light) {};
+	IShaderType(DirectX3D* direct3D, Camera* camera, Light* light) : _direct3D(direct3D), _camera(camera), _light(light), _instancedVertexShader(nullptr), _instancedLayout(nullptr), _vertexShaderFile(nullptr), _pixelShaderFile(nullptr) {};
 	virtual ~IShaderType() {};
 
 	virtual void Initialise(HWND hwnd) = 0;
 	virtual void InitialiseShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename) = 0;
+	virtual void CompileShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename) = 0;
+	bool Reload(HWND hwnd);
+	bool UsesSourceFile(const string& path) const;
 	virtual void Shutdown() = 0;
 
 	virtual void SetShaderParameters(ShaderResources shaderResources) = 0;
+	virtual void SetFrameParameters(const ShaderResources& shaderResources) = 0;
+	virtual void SetMaterialParameters(const ShaderResources& shaderResources) = 0;
+	virtual void SetObjectParameters(const ShaderResources& shaderResources) = 0;
+	virtual int GetConstantSize(ConstantFrequency frequency) const = 0;
+	virtual void SetShaderTextures(const TextureShaderParameters& textureParameters) = 0;
 
 	virtual void Render(int indexCount, ShaderResources shaderResources) = 0;
 
+	virtual void BindShader() = 0;
+	virtual void BindInstancedShader() = 0;
+	bool SupportsInstancing() const;
+
+	ID3D11VertexShader* GetVertexShader(bool instanced) const;
+	ID3D11PixelShader* GetPixelShader() const;
+	ID3D11InputLayout* GetInputLayout(bool instanced) const;
+	ID3D11SamplerState* GetSamplerState() const;
 	virtual void RenderShader(int indexCount) = 0;
 	
 	virtual void OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFileName) = 0;
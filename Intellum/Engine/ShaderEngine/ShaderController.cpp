@@ -1,6 +1,6 @@
 #include "ShaderController.h"
 
-ShaderController::ShaderController(DirectX3D* direct3D) : _direct3D(direct3D), _shaders(map<ShaderType, IShaderType*>())
+ShaderController::ShaderController(DirectX3D* direct3D) : _direct3D(direct3D), _hwnd(nullptr), _shaders(map<ShaderType, IShaderType*>()), _version(0)
 {
 }
 
@@ -10,6 +10,8 @@ ShaderController::~ShaderController()
 
 bool ShaderController::Initialise(HWND hwnd, Camera* camera, Light* light)
 {
+	_hwnd = hwnd;
+
 	_shaders[SHADER_DEFAULT] = new DefaultShader(_direct3D, camera, light);
 	if (!_shaders[SHADER_DEFAULT]) throw Exception("Failed to create the default shader.");
 
@@ -42,7 +44,22 @@ void ShaderController::Shutdown()
 	_shaders.clear();
 }
 
+// Recompiles every shader built from the changed source file
+void ShaderController::Reload(const string& path)
+{
+	for (map<ShaderType, IShaderType*>::iterator iterator = _shaders.begin(); iterator != _shaders.end(); ++iterator)
+	{
+		if (iterator->second != nullptr && iterator->second->UsesSourceFile(path) && iterator->second->Reload(_hwnd))
+			_version++;
+	}
+}
+
 IShaderType* ShaderController::GetShader(ShaderType type)
 {
 	return _shaders[type];
+}
+
+int ShaderController::GetVersion() const
+{
+	return _version;
 }
\ No newline at end of file
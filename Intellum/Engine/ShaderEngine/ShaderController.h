@@ -11,23 +11,19 @@
 #include "DefaultShader.h"
 #include "UIShader.h"
 #include "IShaderType.h"
+#include "ShaderTypes.h"
 
 using namespace DirectX;
 using namespace std;
 
-enum ShaderType
-{
-	SHADER_DEFAULT,
-	SHADER_FONT, 
-	SHADER_UI
-};
-
 class ShaderController
 {
 private:
 	DirectX3D* _direct3D;
+	HWND _hwnd;
 
 	map<ShaderType, IShaderType*> _shaders;
+	int _version;
 
 public:
 	ShaderController(DirectX3D* direct3D);
@@ -36,7 +32,12 @@ public:
 	bool Initialise(HWND hwnd, Camera* camera, Light* light);
 	void Shutdown();
 
+	void Reload(const string& path);
+
 	IShaderType* GetShader(ShaderType type);
+
+	// Goes up every time a shader is recompiled, so anything holding on to shader objects knows to fetch them again
+	int GetVersion() const;
 };
 
 #endif
\ No newline at end of file
@@ -11,5 +11,4 @@ public:
 
 	ColorShaderParameters() : Color(XMFLOAT4(0, 0, 0, 0)), Enabled(false) {}
 	ColorShaderParameters(XMFLOAT4 color) : Color(color), Enabled(true) {}
-	~ColorShaderParameters() {}
 };
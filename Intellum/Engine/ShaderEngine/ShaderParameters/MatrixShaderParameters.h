@@ -11,5 +11,4 @@ public:
 	XMMATRIX ViewMatrix;
 
 	MatrixShaderParameters() : WorldMatrix(XMMATRIX()), ProjectionMatrix(XMMATRIX()), ViewMatrix(XMMATRIX()) {}
-	~MatrixShaderParameters() {}
 };
\ No newline at end of file
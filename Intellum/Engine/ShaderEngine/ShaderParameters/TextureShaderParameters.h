@@ -1,19 +1,29 @@
 #pragma once
 #include "d3d11.h"
 #include <DirectXMath.h>
-#include <vector>
+#include "../../../Common/Constants.h"
+#include "../../../ErrorHandling/Exception.h"
 
 using namespace DirectX;
 
+// Holds its texture views in place so shader resources can be copied around without allocating
 class TextureShaderParameters
 {
 public:
-	std::vector<ID3D11ShaderResourceView*> TextureArray;
+	ID3D11ShaderResourceView* TextureArray[MAX_SHADER_TEXTURES];
+	int TextureCount;
 	ID3D11ShaderResourceView* LightMap;
 	ID3D11ShaderResourceView* BumpMap;
 	bool LightMapEnabled;
 	bool BumpMapEnabled;
 
-	TextureShaderParameters() : TextureArray(std::vector<ID3D11ShaderResourceView*>()), LightMap(nullptr), BumpMap(nullptr), LightMapEnabled(false), BumpMapEnabled(false) {}
-	~TextureShaderParameters() {}
-};
+	TextureShaderParameters() : TextureArray(), TextureCount(0), LightMap(nullptr), BumpMap(nullptr), LightMapEnabled(false), BumpMapEnabled(false) {}
+
+	void AddTexture(ID3D11ShaderResourceView* texture)
+	{
+		if (TextureCount >= MAX_SHADER_TEXTURES)
+			throw Exception("Too many textures for one draw");
+
+		TextureArray[TextureCount++] = texture;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+enum ShaderType
+{
+	SHADER_DEFAULT,
+	SHADER_FONT, 
+	SHADER_UI,
+	SHADER_TYPE_COUNT
+};
+
+// How often a block of shader constants changes, and so how often it needs uploading
+enum ConstantFrequency
+{
+	CONSTANTS_PER_FRAME,
+	CONSTANTS_PER_MATERIAL,
+	CONSTANTS_PER_OBJECT,
+	CONSTANT_FREQUENCY_COUNT
+};
\ No newline at end of file
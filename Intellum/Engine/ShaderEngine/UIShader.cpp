@@ -13,82 +13,89 @@ void UIShader::Initialise(HWND hwnd)
 	InitialiseShader(hwnd, L"Content/Shaders/FontVertexShader.hlsl", L"Content/Shaders/FontPixelShader.hlsl");
 }
 
-void UIShader::InitialiseShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
+void UIShader::CompileShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
 {
-	try
-	{
-		ID3D10Blob* errorMessage = nullptr;
+	ID3D10Blob* errorMessage = nullptr;
 
-		ID3D10Blob* vertexShaderBuffer = nullptr;
-		HRESULT result = D3DCompileFromFile(vsFilename, nullptr, nullptr, "FontVertexShader", "vs_5_0", D3D10_SHADER_DEBUG, 0, &vertexShaderBuffer, &errorMessage);
-		if (FAILED(result))
+	ID3D10Blob* vertexShaderBuffer = nullptr;
+	HRESULT result = D3DCompileFromFile(vsFilename, nullptr, nullptr, "FontVertexShader", "vs_5_0", D3D10_SHADER_DEBUG, 0, &vertexShaderBuffer, &errorMessage);
+	if (FAILED(result))
+	{
+		if (errorMessage)
 		{
-			if (errorMessage)
-			{
-				OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
-			}
-			else
-			{
-				MessageBox(hwnd, vsFilename, L"Missing Vertex Shader File", MB_OK);
-			}
-
-			throw Exception("Vertex Shader file missing");
+			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
 		}
-
-		ID3D10Blob* pixelShaderBuffer = nullptr;
-		result = D3DCompileFromFile(psFilename, nullptr, nullptr, "FontPixelShader", "ps_5_0", D3D10_SHADER_DEBUG, 0, &pixelShaderBuffer, &errorMessage);
-
-		if (FAILED(result))
+		else
 		{
-			if (errorMessage)
-			{
-				OutputShaderErrorMessage(errorMessage, hwnd, psFilename);
-			}
-			else
-			{
-				MessageBox(hwnd, psFilename, L"Missing Pixel Shader File", MB_OK);
-			}
-
-			throw Exception("Pixel Shader file missing");
+			MessageBox(hwnd, vsFilename, L"Missing Vertex Shader File", MB_OK);
 		}
 
-		// Create Vertex Shader from the buffer
-		result = _direct3D->GetDevice()->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), nullptr, &_vertexShader);
-		if (FAILED(result)) throw Exception("Failed to create the vertex shader");
-
-		// Create Pixel Shader from the buffer
-		result = _direct3D->GetDevice()->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), nullptr, &_pixelShader);
-		if (FAILED(result)) throw Exception("Failed to create the pixel shader");
-
-		// Vertex Shader layout description
-		// The setup below NEEDS to match the VertexType structure defined in the shader file, otherwise the bytes of data become missalligned / errors occur
-		D3D11_INPUT_ELEMENT_DESC polygonLayout[2];
-		polygonLayout[0].SemanticName = "POSITION";
-		polygonLayout[0].SemanticIndex = 0;
-		polygonLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		polygonLayout[0].InputSlot = 0;
-		polygonLayout[0].AlignedByteOffset = 0;
-		polygonLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-		polygonLayout[0].InstanceDataStepRate = 0;
+		throw Exception("Vertex Shader file missing");
+	}
 
-		polygonLayout[1].SemanticName = "TEXCOORD";
-		polygonLayout[1].SemanticIndex = 0;
-		polygonLayout[1].Format = DXGI_FORMAT_R32G32_FLOAT;
-		polygonLayout[1].InputSlot = 0;
-		polygonLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-		polygonLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-		polygonLayout[1].InstanceDataStepRate = 0;
+	ID3D10Blob* pixelShaderBuffer = nullptr;
+	result = D3DCompileFromFile(psFilename, nullptr, nullptr, "FontPixelShader", "ps_5_0", D3D10_SHADER_DEBUG, 0, &pixelShaderBuffer, &errorMessage);
 
-		unsigned int numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
+	if (FAILED(result))
+	{
+		if (errorMessage)
+		{
+			OutputShaderErrorMessage(errorMessage, hwnd, psFilename);
+		}
+		else
+		{
+			MessageBox(hwnd, psFilename, L"Missing Pixel Shader File", MB_OK);
+		}
 
-		result = _direct3D->GetDevice()->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &_layout);
-		if (FAILED(result)) throw Exception("Failed to create the input layout");
+		throw Exception("Pixel Shader file missing");
+	}
 
-		vertexShaderBuffer->Release();
-		vertexShaderBuffer = nullptr;
+	// Create Vertex Shader from the buffer
+	result = _direct3D->GetDevice()->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), nullptr, &_vertexShader);
+	if (FAILED(result)) throw Exception("Failed to create the vertex shader");
+
+	// Create Pixel Shader from the buffer
+	result = _direct3D->GetDevice()->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), nullptr, &_pixelShader);
+	if (FAILED(result)) throw Exception("Failed to create the pixel shader");
+
+	// Vertex Shader layout description
+	// The setup below NEEDS to match the VertexType structure defined in the shader file, otherwise the bytes of data become missalligned / errors occur
+	D3D11_INPUT_ELEMENT_DESC polygonLayout[2];
+	polygonLayout[0].SemanticName = "POSITION";
+	polygonLayout[0].SemanticIndex = 0;
+	polygonLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	polygonLayout[0].InputSlot = 0;
+	polygonLayout[0].AlignedByteOffset = 0;
+	polygonLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[0].InstanceDataStepRate = 0;
+
+	polygonLayout[1].SemanticName = "TEXCOORD";
+	polygonLayout[1].SemanticIndex = 0;
+	polygonLayout[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+	polygonLayout[1].InputSlot = 0;
+	polygonLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	polygonLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[1].InstanceDataStepRate = 0;
+
+	unsigned int numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
+
+	result = _direct3D->GetDevice()->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &_layout);
+	if (FAILED(result)) throw Exception("Failed to create the input layout");
+
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = nullptr;
+
+	pixelShaderBuffer->Release();
+	pixelShaderBuffer = nullptr;
+}
 
-		pixelShaderBuffer->Release();
-		pixelShaderBuffer = nullptr;
+void UIShader::InitialiseShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
+{
+	try
+	{
+		_vertexShaderFile = vsFilename;
+		_pixelShaderFile = psFilename;
+		CompileShader(hwnd, vsFilename, psFilename);
 
 		_matrixBuffer = new MatrixBuffer(_direct3D);
 		_cameraBuffer = new CameraBuffer(_direct3D, _camera);
@@ -111,7 +118,7 @@ void UIShader::InitialiseShader(HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
 		samplerDesc.MinLOD = 0;
 		samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
 
-		result = _direct3D->GetDevice()->CreateSamplerState(&samplerDesc, &_sampleState);
+		HRESULT result = _direct3D->GetDevice()->CreateSamplerState(&samplerDesc, &_sampleState);
 		if (FAILED(result)) throw Exception("Failed to create the sampler state");
 	}
 	catch (Exception& exception)
@@ -172,6 +179,7 @@ void UIShader::Shutdown()
 void UIShader::Render(int indexCount, ShaderResources shaderResources)
 {
 	SetShaderParameters(shaderResources);
+	SetShaderTextures(shaderResources.TextureParameters);
 	RenderShader(indexCount);
 }
 
@@ -179,26 +187,9 @@ void UIShader::SetShaderParameters(ShaderResources shaderResources)
 {
 	try
 	{
-		_matrixBuffer->SetShaderParameters(0, shaderResources);
-		_cameraBuffer->SetShaderParameters(1, shaderResources);
-		_colorBuffer->SetShaderParameters(2, shaderResources);
-
-		bool lightMapEnabled = false;
-		if (shaderResources.TextureParameters.LightMap != nullptr)
-			lightMapEnabled = true;
-
-		bool bumpMapEnabled = false;
-		if (shaderResources.TextureParameters.BumpMap != nullptr)
-			bumpMapEnabled = true;
-
-		int textureCount = static_cast<int>(shaderResources.TextureParameters.TextureArray.size());
-		_textureBuffer->SetShaderParameters(3, shaderResources);
-
-		if (textureCount > 0)
-			_direct3D->GetDeviceContext()->PSSetShaderResources(0, textureCount, &shaderResources.TextureParameters.TextureArray.at(0));
-
-		if (lightMapEnabled)
-			_direct3D->GetDeviceContext()->PSSetShaderResources(10, 1, &shaderResources.TextureParameters.LightMap);
+		SetFrameParameters(shaderResources);
+		SetMaterialParameters(shaderResources);
+		SetObjectParameters(shaderResources);
 	}
 	catch (Exception& exception)
 	{
@@ -210,7 +201,47 @@ void UIShader::SetShaderParameters(ShaderResources shaderResources)
 	}
 }
 
-void UIShader::RenderShader(int indexCount)
+void UIShader::SetFrameParameters(const ShaderResources& shaderResources)
+{
+	_cameraBuffer->SetShaderParameters(1, shaderResources);
+}
+
+void UIShader::SetMaterialParameters(const ShaderResources& shaderResources)
+{
+	_textureBuffer->SetShaderParameters(3, shaderResources);
+}
+
+void UIShader::SetObjectParameters(const ShaderResources& shaderResources)
+{
+	_matrixBuffer->SetShaderParameters(0, shaderResources);
+	_colorBuffer->SetShaderParameters(2, shaderResources);
+}
+
+int UIShader::GetConstantSize(ConstantFrequency frequency) const
+{
+	switch (frequency)
+	{
+	case CONSTANTS_PER_FRAME:
+		return _cameraBuffer->GetSize();
+	case CONSTANTS_PER_MATERIAL:
+		return _textureBuffer->GetSize();
+	case CONSTANTS_PER_OBJECT:
+		return _matrixBuffer->GetSize() + _colorBuffer->GetSize();
+	default:
+		return 0;
+	}
+}
+
+void UIShader::SetShaderTextures(const TextureShaderParameters& textureParameters)
+{
+	if (textureParameters.TextureCount > 0)
+		_direct3D->GetDeviceContext()->PSSetShaderResources(0, textureParameters.TextureCount, textureParameters.TextureArray);
+
+	if (textureParameters.LightMap != nullptr)
+		_direct3D->GetDeviceContext()->PSSetShaderResources(10, 1, &textureParameters.LightMap);
+}
+
+void UIShader::BindShader()
 {
 	_direct3D->GetDeviceContext()->IASetInputLayout(_layout);
 
@@ -218,6 +249,16 @@ void UIShader::RenderShader(int indexCount)
 	_direct3D->GetDeviceContext()->PSSetShader(_pixelShader, nullptr, 0);
 
 	_direct3D->GetDeviceContext()->PSSetSamplers(0, 1, &_sampleState);
+}
+
+void UIShader::BindInstancedShader()
+{
+	throw Exception("The font shader does not support instanced drawing");
+}
+
+void UIShader::RenderShader(int indexCount)
+{
+	BindShader();
 	_direct3D->GetDeviceContext()->DrawIndexed(indexCount, 0, 0);
 }
 
@@ -0,0 +1,78 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(int workerCount) : _stopping(false)
+{
+	Initialise(workerCount);
+}
+
+WorkerPool::~WorkerPool()
+{
+}
+
+void WorkerPool::Initialise(int workerCount)
+{
+	for (int i = 0; i < workerCount; i++)
+		_workers.push_back(thread(&WorkerPool::RunWorker, this));
+}
+
+void WorkerPool::Shutdown()
+{
+	{
+		lock_guard<mutex> lock(_taskLock);
+		_stopping = true;
+	}
+
+	_taskAvailable.notify_all();
+
+	for (thread& worker : _workers)
+	{
+		if (worker.joinable())
+			worker.join();
+	}
+
+	_workers.clear();
+}
+
+// Leaves one hardware thread free for the main thread, which keeps running the systems that must stay on it.
+int WorkerPool::GetDefaultWorkerCount()
+{
+	int hardwareThreads = static_cast<int>(thread::hardware_concurrency());
+	return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+int WorkerPool::GetWorkerCount() const
+{
+	return static_cast<int>(_workers.size());
+}
+
+void WorkerPool::Submit(function<void()> task)
+{
+	{
+		lock_guard<mutex> lock(_taskLock);
+		_tasks.push(move(task));
+	}
+
+	_taskAvailable.notify_one();
+}
+
+void WorkerPool::RunWorker()
+{
+	while (true)
+	{
+		function<void()> task;
+
+		{
+			unique_lock<mutex> lock(_taskLock);
+			while (_stopping == false && _tasks.empty())
+				_taskAvailable.wait(lock);
+
+			if (_tasks.empty())
+				return;
+
+			task = move(_tasks.front());
+			_tasks.pop();
+		}
+
+		task();
+	}
+}
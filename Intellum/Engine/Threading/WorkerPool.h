@@ -0,0 +1,33 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class WorkerPool
+{
+private:
+	vector<thread> _workers;
+	queue<function<void()>> _tasks;
+	mutex _taskLock;
+	condition_variable _taskAvailable;
+	bool _stopping;
+
+	void Initialise(int workerCount);
+	void RunWorker();
+
+public:
+	WorkerPool(int workerCount);
+	~WorkerPool();
+
+	void Shutdown();
+
+	static int GetDefaultWorkerCount();
+	int GetWorkerCount() const;
+
+	void Submit(function<void()> task);
+};
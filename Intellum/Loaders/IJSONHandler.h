@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+
+// Receives the events of a streaming JSON parse in document order. Strings and keys are only valid for the
+// duration of the call; copy them if they are needed later. Throwing an Exception from any event stops the
+// parse, and the loader reports it with the line and column of the value that caused it.
+class IJSONHandler
+{
+public:
+	virtual ~IJSONHandler() {}
+
+	virtual void StartObject() = 0;
+	virtual void EndObject() = 0;
+	virtual void StartArray() = 0;
+	virtual void EndArray() = 0;
+
+	virtual void Key(const char* text, size_t length) = 0;
+	virtual void String(const char* text, size_t length) = 0;
+	virtual void Number(double value) = 0;
+	virtual void Boolean(bool value) = 0;
+	virtual void Null() = 0;
+};
\ No newline at end of file
@@ -1,9 +1,497 @@
 #include "JSONLoader.h"
+#include <cmath>
+#include <cstring>
+#include "../Engine/Scenes/MappedFile.h"
+#include "../ErrorHandling/Exception.h"
 
-JSONLoader::JSONLoader()
+JSONLoader::JSONLoader() : _handler(nullptr), _start(nullptr), _current(nullptr), _end(nullptr), _valueStart(nullptr), _depth(0), _failed(false)
 {
 }
 
 JSONLoader::~JSONLoader()
 {
+}
+
+void JSONLoader::Load(const string& file, IJSONHandler* handler)
+{
+	MappedFile mappedFile(file);
+	Parse(mappedFile.GetData(), mappedFile.GetSize(), file, handler);
+	mappedFile.Shutdown();
+}
+
+void JSONLoader::Parse(const char* data, size_t size, const string& source, IJSONHandler* handler)
+{
+	_handler = handler;
+	_source = source;
+	_start = data;
+	_current = data;
+	_end = data + size;
+	_valueStart = data;
+	_depth = 0;
+	_failed = false;
+
+	if (size >= 3 && static_cast<unsigned char>(data[0]) == 0xEF && static_cast<unsigned char>(data[1]) == 0xBB && static_cast<unsigned char>(data[2]) == 0xBF)
+		_current += 3;
+
+	try
+	{
+		SkipWhitespace();
+		if (_current == _end)
+			Fail("The document is empty.");
+
+		ParseValue();
+
+		SkipWhitespace();
+		if (_current != _end)
+			Fail("Unexpected data after the end of the document.");
+	}
+	catch (Exception& exception)
+	{
+		if (_failed)
+			throw;
+
+		throw Exception(DescribePosition(_valueStart) + ": " + exception._message);
+	}
+}
+
+void JSONLoader::SkipWhitespace()
+{
+	while (_current != _end && (*_current == ' ' || *_current == '\n' || *_current == '\r' || *_current == '\t'))
+		_current++;
+}
+
+void JSONLoader::Expect(char character, const char* context)
+{
+	SkipWhitespace();
+
+	if (_current == _end || *_current != character)
+		Fail(string("Expected '") + character + "' " + context + ".");
+
+	_current++;
+}
+
+void JSONLoader::ParseValue()
+{
+	SkipWhitespace();
+	if (_current == _end)
+		Fail("Unexpected end of the document.");
+
+	_valueStart = _current;
+
+	switch (*_current)
+	{
+	case '{':
+		ParseObject();
+		break;
+	case '[':
+		ParseArray();
+		break;
+	case '"':
+		ParseString(false);
+		break;
+	case 't':
+		ParseLiteral("true", 4);
+		_handler->Boolean(true);
+		break;
+	case 'f':
+		ParseLiteral("false", 5);
+		_handler->Boolean(false);
+		break;
+	case 'n':
+		ParseLiteral("null", 4);
+		_handler->Null();
+		break;
+	default:
+		if (*_current == '-' || (*_current >= '0' && *_current <= '9'))
+			ParseNumber();
+		else
+			Fail(string("Unexpected character '") + *_current + "'.");
+	}
+}
+
+void JSONLoader::ParseObject()
+{
+	if (++_depth > MaximumDepth)
+		Fail("The document is nested too deeply.");
+
+	_current++;
+	_handler->StartObject();
+
+	SkipWhitespace();
+	if (_current != _end && *_current == '}')
+	{
+		_current++;
+	}
+	else
+	{
+		while (true)
+		{
+			SkipWhitespace();
+			if (_current == _end || *_current != '"')
+				Fail("Expected a quoted property name.");
+
+			_valueStart = _current;
+			ParseString(true);
+
+			Expect(':', "after a property name");
+			ParseValue();
+
+			SkipWhitespace();
+			if (_current != _end && *_current == ',')
+			{
+				_current++;
+				continue;
+			}
+
+			Expect('}', "or ',' after a property value");
+			break;
+		}
+	}
+
+	_valueStart = _current - 1;
+	_handler->EndObject();
+	_depth--;
+}
+
+void JSONLoader::ParseArray()
+{
+	if (++_depth > MaximumDepth)
+		Fail("The document is nested too deeply.");
+
+	_current++;
+	_handler->StartArray();
+
+	SkipWhitespace();
+	if (_current != _end && *_current == ']')
+	{
+		_current++;
+	}
+	else
+	{
+		while (true)
+		{
+			ParseValue();
+
+			SkipWhitespace();
+			if (_current != _end && *_current == ',')
+			{
+				_current++;
+				continue;
+			}
+
+			Expect(']', "or ',' after an array element");
+			break;
+		}
+	}
+
+	_valueStart = _current - 1;
+	_handler->EndArray();
+	_depth--;
+}
+
+void JSONLoader::ParseString(bool key)
+{
+	const char* stringStart = ++_current;
+
+	while (_current != _end)
+	{
+		unsigned char character = static_cast<unsigned char>(*_current);
+
+		if (character == '"')
+		{
+			size_t length = _current - stringStart;
+			_current++;
+
+			if (key)
+				_handler->Key(stringStart, length);
+			else
+				_handler->String(stringStart, length);
+			return;
+		}
+
+		if (character == '\\')
+		{
+			DecodeEscapedString(stringStart);
+
+			if (key)
+				_handler->Key(_scratch.data(), _scratch.size());
+			else
+				_handler->String(_scratch.data(), _scratch.size());
+			return;
+		}
+
+		if (character < 0x20)
+			Fail("Control characters must be escaped inside strings.");
+
+		_current++;
+	}
+
+	Fail("Unterminated string.");
+}
+
+// Only reached once a backslash is found, so the common case of plain strings never copies anything.
+void JSONLoader::DecodeEscapedString(const char* stringStart)
+{
+	_scratch.assign(stringStart, _current);
+
+	while (_current != _end)
+	{
+		unsigned char character = static_cast<unsigned char>(*_current);
+
+		if (character == '"')
+		{
+			_current++;
+			return;
+		}
+
+		if (character < 0x20)
+			Fail("Control characters must be escaped inside strings.");
+
+		if (character != '\\')
+		{
+			_scratch.push_back(*_current++);
+			continue;
+		}
+
+		if (++_current == _end)
+			break;
+
+		switch (*_current++)
+		{
+		case '"':
+			_scratch.push_back('"');
+			break;
+		case '\\':
+			_scratch.push_back('\\');
+			break;
+		case '/':
+			_scratch.push_back('/');
+			break;
+		case 'b':
+			_scratch.push_back('\b');
+			break;
+		case 'f':
+			_scratch.push_back('\f');
+			break;
+		case 'n':
+			_scratch.push_back('\n');
+			break;
+		case 'r':
+			_scratch.push_back('\r');
+			break;
+		case 't':
+			_scratch.push_back('\t');
+			break;
+		case 'u':
+		{
+			unsigned int codePoint = ParseHexQuad();
+
+			if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+			{
+				if (_end - _current < 6 || _current[0] != '\\' || _current[1] != 'u')
+					Fail("Unpaired UTF-16 surrogate in string.");
+
+				_current += 2;
+				unsigned int lowSurrogate = ParseHexQuad();
+				if (lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF)
+					Fail("Invalid UTF-16 surrogate pair in string.");
+
+				codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+			}
+			else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+			{
+				Fail("Unpaired UTF-16 surrogate in string.");
+			}
+
+			AppendCodePoint(codePoint);
+			break;
+		}
+		default:
+			_current--;
+			Fail("Invalid escape sequence in string.");
+		}
+	}
+
+	Fail("Unterminated string.");
+}
+
+unsigned int JSONLoader::ParseHexQuad()
+{
+	if (_end - _current < 4)
+		Fail("Incomplete unicode escape in string.");
+
+	unsigned int value = 0;
+
+	for (int i = 0; i < 4; i++)
+	{
+		char digit = *_current++;
+		value <<= 4;
+
+		if (digit >= '0' && digit <= '9')
+			value |= digit - '0';
+		else if (digit >= 'a' && digit <= 'f')
+			value |= digit - 'a' + 10;
+		else if (digit >= 'A' && digit <= 'F')
+			value |= digit - 'A' + 10;
+		else
+			Fail("Invalid unicode escape in string.");
+	}
+
+	return value;
+}
+
+void JSONLoader::AppendCodePoint(unsigned int codePoint)
+{
+	if (codePoint < 0x80)
+	{
+		_scratch.push_back(static_cast<char>(codePoint));
+	}
+	else if (codePoint < 0x800)
+	{
+		_scratch.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+		_scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+	else if (codePoint < 0x10000)
+	{
+		_scratch.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+		_scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+		_scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+	else
+	{
+		_scratch.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+		_scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+		_scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+		_scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+}
+
+// Digits are gathered into an integer mantissa and scaled once at the end. Exact powers of ten cover every
+// number a scene normally holds; anything beyond that falls back to pow.
+void JSONLoader::ParseNumber()
+{
+	static const double exactPowers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	bool negative = false;
+	if (*_current == '-')
+	{
+		negative = true;
+		_current++;
+	}
+
+	if (_current == _end || *_current < '0' || *_current > '9')
+		Fail("Expected a digit.");
+
+	unsigned long long mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+
+	if (*_current == '0')
+	{
+		_current++;
+	}
+	else
+	{
+		while (_current != _end && *_current >= '0' && *_current <= '9')
+		{
+			if (significantDigits < 19)
+			{
+				mantissa = mantissa * 10 + (*_current - '0');
+				significantDigits++;
+			}
+			else
+			{
+				exponent++;
+			}
+
+			_current++;
+		}
+	}
+
+	if (_current != _end && *_current == '.')
+	{
+		_current++;
+		if (_current == _end || *_current < '0' || *_current > '9')
+			Fail("Expected a digit after the decimal point.");
+
+		while (_current != _end && *_current >= '0' && *_current <= '9')
+		{
+			if (significantDigits < 19)
+			{
+				mantissa = mantissa * 10 + (*_current - '0');
+				exponent--;
+
+				if (mantissa != 0)
+					significantDigits++;
+			}
+
+			_current++;
+		}
+	}
+
+	if (_current != _end && (*_current == 'e' || *_current == 'E'))
+	{
+		_current++;
+
+		bool negativeExponent = false;
+		if (_current != _end && (*_current == '+' || *_current == '-'))
+			negativeExponent = *_current++ == '-';
+
+		if (_current == _end || *_current < '0' || *_current > '9')
+			Fail("Expected a digit in the exponent.");
+
+		int writtenExponent = 0;
+		while (_current != _end && *_current >= '0' && *_current <= '9')
+		{
+			if (writtenExponent < 100000)
+				writtenExponent = writtenExponent * 10 + (*_current - '0');
+
+			_current++;
+		}
+
+		exponent += negativeExponent ? -writtenExponent : writtenExponent;
+	}
+
+	double value = static_cast<double>(mantissa);
+
+	if (exponent >= 0 && exponent <= 22)
+		value *= exactPowers[exponent];
+	else if (exponent < 0 && exponent >= -22)
+		value /= exactPowers[-exponent];
+	else
+		value *= pow(10.0, exponent);
+
+	_handler->Number(negative ? -value : value);
+}
+
+void JSONLoader::ParseLiteral(const char* literal, size_t length)
+{
+	if (static_cast<size_t>(_end - _current) < length || memcmp(_current, literal, length) != 0)
+		Fail("Unexpected character '" + string(1, *_current) + "'.");
+
+	_current += length;
+}
+
+void JSONLoader::Fail(const string& message)
+{
+	_failed = true;
+	throw Exception(DescribePosition(_current) + ": " + message);
+}
+
+string JSONLoader::DescribePosition(const char* position) const
+{
+	int line = 1;
+	const char* lineStart = _start;
+
+	for (const char* character = _start; character < position && character < _end; character++)
+	{
+		if (*character == '\n')
+		{
+			line++;
+			lineStart = character + 1;
+		}
+	}
+
+	int column = static_cast<int>(position - lineStart) + 1;
+	return _source + ":" + to_string(line) + ":" + to_string(column);
 }
\ No newline at end of file
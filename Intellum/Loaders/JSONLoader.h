@@ -1,16 +1,49 @@
 #pragma once
 #include <string>
+#include "IJSONHandler.h"
 
 using namespace std;
 
+// Streaming JSON reader. The document is walked once, straight out of a memory mapped file, and every value is
+// handed to an IJSONHandler as it is read, so no DOM is ever built. Strings without escapes point into the
+// source and escaped strings are decoded into one reused buffer. Line and column are only worked out when an
+// error is reported.
 class JSONLoader
 {
+private:
+	static const int MaximumDepth = 256;
+
+	IJSONHandler* _handler;
+	string _source;
+	const char* _start;
+	const char* _current;
+	const char* _end;
+	const char* _valueStart;
+	string _scratch;
+	int _depth;
+	bool _failed;
+
+	void SkipWhitespace();
+	void Expect(char character, const char* context);
+
+	void ParseValue();
+	void ParseObject();
+	void ParseArray();
+	void ParseString(bool key);
+	void ParseNumber();
+	void ParseLiteral(const char* literal, size_t length);
+
+	void DecodeEscapedString(const char* stringStart);
+	void AppendCodePoint(unsigned int codePoint);
+	unsigned int ParseHexQuad();
+
+	void Fail(const string& message);
+	string DescribePosition(const char* position) const;
+
 public:
 	JSONLoader();
 	~JSONLoader();
 
-	template<typename T> T Load(string file)
-	{
-		
-	}
-};
+	void Load(const string& file, IJSONHandler* handler);
+	void Parse(const char* data, size_t size, const string& source, IJSONHandler* handler);
+};
\ No newline at end of file
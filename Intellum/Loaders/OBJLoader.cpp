@@ -1,6 +1,6 @@
 #include "OBJLoader.h"
 
-Geometry OBJLoader::Load(char* filename, ID3D11Device* pd3dDevice, bool invertTexCoords)
+Geometry OBJLoader::Load(char* filename, IRenderDevice* renderDevice, bool invertTexCoords)
 {
 	std::string binaryFilename = filename;
 	binaryFilename.append("Binary");
@@ -14,10 +14,28 @@ Geometry OBJLoader::Load(char* filename, ID3D11Device* pd3dDevice, bool invertTe
 	else
 		objLoader = new OBJFileLoader();
 
-	Geometry geometry = objLoader->Load(filename, &binaryInFile, pd3dDevice, invertTexCoords);
+	Geometry geometry = objLoader->Load(filename, &binaryInFile, renderDevice, invertTexCoords);
 	
 	delete objLoader;
 	objLoader = nullptr;
 
 	return geometry;
+}
+
+MeshData OBJLoader::Decode(char* filename, bool invertTexCoords)
+{
+	return OBJFileLoader::Decode(filename, invertTexCoords);
+}
+
+Geometry OBJLoader::Upload(const MeshData& mesh, IRenderDevice* renderDevice)
+{
+	return OBJFileLoader::Upload(mesh, renderDevice);
+}
+
+// Removes the binary copy written by Load so the next Load parses the edited OBJ again
+void OBJLoader::DiscardBinary(char* filename)
+{
+	std::string binaryFilename = filename;
+	binaryFilename.append("Binary");
+	std::remove(binaryFilename.c_str());
 }
\ No newline at end of file
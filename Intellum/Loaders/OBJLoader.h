@@ -4,6 +4,7 @@
 
 #include <Windows.h>
 #include <directxmath.h>
+#include <cstdio>
 #include <fstream>
 #include <vector>
 #include <map>
@@ -19,5 +20,8 @@ using namespace DirectX;
 
 namespace OBJLoader
 {
-	Geometry Load(char* filename, ID3D11Device* pd3dDevice, bool invertTexCoords = true);
+	Geometry Load(char* filename, IRenderDevice* renderDevice, bool invertTexCoords = true);
+	MeshData Decode(char* filename, bool invertTexCoords = true);
+	Geometry Upload(const MeshData& mesh, IRenderDevice* renderDevice);
+	void DiscardBinary(char* filename);
 };
\ No newline at end of file
@@ -1,10 +1,11 @@
 #pragma once
 #include "../../Engine/Objects/Geometry/Geometry.h"
+#include "../../Engine/Rendering/IRenderDevice.h"
 #include "../../common/Vertex.h"
 
 class IOBJLoader
 {
 public:
 	virtual ~IOBJLoader() {}
-	virtual Geometry Load(char* filename, std::fstream* binaryFile, ID3D11Device* pd3dDevice, bool invertTexCoords) = 0;
+	virtual Geometry Load(char* filename, std::fstream* binaryFile, IRenderDevice* renderDevice, bool invertTexCoords) = 0;
 };
\ No newline at end of file
@@ -10,7 +10,7 @@ OBJBinaryLoader::~OBJBinaryLoader()
 {
 }
 
-Geometry OBJBinaryLoader::Load(char* filename, std::fstream* binaryFile, ID3D11Device* pd3dDevice, bool invertTexCoords)
+Geometry OBJBinaryLoader::Load(char* filename, std::fstream* binaryFile, IRenderDevice* renderDevice, bool invertTexCoords)
 {
 	Geometry meshData;
 
@@ -24,41 +24,12 @@ Geometry OBJBinaryLoader::Load(char* filename, std::fstream* binaryFile, ID3D11D
 	binaryFile->read(reinterpret_cast<char*>(finalVerts), sizeof(Vertex) * meshData.VertexCount);
 	binaryFile->read(reinterpret_cast<char*>(indices), sizeof(unsigned long) * meshData.IndexCount);
 
-	// Setup description for the Vertex Buffer
-	D3D11_BUFFER_DESC vertexBufferDesc;
-	D3D11_SUBRESOURCE_DATA vertexData;
-	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	vertexBufferDesc.ByteWidth = sizeof(Vertex) * meshData.VertexCount;
-	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vertexBufferDesc.CPUAccessFlags = 0;
-	vertexBufferDesc.MiscFlags = 0;
-	vertexBufferDesc.StructureByteStride = 0;
-
-	vertexData.pSysMem = finalVerts;
-	vertexData.SysMemPitch = 0;
-	vertexData.SysMemSlicePitch = 0;
-
-	pd3dDevice->CreateBuffer(&vertexBufferDesc, &vertexData, &meshData.VertexBuffer);
+	meshData.VertexBuffer = renderDevice->CreateBuffer(BUFFER_VERTEX, finalVerts, sizeof(Vertex) * meshData.VertexCount, false);
 
 	meshData.VBOffset = 0;
 	meshData.VBStride = sizeof(Vertex);
 
-	// Setup description for the Index Buffer
-	D3D11_BUFFER_DESC indexBufferDesc;
-	D3D11_SUBRESOURCE_DATA indexData;
-
-	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	indexBufferDesc.ByteWidth = sizeof(unsigned long) * meshData.IndexCount;
-	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	indexBufferDesc.CPUAccessFlags = 0;
-	indexBufferDesc.MiscFlags = 0;
-	indexBufferDesc.StructureByteStride = 0;
-
-	indexData.pSysMem = indices;
-	indexData.SysMemPitch = 0;
-	indexData.SysMemSlicePitch = 0;
-
-	pd3dDevice->CreateBuffer(&indexBufferDesc, &indexData, &meshData.IndexBuffer);
+	meshData.IndexBuffer = renderDevice->CreateBuffer(BUFFER_INDEX, indices, sizeof(unsigned long) * meshData.IndexCount, false);
 
 	float lowestX = finalVerts[0].position.x;
 	float highestX = finalVerts[0].position.x;
@@ -10,5 +10,5 @@ public:
 	OBJBinaryLoader();
 	~OBJBinaryLoader();
 
-	Geometry Load(char* filename, std::fstream* binaryFile, ID3D11Device* pd3dDevice, bool invertTexCoords) override;
+	Geometry Load(char* filename, std::fstream* binaryFile, IRenderDevice* renderDevice, bool invertTexCoords) override;
 };
\ No newline at end of file
@@ -4,38 +4,14 @@ OBJFileLoader::OBJFileLoader()
 {
 }
 
-Geometry OBJFileLoader::Load(char* filename, fstream* binaryFile, ID3D11Device* pd3dDevice, bool invertTexCoords)
+Geometry OBJFileLoader::Load(char* filename, fstream* binaryFile, IRenderDevice* renderDevice, bool invertTexCoords)
 {
 	try
 	{
-		OBJGeometryData geometryData = BuildGeometryDataFrom(filename, invertTexCoords);
-		geometryData = BuildExpandedGeometryDataFrom(geometryData);
-		geometryData = CreateIndices(geometryData);
-		Vertex* finalVerts = BuildVertexObjectFrom(geometryData);
+		MeshData mesh = Decode(filename, invertTexCoords);
+		Geometry meshData = Upload(mesh, renderDevice);
 
-		unsigned long long vertexCount = geometryData.VertexData[VERTICES].size();
-		ID3D11Buffer* vertexBuffer = CreateVertexBuffer(pd3dDevice, vertexCount, finalVerts);
-
-		unsigned long long indexCount = geometryData.IndexData[VERTICES].size();
-		unsigned short* indicesArray = new unsigned short[indexCount];
-		for (unsigned int i = 0; i < indexCount; ++i)
-		{
-			indicesArray[i] = geometryData.IndexData[VERTICES][i];
-		}
-
-		ID3D11Buffer* indexBuffer = CreateIndexBuffer(pd3dDevice, indexCount, indicesArray);
-
-		CreateBinaryFileForObject(binaryFile, finalVerts, indicesArray, vertexCount, indexCount);
-
-		Geometry meshData;
-		meshData.VertexBuffer = vertexBuffer;
-		meshData.VBOffset = 0;
-		meshData.VBStride = sizeof(Vertex);
-		meshData.IndexCount = static_cast<UINT>(indexCount);
-		meshData.IndexBuffer = indexBuffer;
-		meshData.Size = geometryData.Size;
-		delete[] indicesArray;
-		delete[] finalVerts;
+		CreateBinaryFileForObject(binaryFile, &mesh.Vertices[0], &mesh.Indices[0], mesh.Vertices.size(), mesh.Indices.size());
 
 		return meshData;
 	}
@@ -45,6 +21,42 @@ Geometry OBJFileLoader::Load(char* filename, fstream* binaryFile, ID3D11Device*
 	}
 }
 
+// Only reads the file and builds the vertex and index lists, so it is safe to run away from the main thread
+MeshData OBJFileLoader::Decode(char* filename, bool invertTexCoords)
+{
+	OBJGeometryData geometryData = BuildGeometryDataFrom(filename, invertTexCoords);
+	geometryData = BuildExpandedGeometryDataFrom(geometryData);
+	geometryData = CreateIndices(geometryData);
+
+	if (geometryData.IndexData[VERTICES].empty())
+		throw Exception("'" + string(filename) + "' does not contain any faces.");
+
+	Vertex* finalVerts = BuildVertexObjectFrom(geometryData);
+
+	MeshData mesh;
+	mesh.Vertices.assign(finalVerts, finalVerts + geometryData.VertexData[VERTICES].size());
+	mesh.Indices = geometryData.IndexData[VERTICES];
+	mesh.Size = geometryData.Size;
+
+	delete[] finalVerts;
+
+	return mesh;
+}
+
+Geometry OBJFileLoader::Upload(const MeshData& mesh, IRenderDevice* renderDevice)
+{
+	Geometry meshData;
+	meshData.VertexBuffer = CreateVertexBuffer(renderDevice, mesh.Vertices.size(), &mesh.Vertices[0]);
+	meshData.VBOffset = 0;
+	meshData.VBStride = sizeof(Vertex);
+	meshData.VertexCount = static_cast<UINT>(mesh.Vertices.size());
+	meshData.IndexCount = static_cast<UINT>(mesh.Indices.size());
+	meshData.IndexBuffer = CreateIndexBuffer(renderDevice, mesh.Indices.size(), &mesh.Indices[0]);
+	meshData.Size = mesh.Size;
+
+	return meshData;
+}
+
 OBJGeometryData OBJFileLoader::BuildGeometryDataFrom(char* fileName, bool invertTexCoords)
 {
 	ifstream inFile;
@@ -272,47 +284,21 @@ Vertex* OBJFileLoader::BuildVertexObjectFrom(OBJGeometryData geometryData)
 	return finalVerts;
 }
 
-ID3D11Buffer* OBJFileLoader::CreateVertexBuffer(ID3D11Device* pd3dDevice, unsigned long long vertexCount, Vertex* finalVerts)
+ID3D11Buffer* OBJFileLoader::CreateVertexBuffer(IRenderDevice* renderDevice, unsigned long long vertexCount, const Vertex* finalVerts)
 {
-	D3D11_BUFFER_DESC bd;
-	ZeroMemory(&bd, sizeof(bd));
-	bd.Usage = D3D11_USAGE_DEFAULT;
-	bd.ByteWidth = sizeof(Vertex) * static_cast<UINT>(vertexCount);
-	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	bd.CPUAccessFlags = 0;
-
-	D3D11_SUBRESOURCE_DATA InitData;
-	ZeroMemory(&InitData, sizeof(InitData));
-	InitData.pSysMem = finalVerts;
-
-	ID3D11Buffer* vertexBuffer;
-	pd3dDevice->CreateBuffer(&bd, &InitData, &vertexBuffer);
-	return vertexBuffer;
+	return renderDevice->CreateBuffer(BUFFER_VERTEX, finalVerts, sizeof(Vertex) * static_cast<int>(vertexCount), false);
 }
 
-ID3D11Buffer* OBJFileLoader::CreateIndexBuffer(ID3D11Device* pd3dDevice, unsigned long long indicesCount, unsigned short* indicesArray)
+ID3D11Buffer* OBJFileLoader::CreateIndexBuffer(IRenderDevice* renderDevice, unsigned long long indicesCount, const unsigned short* indicesArray)
 {
-	D3D11_BUFFER_DESC bd;
-	ZeroMemory(&bd, sizeof(bd));
-	bd.Usage = D3D11_USAGE_DEFAULT;
-	bd.ByteWidth = sizeof(WORD) * static_cast<UINT>(indicesCount);
-	bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	bd.CPUAccessFlags = 0;
-
-	D3D11_SUBRESOURCE_DATA InitData;
-	ZeroMemory(&InitData, sizeof(InitData));
-	InitData.pSysMem = indicesArray;
-
-	ID3D11Buffer* indexBuffer;
-	pd3dDevice->CreateBuffer(&bd, &InitData, &indexBuffer);
-	return indexBuffer;
+	return renderDevice->CreateBuffer(BUFFER_INDEX, indicesArray, sizeof(WORD) * static_cast<int>(indicesCount), false);
 }
 
-void OBJFileLoader::CreateBinaryFileForObject(fstream* binaryFile, Vertex* vertices, unsigned short* indicesArray, unsigned long long vertexCount, unsigned long long indexCount)
+void OBJFileLoader::CreateBinaryFileForObject(fstream* binaryFile, const Vertex* vertices, const unsigned short* indicesArray, unsigned long long vertexCount, unsigned long long indexCount)
 {
 	binaryFile->write(reinterpret_cast<char*>(&vertexCount), sizeof(unsigned int));
 	binaryFile->write(reinterpret_cast<char*>(&indexCount), sizeof(unsigned int));
-	binaryFile->write(reinterpret_cast<char*>(vertices), sizeof(Vertex) * vertexCount);
-	binaryFile->write(reinterpret_cast<char*>(indicesArray), sizeof(unsigned short) * indexCount);
+	binaryFile->write(reinterpret_cast<const char*>(vertices), sizeof(Vertex) * vertexCount);
+	binaryFile->write(reinterpret_cast<const char*>(indicesArray), sizeof(unsigned short) * indexCount);
 	binaryFile->close();
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <map>
 #include "IOBJLoader.h"
 #include "../models/OBJGeometryData.h"
+#include "../models/MeshData.h"
 #include "../../ErrorHandling/Exception.h"
 
 class OBJFileType
@@ -31,13 +32,16 @@ private:
 
 	static Vertex* BuildVertexObjectFrom(OBJGeometryData geometryData);
 
-	static ID3D11Buffer* CreateVertexBuffer(ID3D11Device* pd3dDevice, unsigned long long vertexCount, Vertex* finalVerts);
-	static ID3D11Buffer* CreateIndexBuffer(ID3D11Device* pd3dDevice, unsigned long long indicesCount, unsigned short* indicesArray);
+	static ID3D11Buffer* CreateVertexBuffer(IRenderDevice* renderDevice, unsigned long long vertexCount, const Vertex* finalVerts);
+	static ID3D11Buffer* CreateIndexBuffer(IRenderDevice* renderDevice, unsigned long long indicesCount, const unsigned short* indicesArray);
 
-	static void CreateBinaryFileForObject(fstream* binaryFile, Vertex* vertices, unsigned short* indicesArray, unsigned long long vertexCount, unsigned long long indexCount);
+	static void CreateBinaryFileForObject(fstream* binaryFile, const Vertex* vertices, const unsigned short* indicesArray, unsigned long long vertexCount, unsigned long long indexCount);
 public:
 	OBJFileLoader();
 	~OBJFileLoader() override = default;
 
-	Geometry Load(char* filename, fstream* binaryFile, ID3D11Device* pd3dDevice, bool invertTexCoords) override;
+	static MeshData Decode(char* filename, bool invertTexCoords);
+	static Geometry Upload(const MeshData& mesh, IRenderDevice* renderDevice);
+
+	Geometry Load(char* filename, fstream* binaryFile, IRenderDevice* renderDevice, bool invertTexCoords) override;
 };
\ No newline at end of file
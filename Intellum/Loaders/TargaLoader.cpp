@@ -24,6 +24,46 @@ TargaData TargaLoader::LoadTarga(char* filename)
 	return targaData;
 }
 
+// Writes the image the way LoadTarga reads it back: uncompressed 32 bit, bottom row first, in BGRA order
+void TargaLoader::SaveTarga(char* filename, const TargaData& targaData)
+{
+	FILE* filePointer;
+
+	int error = fopen_s(&filePointer, filename, "wb");
+	if (error != 0)
+		throw Exception("Errors occured opening file: '" + string(filename) + "'");
+
+	int width = static_cast<int>(targaData.ImageSize.Width);
+	int height = static_cast<int>(targaData.ImageSize.Height);
+
+	TargaHeader targaFileHeader = {};
+	targaFileHeader.data1[2] = 2;
+	targaFileHeader.width = static_cast<unsigned short>(width);
+	targaFileHeader.height = static_cast<unsigned short>(height);
+	targaFileHeader.bpp = 32;
+	targaFileHeader.data2 = 8;
+
+	unsigned char* rawTargaData = new unsigned char[width * height * 4];
+	for (int y = 0; y < height; y++)
+	{
+		const unsigned char* row = &targaData.ImageData[(height - 1 - y) * width * 4];
+		for (int x = 0; x < width * 4; x += 4)
+		{
+			rawTargaData[y * width * 4 + x] = row[x + 2];
+			rawTargaData[y * width * 4 + x + 1] = row[x + 1];
+			rawTargaData[y * width * 4 + x + 2] = row[x];
+			rawTargaData[y * width * 4 + x + 3] = row[x + 3];
+		}
+	}
+
+	bool written = fwrite(&targaFileHeader, sizeof(TargaHeader), 1, filePointer) == 1 && fwrite(rawTargaData, 1, width * height * 4, filePointer) == static_cast<size_t>(width * height * 4);
+	delete[] rawTargaData;
+
+	CloseFile(filePointer, filename);
+	if (!written)
+		throw Exception("Failed to write the data to: '" + string(filename) + "'");
+}
+
 FILE* TargaLoader::OpenFile(char* filename)
 {
 	FILE* filePointer;
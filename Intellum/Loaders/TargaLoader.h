@@ -29,6 +29,7 @@ private:
 	static unsigned char* ReverseTargaData(unsigned char* rawTargaData, int imageDataSize, Box imageSize);
 public:
 	static TargaData LoadTarga(char* filename);
+	static void SaveTarga(char* filename, const TargaData& targaData);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+#include <vector>
+#include "../../Common/Vertex.h"
+
+using namespace std;
+
+// A mesh decoded into memory but not yet uploaded, so decoding can happen away from the device
+class MeshData
+{
+public:
+	vector<Vertex> Vertices;
+	vector<unsigned short> Indices;
+	XMFLOAT3 Size;
+};
\ No newline at end of file